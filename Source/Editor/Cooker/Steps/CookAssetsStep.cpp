@@ -18,7 +18,9 @@
 #include "Engine/Render2D/SpriteAtlas.h"
 #include "Engine/Content/Storage/FlaxFile.h"
 #include "Engine/Particles/ParticleEmitter.h"
+#include "Engine/Level/Scene/SceneAsset.h"
 #include "Engine/Utilities/Encryption.h"
+#include "Engine/Serialization/JsonBinary.h"
 #include "Engine/Serialization/JsonWriters.h"
 #include "Engine/Serialization/FileWriteStream.h"
 #include "Engine/Serialization/MemoryWriteStream.h"
@@ -737,6 +739,23 @@ bool ProcessTextureBase(CookAssetsStep::AssetCookData& data)
     return false;
 }
 
+bool ProcessSceneAsset(CookAssetsStep::AssetCookData& data)
+{
+    auto asset = static_cast<JsonAssetBase*>(data.Asset);
+
+    // Use binary json so scene loading in game skips text parsing
+    MemoryWriteStream stream(64 * 1024);
+    JsonBinary::Write(asset->Document, stream);
+
+    // Store json data in the first chunk
+    auto chunk = New<FlaxChunk>();
+    chunk->Flags = FlaxChunkFlags::CompressedLZ4; // Compress json data (internal storage layer will handle it)
+    chunk->Data.Copy(stream.GetHandle(), stream.GetPosition());
+    data.InitData.Header.Chunks[0] = chunk;
+
+    return false;
+}
+
 CookAssetsStep::CookAssetsStep()
     : AssetsRegistry(1024)
     , AssetPathsMapping(256)
@@ -747,6 +766,7 @@ CookAssetsStep::CookAssetsStep()
     AssetProcessors.Add(Texture::TypeName, ProcessTextureBase);
     AssetProcessors.Add(CubeTexture::TypeName, ProcessTextureBase);
     AssetProcessors.Add(SpriteAtlas::TypeName, ProcessTextureBase);
+    AssetProcessors.Add(SceneAsset::TypeName, ProcessSceneAsset);
 }
 
 bool CookAssetsStep::Process(CookingData& data, CacheData& cache, BinaryAsset* asset)
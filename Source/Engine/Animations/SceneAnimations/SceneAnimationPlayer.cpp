@@ -3,6 +3,7 @@
 #include "SceneAnimationPlayer.h"
 #include "Engine/Core/Random.h"
 #include "Engine/Engine/Time.h"
+#include "Engine/Level/Level.h"
 #include "Engine/Level/Scene/Scene.h"
 #include "Engine/Level/SceneObjectsFactory.h"
 #include "Engine/Level/Actors/Camera.h"
@@ -193,9 +194,11 @@ void SceneAnimationPlayer::Tick(float dt)
     _isUsingCameraCuts = false;
     _cameraCutCam = nullptr;
 
-    // Tick the animation
+    // Tick the animation (tracks can animate many actors so update their hierarchies once at the end)
     CallStack callStack;
+    Level::BeginTransformUpdate();
     Tick(anim, time, dt, 0, callStack);
+    Level::EndTransformUpdate();
 #if !BUILD_RELEASE
     if (_tracksDataStack.Count() != 0)
     {
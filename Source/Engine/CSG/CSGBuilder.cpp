@@ -4,7 +4,7 @@
 #include "CSGMesh.h"
 #include "CSGData.h"
 #include "Engine/Level/Level.h"
-#include "Engine/Level/SceneQuery.h"
+#include "Engine/Level/Scene/Scene.h"
 #include "Engine/Level/Actor.h"
 #include "Engine/Core/Log.h"
 #include "Engine/Core/Types/TimeSpan.h"
@@ -18,6 +18,10 @@
 #include "Engine/Engine/Engine.h"
 #include "Engine/Engine/EngineService.h"
 #include "Engine/Serialization/MemoryWriteStream.h"
+#include "Engine/Core/Math/Int3.h"
+#include "Engine/Profiler/ProfilerCPU.h"
+#include "Engine/Threading/JobSystem.h"
+#include "Engine/Utilities/Crc.h"
 #if USE_EDITOR
 #include "Editor/Editor.h"
 #endif
@@ -29,11 +33,21 @@ using namespace CSG;
 // Enable/disable locking scene during building CSG brushes nodes
 #define CSG_USE_SCENE_LOCKS 0
 
+// Size of the grid cell used to find the brushes that can affect each other (in world units)
+#define CSG_BUILD_CELL_SIZE 1000.0f
+
+// Maximum amount of grid cells a single brush can be inserted into (bigger brushes are tested against all others)
+#define CSG_BUILD_MAX_BRUSH_CELLS 512
+
+// Margin added to the brush bounds when checking if brushes affect each other
+#define CSG_BUILD_BOUNDS_MARGIN 1
+
 struct BuildData;
 
 namespace CSGBuilderImpl
 {
     Array<Scene*> ScenesToRebuild;
+    Dictionary<Scene*, Dictionary<Guid, CSG::RawData*>> ChunksCache;
 
     void onSceneUnloading(Scene* scene, const Guid& sceneId);
     bool buildInner(Scene* scene, BuildData& data);
@@ -54,6 +68,7 @@ class CSGBuilderService : public EngineService
 
     bool Init() override;
     void Update() override;
+    void Dispose() override;
 };
 
 CSGBuilderService CSGBuilderServiceInstance;
@@ -64,6 +79,14 @@ void CSGBuilderImpl::onSceneUnloading(Scene* scene, const Guid& sceneId)
 {
     // Ensure to remove scene (prevent crashes)
     ScenesToRebuild.Remove(scene);
+
+    // Release cached chunks
+    Dictionary<Guid, RawData*>* cache = ChunksCache.TryGet(scene);
+    if (cache)
+    {
+        cache->ClearDelete();
+        ChunksCache.Remove(scene);
+    }
 }
 
 bool CSGBuilderService::Init()
@@ -93,6 +116,13 @@ void CSGBuilderService::Update()
     }
 }
 
+void CSGBuilderService::Dispose()
+{
+    for (auto i = ChunksCache.Begin(); i.IsNotEnd(); ++i)
+        i->Value.ClearDelete();
+    ChunksCache.Clear();
+}
+
 bool Builder::IsActive()
 {
     return ScenesToRebuild.HasItems();
@@ -121,37 +151,6 @@ namespace CSG
 {
     typedef Dictionary<Actor*, Mesh*> MeshesLookup;
 
-    bool walkTree(Actor* actor, MeshesArray& meshes, MeshesLookup& cache)
-    {
-        // Check if actor is a brush
-        auto brush = dynamic_cast<Brush*>(actor);
-        if (brush)
-        {
-            // Check if can build it
-            if (brush->CanUseCSG())
-            {
-                // Skip subtract/common meshes from the beginning (they have no effect)
-                if (meshes.Count() > 0 || brush->GetBrushMode() == Mode::Additive)
-                {
-                    // Create new mesh and build for given brush
-                    auto mesh = New<CSG::Mesh>();
-                    mesh->Build(brush);
-
-                    // Save results
-                    meshes.Add(mesh);
-                    cache.Add(actor, mesh);
-                }
-                else
-                {
-                    // Info
-                    LOG(Info, "Skipping CSG brush '{0}'", actor->ToString());
-                }
-            }
-        }
-
-        return true;
-    }
-
     Mesh* Combine(Actor* actor, MeshesLookup& cache, Mesh* combineParent)
     {
         ASSERT(actor);
@@ -218,65 +217,316 @@ namespace CSG
 
         return result;
     }
+}
 
-    Mesh* Combine(Scene* scene, MeshesLookup& cache)
-    {
-#if CSG_USE_SCENE_LOCKS
-		auto Level = Level::Instance();
-		Level->Lock();
-#endif
-
-        Mesh* result = Combine(scene, cache, nullptr);
-
-#if CSG_USE_SCENE_LOCKS
-		Level->Unlock();
-#endif
+struct BuildBrush
+{
+    Actor* Owner;
+    CSG::Brush* Brush;
+    CSG::Mesh* Mesh;
+    AABB Bounds;
+};
 
-        return result;
-    }
-}
+struct BuildChunk
+{
+    Guid Key;
+    Actor* Root;
+    Array<int32> Brushes;
+    RawData* Data;
+};
 
 struct BuildData
 {
-    MeshesArray meshes;
-    MeshesLookup cache;
+    Array<BuildBrush> brushes;
+    Array<BuildChunk> chunks;
+    int32 rebuiltChunks = 0;
     Guid outputModelAssetId = Guid::Empty;
     Guid outputRawDataAssetId = Guid::Empty;
     Guid outputCollisionDataAssetId = Guid::Empty;
 
-    BuildData(int32 meshesCapacity = 32)
-        : meshes(meshesCapacity * 32)
-        , cache(meshesCapacity * 4)
+    BuildData(int32 brushesCapacity = 32)
+        : brushes(brushesCapacity)
+    {
+    }
+
+    ~BuildData()
     {
+        for (int32 i = 0; i < brushes.Count(); i++)
+        {
+            if (brushes[i].Mesh)
+                Delete(brushes[i].Mesh);
+        }
     }
 };
 
+namespace
+{
+    struct ChunkKeyBuilder
+    {
+        uint32 Crc = 0;
+        uint64 Fnv = 14695981039346656037ull;
+        uint32 Length = 0;
+
+        void Append(const void* data, int32 length)
+        {
+            Crc = Crc::MemCrc32(data, length, Crc);
+            const byte* ptr = (const byte*)data;
+            for (int32 i = 0; i < length; i++)
+            {
+                Fnv ^= ptr[i];
+                Fnv *= 1099511628211ull;
+            }
+            Length += (uint32)length;
+        }
+
+        Guid ToKey() const
+        {
+            return Guid(Crc, (uint32)Fnv, (uint32)(Fnv >> 32), Length);
+        }
+    };
+
+    bool walkTree(Actor* actor, Array<BuildBrush>& brushes)
+    {
+        // Check if actor is a brush that can be built
+        auto brush = dynamic_cast<Brush*>(actor);
+        if (brush && brush->CanUseCSG())
+        {
+            auto& e = brushes.AddOne();
+            e.Owner = actor;
+            e.Brush = brush;
+            e.Mesh = nullptr;
+        }
+
+        return true;
+    }
+
+    int32 findChunk(Array<int32>& parents, int32 index)
+    {
+        while (parents[index] != index)
+        {
+            parents[index] = parents[parents[index]];
+            index = parents[index];
+        }
+        return index;
+    }
+
+    void mergeChunks(Array<int32>& parents, const Array<BuildBrush>& brushes, int32 a, int32 b)
+    {
+        if (AABB::IsOutside(brushes[a].Bounds, brushes[b].Bounds))
+            return;
+        a = findChunk(parents, a);
+        b = findChunk(parents, b);
+        if (a != b)
+            parents[Math::Max(a, b)] = Math::Min(a, b);
+    }
+
+    bool isInHierarchy(const Actor* parent, const Actor* actor)
+    {
+        while (actor && actor != parent)
+            actor = actor->GetParent();
+        return actor != nullptr;
+    }
+
+    void appendChunk(RawData& result, const RawData& chunk)
+    {
+        // Keep separate slots per chunk so every chunk ends up as a separate mesh (culled on its own)
+        for (int32 i = 0; i < chunk.Slots.Count(); i++)
+        {
+            auto slot = New<RawData::Slot>(chunk.Slots[i]->Material);
+            slot->Surfaces = chunk.Slots[i]->Surfaces;
+            result.Slots.Add(slot);
+        }
+        for (auto i = chunk.Brushes.Begin(); i.IsNotEnd(); ++i)
+            result.Brushes[i->Key] = i->Value;
+    }
+}
+
 bool CSGBuilderImpl::buildInner(Scene* scene, BuildData& data)
 {
-    // Setup CSG meshes list and build them
+    // Gather CSG brushes and build their meshes
     {
-        Function<bool(Actor*, MeshesArray&, MeshesLookup&)> treeWalkFunction(walkTree);
-        SceneQuery::TreeExecute<Array<CSG::Mesh*>&, MeshesLookup&>(treeWalkFunction, data.meshes, data.cache);
+        Function<bool(Actor*, Array<BuildBrush>&)> treeWalkFunction(walkTree);
+        scene->TreeExecute<Array<BuildBrush>&>(treeWalkFunction, data.brushes);
     }
-    if (data.meshes.IsEmpty())
+    if (data.brushes.IsEmpty())
         return false;
+    {
+        PROFILE_CPU_NAMED("CSG.BuildBrushes");
+        Function<void(int32)> job = [&data](int32 index)
+        {
+            auto& e = data.brushes[index];
+            e.Mesh = New<CSG::Mesh>();
+            e.Mesh->Build(e.Brush);
+        };
+        JobSystem::Execute(job, data.brushes.Count());
+    }
 
-    // Process all meshes (performs actual CSG opterations on geometry in tree structure)
-    CSG::Mesh* combinedMesh = Combine(scene, data.cache);
-    if (combinedMesh == nullptr)
-        return false;
+    // Split brushes into chunks of brushes that can affect each other (with overlapping bounds), other brushes don't interact during CSG operations
+    Array<int32> parents;
+    parents.Resize(data.brushes.Count());
+    {
+        PROFILE_CPU_NAMED("CSG.Partition");
+        Dictionary<uint64, Array<int32>> cells(data.brushes.Count() * 4);
+        Array<int32> largeBrushes;
+        for (int32 i = 0; i < data.brushes.Count(); i++)
+        {
+            auto& e = data.brushes[i];
+            parents[i] = i;
+            e.Bounds = AABB();
+            if (e.Mesh->GetVertices()->IsEmpty())
+                continue;
+            e.Bounds = e.Mesh->GetBounds();
+            e.Bounds.MinX -= CSG_BUILD_BOUNDS_MARGIN;
+            e.Bounds.MinY -= CSG_BUILD_BOUNDS_MARGIN;
+            e.Bounds.MinZ -= CSG_BUILD_BOUNDS_MARGIN;
+            e.Bounds.MaxX += CSG_BUILD_BOUNDS_MARGIN;
+            e.Bounds.MaxY += CSG_BUILD_BOUNDS_MARGIN;
+            e.Bounds.MaxZ += CSG_BUILD_BOUNDS_MARGIN;
+
+            // Insert brush into the grid cells it overlaps (test only against brushes from the same cells)
+            const Int3 cellMin(Math::FloorToInt((float)e.Bounds.MinX / CSG_BUILD_CELL_SIZE), Math::FloorToInt((float)e.Bounds.MinY / CSG_BUILD_CELL_SIZE), Math::FloorToInt((float)e.Bounds.MinZ / CSG_BUILD_CELL_SIZE));
+            const Int3 cellMax(Math::FloorToInt((float)e.Bounds.MaxX / CSG_BUILD_CELL_SIZE), Math::FloorToInt((float)e.Bounds.MaxY / CSG_BUILD_CELL_SIZE), Math::FloorToInt((float)e.Bounds.MaxZ / CSG_BUILD_CELL_SIZE));
+            const int64 cellsCount = (int64)(cellMax.X - cellMin.X + 1) * (cellMax.Y - cellMin.Y + 1) * (cellMax.Z - cellMin.Z + 1);
+            if (cellsCount > CSG_BUILD_MAX_BRUSH_CELLS)
+            {
+                // Very big brushes are tested against all other brushes
+                largeBrushes.Add(i);
+                continue;
+            }
+            for (int32 z = cellMin.Z; z <= cellMax.Z; z++)
+            {
+                for (int32 y = cellMin.Y; y <= cellMax.Y; y++)
+                {
+                    for (int32 x = cellMin.X; x <= cellMax.X; x++)
+                    {
+                        const uint64 cellKey = (uint64)(x & 0x1fffff) | (uint64)(y & 0x1fffff) << 21 | (uint64)(z & 0x1fffff) << 42;
+                        auto& cell = cells[cellKey];
+                        for (int32 j = 0; j < cell.Count(); j++)
+                            mergeChunks(parents, data.brushes, i, cell[j]);
+                        cell.Add(i);
+                    }
+                }
+            }
+        }
+        for (int32 i = 0; i < largeBrushes.Count(); i++)
+        {
+            for (int32 j = 0; j < data.brushes.Count(); j++)
+            {
+                if (largeBrushes[i] != j)
+                    mergeChunks(parents, data.brushes, largeBrushes[i], j);
+            }
+        }
+    }
+
+    // Setup chunks (in the scene tree order)
+    {
+        Array<int32> rootToChunk;
+        rootToChunk.Resize(data.brushes.Count());
+        for (int32 i = 0; i < data.brushes.Count(); i++)
+            rootToChunk[i] = -1;
+        for (int32 i = 0; i < data.brushes.Count(); i++)
+        {
+            auto& e = data.brushes[i];
+            if (e.Mesh->GetVertices()->IsEmpty())
+                continue;
+            const int32 root = findChunk(parents, i);
+            int32& chunkIndex = rootToChunk[root];
+            if (chunkIndex == -1)
+            {
+                // Skip subtract/common meshes from the beginning (they have no effect)
+                if (e.Brush->GetBrushMode() != Mode::Additive)
+                {
+                    LOG(Info, "Skipping CSG brush '{0}'", e.Owner->ToString());
+                    continue;
+                }
+                chunkIndex = data.chunks.Count();
+                auto& chunk = data.chunks.AddOne();
+                chunk.Root = e.Owner;
+                chunk.Data = nullptr;
+            }
+            auto& chunk = data.chunks[chunkIndex];
+            chunk.Brushes.Add(i);
+
+            // Combine from the common parent of all chunk brushes
+            while (!isInHierarchy(chunk.Root, e.Owner))
+                chunk.Root = chunk.Root->GetParent();
+        }
+    }
+
+    // Reuse cached results for chunks that didn't change
+    auto& cache = ChunksCache[scene];
+    Array<int32> chunksToRebuild;
+    for (int32 chunkIndex = 0; chunkIndex < data.chunks.Count(); chunkIndex++)
+    {
+        auto& chunk = data.chunks[chunkIndex];
+        ChunkKeyBuilder key;
+        const Guid rootId = chunk.Root->GetID();
+        key.Append(&rootId, sizeof(rootId));
+        for (int32 i = 0; i < chunk.Brushes.Count(); i++)
+        {
+            auto& e = data.brushes[chunk.Brushes[i]];
+            const Guid id = e.Owner->GetID();
+            const Guid parentId = e.Owner->GetParent() ? e.Owner->GetParent()->GetID() : Guid::Empty;
+            const Mode mode = e.Brush->GetBrushMode();
+            const Array<Surface>* surfaces = e.Mesh->GetSurfaces();
+            key.Append(&id, sizeof(id));
+            key.Append(&parentId, sizeof(parentId));
+            key.Append(&mode, sizeof(mode));
+            key.Append(surfaces->Get(), surfaces->Count() * sizeof(Surface));
+        }
+        chunk.Key = key.ToKey();
+        if (!cache.TryGet(chunk.Key, chunk.Data))
+            chunksToRebuild.Add(chunkIndex);
+    }
 
-    // TODO: split too big meshes (too many verts, to far parts, etc.)
+    // Process modified chunks (performs actual CSG operations on geometry in tree structure and triangulates the result)
+    if (chunksToRebuild.HasItems())
+    {
+        PROFILE_CPU_NAMED("CSG.BuildChunks");
+#if CSG_USE_SCENE_LOCKS
+        ScopeLock lock(Level::ScenesLock);
+#endif
+        Function<void(int32)> job = [&data, &chunksToRebuild](int32 index)
+        {
+            auto& chunk = data.chunks[chunksToRebuild[index]];
+            MeshesLookup meshes(chunk.Brushes.Count() * 4);
+            for (int32 i = 0; i < chunk.Brushes.Count(); i++)
+            {
+                auto& e = data.brushes[chunk.Brushes[i]];
+                meshes.Add(e.Owner, e.Mesh);
+            }
+            chunk.Data = New<RawData>();
+            CSG::Mesh* combinedMesh = Combine(chunk.Root, meshes, nullptr);
+            if (combinedMesh && combinedMesh->HasMode(Mode::Additive))
+            {
+                // Convert CSG meshes into raw triangles data
+                Array<RawModelVertex> vertexBuffer;
+                combinedMesh->Triangulate(*chunk.Data, vertexBuffer);
+                chunk.Data->RemoveEmptySlots();
+            }
+        };
+        JobSystem::Execute(job, chunksToRebuild.Count());
+        data.rebuiltChunks = chunksToRebuild.Count();
+    }
 
-    // Triangulate meshes
+    // Update cache (remove chunks that no longer exist)
     {
-        // TODO: setup valid loop for splited meshes
+        Dictionary<Guid, RawData*> chunksCache(data.chunks.Count() * 2);
+        for (int32 i = 0; i < data.chunks.Count(); i++)
+            chunksCache.Add(data.chunks[i].Key, data.chunks[i].Data);
+        for (auto i = cache.Begin(); i.IsNotEnd(); ++i)
+        {
+            if (!chunksCache.ContainsKey(i->Key))
+                Delete(i->Value);
+        }
+        cache = MoveTemp(chunksCache);
+    }
 
-        // Convert CSG meshes into raw triangles data
+    // Merge chunks into a single model (each chunk uses own meshes, lightmap UVs are packed for all of them)
+    {
         RawData meshData;
-        Array<RawModelVertex> vertexBuffer;
-        combinedMesh->Triangulate(meshData, vertexBuffer);
-        meshData.RemoveEmptySlots();
+        for (int32 i = 0; i < data.chunks.Count(); i++)
+            appendChunk(meshData, *data.chunks[i].Data);
         if (meshData.Slots.HasItems())
         {
             const auto sceneDataFolderPath = scene->GetDataFolderPath();
@@ -383,9 +633,8 @@ void CSGBuilderImpl::build(Scene* scene)
     scene->CSGData.PostCSGBuild();
 
     // End
-    data.meshes.ClearDelete();
     auto endTime = DateTime::Now();
-    LOG(Info, "CSG build in {0} ms! {1} brush(es)", (endTime - startTime).GetTotalMilliseconds(), data.meshes.Count());
+    LOG(Info, "CSG build in {0} ms! {1} brush(es), {2}/{3} chunk(s) rebuilt", (endTime - startTime).GetTotalMilliseconds(), data.brushes.Count(), data.rebuiltChunks, data.chunks.Count());
 }
 
 bool CSGBuilderImpl::generateRawDataAsset(Scene* scene, RawData& meshData, Guid& assetId, const String& assetPath)
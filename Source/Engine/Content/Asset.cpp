@@ -11,7 +11,6 @@
 #include "Engine/Threading/Threading.h"
 #include "Engine/Profiler/ProfilerCPU.h"
 #include "Engine/Threading/MainThreadTask.h"
-#include "Engine/Threading/ConcurrentTaskQueue.h"
 #if USE_MONO
 #include <ThirdParty/mono-2.0/mono/metadata/mono-gc.h>
 #endif
@@ -345,11 +344,6 @@ void Asset::Reload()
     }
 }
 
-namespace ContentLoadingManagerImpl
-{
-    extern ConcurrentTaskQueue<ContentLoadTask> Tasks;
-};
-
 bool Asset::WaitForLoaded(double timeoutInMilliseconds)
 {
     // This function is used many time when some parts of the engine need to wait for asset loading end (it may fail but has to end).
@@ -401,44 +395,11 @@ bool Asset::WaitForLoaded(double timeoutInMilliseconds)
         // So during loading first material it will wait for child materials loaded calling this function
 
         Task* task = loadingTask;
-        Array<ContentLoadTask*, InlinedAllocation<64>> localQueue;
         while (!Engine::ShouldExit())
         {
-            // Try to execute content tasks
-            while (task->IsQueued() && !Engine::ShouldExit())
-            {
-                // Dequeue task from the loading queue
-                ContentLoadTask* tmp;
-                if (ContentLoadingManagerImpl::Tasks.try_dequeue(tmp))
-                {
-                    if (tmp == task)
-                    {
-                        if (localQueue.Count() != 0)
-                        {
-                            // Put back queued tasks
-                            ContentLoadingManagerImpl::Tasks.enqueue_bulk(localQueue.Get(), localQueue.Count());
-                            localQueue.Clear();
-                        }
-
-                        thread->Run(tmp);
-                    }
-                    else
-                    {
-                        localQueue.Add(tmp);
-                    }
-                }
-                else
-                {
-                    // No task in queue but it's queued so other thread could have stolen it into own local queue
-                    break;
-                }
-            }
-            if (localQueue.Count() != 0)
-            {
-                // Put back queued tasks
-                ContentLoadingManagerImpl::Tasks.enqueue_bulk(localQueue.Get(), localQueue.Count());
-                localQueue.Clear();
-            }
+            // Execute the task in place if it has not been taken by other thread yet
+            if (task->IsQueued() && ContentLoadingManager::TryDequeue(task))
+                thread->Run((ContentLoadTask*)task);
 
             // Check if task is done
             if (task->IsEnded())
@@ -460,7 +421,8 @@ bool Asset::WaitForLoaded(double timeoutInMilliseconds)
     }
     else
     {
-        // Wait for task end
+        // Move the task to the front of the loading queue and wait for its end
+        loadingTask->SetPriority(ContentLoadTask::Priority::Blocking);
         loadingTask->Wait(timeoutInMilliseconds);
     }
 
@@ -13,6 +13,7 @@
 #include "FlaxEngine.Gen.h"
 #include "Cache/AssetsCache.h"
 #include "Engine/Core/Log.h"
+#include "Engine/Serialization/JsonBinary.h"
 #include "Engine/Serialization/JsonTools.h"
 #include "Engine/Content/Factories/JsonAssetFactory.h"
 #include "Engine/Core/Cache.h"
@@ -146,15 +147,23 @@ Asset::LoadResult JsonAssetBase::loadAsset()
     auto& data = chunk->Data;
 #endif
 
-    // Parse json document
+    // Parse json document (cooked data can use binary format)
+    if (JsonBinary::IsBinary(data.Get(), data.Length()))
     {
-        PROFILE_CPU_NAMED("Json.Parse");
-        Document.Parse(data.Get<char>(), data.Length());
+        if (JsonBinary::Read(data.Get(), data.Length(), Document))
+            return LoadResult::CannotLoadData;
     }
-    if (Document.HasParseError())
+    else
     {
-        Log::JsonParseException(Document.GetParseError(), Document.GetErrorOffset());
-        return LoadResult::CannotLoadData;
+        {
+            PROFILE_CPU_NAMED("Json.Parse");
+            Document.Parse(data.Get<char>(), data.Length());
+        }
+        if (Document.HasParseError())
+        {
+            Log::JsonParseException(Document.GetParseError(), Document.GetErrorOffset());
+            return LoadResult::CannotLoadData;
+        }
     }
 
     // Gather information from the header
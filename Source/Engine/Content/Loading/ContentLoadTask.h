@@ -14,6 +14,7 @@ class LoadingThread;
 class ContentLoadTask : public Task
 {
     friend LoadingThread;
+    friend class ContentLoadingQueue;
 
 public:
 
@@ -27,6 +28,11 @@ class ContentLoadTask : public Task
     /// </summary>
     DECLARE_ENUM_5(Result, Ok, AssetLoadError, MissingReferences, LoadDataError, TaskFailed);
 
+    /// <summary>
+    /// Describes task priority class (in order of the execution). Blocking tasks are awaited by a thread, Urgent ones are needed by the gameplay soon, Normal is default and Prefetch is for speculative background loads.
+    /// </summary>
+    DECLARE_ENUM_4(Priority, Blocking, Urgent, Normal, Prefetch);
+
 private:
 
     /// <summary>
@@ -34,6 +40,12 @@ class ContentLoadTask : public Task
     /// </summary>
     Type _type;
 
+    // Loading queue data (guarded by the loading manager lock)
+    Priority _priority = Priority::Normal;
+    bool _isInQueue = false;
+    double _queueTime = 0.0;
+    double _deadline = 0.0;
+
 protected:
 
     /// <summary>
@@ -56,6 +68,26 @@ class ContentLoadTask : public Task
         return _type;
     }
 
+    /// <summary>
+    /// Gets the task priority.
+    /// </summary>
+    FORCE_INLINE Priority GetPriority() const
+    {
+        return _priority;
+    }
+
+    /// <summary>
+    /// Raises the task priority (lower priority is ignored). Moves the task to the higher queue if it's already queued. Propagated to the continuation tasks (eg. asset data loading followed by the asset loading).
+    /// </summary>
+    /// <param name="priority">The priority.</param>
+    void SetPriority(Priority priority);
+
+    /// <summary>
+    /// Sets the deadline for the task execution. If task is still waiting in the queue after that time it gets promoted to the Urgent priority.
+    /// </summary>
+    /// <param name="timeout">The timeout (in seconds) from now.</param>
+    void SetDeadline(float timeout);
+
 public:
 
     /// <summary>
@@ -88,4 +120,5 @@ class ContentLoadTask : public Task
     // [Task]
     void Enqueue() override;
     bool Run() override;
+    void OnCancel() override;
 };
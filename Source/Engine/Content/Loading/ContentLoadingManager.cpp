@@ -2,6 +2,7 @@
 
 #include "ContentLoadingManager.h"
 #include "ContentLoadTask.h"
+#include "ContentLoadingQueue.h"
 #include "Engine/Core/Log.h"
 #include "Engine/Core/Math/Math.h"
 #include "Engine/Platform/CPUInfo.h"
@@ -10,7 +11,6 @@
 #include "Engine/Content/Config.h"
 #include "Engine/Engine/EngineService.h"
 #include "Engine/Threading/Threading.h"
-#include "Engine/Threading/ConcurrentTaskQueue.h"
 #if USE_EDITOR && PLATFORM_WINDOWS
 #include "Engine/Platform/Win32/IncludeWindowsHeaders.h"
 #include <propidlbase.h>
@@ -21,7 +21,7 @@ namespace ContentLoadingManagerImpl
     THREADLOCAL LoadingThread* ThisThread = nullptr;
     LoadingThread* MainThread = nullptr;
     Array<LoadingThread*> Threads;
-    ConcurrentTaskQueue<ContentLoadTask> Tasks;
+    ContentLoadingQueue Tasks;
     ConditionVariable TasksSignal;
     CriticalSection TasksMutex;
 };
@@ -48,6 +48,7 @@ LoadingThread::LoadingThread()
     : _exitFlag(false)
     , _thread(nullptr)
     , _totalTasksDoneCount(0)
+    , _currentTask(nullptr)
 {
 }
 
@@ -97,7 +98,11 @@ void LoadingThread::Run(ContentLoadTask* job)
 {
     ASSERT(job);
 
+    // Note: task can be executed in place while waiting for the other one (see Asset::WaitForLoaded)
+    ContentLoadTask* prevTask = _currentTask;
+    _currentTask = job;
     job->Execute();
+    _currentTask = prevTask;
     _totalTasksDoneCount++;
 }
 
@@ -126,16 +131,13 @@ int32 LoadingThread::Run()
 
     while (HasExitFlagClear())
     {
-        if (Tasks.try_dequeue(task))
-        {
-            Run(task);
-        }
-        else
-        {
-            TasksMutex.Lock();
+        TasksMutex.Lock();
+        task = Tasks.Pop();
+        if (task == nullptr && HasExitFlagClear())
             TasksSignal.Wait(TasksMutex);
-            TasksMutex.Unlock();
-        }
+        TasksMutex.Unlock();
+        if (task)
+            Run(task);
     }
 
     ThisThread = nullptr;
@@ -156,9 +158,34 @@ LoadingThread* ContentLoadingManager::GetCurrentLoadThread()
 
 int32 ContentLoadingManager::GetTasksCount()
 {
+    ScopeLock lock(TasksMutex);
     return Tasks.Count();
 }
 
+int32 ContentLoadingManager::GetTasksCount(ContentLoadTask::Priority priority)
+{
+    ScopeLock lock(TasksMutex);
+    return Tasks.Count(priority);
+}
+
+float ContentLoadingManager::GetAverageWaitTime(ContentLoadTask::Priority priority)
+{
+    ScopeLock lock(TasksMutex);
+    return Tasks.GetAverageWaitTime(priority);
+}
+
+float ContentLoadingManager::GetMaxWaitTime(ContentLoadTask::Priority priority)
+{
+    ScopeLock lock(TasksMutex);
+    return Tasks.GetMaxWaitTime(priority);
+}
+
+bool ContentLoadingManager::TryDequeue(Task* task)
+{
+    ScopeLock lock(TasksMutex);
+    return Tasks.Remove(task);
+}
+
 bool ContentLoadingManagerService::Init()
 {
     ASSERT(ContentLoadingManagerImpl::Threads.IsEmpty() && IsInMainThread());
@@ -192,7 +219,9 @@ void ContentLoadingManagerService::BeforeExit()
     // Signal threads to end work soon
     for (int32 i = 0; i < Threads.Count(); i++)
         Threads[i]->NotifyExit();
+    TasksMutex.Lock();
     TasksSignal.NotifyAll();
+    TasksMutex.Unlock();
 }
 
 void ContentLoadingManagerService::Dispose()
@@ -200,7 +229,9 @@ void ContentLoadingManagerService::Dispose()
     // Exit all threads
     for (int32 i = 0; i < Threads.Count(); i++)
         Threads[i]->NotifyExit();
+    TasksMutex.Lock();
     TasksSignal.NotifyAll();
+    TasksMutex.Unlock();
     for (int32 i = 0; i < Threads.Count(); i++)
         Threads[i]->Join();
     Threads.ClearDelete();
@@ -209,15 +240,62 @@ void ContentLoadingManagerService::Dispose()
     ThisThread = nullptr;
 
     // Cancel all remaining tasks (no chance to execute them)
-    Tasks.CancelAll();
+    while (true)
+    {
+        TasksMutex.Lock();
+        ContentLoadTask* task = Tasks.Pop();
+        TasksMutex.Unlock();
+        if (!task)
+            break;
+        task->Cancel();
+    }
+}
+
+void ContentLoadTask::SetPriority(Priority priority)
+{
+    ScopeLock lock(TasksMutex);
+    ContentLoadTask* task = this;
+    while (task)
+    {
+        if (priority < task->_priority)
+            Tasks.SetPriority(task, priority);
+        task = dynamic_cast<ContentLoadTask*>(task->GetContinueWithTask());
+    }
+}
+
+void ContentLoadTask::SetDeadline(float timeout)
+{
+    ScopeLock lock(TasksMutex);
+    Tasks.SetDeadline(this, Platform::GetTimeSeconds() + Math::Max(timeout, ZeroTolerance));
 }
 
 void ContentLoadTask::Enqueue()
 {
+    TasksMutex.Lock();
+
+    // Inherit priority from the task that started this one (eg. dependency asset requested during other asset loading)
+    const LoadingThread* thread = ThisThread;
+    const ContentLoadTask* parent = thread ? thread->GetCurrentTask() : nullptr;
+    if (parent && parent->_priority < _priority)
+        _priority = parent->_priority;
+
     Tasks.Add(this);
+    TasksMutex.Unlock();
     TasksSignal.NotifyOne();
 }
 
+void ContentLoadTask::OnCancel()
+{
+    // Remove from the queue so the task won't be executed after being deleted
+    TasksMutex.Lock();
+    if (_isInQueue)
+        Tasks.Remove(this);
+    TasksMutex.Unlock();
+
+    // Base
+    Task::OnCancel();
+}
+
 bool ContentLoadTask::Run()
 {
     // Perform an operation
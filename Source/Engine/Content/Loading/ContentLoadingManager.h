@@ -3,10 +3,10 @@
 #pragma once
 
 #include "Engine/Threading/IRunnable.h"
+#include "ContentLoadTask.h"
 
 class Asset;
 class LoadingThread;
-class ContentLoadTask;
 
 /// <summary>
 /// Resources loading thread
@@ -18,6 +18,7 @@ class LoadingThread : public IRunnable
     volatile int64 _exitFlag;
     Thread* _thread;
     int32 _totalTasksDoneCount;
+    ContentLoadTask* _currentTask;
 
 public:
 
@@ -39,6 +40,14 @@ class LoadingThread : public IRunnable
     /// <returns>Thread ID</returns>
     uint64 GetID() const;
 
+    /// <summary>
+    /// Gets the task that is currently executed by this thread (or null if idle).
+    /// </summary>
+    FORCE_INLINE ContentLoadTask* GetCurrentTask() const
+    {
+        return _currentTask;
+    }
+
 public:
 
     /// <summary>
@@ -116,4 +125,30 @@ class ContentLoadingManager
     /// </summary>
     /// <returns>The tasks count.</returns>
     static int32 GetTasksCount();
+
+    /// <summary>
+    /// Gets amount of enqueued tasks to perform with the given priority.
+    /// </summary>
+    /// <param name="priority">The tasks priority.</param>
+    /// <returns>The tasks count.</returns>
+    static int32 GetTasksCount(ContentLoadTask::Priority priority);
+
+    /// <summary>
+    /// Gets the average time (in milliseconds) that tasks with the given priority waited in the queue before being executed.
+    /// </summary>
+    /// <param name="priority">The tasks priority.</param>
+    /// <returns>The average wait time (in milliseconds).</returns>
+    static float GetAverageWaitTime(ContentLoadTask::Priority priority);
+
+    /// <summary>
+    /// Gets the maximum time (in milliseconds) that task with the given priority waited in the queue before being executed.
+    /// </summary>
+    /// <param name="priority">The tasks priority.</param>
+    /// <returns>The maximum wait time (in milliseconds).</returns>
+    static float GetMaxWaitTime(ContentLoadTask::Priority priority);
+
+private:
+
+    // Removes the task from the queue so it can be executed in place (eg. by the thread that waits for it). Returns true if task was removed.
+    static bool TryDequeue(Task* task);
 };
@@ -0,0 +1,202 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#include "ContentLoadTask.h"
+#include "Engine/Core/Math/Math.h"
+#include "Engine/Core/Collections/RingBuffer.h"
+#include "Engine/Platform/Platform.h"
+
+#define CONTENT_LOAD_PRIORITIES_COUNT ((int32)ContentLoadTask::Priority::Prefetch + 1)
+
+/// <summary>
+/// Content loading tasks queue with a separate FIFO per priority class. Not thread-safe (guarded by the manager lock).
+/// </summary>
+class ContentLoadingQueue
+{
+private:
+
+    struct Lane
+    {
+        // Removed tasks are replaced with null and skipped when popping
+        RingBuffer<ContentLoadTask*> Items;
+        int32 Count = 0;
+        int64 WaitCount = 0;
+        double WaitTimeTotal = 0.0;
+        double WaitTimeMax = 0.0;
+    };
+
+    Lane _lanes[CONTENT_LOAD_PRIORITIES_COUNT];
+    int32 _deadlinesCount = 0;
+    double _nextDeadline = 0.0;
+
+public:
+
+    int32 Count() const
+    {
+        int32 result = 0;
+        for (const Lane& lane : _lanes)
+            result += lane.Count;
+        return result;
+    }
+
+    int32 Count(ContentLoadTask::Priority priority) const
+    {
+        return _lanes[(int32)priority].Count;
+    }
+
+    float GetAverageWaitTime(ContentLoadTask::Priority priority) const
+    {
+        const Lane& lane = _lanes[(int32)priority];
+        return lane.WaitCount != 0 ? (float)(lane.WaitTimeTotal / (double)lane.WaitCount * 1000.0) : 0.0f;
+    }
+
+    float GetMaxWaitTime(ContentLoadTask::Priority priority) const
+    {
+        return (float)(_lanes[(int32)priority].WaitTimeMax * 1000.0);
+    }
+
+    void Add(ContentLoadTask* task)
+    {
+        task->_isInQueue = true;
+        task->_queueTime = Platform::GetTimeSeconds();
+        if (task->_deadline > 0.0)
+            AddDeadline(task->_deadline);
+        AddToLane(task);
+    }
+
+    void SetPriority(ContentLoadTask* task, ContentLoadTask::Priority priority)
+    {
+        if (task->_isInQueue && RemoveFromLane(task))
+        {
+            task->_priority = priority;
+            AddToLane(task);
+        }
+        else
+        {
+            task->_priority = priority;
+        }
+    }
+
+    void SetDeadline(ContentLoadTask* task, double deadline)
+    {
+        if (task->_isInQueue)
+        {
+            if (task->_deadline <= 0.0)
+                AddDeadline(deadline);
+            else
+                _nextDeadline = Math::Min(_nextDeadline, deadline);
+        }
+        task->_deadline = deadline;
+    }
+
+    ContentLoadTask* Pop()
+    {
+        const double time = Platform::GetTimeSeconds();
+        if (_deadlinesCount != 0 && time >= _nextDeadline)
+            PromoteExpired(time);
+        for (Lane& lane : _lanes)
+        {
+            while (lane.Items.Count() != 0)
+            {
+                ContentLoadTask* task = lane.Items.PeekFront();
+                lane.Items.PopFront();
+                if (task)
+                {
+                    lane.Count--;
+                    OnRemoved(task, lane, time);
+                    return task;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    bool Remove(Task* task)
+    {
+        for (Lane& lane : _lanes)
+        {
+            for (int32 i = 0; i < lane.Items.Count(); i++)
+            {
+                if (lane.Items[i] == task)
+                {
+                    ContentLoadTask* contentTask = lane.Items[i];
+                    lane.Items[i] = nullptr;
+                    lane.Count--;
+                    OnRemoved(contentTask, lane, Platform::GetTimeSeconds());
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+
+    void AddToLane(ContentLoadTask* task)
+    {
+        Lane& lane = _lanes[(int32)task->_priority];
+        lane.Items.PushBack(task);
+        lane.Count++;
+    }
+
+    bool RemoveFromLane(ContentLoadTask* task)
+    {
+        Lane& lane = _lanes[(int32)task->_priority];
+        for (int32 i = 0; i < lane.Items.Count(); i++)
+        {
+            if (lane.Items[i] == task)
+            {
+                lane.Items[i] = nullptr;
+                lane.Count--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void AddDeadline(double deadline)
+    {
+        _nextDeadline = _deadlinesCount == 0 ? deadline : Math::Min(_nextDeadline, deadline);
+        _deadlinesCount++;
+    }
+
+    void OnRemoved(ContentLoadTask* task, Lane& lane, double time)
+    {
+        task->_isInQueue = false;
+        if (task->_deadline > 0.0)
+            _deadlinesCount--;
+        const double waitTime = time - task->_queueTime;
+        lane.WaitCount++;
+        lane.WaitTimeTotal += waitTime;
+        lane.WaitTimeMax = Math::Max(lane.WaitTimeMax, waitTime);
+    }
+
+    void PromoteExpired(double time)
+    {
+        // Move tasks that missed the deadline to the urgent queue (keep the next closest deadline for the later checks)
+        _nextDeadline = MAX_double;
+        for (int32 priority = (int32)ContentLoadTask::Priority::Normal; priority < CONTENT_LOAD_PRIORITIES_COUNT; priority++)
+        {
+            Lane& lane = _lanes[priority];
+            for (int32 i = 0; i < lane.Items.Count(); i++)
+            {
+                ContentLoadTask* task = lane.Items[i];
+                if (task && task->_deadline > 0.0)
+                {
+                    if (task->_deadline <= time)
+                    {
+                        lane.Items[i] = nullptr;
+                        lane.Count--;
+                        task->_priority = ContentLoadTask::Priority::Urgent;
+                        AddToLane(task);
+                    }
+                    else
+                    {
+                        _nextDeadline = Math::Min(_nextDeadline, task->_deadline);
+                    }
+                }
+            }
+        }
+    }
+};
@@ -3,7 +3,9 @@
 #if COMPILE_WITH_ASSETS_IMPORTER
 
 #include "AssetsImportingManager.h"
+#include "DerivedDataCache.h"
 #include "Engine/Core/Utilities.h"
+#include "Engine/Core/ISerializable.h"
 #include "Engine/Serialization/JsonWriters.h"
 #include "Engine/Threading/MainThreadTask.h"
 #include "Engine/Content/Storage/ContentStorageManager.h"
@@ -78,6 +80,8 @@ CreateAssetContext::CreateAssetContext(const StringView& inputPath, const String
     CustomArg = arg;
     Data.Header.ID = id;
     SkipMetadata = false;
+    _derivedDataKey = Guid::Empty;
+    _derivedDataRestored = false;
 
     // TODO: we should use ASNI only chars path (Assimp can use only that kind)
     OutputPath = Content::CreateTemporaryAssetPath();
@@ -103,6 +107,10 @@ CreateAssetResult CreateAssetContext::Run(const CreateAssetFunction& callback)
         return CreateAssetResult::InvalidTypeID;
     }
 
+    // Cache the imported data for the next time
+    if (_derivedDataKey.IsValid() && !_derivedDataRestored)
+        DerivedDataCache::Store(_derivedDataKey, Data);
+
     // Add import metadata to the file (if it's empty)
     if (!SkipMetadata && Data.Metadata.IsInvalid())
     {
@@ -157,6 +165,29 @@ bool CreateAssetContext::AllocateChunk(int32 index)
     return false;
 }
 
+bool CreateAssetContext::TryRestoreDerivedData(const StringView& importer, uint32 version, ISerializable& options)
+{
+    if (!DerivedDataCache::Enabled || InputPath.IsEmpty())
+        return false;
+
+    // Build the cache key from the source file contents and the import options
+    rapidjson_flax::StringBuffer buffer;
+    CompactJsonWriter writer(buffer);
+    writer.StartObject();
+    options.Serialize(writer, nullptr);
+    writer.EndObject();
+    if (DerivedDataCache::ComputeKey(InputPath, importer, version, StringAnsiView(buffer.GetString(), (int32)buffer.GetSize()), _derivedDataKey))
+    {
+        _derivedDataKey = Guid::Empty;
+        return false;
+    }
+
+    _derivedDataRestored = !DerivedDataCache::Load(_derivedDataKey, Data);
+    if (_derivedDataRestored)
+        LOG(Info, "Restored '{0}' from the derived data cache", InputPath);
+    return _derivedDataRestored;
+}
+
 void CreateAssetContext::AddMeta(JsonWriter& writer) const
 {
     writer.JKEY("ImportPath");
@@ -0,0 +1,455 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#if COMPILE_WITH_ASSETS_IMPORTER
+
+#include "DerivedDataCache.h"
+#include "Engine/Core/Log.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Engine/Globals.h"
+#include "Engine/Engine/EngineService.h"
+#include "Engine/Platform/File.h"
+#include "Engine/Platform/FileSystem.h"
+#include "Engine/Threading/Threading.h"
+#include "Engine/Serialization/MemoryReadStream.h"
+#include "Engine/Serialization/MemoryWriteStream.h"
+#include "Engine/Profiler/ProfilerCPU.h"
+#include "Engine/Utilities/Crc.h"
+#include "FlaxEngine.Gen.h"
+
+// Default cache size limit (in bytes)
+#define DDC_DEFAULT_MAX_SIZE (4ull * 1024 * 1024 * 1024)
+// Cache files format identifier and version (change version to invalidate all entries)
+#define DDC_FILE_MAGIC 0x43444446
+#define DDC_FILE_VERSION 1
+#define DDC_FILE_EXTENSION TEXT(".ddc")
+// Size of the buffer used to hash the source file contents
+#define DDC_HASH_BUFFER_SIZE (64 * 1024)
+
+namespace
+{
+    struct CacheEntry
+    {
+        uint64 Size;
+        int64 LastAccess;
+    };
+
+    struct CacheKeyBuilder
+    {
+        uint32 Crc = 0;
+        uint64 Fnv = 14695981039346656037ull;
+        uint32 Length = 0;
+
+        void Append(const void* data, int32 length)
+        {
+            Crc = Crc::MemCrc32(data, length, Crc);
+            const byte* ptr = (const byte*)data;
+            for (int32 i = 0; i < length; i++)
+            {
+                Fnv ^= ptr[i];
+                Fnv *= 1099511628211ull;
+            }
+            Length += (uint32)length;
+        }
+
+        Guid ToKey() const
+        {
+            return Guid(Crc, (uint32)Fnv, (uint32)(Fnv >> 32), Length);
+        }
+    };
+
+    CriticalSection Locker;
+    Dictionary<Guid, CacheEntry> Entries;
+    uint64 TotalSize = 0;
+    bool IsIndexLoaded = false;
+    bool IsIndexDirty = false;
+    int32 HitsCount = 0;
+    int32 MissesCount = 0;
+    int32 EvictionsCount = 0;
+
+    String GetIndexPath()
+    {
+        return DerivedDataCache::GetFolder() / TEXT("Index.bin");
+    }
+
+    String GetEntryPath(const Guid& key)
+    {
+        return DerivedDataCache::GetFolder() / key.ToString(Guid::FormatType::N) + DDC_FILE_EXTENSION;
+    }
+
+    void LoadIndex()
+    {
+        if (IsIndexLoaded)
+            return;
+        IsIndexLoaded = true;
+        Entries.Clear();
+        TotalSize = 0;
+
+        // Try to use the saved index
+        Array<byte> data;
+        if (FileSystem::FileExists(GetIndexPath()) && !File::ReadAllBytes(GetIndexPath(), data) && data.Count() >= 3 * sizeof(int32))
+        {
+            MemoryReadStream stream(data.Get(), data.Count());
+            int32 magic, version, count;
+            stream.ReadInt32(&magic);
+            stream.ReadInt32(&version);
+            stream.ReadInt32(&count);
+            const int32 entrySize = sizeof(Guid) + sizeof(CacheEntry);
+            if (magic == DDC_FILE_MAGIC && version == DDC_FILE_VERSION && count >= 0 && (int32)(stream.GetLength() - stream.GetPosition()) >= count * entrySize)
+            {
+                Entries.EnsureCapacity(count);
+                for (int32 i = 0; i < count; i++)
+                {
+                    Guid key;
+                    CacheEntry entry;
+                    stream.Read(&key);
+                    stream.Read(&entry);
+                    Entries[key] = entry;
+                    TotalSize += entry.Size;
+                }
+            }
+        }
+
+        // Add entries missing in the index (eg. stored by the other process or the index is missing or outdated)
+        Array<String> files;
+        if (FileSystem::DirectoryExists(DerivedDataCache::GetFolder()))
+            FileSystem::DirectoryGetFiles(files, DerivedDataCache::GetFolder(), TEXT("*.ddc"), DirectorySearchOption::TopDirectoryOnly);
+        for (const String& file : files)
+        {
+            Guid key;
+            if (Guid::Parse(StringUtils::GetFileNameWithoutExtension(file), key) || Entries.ContainsKey(key))
+                continue;
+            CacheEntry entry;
+            entry.Size = FileSystem::GetFileSize(file);
+            entry.LastAccess = FileSystem::GetFileLastEditTime(file).Ticks;
+            Entries[key] = entry;
+            TotalSize += entry.Size;
+            IsIndexDirty = true;
+        }
+    }
+
+    void SaveIndex()
+    {
+        if (!IsIndexDirty)
+            return;
+        IsIndexDirty = false;
+        const String folder = DerivedDataCache::GetFolder();
+        if (!FileSystem::DirectoryExists(folder) && FileSystem::CreateDirectory(folder))
+            return;
+        MemoryWriteStream stream(Entries.Count() * (sizeof(Guid) + sizeof(CacheEntry)) + 64);
+        stream.WriteInt32(DDC_FILE_MAGIC);
+        stream.WriteInt32(DDC_FILE_VERSION);
+        stream.WriteInt32(Entries.Count());
+        for (const auto& e : Entries)
+        {
+            stream.Write(&e.Key);
+            stream.Write(&e.Value);
+        }
+
+        // Write to the temporary file and move it so the index is never partially written
+        const String path = GetIndexPath();
+        const String tmpPath = path + TEXT(".tmp");
+        if (File::WriteAllBytes(tmpPath, stream.GetHandle(), (int32)stream.GetPosition()) || FileSystem::MoveFile(path, tmpPath, true))
+        {
+            LOG(Warning, "Failed to save derived data cache index.");
+            FileSystem::DeleteFile(tmpPath);
+        }
+    }
+
+    bool ReadEntry(MemoryReadStream& stream, AssetInitData& data)
+    {
+        // Validate every size since cache files can be corrupted
+#define CHECK_SIZE(size) if ((uint64)(stream.GetLength() - stream.GetPosition()) < (uint64)(size)) return true
+        CHECK_SIZE(3 * sizeof(int32));
+        int32 magic, version;
+        stream.ReadInt32(&magic);
+        stream.ReadInt32(&version);
+        if (magic != DDC_FILE_MAGIC || version != DDC_FILE_VERSION)
+            return true;
+        int32 typeNameLength;
+        stream.ReadInt32(&typeNameLength);
+        if (typeNameLength < 0)
+            return true;
+        CHECK_SIZE(typeNameLength * sizeof(Char) + 2 * sizeof(uint32));
+        data.Header.TypeName.Set((const Char*)stream.Read(typeNameLength * sizeof(Char)), typeNameLength);
+        stream.ReadUint32(&data.SerializedVersion);
+        uint32 customDataSize;
+        stream.ReadUint32(&customDataSize);
+        CHECK_SIZE((uint64)customDataSize + sizeof(int32));
+        data.CustomData.Copy((const byte*)stream.Read(customDataSize), customDataSize);
+        int32 dependenciesCount;
+        stream.ReadInt32(&dependenciesCount);
+        if (dependenciesCount < 0)
+            return true;
+        CHECK_SIZE((uint64)dependenciesCount * (sizeof(Guid) + sizeof(DateTime)) + sizeof(uint32));
+#if USE_EDITOR
+        data.Dependencies.Resize(dependenciesCount);
+        for (auto& e : data.Dependencies)
+        {
+            stream.Read(&e.First);
+            stream.Read(&e.Second);
+        }
+#else
+        stream.Read(dependenciesCount * (sizeof(Guid) + sizeof(DateTime)));
+#endif
+        uint32 chunksMask;
+        stream.ReadUint32(&chunksMask);
+        for (int32 i = 0; i < ASSET_FILE_DATA_CHUNKS; i++)
+        {
+            if ((chunksMask & (1u << i)) == 0)
+                continue;
+            CHECK_SIZE(2 * sizeof(uint32));
+            uint32 flags, size;
+            stream.ReadUint32(&flags);
+            stream.ReadUint32(&size);
+            CHECK_SIZE(size);
+            FlaxChunk* chunk = data.Header.Chunks[i];
+            if (!chunk)
+            {
+                chunk = New<FlaxChunk>();
+                data.Header.Chunks[i] = chunk;
+            }
+            chunk->Flags = (FlaxChunkFlags)flags;
+            chunk->Data.Copy((const byte*)stream.Read(size), size);
+        }
+#undef CHECK_SIZE
+        return false;
+    }
+
+    void RemoveEntry(const Guid& key)
+    {
+        CacheEntry entry;
+        if (Entries.TryGet(key, entry))
+        {
+            TotalSize -= entry.Size;
+            Entries.Remove(key);
+            IsIndexDirty = true;
+        }
+        FileSystem::DeleteFile(GetEntryPath(key));
+    }
+
+    void EvictEntries()
+    {
+        // Remove the least recently used entries until the cache fits the size limit
+        while (TotalSize > DerivedDataCache::MaxSize && Entries.Count() > 1)
+        {
+            Guid oldestKey = Guid::Empty;
+            int64 oldestAccess = MAX_int64;
+            for (const auto& e : Entries)
+            {
+                if (e.Value.LastAccess < oldestAccess)
+                {
+                    oldestAccess = e.Value.LastAccess;
+                    oldestKey = e.Key;
+                }
+            }
+            RemoveEntry(oldestKey);
+            EvictionsCount++;
+        }
+    }
+}
+
+class DerivedDataCacheService : public EngineService
+{
+public:
+
+    DerivedDataCacheService()
+        : EngineService(TEXT("Derived Data Cache"), -390)
+    {
+    }
+
+    void Dispose() override;
+};
+
+DerivedDataCacheService DerivedDataCacheServiceInstance;
+
+bool DerivedDataCache::Enabled = true;
+uint64 DerivedDataCache::MaxSize = DDC_DEFAULT_MAX_SIZE;
+
+String DerivedDataCache::GetFolder()
+{
+    return Globals::ProjectCacheFolder / TEXT("DerivedData");
+}
+
+bool DerivedDataCache::ComputeKey(const StringView& inputPath, const StringView& importer, uint32 version, const StringAnsiView& options, Guid& key)
+{
+    PROFILE_CPU();
+    auto file = File::Open(inputPath, FileMode::OpenExisting, FileAccess::Read, FileShare::Read);
+    if (file == nullptr)
+        return true;
+
+    // Hash the importer identity and options
+    CacheKeyBuilder builder;
+    const uint32 header[] = { DDC_FILE_VERSION, FLAXENGINE_VERSION_BUILD, version };
+    builder.Append(header, sizeof(header));
+    builder.Append(importer.Get(), importer.Length() * sizeof(Char));
+    builder.Append(options.Get(), options.Length());
+
+    // Hash the source file contents
+    Array<byte> buffer;
+    buffer.Resize(DDC_HASH_BUFFER_SIZE);
+    bool failed = false;
+    while (true)
+    {
+        uint32 bytesRead = 0;
+        if (file->Read(buffer.Get(), buffer.Count(), &bytesRead))
+        {
+            failed = true;
+            break;
+        }
+        if (bytesRead == 0)
+            break;
+        builder.Append(buffer.Get(), (int32)bytesRead);
+    }
+    Delete(file);
+
+    key = builder.ToKey();
+    return failed;
+}
+
+bool DerivedDataCache::Load(const Guid& key, AssetInitData& data)
+{
+    PROFILE_CPU();
+    ScopeLock lock(Locker);
+    LoadIndex();
+    CacheEntry* entry = Entries.TryGet(key);
+    Array<byte> bytes;
+    if (!entry || File::ReadAllBytes(GetEntryPath(key), bytes))
+    {
+        if (entry)
+            RemoveEntry(key);
+        MissesCount++;
+        return true;
+    }
+
+    // Deserialize the asset data
+    MemoryReadStream stream(bytes.Get(), bytes.Count());
+    if (ReadEntry(stream, data))
+    {
+        LOG(Warning, "Corrupted derived data cache entry {0}.", key);
+        for (auto& chunk : data.Header.Chunks)
+        {
+            Delete(chunk);
+            chunk = nullptr;
+        }
+        data.Header.TypeName.Clear();
+        data.CustomData.Release();
+        RemoveEntry(key);
+        MissesCount++;
+        return true;
+    }
+
+    entry->LastAccess = DateTime::NowUTC().Ticks;
+    IsIndexDirty = true;
+    HitsCount++;
+    return false;
+}
+
+void DerivedDataCache::Store(const Guid& key, const AssetInitData& data)
+{
+    PROFILE_CPU();
+
+    // Serialize the asset data
+    MemoryWriteStream stream(4096);
+    stream.WriteInt32(DDC_FILE_MAGIC);
+    stream.WriteInt32(DDC_FILE_VERSION);
+    stream.WriteInt32(data.Header.TypeName.Length());
+    stream.WriteBytes(data.Header.TypeName.Get(), data.Header.TypeName.Length() * sizeof(Char));
+    stream.WriteUint32(data.SerializedVersion);
+    stream.WriteUint32(data.CustomData.Length());
+    stream.WriteBytes(data.CustomData.Get(), data.CustomData.Length());
+#if USE_EDITOR
+    stream.WriteInt32(data.Dependencies.Count());
+    for (const auto& e : data.Dependencies)
+    {
+        stream.Write(&e.First);
+        stream.Write(&e.Second);
+    }
+#else
+    stream.WriteInt32(0);
+#endif
+    uint32 chunksMask = 0;
+    for (int32 i = 0; i < ASSET_FILE_DATA_CHUNKS; i++)
+    {
+        if (data.Header.Chunks[i])
+            chunksMask |= 1u << i;
+    }
+    stream.WriteUint32(chunksMask);
+    for (int32 i = 0; i < ASSET_FILE_DATA_CHUNKS; i++)
+    {
+        const FlaxChunk* chunk = data.Header.Chunks[i];
+        if (!chunk)
+            continue;
+        stream.WriteUint32((uint32)chunk->Flags);
+        stream.WriteUint32(chunk->Data.Length());
+        stream.WriteBytes(chunk->Data.Get(), chunk->Data.Length());
+    }
+
+    // Write to the temporary file and move it so other processes never read partially written entries
+    ScopeLock lock(Locker);
+    LoadIndex();
+    const String folder = GetFolder();
+    if (!FileSystem::DirectoryExists(folder) && FileSystem::CreateDirectory(folder))
+        return;
+    const String path = GetEntryPath(key);
+    const String tmpPath = path + TEXT(".tmp");
+    if (File::WriteAllBytes(tmpPath, stream.GetHandle(), (int32)stream.GetPosition()) || FileSystem::MoveFile(path, tmpPath, true))
+    {
+        LOG(Warning, "Failed to write derived data cache entry {0}.", path);
+        FileSystem::DeleteFile(tmpPath);
+        return;
+    }
+    CacheEntry entry;
+    entry.Size = stream.GetPosition();
+    entry.LastAccess = DateTime::NowUTC().Ticks;
+    CacheEntry prevEntry;
+    if (Entries.TryGet(key, prevEntry))
+        TotalSize -= prevEntry.Size;
+    Entries[key] = entry;
+    TotalSize += entry.Size;
+    IsIndexDirty = true;
+    EvictEntries();
+
+    // Save index after each store so it's up to date even if the process doesn't exit properly
+    SaveIndex();
+}
+
+DerivedDataCache::Stats DerivedDataCache::GetStats()
+{
+    ScopeLock lock(Locker);
+    LoadIndex();
+    Stats result;
+    result.Hits = HitsCount;
+    result.Misses = MissesCount;
+    result.Evictions = EvictionsCount;
+    result.Entries = Entries.Count();
+    result.Size = TotalSize;
+    return result;
+}
+
+void DerivedDataCache::Flush()
+{
+    ScopeLock lock(Locker);
+    SaveIndex();
+}
+
+void DerivedDataCache::Clear()
+{
+    ScopeLock lock(Locker);
+    LOG(Info, "Clearing derived data cache ({0} entries, {1} MB)", Entries.Count(), (int32)(TotalSize / (1024 * 1024)));
+    FileSystem::DeleteDirectory(GetFolder());
+    Entries.Clear();
+    TotalSize = 0;
+    IsIndexLoaded = true;
+    IsIndexDirty = false;
+}
+
+void DerivedDataCacheService::Dispose()
+{
+    if (HitsCount != 0 || MissesCount != 0)
+    {
+        LOG(Info, "Derived data cache: {0} hits, {1} misses, {2} evictions, {3} entries ({4} MB)", HitsCount, MissesCount, EvictionsCount, Entries.Count(), (int32)(TotalSize / (1024 * 1024)));
+    }
+    DerivedDataCache::Flush();
+}
+
+#endif
@@ -0,0 +1,111 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#include "Types.h"
+
+#if COMPILE_WITH_ASSETS_IMPORTER
+
+/// <summary>
+/// Local content-addressed cache for the imported assets data (derived data). Entries are identified by the hash of the source file contents, import options and importer version so reimporting the unchanged source (eg. on a different project copy) can skip the whole importing pipeline.
+/// </summary>
+/// <remarks>
+/// Cache stores only the asset chunks, custom data and dependencies (metadata is generated by the importer because it contains the source file path). Cache size is limited and the least recently used entries are removed first.
+/// </remarks>
+class DerivedDataCache
+{
+public:
+
+    /// <summary>
+    /// The cache usage statistics.
+    /// </summary>
+    struct Stats
+    {
+        /// <summary>
+        /// The amount of lookups that restored the data from the cache.
+        /// </summary>
+        int32 Hits;
+
+        /// <summary>
+        /// The amount of lookups that didn't find the valid entry in the cache.
+        /// </summary>
+        int32 Misses;
+
+        /// <summary>
+        /// The amount of entries removed from the cache to keep it within the size limit.
+        /// </summary>
+        int32 Evictions;
+
+        /// <summary>
+        /// The amount of entries in the cache.
+        /// </summary>
+        int32 Entries;
+
+        /// <summary>
+        /// The total size of the cache entries (in bytes).
+        /// </summary>
+        uint64 Size;
+    };
+
+public:
+
+    /// <summary>
+    /// True if use the derived data cache for assets importing, otherwise false.
+    /// </summary>
+    static bool Enabled;
+
+    /// <summary>
+    /// The maximum size of the cache (in bytes). Least recently used entries are removed when cache gets bigger.
+    /// </summary>
+    static uint64 MaxSize;
+
+public:
+
+    /// <summary>
+    /// Gets the folder that contains the cache entries.
+    /// </summary>
+    static String GetFolder();
+
+    /// <summary>
+    /// Computes the cache entry key for the given importing source.
+    /// </summary>
+    /// <param name="inputPath">The source file path (its contents are hashed).</param>
+    /// <param name="importer">The importer name (eg. asset type).</param>
+    /// <param name="version">The importer version. Increment it when importer output changes to invalidate old entries.</param>
+    /// <param name="options">The serialized import options.</param>
+    /// <param name="key">The result key.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    static bool ComputeKey(const StringView& inputPath, const StringView& importer, uint32 version, const StringAnsiView& options, Guid& key);
+
+    /// <summary>
+    /// Loads the cached asset data. Asset ID and metadata are not modified.
+    /// </summary>
+    /// <param name="key">The entry key.</param>
+    /// <param name="data">The output asset data.</param>
+    /// <returns>True if failed (eg. entry is missing), otherwise false.</returns>
+    static bool Load(const Guid& key, AssetInitData& data);
+
+    /// <summary>
+    /// Stores the asset data in the cache.
+    /// </summary>
+    /// <param name="key">The entry key.</param>
+    /// <param name="data">The asset data.</param>
+    static void Store(const Guid& key, const AssetInitData& data);
+
+    /// <summary>
+    /// Gets the cache usage statistics.
+    /// </summary>
+    static Stats GetStats();
+
+    /// <summary>
+    /// Saves the cache index to the file (index is saved after each store, this persists the entries access time).
+    /// </summary>
+    static void Flush();
+
+    /// <summary>
+    /// Removes all the cache entries.
+    /// </summary>
+    static void Clear();
+};
+
+#endif
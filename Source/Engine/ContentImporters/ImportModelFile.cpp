@@ -53,6 +53,27 @@ bool ImportModelFile::TryGetImportOptions(String path, Options& options)
     return false;
 }
 
+// Version of the model importer output (increment to invalidate cached import results)
+#define IMPORT_MODEL_DERIVED_DATA_VERSION 1
+
+void SetImportOptionsMeta(CreateAssetContext& context, ImportModelFile::Options& options)
+{
+#if IMPORT_MODEL_CACHE_OPTIONS
+    // Create json with import context
+    rapidjson_flax::StringBuffer importOptionsMetaBuffer;
+    importOptionsMetaBuffer.Reserve(256);
+    CompactJsonWriter importOptionsMetaObj(importOptionsMetaBuffer);
+    JsonWriter& importOptionsMeta = importOptionsMetaObj;
+    importOptionsMeta.StartObject();
+    {
+        context.AddMeta(importOptionsMeta);
+        options.Serialize(importOptionsMeta, nullptr);
+    }
+    importOptionsMeta.EndObject();
+    context.Data.Metadata.Copy((const byte*)importOptionsMetaBuffer.GetString(), (uint32)importOptionsMetaBuffer.GetSize());
+#endif
+}
+
 void TryRestoreMaterials(CreateAssetContext& context, ModelData& modelData)
 {
     // Skip if file is missing
@@ -126,6 +147,15 @@ CreateAssetResult ImportModelFile::Import(CreateAssetContext& context)
         });
     }
 
+    // Try to reuse the previous import results (only if importing doesn't create other assets and doesn't depend on the existing asset)
+    const bool restoresMaterials = options.RestoreMaterialsOnReimport && FileSystem::FileExists(context.TargetAssetPath);
+    if (!options.SplitObjects && !options.ImportMaterials && !options.ImportTextures && !restoresMaterials &&
+        context.TryRestoreDerivedData(TEXT("Model"), IMPORT_MODEL_DERIVED_DATA_VERSION, options))
+    {
+        SetImportOptionsMeta(context, options);
+        return CreateAssetResult::Ok;
+    }
+
     // Import model file
     ModelData modelData;
     String errorMsg;
@@ -162,20 +192,7 @@ CreateAssetResult ImportModelFile::Import(CreateAssetContext& context)
     if (result != CreateAssetResult::Ok)
         return result;
 
-#if IMPORT_MODEL_CACHE_OPTIONS
-    // Create json with import context
-    rapidjson_flax::StringBuffer importOptionsMetaBuffer;
-    importOptionsMetaBuffer.Reserve(256);
-    CompactJsonWriter importOptionsMetaObj(importOptionsMetaBuffer);
-    JsonWriter& importOptionsMeta = importOptionsMetaObj;
-    importOptionsMeta.StartObject();
-    {
-        context.AddMeta(importOptionsMeta);
-        options.Serialize(importOptionsMeta, nullptr);
-    }
-    importOptionsMeta.EndObject();
-    context.Data.Metadata.Copy((const byte*)importOptionsMetaBuffer.GetString(), (uint32)importOptionsMetaBuffer.GetSize());
-#endif
+    SetImportOptionsMeta(context, options);
 
     return CreateAssetResult::Ok;
 }
@@ -20,6 +20,26 @@
 #include "Engine/Platform/FileSystem.h"
 #include "Engine/Platform/File.h"
 
+// Version of the texture importer output (increment to invalidate cached import results)
+#define IMPORT_TEXTURE_DERIVED_DATA_VERSION 1
+
+void SetImportOptionsMeta(CreateAssetContext& context, ImportTexture::Options& options)
+{
+#if IMPORT_TEXTURE_CACHE_OPTIONS
+    // Create json with import context
+    rapidjson_flax::StringBuffer importOptionsMetaBuffer;
+    importOptionsMetaBuffer.Reserve(256);
+    CompactJsonWriter importOptionsMeta(importOptionsMetaBuffer);
+    importOptionsMeta.StartObject();
+    {
+        context.AddMeta(importOptionsMeta);
+        options.Serialize(importOptionsMeta, nullptr);
+    }
+    importOptionsMeta.EndObject();
+    context.Data.Metadata.Copy((const byte*)importOptionsMetaBuffer.GetString(), (uint32)importOptionsMetaBuffer.GetSize());
+#endif
+}
+
 bool IsSpriteAtlasOrTexture(const String& typeName)
 {
     return typeName == Texture::TypeName || typeName == SpriteAtlas::TypeName;
@@ -236,21 +256,7 @@ CreateAssetResult ImportTexture::Create(CreateAssetContext& context, const Textu
         }
     }
 
-#if IMPORT_TEXTURE_CACHE_OPTIONS
-
-    // Create json with import context
-    rapidjson_flax::StringBuffer importOptionsMetaBuffer;
-    importOptionsMetaBuffer.Reserve(256);
-    CompactJsonWriter importOptionsMeta(importOptionsMetaBuffer);
-    importOptionsMeta.StartObject();
-    {
-        context.AddMeta(importOptionsMeta);
-        options.Serialize(importOptionsMeta, nullptr);
-    }
-    importOptionsMeta.EndObject();
-    context.Data.Metadata.Copy((const byte*)importOptionsMetaBuffer.GetString(), (uint32)importOptionsMetaBuffer.GetSize());
-
-#endif
+    SetImportOptionsMeta(context, options);
 
     return CreateAssetResult::Ok;
 }
@@ -370,21 +376,7 @@ CreateAssetResult ImportTexture::Create(CreateAssetContext& context, const Textu
         }
     }
 
-#if IMPORT_TEXTURE_CACHE_OPTIONS
-
-    // Create json with import context
-    rapidjson_flax::StringBuffer importOptionsMetaBuffer;
-    importOptionsMetaBuffer.Reserve(256);
-    CompactJsonWriter importOptionsMeta(importOptionsMetaBuffer);
-    importOptionsMeta.StartObject();
-    {
-        context.AddMeta(importOptionsMeta);
-        options.Serialize(importOptionsMeta, nullptr);
-    }
-    importOptionsMeta.EndObject();
-    context.Data.Metadata.Copy((const byte*)importOptionsMetaBuffer.GetString(), (uint32)importOptionsMetaBuffer.GetSize());
-
-#endif
+    SetImportOptionsMeta(context, options);
 
     return CreateAssetResult::Ok;
 }
@@ -394,6 +386,13 @@ CreateAssetResult ImportTexture::Import(CreateAssetContext& context)
     Options options;
     InitOptions(context, options);
 
+    // Try to reuse the previous import results
+    if (context.TryRestoreDerivedData(TEXT("Texture"), IMPORT_TEXTURE_DERIVED_DATA_VERSION, options))
+    {
+        SetImportOptionsMeta(context, options);
+        return CreateAssetResult::Ok;
+    }
+
     // Import
     TextureData textureData;
     String errorMsg;
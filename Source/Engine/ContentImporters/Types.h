@@ -13,6 +13,7 @@
 #include "Engine/Content/Storage/FlaxFile.h"
 
 class JsonWriter;
+class ISerializable;
 class CreateAssetContext;
 
 /// <summary>
@@ -33,6 +34,8 @@ class CreateAssetContext : public NonCopyable
 private:
 
     CreateAssetResult _applyChangesResult;
+    Guid _derivedDataKey;
+    bool _derivedDataRestored;
 
 public:
 
@@ -105,6 +108,18 @@ class CreateAssetContext : public NonCopyable
     /// <returns>True if cannot allocate it.</returns>
     bool AllocateChunk(int32 index);
 
+    /// <summary>
+    /// Tries to restore the imported asset data from the derived data cache (keyed by the input file contents, importer and import options). On cache miss, the importer should continue and the imported data will be cached after the successful import.
+    /// </summary>
+    /// <remarks>
+    /// Use only if the importing result depends only on the input file and the import options (eg. importer doesn't create other assets). Metadata is not restored.
+    /// </remarks>
+    /// <param name="importer">The importer name.</param>
+    /// <param name="version">The importer version. Increment it when importer output changes to invalidate old cache entries.</param>
+    /// <param name="options">The import options.</param>
+    /// <returns>True if asset data has been restored from the cache, otherwise false.</returns>
+    bool TryRestoreDerivedData(const StringView& importer, uint32 version, ISerializable& options);
+
     /// <summary>
     /// Adds the meta to the writer.
     /// </summary>
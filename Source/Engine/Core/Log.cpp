@@ -1,23 +1,30 @@
 // Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
 
 #include "Log.h"
+#include "LogAsyncBuffer.h"
 #include "Engine/Engine/CommandLine.h"
 #include "Engine/Core/Types/DateTime.h"
 #include "Engine/Core/Collections/Sorting.h"
+#include "Engine/Core/Math/Math.h"
 #include "Engine/Engine/Time.h"
 #include "Engine/Engine/Globals.h"
 #include "Engine/Platform/FileSystem.h"
 #include "Engine/Platform/CriticalSection.h"
+#include "Engine/Platform/Thread.h"
+#include "Engine/Threading/ThreadSpawner.h"
 #include "Engine/Serialization/FileWriteStream.h"
 #include "Engine/Serialization/MemoryWriteStream.h"
 #include "Engine/Debug/Exceptions/Exceptions.h"
-#if USE_EDITOR
 #include "Engine/Core/Collections/Array.h"
-#endif
 #include <iostream>
 
 #define LOG_ENABLE_FILE (!PLATFORM_SWITCH)
 
+// Size of the buffer for the async log messages (in bytes)
+#define LOG_ASYNC_BUFFER_SIZE (1024 * 1024)
+// Interval between the async log writes (in milliseconds)
+#define LOG_ASYNC_WRITE_INTERVAL 10
+
 namespace
 {
     bool LogAfterInit = false, IsDuringLog = false;
@@ -25,6 +32,49 @@ namespace
     FileWriteStream* LogFile = nullptr;
     CriticalSection LogLocker;
     DateTime LogStartTime;
+
+    volatile int64 LogAsync = 0;
+    volatile int64 LogAsyncWriters = 0;
+    volatile int64 LogAsyncExit = 0;
+    volatile int64 LogAsyncDropped = 0;
+    int64 LogAsyncDroppedReported = 0;
+    Thread* LogAsyncThread = nullptr;
+    LogAsyncBuffer* LogAsyncRing = nullptr;
+    THREADLOCAL bool IsDuringLogAsync = false;
+
+    bool WriteAsync()
+    {
+        // Write pending messages (up to the first one that is still being written)
+        const bool written = LogAsyncRing->Pop([](const Char* text, int32 length)
+        {
+            if (LogAfterInit)
+                LogFile->Write(text, length);
+        });
+
+        // Report dropped messages
+        const int64 dropped = Platform::AtomicRead(&LogAsyncDropped);
+        if (dropped != LogAsyncDroppedReported && LogAfterInit)
+        {
+            const String msg = String::Format(TEXT("[ Log ]: Dropped {0} messages (async log buffer is full)" PLATFORM_LINE_TERMINATOR), dropped - LogAsyncDroppedReported);
+            LogFile->Write(*msg, msg.Length());
+            LogAsyncDroppedReported = dropped;
+        }
+
+        return written;
+    }
+
+    int32 LogAsyncWriterMain()
+    {
+        while (Platform::AtomicRead(&LogAsyncExit) == 0)
+        {
+            Platform::Sleep(LOG_ASYNC_WRITE_INTERVAL);
+            LogLocker.Lock();
+            if (WriteAsync() && LogFile)
+                LogFile->Flush();
+            LogLocker.Unlock();
+        }
+        return 0;
+    }
 }
 
 String Log::Logger::LogFilePath;
@@ -100,6 +150,24 @@ bool Log::Logger::Init()
 #endif
     WriteFloor();
 
+    // Start async writer
+    if (CommandLine::Options.LogAsync.IsTrue())
+    {
+        Platform::AtomicStore(&LogAsyncExit, 0);
+        LogAsyncRing = New<LogAsyncBuffer>(LOG_ASYNC_BUFFER_SIZE);
+        Function<int32()> func(LogAsyncWriterMain);
+        LogAsyncThread = ThreadSpawner::Start(func, TEXT("Log Writer"), ThreadPriority::BelowNormal);
+        if (LogAsyncThread)
+        {
+            Platform::AtomicStore(&LogAsync, 1);
+        }
+        else
+        {
+            Delete(LogAsyncRing);
+            LogAsyncRing = nullptr;
+        }
+    }
+
     return false;
 }
 
@@ -108,6 +176,39 @@ void Log::Logger::Write(const StringView& msg)
     const auto ptr = msg.Get();
     const auto length = msg.Length();
 
+    // Pass message to the writer thread without locking (only the standard output is synchronized)
+    // Note: writers count is increased before checking the mode so disposing can wait for the messages being pushed
+    Platform::InterlockedIncrement(&LogAsyncWriters);
+    if (Platform::AtomicRead(&LogAsync))
+    {
+        if (IsDuringLogAsync)
+        {
+            Platform::InterlockedDecrement(&LogAsyncWriters);
+            return;
+        }
+        IsDuringLogAsync = true;
+        if (CommandLine::Options.Std)
+        {
+            LogLocker.Lock();
+#if PLATFORM_TEXT_IS_CHAR16
+            StringAnsi ansi(msg);
+            ansi += PLATFORM_LINE_TERMINATOR;
+            printf("%s", ansi.Get());
+#else
+            std::wcout.write(ptr, length);
+            std::wcout.write(TEXT(PLATFORM_LINE_TERMINATOR), ARRAY_COUNT(PLATFORM_LINE_TERMINATOR) - 1);
+#endif
+            LogLocker.Unlock();
+        }
+        Platform::Log(msg);
+        if (LogAsyncRing->Push(msg))
+            Platform::InterlockedIncrement(&LogAsyncDropped);
+        IsDuringLogAsync = false;
+        Platform::InterlockedDecrement(&LogAsyncWriters);
+        return;
+    }
+    Platform::InterlockedDecrement(&LogAsyncWriters);
+
     LogLocker.Lock();
     if (IsDuringLog)
     {
@@ -153,6 +254,25 @@ void Log::Logger::Write(const Exception& exception)
 
 void Log::Logger::Dispose()
 {
+    // Stop async writer and write the remaining messages
+    if (LogAsyncThread)
+    {
+        Platform::AtomicStore(&LogAsyncExit, 1);
+        LogAsyncThread->Join();
+        Delete(LogAsyncThread);
+        LogAsyncThread = nullptr;
+
+        // Switch to the synchronous mode and wait for the messages that are still being pushed
+        Platform::AtomicStore(&LogAsync, 0);
+        while (Platform::AtomicRead(&LogAsyncWriters) != 0)
+            Platform::Sleep(1);
+        LogLocker.Lock();
+        WriteAsync();
+        Delete(LogAsyncRing);
+        LogAsyncRing = nullptr;
+        LogLocker.Unlock();
+    }
+
     LogLocker.Lock();
 
     // Write ending info
@@ -181,9 +301,21 @@ bool Log::Logger::IsLogEnabled()
 #endif
 }
 
+bool Log::Logger::IsAsync()
+{
+    return Platform::AtomicRead(&LogAsync) != 0;
+}
+
+int64 Log::Logger::GetDroppedMessagesCount()
+{
+    return Platform::AtomicRead(&LogAsyncDropped);
+}
+
 void Log::Logger::Flush()
 {
     LogLocker.Lock();
+    if (LogAsyncRing)
+        WriteAsync();
     if (LogFile)
         LogFile->Flush();
     LogLocker.Unlock();
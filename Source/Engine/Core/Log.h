@@ -111,7 +111,19 @@ namespace Log
         static bool IsLogEnabled();
 
         /// <summary>
-        /// Flushes log file with a memory buffer.
+        /// Determines whether log file is written asynchronously on a background thread (see -logasync command line switch).
+        /// </summary>
+        /// <returns><c>true</c> if log uses async writer; otherwise, <c>false</c>.</returns>
+        static bool IsAsync();
+
+        /// <summary>
+        /// Gets the amount of log messages dropped by the async writer because the buffer was full.
+        /// </summary>
+        /// <returns>The dropped messages count.</returns>
+        static int64 GetDroppedMessagesCount();
+
+        /// <summary>
+        /// Flushes log file with a memory buffer. Writes all pending messages of the async writer.
         /// </summary>
         static void Flush();
 
@@ -0,0 +1,130 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#include "Engine/Core/Types/StringView.h"
+#include "Engine/Core/Math/Math.h"
+#include "Engine/Platform/Platform.h"
+
+/// <summary>
+/// Lock-free multi-producer single-consumer ring buffer with the log messages from all threads (used by the async log writer).
+/// Records space is reserved in order so the consumer reads them in order of logging (it stops at the first record that is still being written).
+/// </summary>
+class LogAsyncBuffer
+{
+private:
+
+    // Header of the message in the buffer (followed by the text, records are aligned to the header size)
+    struct alignas(16) Record
+    {
+        volatile int64 Ready; // Non-zero when record has been written
+        int32 Length; // Negative to skip to the buffer start
+        int32 Padding;
+    };
+
+    volatile int64 _head = 0;
+    volatile int64 _tail = 0;
+    int64 _size;
+    byte* _data;
+
+public:
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="LogAsyncBuffer"/> class.
+    /// </summary>
+    /// <param name="size">The buffer size (in bytes). Must be multiple of 16.</param>
+    explicit LogAsyncBuffer(int32 size)
+        : _size(size)
+    {
+        _data = (byte*)Platform::Allocate(size, alignof(Record));
+        Platform::MemoryClear(_data, size);
+    }
+
+    ~LogAsyncBuffer()
+    {
+        Platform::Free(_data);
+    }
+
+public:
+
+    /// <summary>
+    /// Pushes the message (followed by the line terminator) to the buffer. Can be called from any thread.
+    /// </summary>
+    /// <param name="msg">The message.</param>
+    /// <returns>True if message has been dropped (buffer is full or message is too large), otherwise false.</returns>
+    bool Push(const StringView& msg)
+    {
+        const int32 terminatorLength = ARRAY_COUNT(PLATFORM_LINE_TERMINATOR) - 1;
+        const int32 length = msg.Length() + terminatorLength;
+        const int64 size = Math::AlignUp<int64>(sizeof(Record) + length * sizeof(Char), sizeof(Record));
+        if (size > _size / 2)
+            return true;
+
+        // Reserve space for the record (split records are not supported so skip the buffer end if message doesn't fit)
+        int64 head, offset, padding;
+        do
+        {
+            head = Platform::AtomicRead(&_head);
+            const int64 tail = Platform::AtomicRead(&_tail);
+            offset = head % _size;
+            padding = offset + size > _size ? _size - offset : 0;
+            if (head + padding + size - tail > _size)
+                return true;
+        } while (Platform::InterlockedCompareExchange(&_head, head + padding + size, head) != head);
+        if (padding != 0)
+        {
+            auto skip = (Record*)(_data + offset);
+            skip->Length = -1;
+            Platform::AtomicStore(&skip->Ready, 1);
+            head += padding;
+        }
+
+        // Write message
+        auto record = (Record*)(_data + head % _size);
+        record->Length = length;
+        Char* text = (Char*)(record + 1);
+        Platform::MemoryCopy(text, msg.Get(), msg.Length() * sizeof(Char));
+        Platform::MemoryCopy(text + msg.Length(), TEXT(PLATFORM_LINE_TERMINATOR), terminatorLength * sizeof(Char));
+
+        // Publish it to the consumer
+        Platform::AtomicStore(&record->Ready, 1);
+        return false;
+    }
+
+    /// <summary>
+    /// Reads the pending messages (up to the first one that is still being written) and releases their space. Can be called only by a single thread at once.
+    /// </summary>
+    /// <param name="callback">The function called for each message with its text and length (including the line terminator).</param>
+    /// <returns>True if any message has been read, otherwise false.</returns>
+    template<typename Callback>
+    bool Pop(Callback callback)
+    {
+        const int64 head = Platform::AtomicRead(&_head);
+        int64 pos = _tail;
+        bool result = false;
+        while (pos < head)
+        {
+            const int64 offset = pos % _size;
+            auto record = (Record*)(_data + offset);
+            if (Platform::AtomicRead(&record->Ready) == 0)
+                break;
+            int64 size;
+            if (record->Length < 0)
+            {
+                size = _size - offset;
+            }
+            else
+            {
+                size = Math::AlignUp<int64>(sizeof(Record) + record->Length * sizeof(Char), sizeof(Record));
+                callback((const Char*)(record + 1), record->Length);
+                result = true;
+            }
+
+            // Clear the space before releasing it (records written later can start at any offset within it)
+            Platform::MemoryClear(record, (uint64)size);
+            pos += size;
+        }
+        Platform::AtomicStore(&_tail, pos);
+        return result;
+    }
+};
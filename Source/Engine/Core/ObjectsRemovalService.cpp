@@ -1,6 +1,7 @@
 // Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
 
 #include "ObjectsRemovalService.h"
+#include "Collections/Array.h"
 #include "Collections/Dictionary.h"
 #include "Engine/Engine/EngineService.h"
 #include "Engine/Threading/Threading.h"
@@ -9,15 +10,110 @@
 #include "Engine/Scripting/ScriptingObject.h"
 #include "Log.h"
 
+// Time resolution of the removal timers (in seconds)
+#define OBJECTS_REMOVAL_TICK (1.0 / 64.0)
+// Amount of slots in the timer wheel levels (each level slot covers the whole range of the previous level)
+#define OBJECTS_REMOVAL_WHEEL0_SIZE 256
+#define OBJECTS_REMOVAL_WHEEL1_SIZE 64
+
 namespace ObjectsRemovalServiceImpl
 {
-    bool IsReady = false;
+    struct PoolEntry
+    {
+        uint32 Ticket;
+    };
+
+    struct TimerItem
+    {
+        Object* Obj;
+        uint32 Ticket;
+        int64 DeadlineTick;
+    };
+
+    // Hierarchical timing wheel. Objects are bucketed by the absolute deadline so advancing the time touches only the expired slots (far timers are cascaded to the lower level when its range wraps).
+    struct TimerWheel
+    {
+        double Time = 0.0;
+        int64 Tick = 0;
+        Array<TimerItem> Level0[OBJECTS_REMOVAL_WHEEL0_SIZE];
+        Array<TimerItem> Level1[OBJECTS_REMOVAL_WHEEL1_SIZE];
+        Array<TimerItem> Overflow;
+
+        void Add(const TimerItem& item)
+        {
+            const int64 delta = item.DeadlineTick - Tick;
+            if (delta < OBJECTS_REMOVAL_WHEEL0_SIZE)
+                Level0[item.DeadlineTick % OBJECTS_REMOVAL_WHEEL0_SIZE].Add(item);
+            else if (delta < OBJECTS_REMOVAL_WHEEL0_SIZE * OBJECTS_REMOVAL_WHEEL1_SIZE)
+                Level1[(item.DeadlineTick / OBJECTS_REMOVAL_WHEEL0_SIZE) % OBJECTS_REMOVAL_WHEEL1_SIZE].Add(item);
+            else
+                Overflow.Add(item);
+        }
+
+        void Cascade(Array<TimerItem>& slot)
+        {
+            Array<TimerItem> items;
+            items.Swap(slot);
+            for (const TimerItem& item : items)
+                Add(item);
+        }
+
+        void Advance(float dt, Array<TimerItem>& expired)
+        {
+            Time += dt;
+            const int64 targetTick = (int64)(Time / OBJECTS_REMOVAL_TICK);
+            while (Tick < targetTick)
+            {
+                Tick++;
+                if (Tick % OBJECTS_REMOVAL_WHEEL0_SIZE == 0)
+                {
+                    const int64 level1Tick = Tick / OBJECTS_REMOVAL_WHEEL0_SIZE;
+                    if (level1Tick % OBJECTS_REMOVAL_WHEEL1_SIZE == 0)
+                        Cascade(Overflow);
+                    Cascade(Level1[level1Tick % OBJECTS_REMOVAL_WHEEL1_SIZE]);
+                }
+                auto& slot = Level0[Tick % OBJECTS_REMOVAL_WHEEL0_SIZE];
+                if (slot.HasItems())
+                {
+                    expired.Add(slot);
+                    slot.Clear();
+                }
+            }
+        }
+
+        int64 GetDeadlineTick(float timeToLive) const
+        {
+            return Math::Max((int64)Math::Ceil((Time + timeToLive) / OBJECTS_REMOVAL_TICK), Tick + 1);
+        }
+    };
+
+    // Pool can be used from the static init until the service dispose
+    bool IsReady = true;
     CriticalSection PoolLocker;
-    CriticalSection NewItemsLocker;
     DateTime LastUpdate;
     float LastUpdateGameTime;
-    Dictionary<Object*, float> Pool(8192);
-    Dictionary<Object*, float> NewItemsPool(2048);
+    uint32 TicketCounter = 0;
+    Dictionary<Object*, PoolEntry> Pool(8192);
+    Array<TimerItem> Immediate;
+    TimerWheel RealTimeWheel;
+    TimerWheel GameTimeWheel;
+
+    void DeleteExpired(Array<TimerItem>& expired)
+    {
+        // Validate each object right before the delete (it could be deleted or rescheduled after expiring, eg. by the previous object delete)
+        for (const TimerItem& item : expired)
+        {
+            PoolLocker.Lock();
+            const PoolEntry* entry = Pool.TryGet(item.Obj);
+            const bool valid = entry && entry->Ticket == item.Ticket;
+            if (valid)
+                Pool.Remove(item.Obj);
+            PoolLocker.Unlock();
+            if (valid)
+                item.Obj->OnDeleteObject();
+        }
+        expired.Clear();
+    }
 }
 
 using namespace ObjectsRemovalServiceImpl;
@@ -43,26 +139,15 @@ bool ObjectsRemovalService::IsInPool(Object* obj)
     if (!IsReady)
         return false;
 
-    {
-        ScopeLock lock(NewItemsLocker);
-        if (NewItemsPool.ContainsKey(obj))
-            return true;
-    }
-
-    {
-        ScopeLock lock(PoolLocker);
-        if (Pool.ContainsKey(obj))
-            return true;
-    }
-
-    return false;
+    ScopeLock lock(PoolLocker);
+    return Pool.ContainsKey(obj);
 }
 
 bool ObjectsRemovalService::HasNewItemsForFlush()
 {
-    NewItemsLocker.Lock();
-    const bool result = NewItemsPool.HasItems();
-    NewItemsLocker.Unlock();
+    PoolLocker.Lock();
+    const bool result = Immediate.HasItems();
+    PoolLocker.Unlock();
 
     return result;
 }
@@ -72,10 +157,7 @@ void ObjectsRemovalService::Dereference(Object* obj)
     if (!IsReady)
         return;
 
-    NewItemsLocker.Lock();
-    NewItemsPool.Remove(obj);
-    NewItemsLocker.Unlock();
-
+    // Timers are removed lazily (ticket won't match)
     PoolLocker.Lock();
     Pool.Remove(obj);
     PoolLocker.Unlock();
@@ -83,93 +165,55 @@ void ObjectsRemovalService::Dereference(Object* obj)
 
 void ObjectsRemovalService::Add(Object* obj, float timeToLive, bool useGameTime)
 {
-    ScopeLock lock(NewItemsLocker);
+    ScopeLock lock(PoolLocker);
 
     obj->Flags |= ObjectFlags::WasMarkedToDelete;
     if (useGameTime)
         obj->Flags |= ObjectFlags::UseGameTimeForDelete;
     else
         obj->Flags &= ~ObjectFlags::UseGameTimeForDelete;
-    NewItemsPool[obj] = timeToLive;
-}
 
-void ObjectsRemovalService::Flush(float dt, float gameDelta)
-{
-    // Add new items
+    // Register object with a new ticket (invalidates the previous timer if object was already in pool)
+    TimerItem item;
+    item.Obj = obj;
+    item.Ticket = ++TicketCounter;
+    Pool[obj].Ticket = item.Ticket;
+    if (timeToLive <= ZeroTolerance)
     {
-        ScopeLock lock(NewItemsLocker);
-
-        for (auto i = NewItemsPool.Begin(); i.IsNotEnd(); ++i)
-        {
-            Pool[i->Key] = i->Value;
-        }
-        NewItemsPool.Clear();
+        item.DeadlineTick = 0;
+        Immediate.Add(item);
     }
+    else
+    {
+        TimerWheel& wheel = useGameTime ? GameTimeWheel : RealTimeWheel;
+        item.DeadlineTick = wheel.GetDeadlineTick(timeToLive);
+        wheel.Add(item);
+    }
+}
 
-    // Update timeouts and delete objects that timed out
+void ObjectsRemovalService::Flush(float dt, float gameDelta)
+{
+    // Collect objects that timed out
+    Array<TimerItem> expired;
     {
         ScopeLock lock(PoolLocker);
-
-        for (auto i = Pool.Begin(); i.IsNotEnd(); ++i)
-        {
-            auto obj = i->Key;
-            const float ttl = i->Value - (obj->Flags & ObjectFlags::UseGameTimeForDelete ? gameDelta : dt);
-            if (ttl <= ZeroTolerance)
-            {
-                Pool.Remove(i);
-
-#if BUILD_DEBUG || BUILD_DEVELOPMENT
-                if (NewItemsPool.ContainsKey(obj))
-                {
-                    const auto asScriptingObj = dynamic_cast<ScriptingObject*>(obj);
-                    if (asScriptingObj)
-                    {
-                        LOG(Warning, "Object {0} was marked to delete after delete timeout", asScriptingObj->GetID());
-                    }
-                }
-#endif
-                NewItemsPool.Remove(obj);
-                //ASSERT(!NewItemsPool.ContainsKey(obj));
-
-                obj->OnDeleteObject();
-            }
-            else
-            {
-                i->Value = ttl;
-            }
-        }
+        expired.Swap(Immediate);
+        RealTimeWheel.Advance(dt, expired);
+        GameTimeWheel.Advance(gameDelta, expired);
     }
 
+    // Delete them in a batch
+    DeleteExpired(expired);
+
     // Perform removing in loop
     // Note: objects during OnDeleteObject call can register new objects to remove with timeout=0, for example Actors do that to remove children and scripts
     while (HasNewItemsForFlush())
     {
-        // Add new items
-        {
-            ScopeLock lock(NewItemsLocker);
-
-            for (auto i = NewItemsPool.Begin(); i.IsNotEnd(); ++i)
-            {
-                Pool[i->Key] = i->Value;
-            }
-            NewItemsPool.Clear();
-        }
-
-        // Delete objects that timed out
         {
             ScopeLock lock(PoolLocker);
-
-            for (auto i = Pool.Begin(); i.IsNotEnd(); ++i)
-            {
-                if (i->Value <= ZeroTolerance)
-                {
-                    auto obj = i->Key;
-                    Pool.Remove(i);
-                    ASSERT(!NewItemsPool.ContainsKey(obj));
-                    obj->OnDeleteObject();
-                }
-            }
+            expired.Swap(Immediate);
         }
+        DeleteExpired(expired);
     }
 }
 
@@ -201,13 +245,14 @@ void ObjectsRemovalServiceService::Dispose()
 
     // Delete all remaining objects
     {
-        ScopeLock lock(PoolLocker);
+        Array<TimerItem> remaining;
+        PoolLocker.Lock();
         for (auto i = Pool.Begin(); i.IsNotEnd(); ++i)
-        {
-            auto obj = i->Key;
-            Pool.Remove(i);
-            obj->OnDeleteObject();
-        }
+            remaining.Add({ i->Key, i->Value.Ticket, 0 });
+        PoolLocker.Unlock();
+        DeleteExpired(remaining);
+        ObjectsRemovalService::Flush();
+        ScopeLock lock(PoolLocker);
         Pool.Clear();
     }
 
@@ -33,6 +33,11 @@ namespace SIMD
         return _mm_load_ps((const float*)(src));
     }
 
+    FORCE_INLINE SimdVector4 LoadUnaligned(const void* src)
+    {
+        return _mm_loadu_ps((const float*)(src));
+    }
+
     FORCE_INLINE SimdVector4 Splat(float value)
     {
         return _mm_set_ps1(value);
@@ -118,6 +123,12 @@ namespace SIMD
 		return *(const SimdVector4*)src;
 	}
 
+	FORCE_INLINE SimdVector4 LoadUnaligned(const void* src)
+	{
+		const float* ptr = (const float*)src;
+		return { ptr[0], ptr[1], ptr[2], ptr[3] };
+	}
+
 	FORCE_INLINE SimdVector4 Splat(float value)
 	{
 		return { value, value, value, value };
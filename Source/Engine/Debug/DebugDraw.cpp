@@ -22,6 +22,9 @@
 #include "Engine/Graphics/Shaders/GPUShader.h"
 #include "Engine/Animations/AnimationUtils.h"
 #include "Engine/Profiler/Profiler.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Threading/Threading.h"
+#include "Engine/Threading/JobSystem.h"
 #include "Engine/Debug/DebugLog.h"
 #include "Engine/Render2D/Render2D.h"
 #include "Engine/Render2D/FontAsset.h"
@@ -31,6 +34,9 @@
 
 // Debug draw service configuration
 #define DEBUG_DRAW_INITIAL_VB_CAPACITY (4 * 1024)
+#define DEBUG_DRAW_WRITE_BATCH_SIZE (8 * 1024)
+// Amount of updates after which unused thread context is released (eg. thread has exited)
+#define DEBUG_DRAW_THREAD_CONTEXT_TIMEOUT 60
 //
 #define DEBUG_DRAW_SPHERE_LOD0_RESOLUTION 64
 #define DEBUG_DRAW_SPHERE_LOD0_SCREEN_SIZE 0.2f
@@ -255,6 +261,21 @@ struct DebugDrawData
         OneFrameText3D.Clear();
     }
 
+    inline void Append(DebugDrawData& other)
+    {
+        DefaultLines.Add(other.DefaultLines);
+        OneFrameLines.Add(other.OneFrameLines);
+        DefaultTriangles.Add(other.DefaultTriangles);
+        OneFrameTriangles.Add(other.OneFrameTriangles);
+        DefaultWireTriangles.Add(other.DefaultWireTriangles);
+        OneFrameWireTriangles.Add(other.OneFrameWireTriangles);
+        DefaultText2D.Add(other.DefaultText2D);
+        OneFrameText2D.Add(other.OneFrameText2D);
+        DefaultText3D.Add(other.DefaultText3D);
+        OneFrameText3D.Add(other.OneFrameText3D);
+        other.Clear();
+    }
+
     inline void Clear()
     {
         DefaultLines.Clear();
@@ -292,6 +313,14 @@ struct DebugDrawContext
     Matrix LastViewProj = Matrix::Identity;
 };
 
+// Debug shapes drawn from the thread other than main (eg. by the job) that are merged into the global context before the rendering.
+struct DebugDrawThreadContext
+{
+    CriticalSection Locker;
+    DebugDrawContext Context;
+    int32 IdleUpdates = 0;
+};
+
 namespace
 {
     DebugDrawContext GlobalContext;
@@ -308,8 +337,83 @@ namespace
     Vector3 CircleCache[DEBUG_DRAW_CIRCLE_VERTICES];
     Array<Vector3> SphereTriangleCache;
     DebugSphereCache SphereCache[3];
+    CriticalSection ThreadContextsLocker;
+    Dictionary<uint64, DebugDrawThreadContext*> ThreadContexts; // Key is the thread ID
+};
+
+// Gets the locked context of the current thread (created on the first use, reused by the thread with the same ID if the previous one has exited)
+DebugDrawThreadContext* LockThreadContext()
+{
+    ScopeLock lock(ThreadContextsLocker);
+    const uint64 threadId = Platform::GetCurrentThreadID();
+    DebugDrawThreadContext* context;
+    if (!ThreadContexts.TryGet(threadId, context))
+    {
+        context = New<DebugDrawThreadContext>();
+        context->Context.LastViewPos = GlobalContext.LastViewPos;
+        context->Context.LastViewProj = GlobalContext.LastViewProj;
+        ThreadContexts.Add(threadId, context);
+    }
+    context->Locker.Lock();
+    return context;
+}
+
+void MergeThreadContexts()
+{
+    ScopeLock lock(ThreadContextsLocker);
+    for (auto i = ThreadContexts.Begin(); i.IsNotEnd(); ++i)
+    {
+        DebugDrawThreadContext* context = i->Value;
+        context->Locker.Lock();
+        if (context->Context.DebugDrawDefault.Count() + context->Context.DebugDrawDepthTest.Count() != 0)
+            context->IdleUpdates = 0;
+        else
+            context->IdleUpdates++;
+        GlobalContext.DebugDrawDefault.Append(context->Context.DebugDrawDefault);
+        GlobalContext.DebugDrawDepthTest.Append(context->Context.DebugDrawDepthTest);
+        context->Context.LastViewPos = GlobalContext.LastViewPos;
+        context->Context.LastViewProj = GlobalContext.LastViewProj;
+        context->Locker.Unlock();
+
+        // Release contexts that are not used anymore (thread drawing again will create a new one)
+        if (context->IdleUpdates > DEBUG_DRAW_THREAD_CONTEXT_TIMEOUT)
+        {
+            Delete(context);
+            ThreadContexts.Remove(i);
+        }
+    }
+}
+
+// Picks the debug shapes container for the current thread. Main thread uses the active context directly while other threads write into own buffers (synchronized with the merging).
+struct DebugDrawContextScope
+{
+    DebugDrawThreadContext* Thread;
+    DebugDrawContext* Context;
+
+    DebugDrawContextScope()
+    {
+        if (IsInMainThread())
+        {
+            Thread = nullptr;
+            Context = ::Context;
+        }
+        else
+        {
+            Thread = LockThreadContext();
+            Context = &Thread->Context;
+        }
+    }
+
+    ~DebugDrawContextScope()
+    {
+        if (Thread)
+            Thread->Locker.Unlock();
+    }
 };
 
+// Declares local Context variable for debug shapes drawing that is valid for the current thread
+#define DEBUG_DRAW_CONTEXT() const DebugDrawContextScope contextScope; DebugDrawContext* Context = contextScope.Context
+
 extern int32 BoxTrianglesIndicesCache[];
 
 int32 BoxLineIndicesCache[] =
@@ -336,7 +440,7 @@ struct DebugDrawCall
     int32 VertexCount;
 };
 
-DebugDrawCall WriteList(int32& vertexCounter, const Array<Vertex>& list)
+DebugDrawCall WriteList(int32& vertexCounter, const Array<Vertex>& list, const BoundingFrustum& frustum)
 {
     DebugDrawCall drawCall;
     drawCall.StartVertex = vertexCounter;
@@ -346,57 +450,119 @@ DebugDrawCall WriteList(int32& vertexCounter, const Array<Vertex>& list)
     return drawCall;
 }
 
-DebugDrawCall WriteList(int32& vertexCounter, const Array<DebugLine>& list)
+FORCE_INLINE bool IsVisible(const BoundingFrustum& frustum, const DebugLine& l)
 {
-    DebugDrawCall drawCall;
-    drawCall.StartVertex = vertexCounter;
-    drawCall.VertexCount = list.Count() * 2;
-    vertexCounter += drawCall.VertexCount;
-    Vertex* dst = DebugDrawVB->WriteReserve<Vertex>(drawCall.VertexCount);
-    for (int32 i = 0, j = 0; i < list.Count(); i++)
-    {
-        const DebugLine& l = list[i];
-        dst[j++] = { l.Start, l.Color };
-        dst[j++] = { l.End, l.Color };
-    }
-    return drawCall;
+    BoundingBox box;
+    Vector3::Min(l.Start, l.End, box.Minimum);
+    Vector3::Max(l.Start, l.End, box.Maximum);
+    return frustum.Intersects(box);
+}
+
+FORCE_INLINE bool IsVisible(const BoundingFrustum& frustum, const DebugTriangle& t)
+{
+    BoundingBox box;
+    Vector3::Min(t.V0, t.V1, box.Minimum);
+    Vector3::Min(box.Minimum, t.V2, box.Minimum);
+    Vector3::Max(t.V0, t.V1, box.Maximum);
+    Vector3::Max(box.Maximum, t.V2, box.Maximum);
+    return frustum.Intersects(box);
 }
 
-DebugDrawCall WriteList(int32& vertexCounter, const Array<DebugTriangle>& list)
+FORCE_INLINE void WriteVertices(Vertex* dst, const DebugLine& l)
+{
+    dst[0] = { l.Start, l.Color };
+    dst[1] = { l.End, l.Color };
+}
+
+FORCE_INLINE void WriteVertices(Vertex* dst, const DebugTriangle& t)
+{
+    dst[0] = { t.V0, t.Color };
+    dst[1] = { t.V1, t.Color };
+    dst[2] = { t.V2, t.Color };
+}
+
+template<typename T, int32 VerticesPerItem>
+DebugDrawCall WriteCulledList(int32& vertexCounter, const Array<T>& list, const BoundingFrustum& frustum)
 {
     DebugDrawCall drawCall;
     drawCall.StartVertex = vertexCounter;
-    drawCall.VertexCount = list.Count() * 3;
-    vertexCounter += drawCall.VertexCount;
-    Vertex* dst = DebugDrawVB->WriteReserve<Vertex>(drawCall.VertexCount);
-    for (int32 i = 0, j = 0; i < list.Count(); i++)
+    drawCall.VertexCount = 0;
+    if (list.IsEmpty())
+        return drawCall;
+
+    // Write vertices of the visible items (large lists are split into batches processed in parallel, each batch writes to own part of the buffer)
+    const int32 start = DebugDrawVB->Data.Count();
+    Vertex* dst = DebugDrawVB->WriteReserve<Vertex>(list.Count() * VerticesPerItem);
+    const int32 batchesCount = Math::DivideAndRoundUp(list.Count(), DEBUG_DRAW_WRITE_BATCH_SIZE);
+    Array<int32, InlinedAllocation<64>> batchesVertices;
+    batchesVertices.Resize(batchesCount);
+    Function<void(int32)> job = [&list, &frustum, &batchesVertices, dst](int32 batch)
+    {
+        const int32 begin = batch * DEBUG_DRAW_WRITE_BATCH_SIZE;
+        const int32 end = Math::Min(begin + DEBUG_DRAW_WRITE_BATCH_SIZE, list.Count());
+        Vertex* batchDst = dst + begin * VerticesPerItem;
+        int32 written = 0;
+        for (int32 i = begin; i < end; i++)
+        {
+            const T& item = list.Get()[i];
+            if (IsVisible(frustum, item))
+            {
+                WriteVertices(batchDst + written, item);
+                written += VerticesPerItem;
+            }
+        }
+        batchesVertices[batch] = written;
+    };
+    if (batchesCount > 1)
+        JobSystem::Execute(job, batchesCount);
+    else
+        job(0);
+
+    // Compact batches into a continuous range
+    for (int32 batch = 0; batch < batchesCount; batch++)
     {
-        const DebugTriangle& l = list[i];
-        dst[j++] = { l.V0, l.Color };
-        dst[j++] = { l.V1, l.Color };
-        dst[j++] = { l.V2, l.Color };
+        const Vertex* src = dst + batch * DEBUG_DRAW_WRITE_BATCH_SIZE * VerticesPerItem;
+        Vertex* target = dst + drawCall.VertexCount;
+        if (src != target)
+        {
+            for (int32 i = 0; i < batchesVertices[batch]; i++)
+                target[i] = src[i];
+        }
+        drawCall.VertexCount += batchesVertices[batch];
     }
+    DebugDrawVB->Data.Resize(start + drawCall.VertexCount * (int32)sizeof(Vertex));
+    vertexCounter += drawCall.VertexCount;
     return drawCall;
 }
 
+FORCE_INLINE DebugDrawCall WriteList(int32& vertexCounter, const Array<DebugLine>& list, const BoundingFrustum& frustum)
+{
+    return WriteCulledList<DebugLine, 2>(vertexCounter, list, frustum);
+}
+
+FORCE_INLINE DebugDrawCall WriteList(int32& vertexCounter, const Array<DebugTriangle>& list, const BoundingFrustum& frustum)
+{
+    return WriteCulledList<DebugTriangle, 3>(vertexCounter, list, frustum);
+}
+
 template<typename T, typename U>
-DebugDrawCall WriteLists(int32& vertexCounter, const Array<T>& listA, const Array<U>& listB)
+DebugDrawCall WriteLists(int32& vertexCounter, const Array<T>& listA, const Array<U>& listB, const BoundingFrustum& frustum)
 {
-    const DebugDrawCall drawCallA = WriteList(vertexCounter, listA);
-    const DebugDrawCall drawCallB = WriteList(vertexCounter, listB);
+    const DebugDrawCall drawCallA = WriteList(vertexCounter, listA, frustum);
+    const DebugDrawCall drawCallB = WriteList(vertexCounter, listB, frustum);
     DebugDrawCall drawCall;
     drawCall.StartVertex = drawCallA.StartVertex;
     drawCall.VertexCount = drawCallA.VertexCount + drawCallB.VertexCount;
     return drawCall;
 }
 
-FORCE_INLINE DebugTriangle* AppendTriangles(int32 count, float duration, bool depthTest)
+FORCE_INLINE DebugTriangle* AppendTriangles(DebugDrawContext* context, int32 count, float duration, bool depthTest)
 {
     Array<DebugTriangle>* list;
     if (depthTest)
-        list = duration > 0 ? &Context->DebugDrawDepthTest.DefaultTriangles : &Context->DebugDrawDepthTest.OneFrameTriangles;
+        list = duration > 0 ? &context->DebugDrawDepthTest.DefaultTriangles : &context->DebugDrawDepthTest.OneFrameTriangles;
     else
-        list = duration > 0 ? &Context->DebugDrawDefault.DefaultTriangles : &Context->DebugDrawDefault.OneFrameTriangles;
+        list = duration > 0 ? &context->DebugDrawDefault.DefaultTriangles : &context->DebugDrawDefault.OneFrameTriangles;
     const int32 startIndex = list->Count();
     list->AddUninitialized(count);
     return list->Get() + startIndex;
@@ -546,6 +712,7 @@ void DebugDrawService::Update()
     // Special case for Null renderer
     if (GPUDevice::Instance->GetRendererType() == RendererType::Null)
     {
+        MergeThreadContexts();
         GlobalContext.DebugDrawDefault.Clear();
         GlobalContext.DebugDrawDepthTest.Clear();
         return;
@@ -561,6 +728,7 @@ void DebugDrawService::Update()
 #endif
     GlobalContext.DebugDrawDefault.Update(deltaTime);
     GlobalContext.DebugDrawDepthTest.Update(deltaTime);
+    MergeThreadContexts();
 
     // Check if need to setup a resources
     if (DebugDrawShader == nullptr)
@@ -617,6 +785,10 @@ void DebugDrawService::Dispose()
     // Clear lists
     GlobalContext.DebugDrawDefault.Release();
     GlobalContext.DebugDrawDepthTest.Release();
+    {
+        ScopeLock lock(ThreadContextsLocker);
+        ThreadContexts.ClearDelete();
+    }
 
     // Release resources
     SphereTriangleCache.Resize(0);
@@ -662,6 +834,10 @@ void DebugDraw::Draw(RenderContext& renderContext, GPUTextureView* target, GPUTe
 {
     PROFILE_GPU_CPU("Debug Draw");
 
+    // Collect shapes drawn by the other threads
+    if (Context == &GlobalContext)
+        MergeThreadContexts();
+
     // Ensure to have shader loaded and any lines to render
     const int32 debugDrawDepthTestCount = Context->DebugDrawDepthTest.Count();
     const int32 debugDrawDefaultCount = Context->DebugDrawDefault.Count();
@@ -681,14 +857,15 @@ void DebugDraw::Draw(RenderContext& renderContext, GPUTextureView* target, GPUTe
     DebugDrawCall depthTestLines, defaultLines, depthTestTriangles, defaultTriangles, depthTestWireTriangles, defaultWireTriangles;
     {
         PROFILE_CPU_NAMED("Update Buffer");
+        const BoundingFrustum& frustum = renderContext.View.Frustum;
         DebugDrawVB->Clear();
         int32 vertexCounter = 0;
-        depthTestLines = WriteLists(vertexCounter, Context->DebugDrawDepthTest.DefaultLines, Context->DebugDrawDepthTest.OneFrameLines);
-        defaultLines = WriteLists(vertexCounter, Context->DebugDrawDefault.DefaultLines, Context->DebugDrawDefault.OneFrameLines);
-        depthTestTriangles = WriteLists(vertexCounter, Context->DebugDrawDepthTest.DefaultTriangles, Context->DebugDrawDepthTest.OneFrameTriangles);
-        defaultTriangles = WriteLists(vertexCounter, Context->DebugDrawDefault.DefaultTriangles, Context->DebugDrawDefault.OneFrameTriangles);
-        depthTestWireTriangles = WriteLists(vertexCounter, Context->DebugDrawDepthTest.DefaultWireTriangles, Context->DebugDrawDepthTest.OneFrameWireTriangles);
-        defaultWireTriangles = WriteLists(vertexCounter, Context->DebugDrawDefault.DefaultWireTriangles, Context->DebugDrawDefault.OneFrameWireTriangles);
+        depthTestLines = WriteLists(vertexCounter, Context->DebugDrawDepthTest.DefaultLines, Context->DebugDrawDepthTest.OneFrameLines, frustum);
+        defaultLines = WriteLists(vertexCounter, Context->DebugDrawDefault.DefaultLines, Context->DebugDrawDefault.OneFrameLines, frustum);
+        depthTestTriangles = WriteLists(vertexCounter, Context->DebugDrawDepthTest.DefaultTriangles, Context->DebugDrawDepthTest.OneFrameTriangles, frustum);
+        defaultTriangles = WriteLists(vertexCounter, Context->DebugDrawDefault.DefaultTriangles, Context->DebugDrawDefault.OneFrameTriangles, frustum);
+        depthTestWireTriangles = WriteLists(vertexCounter, Context->DebugDrawDepthTest.DefaultWireTriangles, Context->DebugDrawDepthTest.OneFrameWireTriangles, frustum);
+        defaultWireTriangles = WriteLists(vertexCounter, Context->DebugDrawDefault.DefaultWireTriangles, Context->DebugDrawDefault.OneFrameWireTriangles, frustum);
         {
             PROFILE_CPU_NAMED("Flush");
             DebugDrawVB->Flush(context);
@@ -858,6 +1035,7 @@ void DebugDraw::DrawActors(Actor** selectedActors, int32 selectedActorsCount, bo
 
 void DebugDraw::DrawLine(const Vector3& start, const Vector3& end, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     auto& debugDrawData = depthTest ? Context->DebugDrawDepthTest : Context->DebugDrawDefault;
     if (duration > 0)
     {
@@ -875,6 +1053,7 @@ void DebugDraw::DrawLine(const Vector3& start, const Vector3& end, const Color&
 
 void DebugDraw::DrawLines(const Span<Vector3>& lines, const Matrix& transform, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     if (lines.Length() == 0)
         return;
     if (lines.Length() % 2 != 0)
@@ -918,6 +1097,7 @@ void DebugDraw::DrawLines(const Array<Vector3>& lines, const Matrix& transform,
 
 void DebugDraw::DrawBezier(const Vector3& p1, const Vector3& p2, const Vector3& p3, const Vector3& p4, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     // Find amount of segments to use
     const Vector3 d1 = p2 - p1;
     const Vector3 d2 = p3 - p2;
@@ -956,6 +1136,7 @@ void DebugDraw::DrawBezier(const Vector3& p1, const Vector3& p2, const Vector3&
 
 void DebugDraw::DrawWireBox(const BoundingBox& box, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     // Get corners
     Vector3 corners[8];
     box.GetCorners(corners);
@@ -988,6 +1169,7 @@ void DebugDraw::DrawWireBox(const BoundingBox& box, const Color& color, float du
 
 void DebugDraw::DrawWireFrustum(const BoundingFrustum& frustum, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     // Get corners
     Vector3 corners[8];
     frustum.GetCorners(corners);
@@ -1020,6 +1202,7 @@ void DebugDraw::DrawWireFrustum(const BoundingFrustum& frustum, const Color& col
 
 void DebugDraw::DrawWireBox(const OrientedBoundingBox& box, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     // Get corners
     Vector3 corners[8];
     box.GetCorners(corners);
@@ -1052,6 +1235,7 @@ void DebugDraw::DrawWireBox(const OrientedBoundingBox& box, const Color& color,
 
 void DebugDraw::DrawWireSphere(const BoundingSphere& sphere, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     // Select LOD
     int32 index;
     const float screenRadiusSquared = RenderTools::ComputeBoundsScreenRadiusSquared(sphere.Center, sphere.Radius, Context->LastViewPos, Context->LastViewProj);
@@ -1090,6 +1274,7 @@ void DebugDraw::DrawWireSphere(const BoundingSphere& sphere, const Color& color,
 
 void DebugDraw::DrawSphere(const BoundingSphere& sphere, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     DebugTriangle t;
     t.Color = Color32(color);
     t.TimeLeft = duration;
@@ -1145,6 +1330,7 @@ void DebugDraw::DrawWireTriangle(const Vector3& v0, const Vector3& v1, const Vec
 
 void DebugDraw::DrawTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     DebugTriangle t;
     t.Color = Color32(color);
     t.TimeLeft = duration;
@@ -1164,12 +1350,13 @@ void DebugDraw::DrawTriangle(const Vector3& v0, const Vector3& v1, const Vector3
 
 void DebugDraw::DrawTriangles(const Span<Vector3>& vertices, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     CHECK(vertices.Length() % 3 == 0);
 
     DebugTriangle t;
     t.Color = Color32(color);
     t.TimeLeft = duration;
-    auto dst = AppendTriangles(vertices.Length() / 3, duration, depthTest);
+    auto dst = AppendTriangles(Context, vertices.Length() / 3, duration, depthTest);
     for (int32 i = 0; i < vertices.Length();)
     {
         t.V0 = vertices.Get()[i++];
@@ -1181,12 +1368,13 @@ void DebugDraw::DrawTriangles(const Span<Vector3>& vertices, const Color& color,
 
 void DebugDraw::DrawTriangles(const Span<Vector3>& vertices, const Matrix& transform, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     CHECK(vertices.Length() % 3 == 0);
 
     DebugTriangle t;
     t.Color = Color32(color);
     t.TimeLeft = duration;
-    auto dst = AppendTriangles(vertices.Length() / 3, duration, depthTest);
+    auto dst = AppendTriangles(Context, vertices.Length() / 3, duration, depthTest);
     for (int32 i = 0; i < vertices.Length();)
     {
         Vector3::Transform(vertices.Get()[i++], transform, t.V0);
@@ -1208,12 +1396,13 @@ void DebugDraw::DrawTriangles(const Array<Vector3>& vertices, const Matrix& tran
 
 void DebugDraw::DrawTriangles(const Span<Vector3>& vertices, const Span<int32>& indices, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     CHECK(indices.Length() % 3 == 0);
 
     DebugTriangle t;
     t.Color = Color32(color);
     t.TimeLeft = duration;
-    auto dst = AppendTriangles(indices.Length() / 3, duration, depthTest);
+    auto dst = AppendTriangles(Context, indices.Length() / 3, duration, depthTest);
     for (int32 i = 0; i < indices.Length();)
     {
         t.V0 = vertices[indices.Get()[i++]];
@@ -1225,12 +1414,13 @@ void DebugDraw::DrawTriangles(const Span<Vector3>& vertices, const Span<int32>&
 
 void DebugDraw::DrawTriangles(const Span<Vector3>& vertices, const Span<int32>& indices, const Matrix& transform, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     CHECK(indices.Length() % 3 == 0);
 
     DebugTriangle t;
     t.Color = Color32(color);
     t.TimeLeft = duration;
-    auto dst = AppendTriangles(indices.Length() / 3, duration, depthTest);
+    auto dst = AppendTriangles(Context, indices.Length() / 3, duration, depthTest);
     for (int32 i = 0; i < indices.Length();)
     {
         Vector3::Transform(vertices[indices.Get()[i++]], transform, t.V0);
@@ -1252,12 +1442,13 @@ void DebugDraw::DrawTriangles(const Array<Vector3>& vertices, const Array<int32,
 
 void DebugDraw::DrawWireTriangles(const Span<Vector3>& vertices, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     CHECK(vertices.Length() % 3 == 0);
 
     DebugTriangle t;
     t.Color = Color32(color);
     t.TimeLeft = duration;
-    auto dst = AppendTriangles(vertices.Length() / 3, duration, depthTest);
+    auto dst = AppendTriangles(Context, vertices.Length() / 3, duration, depthTest);
     for (int32 i = 0; i < vertices.Length();)
     {
         t.V0 = vertices.Get()[i++];
@@ -1274,12 +1465,13 @@ void DebugDraw::DrawWireTriangles(const Array<Vector3>& vertices, const Color& c
 
 void DebugDraw::DrawWireTriangles(const Span<Vector3>& vertices, const Span<int32>& indices, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     CHECK(indices.Length() % 3 == 0);
 
     DebugTriangle t;
     t.Color = Color32(color);
     t.TimeLeft = duration;
-    auto dst = AppendTriangles(indices.Length() / 3, duration, depthTest);
+    auto dst = AppendTriangles(Context, indices.Length() / 3, duration, depthTest);
     for (int32 i = 0; i < indices.Length();)
     {
         t.V0 = vertices[indices.Get()[i++]];
@@ -1498,6 +1690,7 @@ namespace
 
 void DebugDraw::DrawCylinder(const Vector3& position, const Quaternion& orientation, float radius, float height, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     Array<DebugTriangle>* list;
     if (depthTest)
         list = duration > 0 ? &Context->DebugDrawDepthTest.DefaultTriangles : &Context->DebugDrawDepthTest.OneFrameTriangles;
@@ -1508,6 +1701,7 @@ void DebugDraw::DrawCylinder(const Vector3& position, const Quaternion& orientat
 
 void DebugDraw::DrawWireCylinder(const Vector3& position, const Quaternion& orientation, float radius, float height, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     Array<DebugTriangle>* list;
     if (depthTest)
         list = duration > 0 ? &Context->DebugDrawDepthTest.DefaultWireTriangles : &Context->DebugDrawDepthTest.OneFrameWireTriangles;
@@ -1518,6 +1712,7 @@ void DebugDraw::DrawWireCylinder(const Vector3& position, const Quaternion& orie
 
 void DebugDraw::DrawCone(const Vector3& position, const Quaternion& orientation, float radius, float angleXY, float angleXZ, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     Array<DebugTriangle>* list;
     if (depthTest)
         list = duration > 0 ? &Context->DebugDrawDepthTest.DefaultTriangles : &Context->DebugDrawDepthTest.OneFrameTriangles;
@@ -1528,6 +1723,7 @@ void DebugDraw::DrawCone(const Vector3& position, const Quaternion& orientation,
 
 void DebugDraw::DrawWireCone(const Vector3& position, const Quaternion& orientation, float radius, float angleXY, float angleXZ, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     Array<DebugTriangle>* list;
     if (depthTest)
         list = duration > 0 ? &Context->DebugDrawDepthTest.DefaultWireTriangles : &Context->DebugDrawDepthTest.OneFrameWireTriangles;
@@ -1538,6 +1734,7 @@ void DebugDraw::DrawWireCone(const Vector3& position, const Quaternion& orientat
 
 void DebugDraw::DrawArc(const Vector3& position, const Quaternion& orientation, float radius, float angle, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     if (angle <= 0)
         return;
     if (angle > TWO_PI)
@@ -1614,6 +1811,7 @@ void DebugDraw::DrawWireArrow(const Vector3& position, const Quaternion& orienta
 
 void DebugDraw::DrawBox(const BoundingBox& box, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     // Get corners
     Vector3 corners[8];
     box.GetCorners(corners);
@@ -1640,6 +1838,7 @@ void DebugDraw::DrawBox(const BoundingBox& box, const Color& color, float durati
 
 void DebugDraw::DrawBox(const OrientedBoundingBox& box, const Color& color, float duration, bool depthTest)
 {
+    DEBUG_DRAW_CONTEXT();
     // Get corners
     Vector3 corners[8];
     box.GetCorners(corners);
@@ -1666,6 +1865,7 @@ void DebugDraw::DrawBox(const OrientedBoundingBox& box, const Color& color, floa
 
 void DebugDraw::DrawText(const StringView& text, const Vector2& position, const Color& color, int32 size, float duration)
 {
+    DEBUG_DRAW_CONTEXT();
     if (text.Length() == 0 || size < 4)
         return;
     Array<DebugText2D>* list = duration > 0 ? &Context->DebugDrawDefault.DefaultText2D : &Context->DebugDrawDefault.OneFrameText2D;
@@ -1681,6 +1881,7 @@ void DebugDraw::DrawText(const StringView& text, const Vector2& position, const
 
 void DebugDraw::DrawText(const StringView& text, const Vector3& position, const Color& color, int32 size, float duration)
 {
+    DEBUG_DRAW_CONTEXT();
     if (text.Length() == 0 || size < 4)
         return;
     Array<DebugText3D>* list = duration > 0 ? &Context->DebugDrawDefault.DefaultText3D : &Context->DebugDrawDefault.OneFrameText3D;
@@ -1697,6 +1898,7 @@ void DebugDraw::DrawText(const StringView& text, const Vector3& position, const
 
 void DebugDraw::DrawText(const StringView& text, const Transform& transform, const Color& color, int32 size, float duration)
 {
+    DEBUG_DRAW_CONTEXT();
     if (text.Length() == 0 || size < 4)
         return;
     Array<DebugText3D>* list = duration > 0 ? &Context->DebugDrawDefault.DefaultText3D : &Context->DebugDrawDefault.OneFrameText3D;
@@ -20,6 +20,9 @@ struct Transform;
 /// <summary>
 /// The debug shapes rendering service. Not available in final game. For use only in the editor.
 /// </summary>
+/// <remarks>
+/// Shapes can be drawn from any thread (eg. from Job System jobs). Shapes from threads other than main are buffered per-thread and merged into the global context before rendering.
+/// </remarks>
 API_CLASS(Static) class FLAXENGINE_API DebugDraw
 {
 DECLARE_SCRIPTING_TYPE_NO_SPAWN(DebugDraw);
@@ -126,6 +126,7 @@ bool CommandLine::Parse(const Char* cmdLine)
     PARSE_BOOL_SWITCH("-novsync ", NoVSync);
     PARSE_BOOL_SWITCH("-nolog ", NoLog);
     PARSE_BOOL_SWITCH("-std ", Std);
+    PARSE_BOOL_SWITCH("-logasync ", LogAsync);
 #if !BUILD_RELEASE
     PARSE_ARG_SWITCH("-debug ", DebuggerAddress);
     PARSE_BOOL_SWITCH("-debugwait ", WaitForDebugger);
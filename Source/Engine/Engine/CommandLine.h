@@ -49,6 +49,11 @@ class CommandLine
         /// </summary>
         Nullable<bool> Std;
 
+        /// <summary>
+        /// -logasync (write log file on a background thread, messages are buffered and can be dropped if buffer gets full)
+        /// </summary>
+        Nullable<bool> LogAsync;
+
 #if !BUILD_RELEASE
 
         /// <summary>
@@ -24,3 +24,15 @@ struct FoliageInstance;
 
 // Size of the cluster container for instances
 #define FOLIAGE_CLUSTER_CAPACITY (64)
+
+// The depth of the quad-tree at which the clusters are split into separate culling jobs (each level gives up to 4 times more jobs)
+#define FOLIAGE_DRAW_JOBS_DEPTH (3)
+
+// The minimum amount of foliage instances to cull and draw the clusters on multiple threads (small foliage is drawn on the calling thread)
+#define FOLIAGE_DRAW_JOBS_MIN_INSTANCES (8192)
+
+// Enables support for the GPU-driven foliage drawing (compute shader culls the clusters and instances, selects LODs and generates indirect draw arguments). Used only if enabled with Foliage::SetGPUCulling and supported by the graphics device.
+#define FOLIAGE_USE_GPU_CULLING (!FOLIAGE_USE_SINGLE_QUAD_TREE && FOLIAGE_USE_DRAW_CALLS_BATCHING)
+
+// Enables validation of the GPU-driven foliage culling against the CPU culling (visible instances counts per LOD are read back from the GPU and compared, mismatches are logged as warnings).
+#define FOLIAGE_GPU_CULLING_VALIDATION (FOLIAGE_USE_GPU_CULLING && BUILD_DEBUG)
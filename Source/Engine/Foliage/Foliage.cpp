@@ -11,18 +11,256 @@
 #include "Engine/Graphics/RenderTools.h"
 #include "Engine/Graphics/GPUDevice.h"
 #include "Engine/Renderer/RenderList.h"
+#include "Engine/Threading/JobSystem.h"
+#endif
+#if FOLIAGE_USE_GPU_CULLING
+#include "Engine/Content/Content.h"
+#include "Engine/Content/Assets/Shader.h"
+#include "Engine/Engine/EngineService.h"
+#include "Engine/Graphics/GPUBuffer.h"
+#include "Engine/Graphics/GPUContext.h"
+#include "Engine/Graphics/GPULimits.h"
+#include "Engine/Graphics/Shaders/GPUConstantBuffer.h"
+#include "Engine/Graphics/Shaders/GPUShader.h"
+#include "Engine/Profiler/Profiler.h"
 #endif
 #include "Engine/Level/SceneQuery.h"
 #include "Engine/Profiler/ProfilerCPU.h"
 #include "Engine/Serialization/Serialization.h"
 #include "Engine/Utilities/Encryption.h"
 
+static bool UseGPUCulling = false;
+
+#if !FOLIAGE_USE_SINGLE_QUAD_TREE && FOLIAGE_USE_DRAW_CALLS_BATCHING
+
+// The instances buffers filled by a single culling job. Buffers are kept between the draws (only cleared) so drawing doesn't need to reallocate the instances data every frame.
+struct Foliage::DrawResult
+{
+    struct Batch
+    {
+        DrawKey Key;
+        Array<InstanceData> Instances;
+    };
+
+    Dictionary<DrawKey, int32> Lookup;
+    Array<Batch> Batches;
+
+    Array<InstanceData>& Get(const DrawKey& key)
+    {
+        int32 index;
+        if (!Lookup.TryGet(key, index))
+        {
+            index = Batches.Count();
+            Batches.AddOne().Key = key;
+            Lookup.Add(key, index);
+        }
+        return Batches[index].Instances;
+    }
+
+    void Reset()
+    {
+        for (auto& batch : Batches)
+            batch.Instances.Clear();
+    }
+};
+
+// The persistent state of the foliage drawing.
+struct Foliage::DrawCache
+{
+    struct Job
+    {
+        FoliageType* Type;
+        FoliageCluster* Cluster;
+        bool Inside;
+    };
+
+    Array<Job> Jobs;
+    Array<DrawResult*> Results;
+    Dictionary<DrawKey, int32> BatchesLookup;
+    Array<DrawCallsList> DrawCallsLists;
+
+#if FOLIAGE_USE_GPU_CULLING
+    // The output buffers of the GPU culling for a single view.
+    struct GPUView
+    {
+        GPUBuffer* Counters;
+        GPUBuffer* Args;
+        GPUBuffer* Instances;
+    };
+
+    // The GPU data of the foliage type. Clusters and instances are uploaded once and culled for every view into separate output buffers.
+    struct GPUType
+    {
+        bool Initialized = false;
+        bool Supported = false;
+        bool Dirty = false;
+        GPUBuffer* Clusters = nullptr;
+        GPUBuffer* Instances = nullptr;
+        int32 ClustersCount = 0;
+        int32 InstancesCount = 0;
+        int32 MeshesCount = 0;
+        uint64 Frame = 0;
+        int32 ViewsUsed = 0;
+        Array<GPUView> Views;
+#if FOLIAGE_GPU_CULLING_VALIDATION
+        GPUBuffer* ValidationCounters = nullptr;
+        uint64 ValidationFrame = 0;
+        int32 ValidationCounts[MODEL_MAX_LODS];
+#endif
+
+        void Release()
+        {
+            SAFE_DELETE_GPU_RESOURCE(Clusters);
+            SAFE_DELETE_GPU_RESOURCE(Instances);
+            for (auto& view : Views)
+            {
+                SAFE_DELETE_GPU_RESOURCE(view.Counters);
+                SAFE_DELETE_GPU_RESOURCE(view.Args);
+                SAFE_DELETE_GPU_RESOURCE(view.Instances);
+            }
+            Views.Clear();
+#if FOLIAGE_GPU_CULLING_VALIDATION
+            SAFE_DELETE_GPU_RESOURCE(ValidationCounters);
+            ValidationFrame = 0;
+#endif
+            Initialized = false;
+            Supported = false;
+            Dirty = false;
+            ClustersCount = 0;
+            InstancesCount = 0;
+            ViewsUsed = 0;
+        }
+    };
+
+    Array<GPUType> GPUTypes;
+
+    // Marks the GPU data of the foliage type to be uploaded again before the next draw (all types if index is -1).
+    void SetGPUDirty(int32 typeIndex = -1)
+    {
+        for (int32 i = 0; i < GPUTypes.Count(); i++)
+        {
+            if (typeIndex == -1 || typeIndex == i)
+                GPUTypes[i].Dirty = true;
+        }
+    }
+
+    void ReleaseGPU()
+    {
+        for (auto& type : GPUTypes)
+            type.Release();
+        GPUTypes.Clear();
+    }
+#endif
+
+    ~DrawCache()
+    {
+        Results.ClearDelete();
+#if FOLIAGE_USE_GPU_CULLING
+        ReleaseGPU();
+#endif
+    }
+};
+
+#endif
+
+#if FOLIAGE_USE_GPU_CULLING
+
+PACK_STRUCT(struct FoliageCullingData {
+    Vector4 FrustumPlanes[6];
+    Vector3 ViewPosition;
+    float LODDistanceFactor;
+    Vector3 LODViewPosition;
+    float MinScreenRadiusSquared;
+    float LODScreenRadiusSquared[8];
+    uint32 ClustersCount;
+    uint32 LODsCount;
+    uint32 MinLOD;
+    int32 LODBias;
+    uint32 MeshesCount;
+    Vector3 Dummy0;
+    });
+
+// The leaf cluster data for the GPU culling. Matches the shader type.
+struct GPUFoliageCluster
+{
+    Vector3 BoundsCenter;
+    float BoundsRadius;
+    float MaxCullDistance;
+    uint32 InstancesStart;
+    uint32 InstancesCount;
+    float Dummy0;
+};
+
+// The instance data for the GPU culling. Matches the shader type.
+struct GPUFoliageInstance
+{
+    Vector3 InstanceOrigin;
+    float PerInstanceRandom;
+    Vector3 InstanceTransform1;
+    float CullDistance;
+    Vector3 InstanceTransform2;
+    float BoundsRadius;
+    Vector3 InstanceTransform3;
+    float Dummy0;
+    Vector3 BoundsCenter;
+    float Dummy1;
+};
+
+AssetReference<Shader> FoliageCullingShader;
+GPUConstantBuffer* FoliageCullingCB = nullptr;
+GPUShaderProgramCS* FoliageCullingCountCS = nullptr;
+GPUShaderProgramCS* FoliageCullingArgsCS = nullptr;
+GPUShaderProgramCS* FoliageCullingWriteCS = nullptr;
+
+#if COMPILE_WITH_DEV_ENV
+
+void OnFoliageCullingShaderReloading(Asset* obj)
+{
+    FoliageCullingCB = nullptr;
+    FoliageCullingCountCS = nullptr;
+    FoliageCullingArgsCS = nullptr;
+    FoliageCullingWriteCS = nullptr;
+}
+
+#endif
+
+class FoliageService : public EngineService
+{
+public:
+
+    FoliageService()
+        : EngineService(TEXT("Foliage"), 70)
+    {
+    }
+
+    void Dispose() override
+    {
+        FoliageCullingCB = nullptr;
+        FoliageCullingCountCS = nullptr;
+        FoliageCullingArgsCS = nullptr;
+        FoliageCullingWriteCS = nullptr;
+        FoliageCullingShader = nullptr;
+    }
+};
+
+FoliageService FoliageServiceInstance;
+
+#endif
+
 Foliage::Foliage(const SpawnParams& params)
     : Actor(params)
 {
     _disableFoliageTypeEvents = false;
 }
 
+Foliage::~Foliage()
+{
+#if !FOLIAGE_USE_SINGLE_QUAD_TREE && FOLIAGE_USE_DRAW_CALLS_BATCHING
+    if (_drawCache)
+        Delete(_drawCache);
+#endif
+}
+
 void Foliage::AddToCluster(ChunkedArray<FoliageCluster, FOLIAGE_CLUSTER_CHUNKS_SIZE>& clusters, FoliageCluster* cluster, FoliageInstance& instance)
 {
     ASSERT(instance.Bounds.Radius > ZeroTolerance);
@@ -81,7 +319,36 @@ void Foliage::AddToCluster(ChunkedArray<FoliageCluster, FOLIAGE_CLUSTER_CHUNKS_S
 
 #if !FOLIAGE_USE_SINGLE_QUAD_TREE && FOLIAGE_USE_DRAW_CALLS_BATCHING
 
-void Foliage::DrawInstance(RenderContext& renderContext, FoliageInstance& instance, FoliageType& type, Model* model, int32 lod, float lodDitherFactor, DrawCallsList* drawCallsLists, BatchedDrawCalls& result) const
+void Foliage::AddDrawJobs(RenderContext& renderContext, FoliageType& type, FoliageCluster* cluster, int32 depth, bool inside)
+{
+    // Skip clusters that around too far from view
+    if (Vector3::Distance(renderContext.View.Position, cluster->TotalBoundsSphere.Center) - cluster->TotalBoundsSphere.Radius > cluster->MaxCullDistance)
+        return;
+
+    if (depth == 0 || !cluster->Children[0])
+    {
+        // Cull and draw this subtree in a separate job
+        auto& job = _drawCache->Jobs.AddOne();
+        job.Type = &type;
+        job.Cluster = cluster;
+        job.Inside = inside;
+        return;
+    }
+
+    for (FoliageCluster* child : cluster->Children)
+    {
+        if (inside)
+        {
+            AddDrawJobs(renderContext, type, child, depth - 1, true);
+            continue;
+        }
+        const ContainmentType containment = renderContext.View.CullingFrustum.Contains(child->TotalBounds);
+        if (containment != ContainmentType::Disjoint)
+            AddDrawJobs(renderContext, type, child, depth - 1, containment == ContainmentType::Contains);
+    }
+}
+
+void Foliage::DrawInstance(RenderContext& renderContext, FoliageInstance& instance, FoliageType& type, Model* model, int32 lod, float lodDitherFactor, DrawCallsList* drawCallsLists, DrawResult& result) const
 {
     const auto& meshes = model->LODs[lod].Meshes;
     for (int32 meshIndex = 0; meshIndex < meshes.Count(); meshIndex++)
@@ -94,16 +361,9 @@ void Foliage::DrawInstance(RenderContext& renderContext, FoliageInstance& instan
         key.Mat = drawCall.DrawCall.Material;
         key.Geo = &meshes[meshIndex];
         key.Lightmap = instance.Lightmap.TextureIndex;
-        auto* e = result.TryGet(key);
-        if (!e)
-        {
-            e = &result[key];
-            e->DrawCall.Material = key.Mat;
-            e->DrawCall.Surface.Lightmap = _staticFlags & StaticFlags::Lightmap ? _scene->LightmapsData.GetReadyLightmap(key.Lightmap) : nullptr;
-        }
 
         // Add instance to the draw batch
-        auto& instanceData = e->Instances.AddOne();
+        auto& instanceData = result.Get(key).AddOne();
         instanceData.InstanceOrigin = Vector3(instance.World.M41, instance.World.M42, instance.World.M43);
         instanceData.PerInstanceRandom = instance.Random;
         instanceData.InstanceTransform1 = Vector3(instance.World.M11, instance.World.M12, instance.World.M13);
@@ -114,7 +374,7 @@ void Foliage::DrawInstance(RenderContext& renderContext, FoliageInstance& instan
     }
 }
 
-void Foliage::DrawCluster(RenderContext& renderContext, FoliageCluster* cluster, FoliageType& type, DrawCallsList* drawCallsLists, BatchedDrawCalls& result) const
+void Foliage::DrawCluster(RenderContext& renderContext, FoliageCluster* cluster, FoliageType& type, DrawCallsList* drawCallsLists, DrawResult& result, bool inside) const
 {
     // Skip clusters that around too far from view
     if (Vector3::Distance(renderContext.View.Position, cluster->TotalBoundsSphere.Center) - cluster->TotalBoundsSphere.Radius > cluster->MaxCullDistance)
@@ -128,14 +388,18 @@ void Foliage::DrawCluster(RenderContext& renderContext, FoliageCluster* cluster,
         // Don't store instances in non-leaf nodes
         ASSERT_LOW_LAYER(cluster->Instances.IsEmpty());
 
-#define DRAW_CLUSTER(idx) \
-		if (renderContext.View.CullingFrustum.Intersects(cluster->Children[idx]->TotalBounds)) \
-			DrawCluster(renderContext, cluster->Children[idx], type, drawCallsLists, result)
-        DRAW_CLUSTER(0);
-        DRAW_CLUSTER(1);
-        DRAW_CLUSTER(2);
-        DRAW_CLUSTER(3);
-#undef 	DRAW_CLUSTER
+        // Clusters fully inside the view frustum skip culling of all the children and instances
+        for (FoliageCluster* child : cluster->Children)
+        {
+            if (inside)
+            {
+                DrawCluster(renderContext, child, type, drawCallsLists, result, true);
+                continue;
+            }
+            const ContainmentType containment = renderContext.View.CullingFrustum.Contains(child->TotalBounds);
+            if (containment != ContainmentType::Disjoint)
+                DrawCluster(renderContext, child, type, drawCallsLists, result, containment == ContainmentType::Contains);
+        }
     }
     else
     {
@@ -146,7 +410,7 @@ void Foliage::DrawCluster(RenderContext& renderContext, FoliageCluster* cluster,
         {
             auto& instance = *cluster->Instances[i];
             if (Vector3::Distance(renderContext.View.Position, instance.Bounds.Center) - instance.Bounds.Radius < instance.CullDistance &&
-                renderContext.View.CullingFrustum.Intersects(instance.Bounds))
+                (inside || renderContext.View.CullingFrustum.Intersects(instance.Bounds)))
             {
                 const auto modelFrame = instance.DrawState.PrevFrame + 1;
 
@@ -234,6 +498,348 @@ void Foliage::DrawCluster(RenderContext& renderContext, FoliageCluster* cluster,
     }
 }
 
+#if FOLIAGE_USE_GPU_CULLING
+
+#if FOLIAGE_GPU_CULLING_VALIDATION
+
+// Counts the visible instances of the foliage type per LOD the same way as the culling shader does but with the CPU culling and LOD selection.
+void CountVisibleInstances(const RenderContext& renderContext, const FoliageType& type, int32 counts[MODEL_MAX_LODS])
+{
+    const auto& view = renderContext.View;
+    const auto model = type.Model.Get();
+    Platform::MemoryClear(counts, MODEL_MAX_LODS * sizeof(int32));
+    Array<FoliageCluster*> stack;
+    stack.Add(type.Root);
+    while (stack.HasItems())
+    {
+        FoliageCluster* cluster = stack.Pop();
+        if (cluster->Children[0])
+        {
+            for (FoliageCluster* child : cluster->Children)
+                stack.Add(child);
+            continue;
+        }
+        if (Vector3::Distance(view.Position, cluster->TotalBoundsSphere.Center) - cluster->TotalBoundsSphere.Radius > cluster->MaxCullDistance || !view.CullingFrustum.Intersects(cluster->TotalBoundsSphere))
+            continue;
+        for (const FoliageInstance* instance : cluster->Instances)
+        {
+            if (Vector3::Distance(view.Position, instance->Bounds.Center) - instance->Bounds.Radius >= instance->CullDistance || !view.CullingFrustum.Intersects(instance->Bounds))
+                continue;
+            const int32 lodIndex = RenderTools::ComputeModelLOD(model, instance->Bounds.Center, instance->Bounds.Radius, renderContext);
+            if (lodIndex != -1)
+                counts[model->ClampLODIndex(lodIndex + view.ModelLODBias)]++;
+        }
+    }
+}
+
+#endif
+
+bool Foliage::DrawGPU(RenderContext& renderContext, FoliageType& type, DrawCallsList* drawCallsLists)
+{
+    const auto& limits = GPUDevice::Instance->Limits;
+    if (!limits.HasCompute || !limits.HasDrawIndirect || !limits.HasInstancing)
+        return false;
+    const auto& view = renderContext.View;
+    const auto model = type.Model.Get();
+
+    // GPU-generated instances can be drawn only with instancing so skip materials that need to be drawn in other passes
+    int32 meshesCount = 0;
+    for (int32 lod = 0; lod < model->LODs.Count(); lod++)
+    {
+        const auto& meshes = model->LODs[lod].Meshes;
+        meshesCount = Math::Max(meshesCount, meshes.Count());
+        for (int32 meshIndex = 0; meshIndex < meshes.Count(); meshIndex++)
+        {
+            const auto material = drawCallsLists[lod][meshIndex].DrawCall.Material;
+            if (!material)
+                continue;
+            IMaterial::InstancingHandler handler;
+            if (!material->CanUseInstancing(handler))
+                return false;
+            const auto& mesh = meshes[meshIndex];
+            const auto& entry = type.Entries[mesh.GetMaterialSlotIndex()];
+            const MaterialSlot& slot = model->MaterialSlots[mesh.GetMaterialSlotIndex()];
+            const auto shadowsMode = static_cast<ShadowsCastingMode>(entry.ShadowsMode & slot.ShadowsMode);
+            const auto drawModes = (DrawPass)(static_cast<DrawPass>(type._drawModes & view.GetShadowsDrawPassMask(shadowsMode)) & material->GetDrawModes());
+            if (drawModes & (DrawPass::Distortion | DrawPass::Forward) || (drawModes & DrawPass::MotionVectors && (_staticFlags & StaticFlags::Transform) == 0))
+                return false;
+        }
+    }
+
+    // Prepare shader
+    if (!FoliageCullingCB)
+    {
+        if (!FoliageCullingShader)
+        {
+            FoliageCullingShader = Content::LoadAsyncInternal<Shader>(TEXT("Shaders/FoliageCulling"));
+            if (!FoliageCullingShader)
+                return false;
+#if COMPILE_WITH_DEV_ENV
+            FoliageCullingShader.Get()->OnReloading.Bind<OnFoliageCullingShaderReloading>();
+#endif
+        }
+        if (!FoliageCullingShader->IsLoaded())
+            return false;
+        const auto shader = FoliageCullingShader->GetShader();
+        const auto cb = shader->GetCB(0);
+        if (!cb || cb->GetSize() != sizeof(FoliageCullingData))
+        {
+            LOG(Error, "Invalid foliage culling shader constant buffer size. Disabling GPU culling.");
+            UseGPUCulling = false;
+            return false;
+        }
+        FoliageCullingCountCS = shader->GetCS("CS_Count");
+        FoliageCullingArgsCS = shader->GetCS("CS_Args");
+        FoliageCullingWriteCS = shader->GetCS("CS_Write");
+        FoliageCullingCB = cb;
+    }
+
+    // Upload foliage type clusters and instances
+    auto& cache = *_drawCache;
+    if (cache.GPUTypes.Count() < FoliageTypes.Count())
+        cache.GPUTypes.Resize(FoliageTypes.Count());
+    auto& gpu = cache.GPUTypes[type.Index];
+    if (gpu.Dirty)
+        gpu.Release();
+    if (!gpu.Initialized)
+    {
+        PROFILE_CPU_NAMED("Upload");
+        gpu.Initialized = true;
+        Array<GPUFoliageCluster> clusters;
+        Array<GPUFoliageInstance> instances;
+        Array<FoliageCluster*> stack;
+        stack.Add(type.Root);
+        bool hasLightmaps = false;
+        while (stack.HasItems())
+        {
+            FoliageCluster* cluster = stack.Pop();
+            if (cluster->Children[0])
+            {
+                for (FoliageCluster* child : cluster->Children)
+                    stack.Add(child);
+                continue;
+            }
+            if (cluster->Instances.IsEmpty())
+                continue;
+            auto& c = clusters.AddOne();
+            c.BoundsCenter = cluster->TotalBoundsSphere.Center;
+            c.BoundsRadius = cluster->TotalBoundsSphere.Radius;
+            c.MaxCullDistance = cluster->MaxCullDistance;
+            c.InstancesStart = instances.Count();
+            c.InstancesCount = cluster->Instances.Count();
+            c.Dummy0 = 0.0f;
+            for (FoliageInstance* instance : cluster->Instances)
+            {
+                hasLightmaps |= instance->Lightmap.TextureIndex != INVALID_INDEX;
+                auto& e = instances.AddOne();
+                e.InstanceOrigin = Vector3(instance->World.M41, instance->World.M42, instance->World.M43);
+                e.PerInstanceRandom = instance->Random;
+                e.InstanceTransform1 = Vector3(instance->World.M11, instance->World.M12, instance->World.M13);
+                e.CullDistance = instance->CullDistance;
+                e.InstanceTransform2 = Vector3(instance->World.M21, instance->World.M22, instance->World.M23);
+                e.BoundsRadius = instance->Bounds.Radius;
+                e.InstanceTransform3 = Vector3(instance->World.M31, instance->World.M32, instance->World.M33);
+                e.Dummy0 = 0.0f;
+                e.BoundsCenter = instance->Bounds.Center;
+                e.Dummy1 = 0.0f;
+            }
+        }
+        gpu.ClustersCount = clusters.Count();
+        gpu.InstancesCount = instances.Count();
+        gpu.MeshesCount = meshesCount;
+
+        // Lightmapped instances need per-lightmap batches so draw them on the CPU
+        if (hasLightmaps && _staticFlags & StaticFlags::Lightmap)
+            return false;
+        if (clusters.HasItems())
+        {
+            gpu.Clusters = GPUDevice::Instance->CreateBuffer(TEXT("FoliageClusters"));
+            gpu.Instances = GPUDevice::Instance->CreateBuffer(TEXT("FoliageInstances"));
+            if (gpu.Clusters->Init(GPUBufferDescription::Buffer(clusters.Count() * sizeof(GPUFoliageCluster), GPUBufferFlags::Structured | GPUBufferFlags::ShaderResource, PixelFormat::Unknown, clusters.Get(), sizeof(GPUFoliageCluster))) ||
+                gpu.Instances->Init(GPUBufferDescription::Buffer(instances.Count() * sizeof(GPUFoliageInstance), GPUBufferFlags::Structured | GPUBufferFlags::ShaderResource, PixelFormat::Unknown, instances.Get(), sizeof(GPUFoliageInstance))))
+            {
+                LOG(Error, "Failed to create foliage culling buffers.");
+                return false;
+            }
+        }
+        gpu.Supported = true;
+    }
+    if (!gpu.Supported)
+        return false;
+    if (gpu.ClustersCount == 0)
+        return true;
+
+    // Get the output buffers for this view (each view drawn during the frame has own results)
+    if (gpu.Frame != Engine::FrameCount)
+    {
+        gpu.Frame = Engine::FrameCount;
+        gpu.ViewsUsed = 0;
+    }
+    if (gpu.ViewsUsed == gpu.Views.Count())
+    {
+        Array<GPUDrawIndexedIndirectArgs> args;
+        args.Resize(model->LODs.Count() * gpu.MeshesCount);
+        Platform::MemoryClear(args.Get(), args.Count() * sizeof(GPUDrawIndexedIndirectArgs));
+        for (int32 lod = 0; lod < model->LODs.Count(); lod++)
+        {
+            const auto& meshes = model->LODs[lod].Meshes;
+            for (int32 meshIndex = 0; meshIndex < meshes.Count(); meshIndex++)
+            {
+                DrawCall drawCall;
+                meshes[meshIndex].GetDrawCallGeometry(drawCall);
+                auto& e = args[lod * gpu.MeshesCount + meshIndex];
+                e.IndicesCount = drawCall.Draw.IndicesCount;
+                e.StartIndex = drawCall.Draw.StartIndex;
+            }
+        }
+        auto& e = gpu.Views.AddOne();
+        e.Counters = GPUDevice::Instance->CreateBuffer(TEXT("FoliageCullingCounters"));
+        e.Args = GPUDevice::Instance->CreateBuffer(TEXT("FoliageCullingArgs"));
+        e.Instances = GPUDevice::Instance->CreateBuffer(TEXT("FoliageCullingInstances"));
+        if (e.Counters->Init(GPUBufferDescription::Raw(MODEL_MAX_LODS * 2 * sizeof(uint32), GPUBufferFlags::UnorderedAccess)) ||
+            e.Args->Init(GPUBufferDescription::Raw(args.Get(), args.Count() * sizeof(GPUDrawIndexedIndirectArgs), GPUBufferFlags::Argument | GPUBufferFlags::UnorderedAccess)) ||
+            e.Instances->Init(GPUBufferDescription::Buffer(gpu.InstancesCount * sizeof(InstanceData), GPUBufferFlags::RawBuffer | GPUBufferFlags::VertexBuffer | GPUBufferFlags::UnorderedAccess, PixelFormat::R32_Typeless, nullptr, sizeof(InstanceData))))
+        {
+            LOG(Error, "Failed to create foliage culling buffers.");
+            gpu.Supported = false;
+            return false;
+        }
+    }
+    const auto& output = gpu.Views[gpu.ViewsUsed++];
+
+    // Cull instances and generate indirect draw arguments
+    {
+        PROFILE_GPU_CPU("Foliage Culling");
+        const auto context = GPUDevice::Instance->GetMainContext();
+        const auto& lodView = renderContext.LodProxyView ? *renderContext.LodProxyView : view;
+        FoliageCullingData data;
+        for (int32 i = 0; i < 6; i++)
+        {
+            const Plane plane = view.CullingFrustum.GetPlane(i);
+            data.FrustumPlanes[i] = Vector4(plane.Normal, plane.D);
+        }
+        data.ViewPosition = view.Position;
+        data.LODDistanceFactor = Math::Square(0.5f * Math::Max(lodView.Projection.Values[0][0], lodView.Projection.Values[1][1])) * view.ModelLODDistanceFactorSqrt;
+        data.LODViewPosition = lodView.Position;
+        data.MinScreenRadiusSquared = Math::Square(model->MinScreenSize * 0.5f);
+        for (int32 lod = 0; lod < ARRAY_COUNT(data.LODScreenRadiusSquared); lod++)
+            data.LODScreenRadiusSquared[lod] = lod < model->LODs.Count() ? Math::Square(model->LODs[lod].ScreenSize * 0.5f) : 0.0f;
+        data.ClustersCount = gpu.ClustersCount;
+        data.LODsCount = model->LODs.Count();
+        data.MinLOD = model->ClampLODIndex(0);
+        data.LODBias = view.ModelLODBias;
+        data.MeshesCount = gpu.MeshesCount;
+        data.Dummy0 = Vector3::Zero;
+        context->UpdateCB(FoliageCullingCB, &data);
+        context->BindCB(0, FoliageCullingCB);
+        const uint32 counters[4] = { 0, 0, 0, 0 };
+        context->ClearUA(output.Counters, counters);
+        context->BindSR(0, gpu.Clusters->View());
+        context->BindSR(1, gpu.Instances->View());
+        context->BindUA(0, output.Counters->View());
+        const int32 maxGroups = 65535;
+        const uint32 groupsX = Math::Min(gpu.ClustersCount, maxGroups);
+        const uint32 groupsY = Math::DivideAndRoundUp(gpu.ClustersCount, maxGroups);
+        context->Dispatch(FoliageCullingCountCS, groupsX, groupsY, 1);
+        context->BindUA(1, output.Args->View());
+        context->Dispatch(FoliageCullingArgsCS, 1, 1, 1);
+        context->BindUA(1, output.Instances->View());
+        context->Dispatch(FoliageCullingWriteCS, groupsX, groupsY, 1);
+        context->ResetUA();
+        context->ResetSR();
+
+#if FOLIAGE_GPU_CULLING_VALIDATION
+        // Compare the visible instances counts of the first view in the frame with the CPU culling (GPU results are read back a few frames later)
+        if (gpu.ViewsUsed == 1)
+        {
+            if (gpu.ValidationFrame != 0 && Engine::FrameCount >= gpu.ValidationFrame + 3)
+            {
+                BytesContainer counts;
+                if (!gpu.ValidationCounters->GetData(counts) && counts.Length() >= sizeof(gpu.ValidationCounts))
+                {
+                    for (int32 lod = 0; lod < MODEL_MAX_LODS; lod++)
+                    {
+                        // Allow small differences for the instances on the edges (floating point precision of the GPU)
+                        const int32 gpuCount = (int32)((const uint32*)counts.Get())[lod];
+                        const int32 cpuCount = gpu.ValidationCounts[lod];
+                        if (Math::Abs(gpuCount - cpuCount) > Math::Max(1, cpuCount / 100))
+                            LOG(Warning, "Foliage GPU culling mismatch for model {0} LOD {1}: {2} visible instances on GPU, {3} on CPU.", model->ToString(), lod, gpuCount, cpuCount);
+                    }
+                }
+                gpu.ValidationFrame = 0;
+            }
+            if (gpu.ValidationFrame == 0)
+            {
+                if (!gpu.ValidationCounters)
+                    gpu.ValidationCounters = output.Counters->ToStagingReadback();
+                if (gpu.ValidationCounters)
+                {
+                    context->CopyBuffer(gpu.ValidationCounters, output.Counters, sizeof(gpu.ValidationCounts));
+                    CountVisibleInstances(renderContext, type, gpu.ValidationCounts);
+                    gpu.ValidationFrame = Engine::FrameCount;
+                }
+            }
+        }
+#endif
+    }
+
+    // Submit indirect draw calls for all meshes (each LOD uses a separate range of the instances buffer)
+    for (int32 lod = 0; lod < model->LODs.Count(); lod++)
+    {
+        const auto& meshes = model->LODs[lod].Meshes;
+        for (int32 meshIndex = 0; meshIndex < meshes.Count(); meshIndex++)
+        {
+            const auto material = drawCallsLists[lod][meshIndex].DrawCall.Material;
+            if (!material)
+                continue;
+            const auto& mesh = meshes[meshIndex];
+            const auto& entry = type.Entries[mesh.GetMaterialSlotIndex()];
+            const MaterialSlot& slot = model->MaterialSlots[mesh.GetMaterialSlotIndex()];
+            const auto shadowsMode = static_cast<ShadowsCastingMode>(entry.ShadowsMode & slot.ShadowsMode);
+            const auto drawModes = (DrawPass)(static_cast<DrawPass>(type._drawModes & view.GetShadowsDrawPassMask(shadowsMode)) & material->GetDrawModes());
+
+            // Setup draw call
+            BatchedDrawCall batch;
+            batch.DrawCall.Material = material;
+            mesh.GetDrawCallGeometry(batch.DrawCall);
+            batch.DrawCall.InstanceCount = 0;
+            batch.DrawCall.Draw.IndirectArgsBuffer = output.Args;
+            batch.DrawCall.Draw.IndirectArgsOffset = (lod * gpu.MeshesCount + meshIndex) * sizeof(GPUDrawIndexedIndirectArgs);
+            batch.DrawCall.ObjectPosition = _sphere.Center;
+            batch.DrawCall.PerInstanceRandom = 0.0f;
+            batch.DrawCall.World = Matrix::Identity;
+            batch.DrawCall.Surface.PrevWorld = Matrix::Identity;
+            batch.DrawCall.Surface.Lightmap = nullptr;
+            batch.DrawCall.Surface.LightmapUVsArea = Rectangle::Empty;
+            batch.DrawCall.Surface.LODDitherFactor = 0.0f;
+            batch.DrawCall.Surface.GeometrySize = mesh.GetBox().GetSize();
+            batch.DrawCall.Surface.Skinning = nullptr;
+            batch.DrawCall.WorldDeterminantSign = 1;
+            batch.InstancesBuffer = output.Instances;
+
+            const int32 batchIndex = renderContext.List->BatchedDrawCalls.Count();
+            renderContext.List->BatchedDrawCalls.Add(MoveTemp(batch));
+
+            // Add draw call to proper draw lists
+            if (drawModes & DrawPass::Depth)
+            {
+                renderContext.List->DrawCallsLists[(int32)DrawCallsListType::Depth].PreBatchedDrawCalls.Add(batchIndex);
+            }
+            if (drawModes & DrawPass::GBuffer)
+            {
+                if (entry.ReceiveDecals)
+                    renderContext.List->DrawCallsLists[(int32)DrawCallsListType::GBuffer].PreBatchedDrawCalls.Add(batchIndex);
+                else
+                    renderContext.List->DrawCallsLists[(int32)DrawCallsListType::GBufferNoDecals].PreBatchedDrawCalls.Add(batchIndex);
+            }
+        }
+    }
+
+    return true;
+}
+
+#endif
+
 #else
 
 void Foliage::DrawCluster(RenderContext& renderContext, FoliageCluster* cluster, Mesh::DrawInfo& draw)
@@ -454,6 +1060,10 @@ void Foliage::SetInstanceTransform(int32 index, const Transform& value)
 
     // Change transform
     instance.Transform = value;
+#if FOLIAGE_USE_GPU_CULLING
+    if (_drawCache)
+        _drawCache->SetGPUDirty(instance.Type);
+#endif
 
     // Update world matrix
     Matrix matrix, world;
@@ -587,6 +1197,15 @@ void Foliage::RebuildClusters()
 {
     PROFILE_CPU();
 
+#if !FOLIAGE_USE_SINGLE_QUAD_TREE && FOLIAGE_USE_DRAW_CALLS_BATCHING
+    // Release the cached instances buffers (batches may refer to the old foliage types meshes)
+    if (_drawCache)
+    {
+        Delete(_drawCache);
+        _drawCache = nullptr;
+    }
+#endif
+
     // Faster path if foliage is empty or no types is ready
     bool anyTypeReady = false;
     for (auto& type : FoliageTypes)
@@ -741,6 +1360,10 @@ void Foliage::RebuildClusters()
 void Foliage::UpdateCullDistance()
 {
     PROFILE_CPU();
+#if FOLIAGE_USE_GPU_CULLING
+    if (_drawCache)
+        _drawCache->SetGPUDirty();
+#endif
 
     {
         PROFILE_CPU_NAMED("Instances");
@@ -801,6 +1424,16 @@ void Foliage::SetGlobalDensityScale(float value)
     SceneQuery::TreeExecute(f);
 }
 
+bool Foliage::GetGPUCulling()
+{
+    return UseGPUCulling;
+}
+
+void Foliage::SetGPUCulling(bool value)
+{
+    UseGPUCulling = value;
+}
+
 bool Foliage::Intersects(const Ray& ray, float& distance, Vector3& normal, int32& instanceIndex)
 {
     PROFILE_CPU();
@@ -876,18 +1509,29 @@ void Foliage::Draw(RenderContext& renderContext)
     draw.LODBias = 0;
     draw.ForcedLOD = -1;
     draw.VertexColors = nullptr;
-#else
-    DrawCallsList drawCallsLists[MODEL_MAX_LODS];
 #endif
 #if FOLIAGE_USE_SINGLE_QUAD_TREE
     if (Root)
         DrawCluster(renderContext, Root, draw);
+#elif !FOLIAGE_USE_DRAW_CALLS_BATCHING
+    for (auto& type : FoliageTypes)
+    {
+        if (type.Root && type._canDraw && type.Model->CanBeRendered())
+            DrawCluster(renderContext, type.Root, draw);
+    }
 #else
+    if (!_drawCache)
+        _drawCache = New<DrawCache>();
+    auto& cache = *_drawCache;
+    cache.Jobs.Clear();
+    cache.DrawCallsLists.Resize(FoliageTypes.Count() * MODEL_MAX_LODS);
+    const int32 jobsDepth = Instances.Count() >= FOLIAGE_DRAW_JOBS_MIN_INSTANCES ? FOLIAGE_DRAW_JOBS_DEPTH : 0;
     for (auto& type : FoliageTypes)
     {
         if (type.Root && type._canDraw && type.Model->CanBeRendered())
         {
-#if FOLIAGE_USE_DRAW_CALLS_BATCHING
+            DrawCallsList* drawCallsLists = &cache.DrawCallsLists[type.Index * MODEL_MAX_LODS];
+
             // Initialize draw calls for foliage type all LODs meshes
             for (int32 lod = 0; lod < type.Model->LODs.Count(); lod++)
             {
@@ -928,89 +1572,132 @@ void Foliage::Draw(RenderContext& renderContext)
                 }
             }
 
-            // Draw instances of the foliage type
-            BatchedDrawCalls result;
-            DrawCluster(renderContext, type.Root, type, drawCallsLists, result);
+#if FOLIAGE_USE_GPU_CULLING
+            // Cull and draw the foliage type on the GPU if possible
+            if (UseGPUCulling && DrawGPU(renderContext, type, drawCallsLists))
+                continue;
+#endif
+
+            // Split the foliage type quad-tree into subtrees to cull and draw
+            AddDrawJobs(renderContext, type, type.Root, jobsDepth, false);
+        }
+    }
+
+    // Cull and draw the instances (each job fills own instances buffers)
+    while (cache.Results.Count() < cache.Jobs.Count())
+        cache.Results.Add(New<DrawResult>());
+    Function<void(int32)> job = [this, &renderContext, &cache](int32 index)
+    {
+        const auto& e = cache.Jobs[index];
+        auto& result = *cache.Results[index];
+        result.Reset();
+        DrawCluster(renderContext, e.Cluster, *e.Type, &cache.DrawCallsLists[e.Type->Index * MODEL_MAX_LODS], result, e.Inside);
+    };
+    if (jobsDepth != 0 && cache.Jobs.Count() > 1)
+    {
+        JobSystem::Execute(job, cache.Jobs.Count());
+    }
+    else
+    {
+        for (int32 i = 0; i < cache.Jobs.Count(); i++)
+            job(i);
+    }
 
-            // Submit draw calls with valid instances added
-            for (auto& e : result)
+    // Merge the instances of the foliage type subtrees (jobs are grouped by type) directly into the render list batches
+    auto& batches = renderContext.List->BatchedDrawCalls;
+    for (int32 jobIndex = 0; jobIndex < cache.Jobs.Count();)
+    {
+        FoliageType& type = *cache.Jobs[jobIndex].Type;
+        cache.BatchesLookup.Clear();
+        for (; jobIndex < cache.Jobs.Count() && cache.Jobs[jobIndex].Type == &type; jobIndex++)
+        {
+            for (const auto& batch : cache.Results[jobIndex]->Batches)
             {
-                auto& batch = e.Value;
                 if (batch.Instances.IsEmpty())
                     continue;
-                const auto& mesh = *e.Key.Geo;
-                const auto& entry = type.Entries[mesh.GetMaterialSlotIndex()];
-                const MaterialSlot& slot = type.Model->MaterialSlots[mesh.GetMaterialSlotIndex()];
-                const auto shadowsMode = static_cast<ShadowsCastingMode>(entry.ShadowsMode & slot.ShadowsMode);
-                const auto drawModes = (DrawPass)(static_cast<DrawPass>(type._drawModes & renderContext.View.GetShadowsDrawPassMask(shadowsMode)) & batch.DrawCall.Material->GetDrawModes());
-
-                // Setup draw call
-                mesh.GetDrawCallGeometry(batch.DrawCall);
-                batch.DrawCall.InstanceCount = 1;
-                auto& firstInstance = batch.Instances[0];
-                batch.DrawCall.ObjectPosition = firstInstance.InstanceOrigin;
-                batch.DrawCall.PerInstanceRandom = firstInstance.PerInstanceRandom;
-                auto lightmapArea = firstInstance.InstanceLightmapArea.ToVector4();
-                batch.DrawCall.Surface.LightmapUVsArea = *(Rectangle*)&lightmapArea;
-                batch.DrawCall.Surface.LODDitherFactor = firstInstance.LODDitherFactor;
-                batch.DrawCall.World.SetRow1(Vector4(firstInstance.InstanceTransform1, 0.0f));
-                batch.DrawCall.World.SetRow2(Vector4(firstInstance.InstanceTransform2, 0.0f));
-                batch.DrawCall.World.SetRow3(Vector4(firstInstance.InstanceTransform3, 0.0f));
-                batch.DrawCall.World.SetRow4(Vector4(firstInstance.InstanceOrigin, 1.0f));
-                batch.DrawCall.Surface.PrevWorld = batch.DrawCall.World;
-                batch.DrawCall.Surface.GeometrySize = mesh.GetBox().GetSize();
-                batch.DrawCall.Surface.Skinning = nullptr;
-                batch.DrawCall.WorldDeterminantSign = 1;
-
-                const int32 batchIndex = renderContext.List->BatchedDrawCalls.Count();
-                renderContext.List->BatchedDrawCalls.Add(MoveTemp(batch));
-
-                // Add draw call to proper draw lists
-                if (drawModes & DrawPass::Depth)
-                {
-                    renderContext.List->DrawCallsLists[(int32)DrawCallsListType::Depth].PreBatchedDrawCalls.Add(batchIndex);
-                }
-                if (drawModes & DrawPass::GBuffer)
+                int32 batchIndex;
+                if (!cache.BatchesLookup.TryGet(batch.Key, batchIndex))
                 {
-                    if (entry.ReceiveDecals)
-                        renderContext.List->DrawCallsLists[(int32)DrawCallsListType::GBuffer].PreBatchedDrawCalls.Add(batchIndex);
-                    else
-                        renderContext.List->DrawCallsLists[(int32)DrawCallsListType::GBufferNoDecals].PreBatchedDrawCalls.Add(batchIndex);
-                }
-                if (drawModes & DrawPass::Distortion)
-                {
-                    renderContext.List->DrawCallsLists[(int32)DrawCallsListType::Distortion].PreBatchedDrawCalls.Add(batchIndex);
-                }
-                if (drawModes & DrawPass::MotionVectors && (_staticFlags & StaticFlags::Transform) == 0)
-                {
-                    renderContext.List->DrawCallsLists[(int32)DrawCallsListType::MotionVectors].PreBatchedDrawCalls.Add(batchIndex);
+                    batchIndex = batches.Count();
+                    cache.BatchesLookup.Add(batch.Key, batchIndex);
+                    auto& e = batches.AddOne();
+                    e.DrawCall.Material = batch.Key.Mat;
+                    e.DrawCall.Surface.Lightmap = _staticFlags & StaticFlags::Lightmap ? _scene->LightmapsData.GetReadyLightmap(batch.Key.Lightmap) : nullptr;
                 }
-                if (drawModes & DrawPass::Forward)
+                batches[batchIndex].Instances.Add(batch.Instances);
+            }
+        }
+
+        // Submit draw calls with valid instances added
+        for (const auto& e : cache.BatchesLookup)
+        {
+            const int32 batchIndex = e.Value;
+            auto& batch = batches[batchIndex];
+            const auto& mesh = *e.Key.Geo;
+            const auto& entry = type.Entries[mesh.GetMaterialSlotIndex()];
+            const MaterialSlot& slot = type.Model->MaterialSlots[mesh.GetMaterialSlotIndex()];
+            const auto shadowsMode = static_cast<ShadowsCastingMode>(entry.ShadowsMode & slot.ShadowsMode);
+            const auto drawModes = (DrawPass)(static_cast<DrawPass>(type._drawModes & renderContext.View.GetShadowsDrawPassMask(shadowsMode)) & batch.DrawCall.Material->GetDrawModes());
+
+            // Setup draw call
+            mesh.GetDrawCallGeometry(batch.DrawCall);
+            batch.DrawCall.InstanceCount = 1;
+            auto& firstInstance = batch.Instances[0];
+            batch.DrawCall.ObjectPosition = firstInstance.InstanceOrigin;
+            batch.DrawCall.PerInstanceRandom = firstInstance.PerInstanceRandom;
+            auto lightmapArea = firstInstance.InstanceLightmapArea.ToVector4();
+            batch.DrawCall.Surface.LightmapUVsArea = *(Rectangle*)&lightmapArea;
+            batch.DrawCall.Surface.LODDitherFactor = firstInstance.LODDitherFactor;
+            batch.DrawCall.World.SetRow1(Vector4(firstInstance.InstanceTransform1, 0.0f));
+            batch.DrawCall.World.SetRow2(Vector4(firstInstance.InstanceTransform2, 0.0f));
+            batch.DrawCall.World.SetRow3(Vector4(firstInstance.InstanceTransform3, 0.0f));
+            batch.DrawCall.World.SetRow4(Vector4(firstInstance.InstanceOrigin, 1.0f));
+            batch.DrawCall.Surface.PrevWorld = batch.DrawCall.World;
+            batch.DrawCall.Surface.GeometrySize = mesh.GetBox().GetSize();
+            batch.DrawCall.Surface.Skinning = nullptr;
+            batch.DrawCall.WorldDeterminantSign = 1;
+
+            // Add draw call to proper draw lists
+            if (drawModes & DrawPass::Depth)
+            {
+                renderContext.List->DrawCallsLists[(int32)DrawCallsListType::Depth].PreBatchedDrawCalls.Add(batchIndex);
+            }
+            if (drawModes & DrawPass::GBuffer)
+            {
+                if (entry.ReceiveDecals)
+                    renderContext.List->DrawCallsLists[(int32)DrawCallsListType::GBuffer].PreBatchedDrawCalls.Add(batchIndex);
+                else
+                    renderContext.List->DrawCallsLists[(int32)DrawCallsListType::GBufferNoDecals].PreBatchedDrawCalls.Add(batchIndex);
+            }
+            if (drawModes & DrawPass::Distortion)
+            {
+                renderContext.List->DrawCallsLists[(int32)DrawCallsListType::Distortion].PreBatchedDrawCalls.Add(batchIndex);
+            }
+            if (drawModes & DrawPass::MotionVectors && (_staticFlags & StaticFlags::Transform) == 0)
+            {
+                renderContext.List->DrawCallsLists[(int32)DrawCallsListType::MotionVectors].PreBatchedDrawCalls.Add(batchIndex);
+            }
+            if (drawModes & DrawPass::Forward)
+            {
+                // Transparency requires sorting by depth so convert back the batched draw call into normal draw calls (RenderList impl will handle this)
+                DrawCall drawCall = batch.DrawCall;
+                for (int32 j = 0; j < batch.Instances.Count(); j++)
                 {
-                    // Transparency requires sorting by depth so convert back the batched draw call into normal draw calls (RenderList impl will handle this)
-                    batch = renderContext.List->BatchedDrawCalls[batchIndex];
-                    DrawCall drawCall = batch.DrawCall;
-                    for (int32 j = 0; j < batch.Instances.Count(); j++)
-                    {
-                        auto& instance = batch.Instances[j];
-                        drawCall.ObjectPosition = instance.InstanceOrigin;
-                        drawCall.PerInstanceRandom = instance.PerInstanceRandom;
-                        lightmapArea = instance.InstanceLightmapArea.ToVector4();
-                        drawCall.Surface.LightmapUVsArea = *(Rectangle*)&lightmapArea;
-                        drawCall.Surface.LODDitherFactor = instance.LODDitherFactor;
-                        drawCall.World.SetRow1(Vector4(instance.InstanceTransform1, 0.0f));
-                        drawCall.World.SetRow2(Vector4(instance.InstanceTransform2, 0.0f));
-                        drawCall.World.SetRow3(Vector4(instance.InstanceTransform3, 0.0f));
-                        drawCall.World.SetRow4(Vector4(instance.InstanceOrigin, 1.0f));
-                        const int32 drawCallIndex = renderContext.List->DrawCalls.Count();
-                        renderContext.List->DrawCalls.Add(drawCall);
-                        renderContext.List->DrawCallsLists[(int32)DrawCallsListType::Forward].Indices.Add(drawCallIndex);
-                    }
+                    auto& instance = batch.Instances[j];
+                    drawCall.ObjectPosition = instance.InstanceOrigin;
+                    drawCall.PerInstanceRandom = instance.PerInstanceRandom;
+                    lightmapArea = instance.InstanceLightmapArea.ToVector4();
+                    drawCall.Surface.LightmapUVsArea = *(Rectangle*)&lightmapArea;
+                    drawCall.Surface.LODDitherFactor = instance.LODDitherFactor;
+                    drawCall.World.SetRow1(Vector4(instance.InstanceTransform1, 0.0f));
+                    drawCall.World.SetRow2(Vector4(instance.InstanceTransform2, 0.0f));
+                    drawCall.World.SetRow3(Vector4(instance.InstanceTransform3, 0.0f));
+                    drawCall.World.SetRow4(Vector4(instance.InstanceOrigin, 1.0f));
+                    const int32 drawCallIndex = renderContext.List->DrawCalls.Count();
+                    renderContext.List->DrawCalls.Add(drawCall);
+                    renderContext.List->DrawCallsLists[(int32)DrawCallsListType::Forward].Indices.Add(drawCallIndex);
                 }
             }
-#else
-            DrawCluster(renderContext, type.Root, draw);
-#endif
         }
     }
 #endif
@@ -19,9 +19,18 @@ DECLARE_SCENE_OBJECT(Foliage);
 
     bool _disableFoliageTypeEvents;
     int32 _sceneRenderingKey = -1;
+#if !FOLIAGE_USE_SINGLE_QUAD_TREE && FOLIAGE_USE_DRAW_CALLS_BATCHING
+    struct DrawCache;
+    DrawCache* _drawCache = nullptr;
+#endif
 
 public:
 
+    /// <summary>
+    /// Finalizes an instance of the <see cref="Foliage"/> class.
+    /// </summary>
+    ~Foliage();
+
     /// <summary>
     /// The allocated foliage instances. It's read-only.
     /// </summary>
@@ -149,6 +158,16 @@ DECLARE_SCENE_OBJECT(Foliage);
     /// </summary>
     API_PROPERTY() static void SetGlobalDensityScale(float value);
 
+    /// <summary>
+    /// Gets the value indicating whether foliage is culled and drawn on the GPU (compute shader culls the instances, selects LODs and generates indirect draw calls). Used only if graphics device supports compute shaders and indirect drawing. The default value is false.
+    /// </summary>
+    API_PROPERTY() static bool GetGPUCulling();
+
+    /// <summary>
+    /// Sets the value indicating whether foliage is culled and drawn on the GPU (compute shader culls the instances, selects LODs and generates indirect draw calls). Used only if graphics device supports compute shaders and indirect drawing. The default value is false.
+    /// </summary>
+    API_PROPERTY() static void SetGPUCulling(bool value);
+
 private:
 
     void AddToCluster(ChunkedArray<FoliageCluster, FOLIAGE_CLUSTER_CHUNKS_SIZE>& clusters, FoliageCluster* cluster, FoliageInstance& instance);
@@ -174,9 +193,13 @@ DECLARE_SCENE_OBJECT(Foliage);
     };
 
     typedef Array<struct BatchedDrawCall, InlinedAllocation<8>> DrawCallsList;
-    typedef Dictionary<DrawKey, struct BatchedDrawCall, class RenderListAllocation> BatchedDrawCalls;
-    void DrawInstance(RenderContext& renderContext, FoliageInstance& instance, FoliageType& type, Model* model, int32 lod, float lodDitherFactor, DrawCallsList* drawCallsLists, BatchedDrawCalls& result) const;
-    void DrawCluster(RenderContext& renderContext, FoliageCluster* cluster, FoliageType& type, DrawCallsList* drawCallsLists, BatchedDrawCalls& result) const;
+    struct DrawResult;
+    void AddDrawJobs(RenderContext& renderContext, FoliageType& type, FoliageCluster* cluster, int32 depth, bool inside);
+    void DrawInstance(RenderContext& renderContext, FoliageInstance& instance, FoliageType& type, Model* model, int32 lod, float lodDitherFactor, DrawCallsList* drawCallsLists, DrawResult& result) const;
+    void DrawCluster(RenderContext& renderContext, FoliageCluster* cluster, FoliageType& type, DrawCallsList* drawCallsLists, DrawResult& result, bool inside) const;
+#if FOLIAGE_USE_GPU_CULLING
+    bool DrawGPU(RenderContext& renderContext, FoliageType& type, DrawCallsList* drawCallsLists);
+#endif
 #else
     void DrawCluster(RenderContext& renderContext, FoliageCluster* cluster, Mesh::DrawInfo& draw);
 #endif
@@ -64,12 +64,15 @@ namespace
     }
 }
 
+volatile int32 Actor::_hasDirtyTransforms = 0;
+
 Actor::Actor(const SpawnParams& params)
     : SceneObject(params)
     , _isActive(true)
     , _isActiveInHierarchy(true)
     , _isPrefabRoot(false)
     , _isEnabled(false)
+    , _isTransformDirty(false)
     , _layer(0)
     , _tag(ACTOR_TAG_INVALID)
     , _scene(nullptr)
@@ -79,6 +82,7 @@ Actor::Actor(const SpawnParams& params)
     , _sphere(BoundingSphere::Empty)
     , _box(BoundingBox::Zero)
     , _physicsScene(nullptr)
+    , _transformUpdateIndex(-1)
     , HideFlags(HideFlags::None)
 {
 }
@@ -118,6 +122,29 @@ void Actor::OnDisableInHierarchy()
     OnDisable();
 }
 
+void Actor::ResolveTransform() const
+{
+    // Update the hierarchy of the top-most parent with transform change pending (world transform depends on all parents)
+    Actor* root = nullptr;
+    for (Actor* a = const_cast<Actor*>(this); a; a = a->_parent)
+    {
+        if (a->_isTransformDirty)
+            root = a;
+    }
+    if (!root)
+        return;
+
+    // Pending changes can be resolved only on a main thread (transform changed events are not thread-safe) so other threads must not read the actors modified during the batched update
+    ASSERT(IsInMainThread());
+    root->OnTransformChanged();
+}
+
+void Actor::OnLocalTransformChanged()
+{
+    if (!Level::deferTransformUpdate(this))
+        OnTransformChanged();
+}
+
 bool Actor::IsSubClassOf(const Actor* object, const MClass* klass)
 {
     return object->GetClass()->IsSubClassOf(klass);
@@ -136,6 +163,10 @@ String Actor::ToString() const
 
 void Actor::OnDeleteObject()
 {
+    // Skip pending transform update
+    if (_transformUpdateIndex != -1)
+        Level::cancelTransformUpdate(this);
+
     // Check if actor is still in game (eg. user deletes actor object via Object.Delete)
     if (IsDuringPlay())
     {
@@ -247,7 +278,7 @@ void Actor::SetParent(Actor* value, bool worldPositionsStays, bool canBreakPrefa
 #endif
 
     // Peek the previous state
-    const Transform prevTransform = _transform;
+    const Transform prevTransform = GetTransform();
     const bool wasActiveInTree = IsActiveInHierarchy();
     const auto prevParent = _parent;
     const auto prevScene = _scene;
@@ -474,7 +505,10 @@ void Actor::SetTagIndex(int32 tagIndex)
     if (tagIndex == _tag)
         return;
 
+    const int32 prevTag = _tag;
     _tag = tagIndex;
+    if (IsDuringPlay())
+        Level::updateLookupTag(this, prevTag);
     OnTagChanged();
 }
 
@@ -512,7 +546,10 @@ void Actor::SetName(const StringView& value)
         return;
 
     // Set name
+    const uint32 prevNameHash = GetHash(StringView(_name));
     _name = value;
+    if (IsDuringPlay())
+        Level::updateLookupName(this, prevNameHash);
 
     // Fire events
     if (GetScene())
@@ -562,33 +599,33 @@ void Actor::SetStaticFlags(StaticFlags value)
 void Actor::SetTransform(const Transform& value)
 {
     CHECK(!value.IsNanOrInfinity());
-    if (!Transform::NearEqual(_transform, value))
+    if (!Transform::NearEqual(GetTransform(), value))
     {
         if (_parent)
             _parent->GetTransform().WorldToLocal(value, _localTransform);
         else
             _localTransform = value;
-        OnTransformChanged();
+        OnLocalTransformChanged();
     }
 }
 
 void Actor::SetPosition(const Vector3& value)
 {
     CHECK(!value.IsNanOrInfinity());
-    if (!Vector3::NearEqual(_transform.Translation, value))
+    if (!Vector3::NearEqual(GetPosition(), value))
     {
         if (_parent)
             _localTransform.Translation = _parent->GetTransform().WorldToLocal(value);
         else
             _localTransform.Translation = value;
-        OnTransformChanged();
+        OnLocalTransformChanged();
     }
 }
 
 void Actor::SetOrientation(const Quaternion& value)
 {
     CHECK(!value.IsNanOrInfinity());
-    if (!Quaternion::NearEqual(_transform.Orientation, value))
+    if (!Quaternion::NearEqual(GetOrientation(), value))
     {
         if (_parent)
         {
@@ -601,27 +638,27 @@ void Actor::SetOrientation(const Quaternion& value)
         {
             _localTransform.Orientation = value;
         }
-        OnTransformChanged();
+        OnLocalTransformChanged();
     }
 }
 
 void Actor::SetScale(const Vector3& value)
 {
     CHECK(!value.IsNanOrInfinity());
-    if (!Vector3::NearEqual(_transform.Scale, value))
+    if (!Vector3::NearEqual(GetScale(), value))
     {
         if (_parent)
             Vector3::Divide(value, _parent->GetScale(), _localTransform.Scale);
         else
             _localTransform.Scale = value;
-        OnTransformChanged();
+        OnLocalTransformChanged();
     }
 }
 
 Matrix Actor::GetRotation() const
 {
     Matrix result;
-    Matrix::RotationQuaternion(_transform.Orientation, result);
+    Matrix::RotationQuaternion(GetOrientation(), result);
     return result;
 }
 
@@ -660,7 +697,7 @@ void Actor::SetLocalTransform(const Transform& value)
     if (!Transform::NearEqual(_localTransform, value))
     {
         _localTransform = value;
-        OnTransformChanged();
+        OnLocalTransformChanged();
     }
 }
 
@@ -670,7 +707,7 @@ void Actor::SetLocalPosition(const Vector3& value)
     if (!Vector3::NearEqual(_localTransform.Translation, value))
     {
         _localTransform.Translation = value;
-        OnTransformChanged();
+        OnLocalTransformChanged();
     }
 }
 
@@ -683,7 +720,7 @@ void Actor::SetLocalOrientation(const Quaternion& value)
     if (!Quaternion::NearEqual(_localTransform.Orientation, v))
     {
         _localTransform.Orientation = v;
-        OnTransformChanged();
+        OnLocalTransformChanged();
     }
 }
 
@@ -693,22 +730,23 @@ void Actor::SetLocalScale(const Vector3& value)
     if (!Vector3::NearEqual(_localTransform.Scale, value))
     {
         _localTransform.Scale = value;
-        OnTransformChanged();
+        OnLocalTransformChanged();
     }
 }
 
 void Actor::AddMovement(const Vector3& translation, const Quaternion& rotation)
 {
+    const Transform& transform = GetTransform();
     Transform t;
-    t.Translation = _transform.Translation + translation;
-    t.Orientation = _transform.Orientation * rotation;
-    t.Scale = _transform.Scale;
+    t.Translation = transform.Translation + translation;
+    t.Orientation = transform.Orientation * rotation;
+    t.Scale = transform.Scale;
     SetTransform(t);
 }
 
 void Actor::GetWorldToLocalMatrix(Matrix& worldToLocal) const
 {
-    _transform.GetWorld(worldToLocal);
+    GetTransform().GetWorld(worldToLocal);
     worldToLocal.Invert();
 }
 
@@ -834,6 +872,7 @@ void Actor::BeginPlay(SceneBeginData* data)
 
     // Set flag
     Flags |= ObjectFlags::IsDuringPlay;
+    Level::addToLookup(this);
 
     OnBeginPlay();
 
@@ -891,6 +930,7 @@ void Actor::EndPlay()
 
     // Clear flag
     Flags &= ~ObjectFlags::IsDuringPlay;
+    Level::removeFromLookup(this);
 
     // Call event deeper
     for (int32 i = 0; i < Children.Count(); i++)
@@ -987,6 +1027,8 @@ void Actor::Deserialize(DeserializeStream& stream, ISerializeModifier* modifier)
 {
     // Base
     SceneObject::Deserialize(stream, modifier);
+    const uint32 prevNameHash = GetHash(StringView(_name));
+    const int32 prevTag = _tag;
 
     DESERIALIZE_BIT_MEMBER(IsActive, _isActive);
     DESERIALIZE_MEMBER(StaticFlags, _staticFlags);
@@ -1010,6 +1052,7 @@ void Actor::Deserialize(DeserializeStream& stream, ISerializeModifier* modifier)
                 }
                 else
                 {
+                    ScopeLock lock(SceneObjectsFactory::HierarchyLocker);
                     if (_parent)
                         _parent->Children.RemoveKeepOrder(this);
                     _parent = parent;
@@ -1043,6 +1086,15 @@ void Actor::Deserialize(DeserializeStream& stream, ISerializeModifier* modifier)
         }
     }
 
+    // Keep level lookup tables in sync when modifying actor in game (eg. undo in editor)
+    if (IsDuringPlay())
+    {
+        if (GetHash(StringView(_name)) != prevNameHash)
+            Level::updateLookupName(this, prevNameHash);
+        if (_tag != prevTag)
+            Level::updateLookupTag(this, prevTag);
+    }
+
     {
         const auto member = stream.FindMember("PrefabID");
         if (member != stream.MemberEnd())
@@ -1117,6 +1169,7 @@ void Actor::OnParentChanged()
 void Actor::OnTransformChanged()
 {
     ASSERT_LOW_LAYER(!_localTransform.IsNanOrInfinity());
+    _isTransformDirty = false;
 
     if (_parent)
     {
@@ -1453,26 +1506,27 @@ void Actor::LookAt(const Vector3& worldPos, const Vector3& worldUp)
 
 Quaternion Actor::LookingAt(const Vector3& worldPos) const
 {
-    const Vector3 direction = worldPos - _transform.Translation;
+    const Transform& transform = GetTransform();
+    const Vector3 direction = worldPos - transform.Translation;
     if (direction.LengthSquared() < ZeroTolerance)
         return _parent->GetOrientation();
 
     const Vector3 newForward = Vector3::Normalize(direction);
-    const Vector3 oldForward = _transform.Orientation * Vector3::Forward;
+    const Vector3 oldForward = transform.Orientation * Vector3::Forward;
 
     Quaternion orientation;
     if ((newForward + oldForward).LengthSquared() < 0.00005f)
     {
         // 180 degree turn (infinite possible rotation axes)
         // Default to yaw i.e. use current Up
-        orientation = Quaternion(-_transform.Orientation.Y, -_transform.Orientation.Z, _transform.Orientation.W, _transform.Orientation.X);
+        orientation = Quaternion(-transform.Orientation.Y, -transform.Orientation.Z, transform.Orientation.W, transform.Orientation.X);
     }
     else
     {
         // Derive shortest arc to new direction
         Quaternion rotQuat;
         Quaternion::GetRotationFromTo(oldForward, newForward, rotQuat, Vector3::Zero);
-        orientation = rotQuat * _transform.Orientation;
+        orientation = rotQuat * transform.Orientation;
     }
 
     return orientation;
@@ -1480,7 +1534,8 @@ Quaternion Actor::LookingAt(const Vector3& worldPos) const
 
 Quaternion Actor::LookingAt(const Vector3& worldPos, const Vector3& worldUp) const
 {
-    const Vector3 direction = worldPos - _transform.Translation;
+    const Transform& transform = GetTransform();
+    const Vector3 direction = worldPos - transform.Translation;
     if (direction.LengthSquared() < ZeroTolerance)
         return _parent->GetOrientation();
     const Vector3 forward = Vector3::Normalize(direction);
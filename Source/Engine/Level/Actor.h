@@ -39,6 +39,7 @@ DECLARE_SCENE_OBJECT(Actor);
     int8 _isActiveInHierarchy : 1;
     int8 _isPrefabRoot : 1;
     int8 _isEnabled : 1;
+    int8 _isTransformDirty : 1;
     byte _layer;
     byte _tag;
     Scene* _scene;
@@ -52,6 +53,13 @@ DECLARE_SCENE_OBJECT(Actor);
 
 private:
 
+    // Index of the actor in the pending transform updates list (see Level::BeginTransformUpdate), -1 if not queued
+    int32 _transformUpdateIndex;
+
+    // True if any actor has transformation change pending during the batched transform update
+    // Note: set only by the main thread but read from any thread (aligned 32-bit read is atomic, getters use it as a cheap early-out)
+    static volatile int32 _hasDirtyTransforms;
+
     // Disable copying
     Actor(Actor const&) = delete;
     Actor& operator=(Actor const&) = delete;
@@ -406,6 +414,8 @@ DECLARE_SCENE_OBJECT(Actor);
     API_PROPERTY(Attributes="HideInEditor, NoSerialize")
     FORCE_INLINE const Transform& GetTransform() const
     {
+        if (_hasDirtyTransforms)
+            ResolveTransform();
         return _transform;
     }
 
@@ -421,6 +431,8 @@ DECLARE_SCENE_OBJECT(Actor);
     API_PROPERTY(Attributes="HideInEditor, NoSerialize")
     FORCE_INLINE Vector3 GetPosition() const
     {
+        if (_hasDirtyTransforms)
+            ResolveTransform();
         return _transform.Translation;
     }
 
@@ -436,6 +448,8 @@ DECLARE_SCENE_OBJECT(Actor);
     API_PROPERTY(Attributes="HideInEditor, NoSerialize")
     FORCE_INLINE Quaternion GetOrientation() const
     {
+        if (_hasDirtyTransforms)
+            ResolveTransform();
         return _transform.Orientation;
     }
 
@@ -451,6 +465,8 @@ DECLARE_SCENE_OBJECT(Actor);
     API_PROPERTY(Attributes="HideInEditor, NoSerialize")
     FORCE_INLINE Vector3 GetScale() const
     {
+        if (_hasDirtyTransforms)
+            ResolveTransform();
         return _transform.Scale;
     }
 
@@ -593,6 +609,8 @@ DECLARE_SCENE_OBJECT(Actor);
     /// <param name="localToWorld">The world to local matrix.</param>
     API_FUNCTION() FORCE_INLINE void GetLocalToWorldMatrix(API_PARAM(Out) Matrix& localToWorld) const
     {
+        if (_hasDirtyTransforms)
+            ResolveTransform();
         _transform.GetWorld(localToWorld);
     }
 
@@ -603,6 +621,8 @@ DECLARE_SCENE_OBJECT(Actor);
     /// </summary>
     API_PROPERTY() FORCE_INLINE const BoundingSphere& GetSphere() const
     {
+        if (_hasDirtyTransforms)
+            ResolveTransform();
         return _sphere;
     }
 
@@ -611,6 +631,8 @@ DECLARE_SCENE_OBJECT(Actor);
     /// </summary>
     API_PROPERTY() FORCE_INLINE const BoundingBox& GetBox() const
     {
+        if (_hasDirtyTransforms)
+            ResolveTransform();
         return _box;
     }
 
@@ -986,6 +1008,8 @@ DECLARE_SCENE_OBJECT(Actor);
     void SetSceneInHierarchy(Scene* scene);
     void OnEnableInHierarchy();
     void OnDisableInHierarchy();
+    void ResolveTransform() const;
+    void OnLocalTransformChanged();
 
     // Helper methods used by templates GetChildren/GetScripts to prevent including MClass/Script here
     static bool IsSubClassOf(const Actor* object, const MClass* klass);
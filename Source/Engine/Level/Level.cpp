@@ -8,6 +8,9 @@
 #include "Engine/Content/Content.h"
 #include "Engine/Core/Cache.h"
 #include "Engine/Core/Collections/CollectionPoolCache.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Core/Collections/HashSet.h"
+#include "Engine/Core/Collections/Sorting.h"
 #include "Engine/Core/ObjectsRemovalService.h"
 #include "Engine/Core/Config/LayersTagsSettings.h"
 #include "Engine/Core/Types/LayersMask.h"
@@ -17,8 +20,10 @@
 #include "Engine/Debug/Exceptions/JsonParseException.h"
 #include "Engine/Engine/EngineService.h"
 #include "Engine/Threading/Threading.h"
+#include "Engine/Threading/JobSystem.h"
 #include "Engine/Platform/File.h"
 #include "Engine/Platform/FileSystem.h"
+#include "Engine/Platform/CPUInfo.h"
 #include "Engine/Profiler/ProfilerCPU.h"
 #include "Engine/Scripting/Script.h"
 #include "Engine/Engine/Time.h"
@@ -28,6 +33,7 @@
 #include "Engine/Scripting/MException.h"
 #include "Engine/Scripting/Scripting.h"
 #include "Engine/Scripting/BinaryModule.h"
+#include "Engine/Serialization/JsonBinary.h"
 #include "Engine/Serialization/JsonTools.h"
 #include "Engine/Serialization/Serialization.h"
 #include "Engine/Serialization/JsonWriters.h"
@@ -39,6 +45,15 @@
 #include "Engine/Serialization/JsonSerializer.h"
 #endif
 
+// Minimum amount of objects in a scene to deserialize it on multiple threads at once
+#define LEVEL_LOAD_ASYNC_MIN_OBJECTS 1024
+// Amount of scene objects deserialized by a single job
+#define LEVEL_LOAD_ASYNC_BATCH_SIZE 128
+// Amount of jobs executed at once per CPU core (when loading scene over multiple frames the time budget is checked between the executions)
+#define LEVEL_LOAD_ASYNC_BATCHES_PER_CORE 2
+// Amount of scene objects processed between the time budget checks (when loading scene over multiple frames)
+#define LEVEL_LOAD_TIME_CHECK_INTERVAL 8
+
 bool LayersMask::HasLayer(const StringView& layerName) const
 {
     return HasLayer(Level::GetLayerIndex(layerName));
@@ -69,10 +84,16 @@ class SceneAction
         return true;
     }
 
-    virtual bool Do() const
+    virtual bool Do()
     {
         return true;
     }
+
+    // Returns true if action has not been finished and it should be continued in the next frame (eg. time-sliced scene loading).
+    virtual bool IsInProgress() const
+    {
+        return false;
+    }
 };
 
 #if USE_EDITOR
@@ -91,6 +112,56 @@ namespace LevelImpl
     Array<SceneAction*> _sceneActions;
     CriticalSection _sceneActionsLocker;
     DateTime _lastSceneLoadTime(0);
+    int32 _transformUpdateCounter = 0;
+    Array<Actor*> _transformUpdateActors;
+
+    // Lookup tables of the actors and scripts in the loaded scenes (updated on begin/end play, rename and tag change)
+    CriticalSection _lookupLocker;
+    Dictionary<uint32, HashSet<Actor*>> _actorsByName; // Key is the name hash
+    Dictionary<const MClass*, HashSet<Actor*>> _actorsByType;
+    Dictionary<const MClass*, HashSet<Script*>> _scriptsByType;
+    Array<HashSet<Actor*>> _actorsByTag;
+
+    bool IsInLoadedScene(const Actor* actor)
+    {
+        const Scene* scene = actor ? actor->GetScene() : nullptr;
+        ScopeLock lock(Level::ScenesLock);
+        return scene && Level::Scenes.Contains(const_cast<Scene*>(scene));
+    }
+
+    // Checks if the actor goes before the other one in the scenes hierarchy (order of the depth-first scenes traversal). Scenes list has to be locked.
+    bool IsActorBefore(Actor* const& a, Actor* const& b)
+    {
+        if (a == b)
+            return false;
+        Array<Actor*, InlinedAllocation<32>> pathA, pathB;
+        for (Actor* e = a; e; e = e->GetParent())
+            pathA.Add(e);
+        for (Actor* e = b; e; e = e->GetParent())
+            pathB.Add(e);
+        if (pathA.Last() != pathB.Last())
+            return Level::Scenes.Find(pathA.Last()->GetScene()) < Level::Scenes.Find(pathB.Last()->GetScene());
+
+        // Compare the order of the first different ancestors (parent goes before its children)
+        int32 i = pathA.Count() - 1, j = pathB.Count() - 1;
+        while (i >= 0 && j >= 0 && pathA[i] == pathB[j])
+        {
+            i--;
+            j--;
+        }
+        if (i < 0)
+            return true;
+        if (j < 0)
+            return false;
+        return pathA[i]->GetOrderInParent() < pathB[j]->GetOrderInParent();
+    }
+
+    bool IsScriptBefore(Script* const& a, Script* const& b)
+    {
+        if (a->GetParent() != b->GetParent())
+            return IsActorBefore(a->GetParent(), b->GetParent());
+        return a->GetOrderInParent() < b->GetOrderInParent();
+    }
 #if USE_EDITOR
     Array<ScriptsReloadObject> ScriptsReloadObjects;
 #endif
@@ -128,7 +199,10 @@ class LevelService : public EngineService
 LevelService LevelServiceInstanceService;
 
 CriticalSection Level::ScenesLock;
+CriticalSection TagsLocker;
 Array<Scene*> Level::Scenes;
+float Level::SceneLoadingTimeBudget = 0.0f;
+bool Level::DeferTransformUpdates = false;
 Delegate<Actor*> Level::ActorSpawned;
 Delegate<Actor*> Level::ActorDeleted;
 Delegate<Actor*, Actor*> Level::ActorParentChanged;
@@ -221,6 +295,25 @@ void LayersAndTagsSettings::Apply()
     }
 }
 
+// Batches the actors transform changes done by the scripts during the tick (see Level::DeferTransformUpdates)
+struct ScopeTickTransformUpdate
+{
+    bool Enabled;
+
+    ScopeTickTransformUpdate()
+        : Enabled(Level::DeferTransformUpdates)
+    {
+        if (Enabled)
+            Level::BeginTransformUpdate();
+    }
+
+    ~ScopeTickTransformUpdate()
+    {
+        if (Enabled)
+            Level::EndTransformUpdate();
+    }
+};
+
 void LevelService::Update()
 {
     PROFILE_CPU_NAMED("Level::Update");
@@ -231,6 +324,7 @@ void LevelService::Update()
     // Update all actors
     if (!Time::GetGamePaused())
     {
+        ScopeTickTransformUpdate transformUpdate;
         for (int32 i = 0; i < scenes.Count(); i++)
         {
             if (scenes[i]->GetIsActive())
@@ -260,6 +354,7 @@ void LevelService::LateUpdate()
     // Update all actors
     if (!Time::GetGamePaused())
     {
+        ScopeTickTransformUpdate transformUpdate;
         for (int32 i = 0; i < scenes.Count(); i++)
         {
             if (scenes[i]->GetIsActive())
@@ -292,6 +387,7 @@ void LevelService::FixedUpdate()
     // Update all actors
     if (!Time::GetGamePaused())
     {
+        ScopeTickTransformUpdate transformUpdate;
         for (int32 i = 0; i < scenes.Count(); i++)
         {
             if (scenes[i]->GetIsActive())
@@ -315,6 +411,11 @@ void LevelService::Dispose()
 {
     ScopeLock lock(_sceneActionsLocker);
 
+    // Cancel pending actions (eg. scene that is during loading)
+    for (SceneAction* action : _sceneActions)
+        Delete(action);
+    _sceneActions.Clear();
+
     // Unload scenes
     unloadScenes();
 
@@ -396,12 +497,80 @@ void Level::CollectPostFxVolumes(RenderContext& renderContext)
     }
 }
 
+// Checks if the scene object has to be deserialized on a main thread. C# and Visual Script objects data is deserialized by the scripting backends which are not thread-safe.
+FORCE_INLINE bool IsMainThreadDeserialize(const SceneObject* obj)
+{
+    return (obj->Flags & (ObjectFlags::IsManagedType | ObjectFlags::IsCustomScriptingType)) != 0;
+}
+
+// Resumable scene loading state machine. Loads the whole scene within a single call or spreads the main thread work over multiple frames (time-sliced).
+class SceneLoader
+{
+public:
+
+    enum class Stages
+    {
+        Begin,
+        Spawn,
+        SetupPrefabs,
+        Deserialize,
+        SyncPrefabs,
+        PostLoad,
+        BeginPlay,
+        Loaded,
+        Error,
+    };
+
+    Stages Stage = Stages::Begin;
+    float TimeBudget;
+    int32 EngineBuild;
+    int32 ObjectsCount = 0;
+    int32 StageIndex = 0;
+    int32 JobsCount = 0;
+    Guid SceneId;
+    Scene* TargetScene = nullptr;
+    DateTime StartTime;
+    rapidjson_flax::Value& Data;
+    CollectionPoolCache<ISerializeModifier, Cache::ISerializeModifierClearCallback>::ScopeCache Modifier;
+    CollectionPoolCache<ActorsCache::SceneObjectsListType>::ScopeCache SceneObjects;
+    SceneObjectsFactory::Context Context;
+    SceneObjectsFactory::PrefabSyncData* PrefabSyncData = nullptr;
+
+    SceneLoader(rapidjson_flax::Value& data, int32 engineBuild, float timeBudget);
+    ~SceneLoader();
+
+    FORCE_INLINE bool IsDone() const
+    {
+        return Stage == Stages::Loaded || Stage == Stages::Error;
+    }
+
+    // Gets the loading progress (normalized to range 0-1).
+    float GetProgress() const;
+
+    // Performs the loading work (limited by the time budget). Returns true if loading has been finished (check Stage for the result), otherwise false if it should be continued later.
+    bool Tick();
+
+private:
+
+    void OnBegin();
+    void OnSpawn(double endTime);
+    void OnSetupPrefabs();
+    void OnDeserialize(double endTime);
+    void OnDeserializeDone();
+    void OnSyncPrefabs();
+    void OnPostLoad(double endTime);
+    void OnBeginPlay();
+};
+
 class LoadSceneAction : public SceneAction
 {
 public:
 
     Guid SceneId;
     AssetReference<JsonAsset> SceneAsset;
+    SceneLoader* Loader = nullptr;
+    ISerializable::SerializeDocument SceneData;
+    rapidjson_flax::Value* SceneDataNode = nullptr;
 
     LoadSceneAction(const Guid& sceneId, JsonAsset* sceneAsset)
     {
@@ -409,26 +578,58 @@ class LoadSceneAction : public SceneAction
         SceneAsset = sceneAsset;
     }
 
+    ~LoadSceneAction()
+    {
+        if (Loader)
+            Delete(Loader);
+
+        // Give the scene data back to the asset unless it has been reloaded in the meantime
+        if (SceneDataNode && SceneAsset && SceneAsset->Data == SceneDataNode && SceneAsset->Document.IsNull())
+            SceneAsset->Document.Swap(SceneData);
+    }
+
     bool CanDo() const override
     {
         return SceneAsset == nullptr || SceneAsset->IsLoaded();
     }
 
-    bool Do() const override
+    bool Do() override
     {
-        // Now to deserialize scene in a proper way we need to load scripting
-        if (!Scripting::IsEveryAssemblyLoaded())
+        if (!Loader)
         {
-            LOG(Error, "Scripts must be compiled without any errors in order to load a scene.");
+            // Now to deserialize scene in a proper way we need to load scripting
+            if (!Scripting::IsEveryAssemblyLoaded())
+            {
+                LOG(Error, "Scripts must be compiled without any errors in order to load a scene.");
 #if USE_EDITOR
-            Platform::Error(TEXT("Scripts must be compiled without any errors in order to load a scene. Please fix it."));
+                Platform::Error(TEXT("Scripts must be compiled without any errors in order to load a scene. Please fix it."));
 #endif
-            CallSceneEvent(SceneEventType::OnSceneLoadError, nullptr, SceneId);
-            return true;
+                CallSceneEvent(SceneEventType::OnSceneLoadError, nullptr, SceneId);
+                return true;
+            }
+
+            if (SceneAsset == nullptr || SceneAsset->WaitForLoaded())
+            {
+                LOG(Error, "Cannot load scene asset.");
+                CallSceneEvent(SceneEventType::OnSceneLoadError, nullptr, SceneId);
+                return true;
+            }
+            const float timeBudget = Math::Max(Level::SceneLoadingTimeBudget, 0.0f);
+            rapidjson_flax::Value* data = SceneAsset->Data;
+            if (timeBudget > 0.0f)
+            {
+                // Loading over multiple frames takes the ownership of the asset document (asset can be reloaded in the meantime which would release the data)
+                // Data node memory stays in place (it's owned by the document allocator) so the asset data remains readable until loading ends
+                SceneData.Swap(SceneAsset->Document);
+                SceneDataNode = data;
+            }
+            Loader = New<SceneLoader>(*data, SceneAsset->DataEngineBuild, timeBudget);
         }
 
-        // Load scene
-        if (Level::loadScene(SceneAsset.Get()))
+        // Load scene (continued in the next frame if runs out of the time budget)
+        if (!Loader->Tick())
+            return false;
+        if (Loader->Stage == SceneLoader::Stages::Error)
         {
             LOG(Error, "Failed to deserialize scene {0}", SceneId);
             CallSceneEvent(SceneEventType::OnSceneLoadError, nullptr, SceneId);
@@ -437,6 +638,11 @@ class LoadSceneAction : public SceneAction
 
         return false;
     }
+
+    bool IsInProgress() const override
+    {
+        return Loader && !Loader->IsDone();
+    }
 };
 
 class UnloadSceneAction : public SceneAction
@@ -450,7 +656,7 @@ class UnloadSceneAction : public SceneAction
         TargetScene = scene->GetID();
     }
 
-    bool Do() const override
+    bool Do() override
     {
         auto scene = Scripting::FindObject<Scene>(TargetScene);
         if (!scene)
@@ -467,7 +673,7 @@ class UnloadScenesAction : public SceneAction
     {
     }
 
-    bool Do() const override
+    bool Do() override
     {
         return unloadScenes();
     }
@@ -486,7 +692,7 @@ class SaveSceneAction : public SceneAction
         PrettyJson = prettyJson;
     }
 
-    bool Do() const override
+    bool Do() override
     {
         if (saveScene(TargetScene))
         {
@@ -507,7 +713,7 @@ class ReloadScriptsAction : public SceneAction
     {
     }
 
-    bool Do() const override
+    bool Do() override
     {
         // Reloading scripts workflow:
         // - save scenes (to temporary files)
@@ -663,7 +869,7 @@ class SpawnActorAction : public SceneAction
     {
     }
 
-    bool Do() const override
+    bool Do() override
     {
         return spawnActor(TargetActor, ParentActor);
     }
@@ -680,7 +886,7 @@ class DeleteActorAction : public SceneAction
     {
     }
 
-    bool Do() const override
+    bool Do() override
     {
         return deleteActor(TargetActor);
     }
@@ -725,6 +931,8 @@ void LevelImpl::CallSceneEvent(SceneEventType eventType, Scene* scene, Guid scen
 
 int32 Level::GetOrAddTag(const StringView& tag)
 {
+    // Tags can be resolved during scene objects deserialization from multiple threads
+    ScopeLock lock(TagsLocker);
     int32 index = Tags.Find(tag);
     if (index == INVALID_INDEX)
     {
@@ -795,8 +1003,12 @@ void LevelImpl::flushActions()
 
     while (_sceneActions.HasItems() && _sceneActions.First()->CanDo())
     {
-        const auto action = _sceneActions.Dequeue();
+        // Actions are executed in order so the ones after the action that is in progress have to wait for it
+        const auto action = _sceneActions.First();
         action->Do();
+        if (action->IsInProgress())
+            break;
+        _sceneActions.RemoveAtKeepOrder(0);
         Delete(action);
     }
 }
@@ -895,16 +1107,24 @@ bool Level::loadScene(const BytesContainer& sceneData, Scene** outScene)
         return true;
     }
 
-    // Parse scene JSON file
+    // Parse scene JSON file (cooked scenes use binary format)
     rapidjson_flax::Document document;
+    if (JsonBinary::IsBinary(sceneData.Get(), sceneData.Length()))
     {
-        PROFILE_CPU_NAMED("Json.Parse");
-        document.Parse(sceneData.Get<char>(), sceneData.Length());
+        if (JsonBinary::Read(sceneData.Get(), sceneData.Length(), document))
+            return true;
     }
-    if (document.HasParseError())
+    else
     {
-        Log::JsonParseException(document.GetParseError(), document.GetErrorOffset());
-        return true;
+        {
+            PROFILE_CPU_NAMED("Json.Parse");
+            document.Parse(sceneData.Get<char>(), sceneData.Length());
+        }
+        if (document.HasParseError())
+        {
+            Log::JsonParseException(document.GetParseError(), document.GetErrorOffset());
+            return true;
+        }
     }
 
     return loadScene(document, outScene);
@@ -922,16 +1142,103 @@ bool Level::loadScene(rapidjson_flax::Document& document, Scene** outScene)
     return loadScene(data->value, saveEngineBuild, outScene);
 }
 
-bool Level::loadScene(rapidjson_flax::Value& data, int32 engineBuild, Scene** outScene)
+SceneLoader::SceneLoader(rapidjson_flax::Value& data, int32 engineBuild, float timeBudget)
+    : TimeBudget(timeBudget)
+    , EngineBuild(engineBuild)
+    , Data(data)
+    , Modifier(Cache::ISerializeModifier.Get())
+    , SceneObjects(ActorsCache::SceneObjectsListCache.Get())
+    , Context(Modifier.Value)
+{
+    Modifier->EngineBuild = engineBuild;
+}
+
+SceneLoader::~SceneLoader()
+{
+    if (Stage != Stages::Loaded && Stage != Stages::Error && TargetScene)
+    {
+        // Loading has been canceled so cleanup the partially loaded scene (linked objects are removed with their parents)
+        for (int32 i = 1; i < SceneObjects->Count(); i++)
+        {
+            SceneObject* obj = SceneObjects->At(i);
+            if (obj && obj->GetParent() == nullptr)
+                obj->DeleteObject();
+        }
+        TargetScene->DeleteObject();
+    }
+    if (PrefabSyncData)
+        Delete(PrefabSyncData);
+}
+
+float SceneLoader::GetProgress() const
+{
+    const float objectsCount = (float)Math::Max(ObjectsCount, 1);
+    switch (Stage)
+    {
+    case Stages::Begin:
+        return 0.0f;
+    case Stages::Spawn:
+        return 0.2f * (float)StageIndex / objectsCount;
+    case Stages::SetupPrefabs:
+        return 0.2f;
+    case Stages::Deserialize:
+        if (JobsCount != 0)
+            return 0.2f + 0.6f * (float)StageIndex / (float)JobsCount;
+        return 0.2f + 0.6f * (float)StageIndex / objectsCount;
+    case Stages::SyncPrefabs:
+        return 0.8f;
+    case Stages::PostLoad:
+        return 0.8f + 0.15f * (float)StageIndex / (float)Math::Max(SceneObjects->Count(), 1);
+    case Stages::BeginPlay:
+        return 0.95f;
+    default:
+        return 1.0f;
+    }
+}
+
+bool SceneLoader::Tick()
 {
     PROFILE_CPU_NAMED("Level.LoadScene");
 
-    if (outScene)
-        *outScene = nullptr;
+    const double endTime = TimeBudget > 0.0f ? Platform::GetTimeSeconds() + TimeBudget * 0.001 : MAX_double;
+    while (Stage != Stages::Loaded && Stage != Stages::Error)
+    {
+        switch (Stage)
+        {
+        case Stages::Begin:
+            OnBegin();
+            break;
+        case Stages::Spawn:
+            OnSpawn(endTime);
+            break;
+        case Stages::SetupPrefabs:
+            OnSetupPrefabs();
+            break;
+        case Stages::Deserialize:
+            OnDeserialize(endTime);
+            break;
+        case Stages::SyncPrefabs:
+            OnSyncPrefabs();
+            break;
+        case Stages::PostLoad:
+            OnPostLoad(endTime);
+            break;
+        case Stages::BeginPlay:
+            OnBeginPlay();
+            break;
+        }
+        if (Stage != Stages::Loaded && Stage != Stages::Error && Platform::GetTimeSeconds() >= endTime)
+            return false;
+    }
+    return true;
+}
 
+void SceneLoader::OnBegin()
+{
     LOG(Info, "Loading scene...");
-    const DateTime startTime = DateTime::NowUTC();
-    _lastSceneLoadTime = startTime;
+    StartTime = DateTime::NowUTC();
+    _lastSceneLoadTime = StartTime;
+    Stage = Stages::Error;
 
     // Here whole scripting backend should be loaded for current project
     // Later scripts will setup attached scripts and restore initial vars
@@ -942,122 +1249,217 @@ bool Level::loadScene(rapidjson_flax::Value& data, int32 engineBuild, Scene** ou
         if (!CommandLine::Options.Headless.IsTrue())
             MessageBox::Show(TEXT("Cannot load scene without game script modules. Please fix the compilation issues. See logs for more info."), TEXT("Missing game modules"), MessageBoxButtons::OK, MessageBoxIcon::Error);
 #endif
-        return true;
+        return;
     }
 
     // Peek meta
-    if (engineBuild < 6000)
+    if (EngineBuild < 6000)
     {
         LOG(Error, "Invalid serialized engine build.");
-        return true;
+        return;
     }
-    if (!data.IsArray())
+    if (!Data.IsArray())
     {
         LOG(Error, "Invalid Data member.");
-        return true;
+        return;
     }
-    int32 objectsCount = data.Size();
+    ObjectsCount = Data.Size();
 
     // Peek scene node value (it's the first actor serialized)
-    auto& sceneValue = data[0];
-    auto sceneId = JsonTools::GetGuid(sceneValue, "ID");
-    if (!sceneId.IsValid())
+    auto& sceneValue = Data[0];
+    SceneId = JsonTools::GetGuid(sceneValue, "ID");
+    if (!SceneId.IsValid())
     {
         LOG(Error, "Invalid scene id.");
-        return true;
+        return;
     }
-    auto modifier = Cache::ISerializeModifier.Get();
-    modifier->EngineBuild = engineBuild;
 
     // Skip is that scene is already loaded
-    if (FindScene(sceneId) != nullptr)
+    if (Level::FindScene(SceneId) != nullptr)
     {
-        LOG(Info, "Scene {0} is already loaded.", sceneId);
-        return false;
+        LOG(Info, "Scene {0} is already loaded.", SceneId);
+        Stage = Stages::Loaded;
+        return;
     }
 
     // Create scene actor
     // Note: the first object in the scene file data is a Scene Actor
-    auto scene = New<Scene>(ScriptingObjectSpawnParams(sceneId, Scene::TypeInitializer));
-    scene->LoadTime = startTime;
-    scene->RegisterObject();
-    scene->Deserialize(sceneValue, modifier.Value);
+    TargetScene = New<Scene>(ScriptingObjectSpawnParams(SceneId, Scene::TypeInitializer));
+    TargetScene->LoadTime = StartTime;
+    TargetScene->RegisterObject();
+    TargetScene->Deserialize(sceneValue, Modifier.Value);
 
     // Fire event
-    CallSceneEvent(SceneEventType::OnSceneLoading, scene, sceneId);
+    CallSceneEvent(SceneEventType::OnSceneLoading, TargetScene, SceneId);
 
     // Loaded scene objects list
-    CollectionPoolCache<ActorsCache::SceneObjectsListType>::ScopeCache sceneObjects = ActorsCache::SceneObjectsListCache.Get();
-    sceneObjects->Resize(objectsCount);
-    sceneObjects->At(0) = scene;
+    SceneObjects->Resize(ObjectsCount);
+    SceneObjects->At(0) = TargetScene;
+    Stage = Stages::Spawn;
+    StageIndex = 1; // start from 1. at index [0] was scene
+}
 
-    SceneObjectsFactory::Context context(modifier.Value);
-    {
-        PROFILE_CPU_NAMED("Spawn");
+void SceneLoader::OnSpawn(double endTime)
+{
+    PROFILE_CPU_NAMED("Spawn");
 
-        // Spawn all scene objects
-        for (int32 i = 1; i < objectsCount; i++) // start from 1. at index [0] was scene
-        {
-            auto& stream = data[i];
-            auto obj = SceneObjectsFactory::Spawn(context, stream);
-            sceneObjects->At(i) = obj;
-            if (obj)
-                obj->RegisterObject();
-            else
-                SceneObjectsFactory::HandleObjectDeserializationError(stream);
-        }
+    // Spawn all scene objects
+    for (; StageIndex < ObjectsCount; StageIndex++)
+    {
+        if ((StageIndex % LEVEL_LOAD_TIME_CHECK_INTERVAL) == 0 && Platform::GetTimeSeconds() >= endTime)
+            return;
+        auto& stream = Data[StageIndex];
+        auto obj = SceneObjectsFactory::Spawn(Context, stream);
+        SceneObjects->At(StageIndex) = obj;
+        if (obj)
+            obj->RegisterObject();
+        else
+            SceneObjectsFactory::HandleObjectDeserializationError(stream);
     }
+    Stage = Stages::SetupPrefabs;
+}
 
-    SceneObjectsFactory::PrefabSyncData prefabSyncData(*sceneObjects.Value, data, modifier.Value);
+void SceneLoader::OnSetupPrefabs()
+{
+    PrefabSyncData = New<SceneObjectsFactory::PrefabSyncData>(*SceneObjects.Value, Data, Modifier.Value);
 
-    SceneObjectsFactory::SetupPrefabInstances(context, prefabSyncData);
+    SceneObjectsFactory::SetupPrefabInstances(Context, *PrefabSyncData);
 
     // TODO: resave and force sync scenes during game cooking so this step could be skipped in game
-    SceneObjectsFactory::SynchronizeNewPrefabInstances(context, prefabSyncData);
+    SceneObjectsFactory::SynchronizeNewPrefabInstances(Context, *PrefabSyncData);
+
+    Stage = Stages::Deserialize;
+    StageIndex = 1; // start from 1. at index [0] was scene
+    if (ObjectsCount >= LEVEL_LOAD_ASYNC_MIN_OBJECTS)
+    {
+        // Deserialize in batches using Job System (each thread uses own ids mapping table for prefab instances)
+        Context.Async = true;
+        JobsCount = Math::DivideAndRoundUp(ObjectsCount - 1, LEVEL_LOAD_ASYNC_BATCH_SIZE);
+        StageIndex = 0;
+    }
+}
 
-    // /\ all above this has to be done on an any thread
-    // \/ all below this has to be done on multiple threads at once
+void SceneLoader::OnDeserialize(double endTime)
+{
+    PROFILE_CPU_NAMED("Deserialize");
 
+    if (JobsCount != 0)
     {
-        PROFILE_CPU_NAMED("Deserialize");
+        // Execute a limited amount of batches at once so all jobs are done before returning (jobs never stay in flight over frames)
+        // Note: StageIndex is the first batch of the current execution (it's updated after all jobs are done)
+        Function<void(int32)> job = [this](int32 jobIndex)
+        {
+            PROFILE_CPU_NAMED("Deserialize Batch");
+            const int32 start = 1 + (StageIndex + jobIndex) * LEVEL_LOAD_ASYNC_BATCH_SIZE; // start from 1. at index [0] was scene
+            const int32 end = Math::Min(start + LEVEL_LOAD_ASYNC_BATCH_SIZE, ObjectsCount);
+            Scripting::ObjectsLookupIdMapping.Set(&Context.GetThreadContext().Modifier->IdsMapping);
+            for (int32 i = start; i < end; i++)
+            {
+                auto& objData = Data[i];
+                auto obj = SceneObjects->At(i);
+                if (obj && !IsMainThreadDeserialize(obj))
+                    SceneObjectsFactory::Deserialize(Context, obj, objData);
+            }
+            Scripting::ObjectsLookupIdMapping.Set(nullptr);
+        };
+        const int32 batchesPerExecute = TimeBudget > 0.0f ? Math::Max((int32)Platform::GetCPUInfo().ProcessorCoreCount, 1) * LEVEL_LOAD_ASYNC_BATCHES_PER_CORE : JobsCount;
+        while (StageIndex < JobsCount)
+        {
+            const int32 count = Math::Min(JobsCount - StageIndex, batchesPerExecute);
+            JobSystem::Execute(job, count);
+            StageIndex += count;
+            if (StageIndex < JobsCount && Platform::GetTimeSeconds() >= endTime)
+                return;
+        }
+        OnDeserializeDone();
+        return;
+    }
 
-        // TODO: at this point we would probably spawn a few thread pool tasks which will load deserialize scene object but only if scene is big enough
+    // Load all scene objects
+    Scripting::ObjectsLookupIdMapping.Set(&Modifier->IdsMapping);
+    for (; StageIndex < ObjectsCount; StageIndex++)
+    {
+        if ((StageIndex % LEVEL_LOAD_TIME_CHECK_INTERVAL) == 0 && Platform::GetTimeSeconds() >= endTime)
+            break;
+        auto& objData = Data[StageIndex];
+        auto obj = SceneObjects->At(StageIndex);
+        if (obj)
+            SceneObjectsFactory::Deserialize(Context, obj, objData);
+    }
+    Scripting::ObjectsLookupIdMapping.Set(nullptr);
+    if (StageIndex == ObjectsCount)
+        Stage = Stages::SyncPrefabs;
+}
 
-        // Load all scene objects
-        Scripting::ObjectsLookupIdMapping.Set(&modifier.Value->IdsMapping);
-        for (int32 i = 1; i < objectsCount; i++) // start from 1. at index [0] was scene
+void SceneLoader::OnDeserializeDone()
+{
+    PROFILE_CPU_NAMED("Deserialize");
+
+    // Deserialize objects skipped by the jobs
+    Scripting::ObjectsLookupIdMapping.Set(&Context.GetThreadContext().Modifier->IdsMapping);
+    for (int32 i = 1; i < ObjectsCount; i++)
+    {
+        auto obj = SceneObjects->At(i);
+        if (obj && IsMainThreadDeserialize(obj))
+            SceneObjectsFactory::Deserialize(Context, obj, Data[i]);
+    }
+    Scripting::ObjectsLookupIdMapping.Set(nullptr);
+    Context.Async = false;
+
+    // Objects are linked to parents in random order so restore the children order (as serialized)
+    // Note: hierarchy is empty before deserialization so linking in order of data matches the single-threaded loading
+    for (int32 i = 0; i < SceneObjects->Count(); i++)
+    {
+        Actor* actor = dynamic_cast<Actor*>(SceneObjects->At(i));
+        if (actor)
         {
-            auto& objData = data[i];
-            auto obj = sceneObjects->At(i);
-            if (obj)
-                SceneObjectsFactory::Deserialize(context, obj, objData);
+            actor->Children.Clear();
+            actor->Scripts.Clear();
         }
-        Scripting::ObjectsLookupIdMapping.Set(nullptr);
+    }
+    for (int32 i = 1; i < ObjectsCount; i++)
+    {
+        SceneObject* obj = SceneObjects->At(i);
+        Actor* parent = obj ? obj->GetParent() : nullptr;
+        if (!parent)
+            continue;
+        if (Actor* actor = dynamic_cast<Actor*>(obj))
+            parent->Children.Add(actor);
+        else if (Script* script = dynamic_cast<Script*>(obj))
+            parent->Scripts.Add(script);
     }
 
-    // /\ all above this has to be done on multiple threads at once
-    // \/ all below this has to be done on an any thread
+    Stage = Stages::SyncPrefabs;
+}
 
+void SceneLoader::OnSyncPrefabs()
+{
     // Synchronize prefab instances (prefab may have objects removed or reordered so deserialized instances need to synchronize with it)
     // TODO: resave and force sync scenes during game cooking so this step could be skipped in game
-    SceneObjectsFactory::SynchronizePrefabInstances(context, prefabSyncData);
+    SceneObjectsFactory::SynchronizePrefabInstances(Context, *PrefabSyncData);
+
+    Stage = Stages::PostLoad;
+    StageIndex = 0;
+}
+
+void SceneLoader::OnPostLoad(double endTime)
+{
+    PROFILE_CPU_NAMED("Post Load");
 
     // Call post load event to connect all scene actors
+    for (; StageIndex < SceneObjects->Count(); StageIndex++)
     {
-        PROFILE_CPU_NAMED("Post Load");
-
-        for (int32 i = 0; i < sceneObjects->Count(); i++)
-        {
-            SceneObject* obj = sceneObjects->At(i);
-            if (obj)
-                obj->PostLoad();
-        }
+        if ((StageIndex % LEVEL_LOAD_TIME_CHECK_INTERVAL) == 0 && Platform::GetTimeSeconds() >= endTime)
+            return;
+        SceneObject* obj = SceneObjects->At(StageIndex);
+        if (obj)
+            obj->PostLoad();
     }
 
     // Delete objects without parent
-    for (int32 i = 1; i < objectsCount; i++)
+    for (int32 i = 1; i < ObjectsCount; i++)
     {
-        SceneObject* obj = sceneObjects->At(i);
+        SceneObject* obj = SceneObjects->At(i);
         if (obj && obj->GetParent() == nullptr)
         {
             LOG(Warning, "Scene object {0} {1} has missing parent object after load. Removing it.", obj->GetID(), obj->ToString());
@@ -1065,33 +1467,50 @@ bool Level::loadScene(rapidjson_flax::Value& data, int32 engineBuild, Scene** ou
         }
     }
 
+    Stage = Stages::BeginPlay;
+}
+
+void SceneLoader::OnBeginPlay()
+{
     // Cache transformations
     {
         PROFILE_CPU_NAMED("Cache Transform");
 
-        scene->OnTransformChanged();
+        TargetScene->OnTransformChanged();
     }
 
-    // /\ all above this has to be done on an any thread
-    // \/ all below this has to be done on a main thread
-
     // Link scene and call init
+    // Note: begin play goes recursively over the whole hierarchy (parents are awaken after children) so it cannot be split over multiple frames
     {
         PROFILE_CPU_NAMED("BeginPlay");
 
-        ScopeLock lock(ScenesLock);
-        Scenes.Add(scene);
+        ScopeLock lock(Level::ScenesLock);
+        Level::Scenes.Add(TargetScene);
         SceneBeginData beginData;
-        scene->BeginPlay(&beginData);
+        TargetScene->BeginPlay(&beginData);
         beginData.OnDone();
     }
+    Stage = Stages::Loaded;
 
     // Fire event
-    CallSceneEvent(SceneEventType::OnSceneLoaded, scene, sceneId);
+    CallSceneEvent(SceneEventType::OnSceneLoaded, TargetScene, SceneId);
+
+    LOG(Info, "Scene loaded in {0} ms", (int32)(DateTime::NowUTC() - StartTime).GetTotalMilliseconds());
+}
+
+bool Level::loadScene(rapidjson_flax::Value& data, int32 engineBuild, Scene** outScene)
+{
+    if (outScene)
+        *outScene = nullptr;
+
+    // Load the whole scene at once
+    SceneLoader loader(data, engineBuild, 0.0f);
+    loader.Tick();
+    if (loader.Stage == SceneLoader::Stages::Error)
+        return true;
 
-    LOG(Info, "Scene loaded in {0} ms", (int32)(DateTime::NowUTC() - startTime).GetTotalMilliseconds());
     if (outScene)
-        *outScene = scene;
+        *outScene = loader.TargetScene;
     return false;
 }
 
@@ -1321,6 +1740,89 @@ Scene* Level::LoadSceneFromBytes(const BytesContainer& data)
     return scene;
 }
 
+void Level::BeginTransformUpdate()
+{
+    ASSERT(IsInMainThread());
+    _transformUpdateCounter++;
+}
+
+void Level::EndTransformUpdate()
+{
+    ASSERT(IsInMainThread() && _transformUpdateCounter > 0);
+    if (--_transformUpdateCounter == 0)
+        FlushTransformUpdate();
+}
+
+void Level::FlushTransformUpdate()
+{
+    if (_transformUpdateActors.IsEmpty())
+        return;
+    PROFILE_CPU_NAMED("Level.FlushTransformUpdate");
+
+    // Batch rendering bounds updates of all modified actors
+    ScopeLock lock(ScenesLock);
+    for (Scene* scene : Scenes)
+        scene->Rendering.BeginBatchUpdate();
+
+    // Update each modified hierarchy once (start from the top-most parent with transform change pending, children updated by it are not dirty anymore)
+    // Note: list can grow when actors are modified during the update (eg. by the transform changed event) and deleted actors are set to null
+    for (int32 i = 0; i < _transformUpdateActors.Count(); i++)
+    {
+        Actor* actor = _transformUpdateActors[i];
+        if (!actor)
+            continue;
+        actor->_transformUpdateIndex = -1;
+        if (!actor->_isTransformDirty)
+            continue;
+        Actor* root = actor;
+        for (Actor* a = actor->GetParent(); a; a = a->GetParent())
+        {
+            if (a->_isTransformDirty)
+                root = a;
+        }
+        root->OnTransformChanged();
+    }
+    _transformUpdateActors.Clear();
+    Platform::AtomicStore(&Actor::_hasDirtyTransforms, 0);
+
+    for (Scene* scene : Scenes)
+        scene->Rendering.EndBatchUpdate();
+}
+
+bool Level::deferTransformUpdate(Actor* actor)
+{
+    if (_transformUpdateCounter == 0 || !IsInMainThread())
+        return false;
+    actor->_isTransformDirty = true;
+    if (actor->_transformUpdateIndex == -1)
+    {
+        actor->_transformUpdateIndex = _transformUpdateActors.Count();
+        _transformUpdateActors.Add(actor);
+    }
+    if (!Actor::_hasDirtyTransforms)
+        Platform::AtomicStore(&Actor::_hasDirtyTransforms, 1);
+    return true;
+}
+
+void Level::cancelTransformUpdate(Actor* actor)
+{
+    // Don't remove the actor from the list as it can be during the update (entry is skipped when flushing)
+    _transformUpdateActors[actor->_transformUpdateIndex] = nullptr;
+    actor->_isTransformDirty = false;
+    actor->_transformUpdateIndex = -1;
+}
+
+float Level::GetSceneLoadingProgress()
+{
+    ScopeLock lock(_sceneActionsLocker);
+    for (SceneAction* action : _sceneActions)
+    {
+        if (const auto loadAction = dynamic_cast<LoadSceneAction*>(action))
+            return loadAction->Loader ? loadAction->Loader->GetProgress() : 0.0f;
+    }
+    return 1.0f;
+}
+
 bool Level::LoadSceneAsync(const Guid& id)
 {
     // Check ID
@@ -1383,67 +1885,200 @@ Actor* Level::FindActor(const Guid& id)
     return Scripting::FindObject<Actor>(id);
 }
 
-Actor* Level::FindActor(const StringView& name)
+void Level::addToLookup(Actor* actor)
 {
-    Actor* result = nullptr;
+    // Skip actors outside the level (eg. editor preview scenes)
+    // Note: scenes list stays locked so the actor cannot be added after its scene gets unloaded (locks order is scenes then lookup)
+    ScopeLock scenesLock(ScenesLock);
+    if (!IsInLoadedScene(actor))
+        return;
+    ScopeLock lock(_lookupLocker);
+    _actorsByName[GetHash(StringView(actor->GetName()))].Add(actor);
+    _actorsByType[actor->GetClass()].Add(actor);
+    if (actor->HasTag())
+    {
+        const int32 tag = actor->GetTagIndex();
+        if (_actorsByTag.Count() <= tag)
+            _actorsByTag.Resize(tag + 1);
+        _actorsByTag[tag].Add(actor);
+    }
+}
 
-    ScopeLock lock(ScenesLock);
+void Level::addToLookup(Script* script)
+{
+    ScopeLock scenesLock(ScenesLock);
+    if (!IsInLoadedScene(script->GetParent()))
+        return;
+    ScopeLock lock(_lookupLocker);
+    _scriptsByType[script->GetClass()].Add(script);
+}
 
-    for (int32 i = 0; result == nullptr && i < Scenes.Count(); i++)
+void Level::removeFromLookup(Actor* actor)
+{
+    ScopeLock lock(_lookupLocker);
+    auto actors = _actorsByType.TryGet(actor->GetClass());
+    if (!actors || !actors->Remove(actor))
+        return;
+    if (actors->IsEmpty())
+        _actorsByType.Remove(actor->GetClass());
+    const uint32 nameHash = GetHash(StringView(actor->GetName()));
+    actors = _actorsByName.TryGet(nameHash);
+    if (actors && actors->Remove(actor) && actors->IsEmpty())
+        _actorsByName.Remove(nameHash);
+    const int32 tag = actor->GetTagIndex();
+    if (actor->HasTag() && tag < _actorsByTag.Count())
+        _actorsByTag[tag].Remove(actor);
+}
+
+void Level::removeFromLookup(Script* script)
+{
+    ScopeLock lock(_lookupLocker);
+    auto scripts = _scriptsByType.TryGet(script->GetClass());
+    if (scripts && scripts->Remove(script) && scripts->IsEmpty())
+        _scriptsByType.Remove(script->GetClass());
+}
+
+void Level::updateLookupName(Actor* actor, uint32 prevNameHash)
+{
+    ScopeLock lock(_lookupLocker);
+    auto actors = _actorsByName.TryGet(prevNameHash);
+    if (actors && actors->Remove(actor))
+    {
+        // Remove empty buckets to not leak the entries for the unused names
+        if (actors->IsEmpty())
+            _actorsByName.Remove(prevNameHash);
+        _actorsByName[GetHash(StringView(actor->GetName()))].Add(actor);
+    }
+}
+
+void Level::updateLookupTag(Actor* actor, int32 prevTag)
+{
+    ScopeLock lock(_lookupLocker);
+    auto actors = _actorsByType.TryGet(actor->GetClass());
+    if (!actors || !actors->Contains(actor))
+        return;
+    if (prevTag != ACTOR_TAG_INVALID && prevTag < _actorsByTag.Count())
+        _actorsByTag[prevTag].Remove(actor);
+    if (actor->HasTag())
     {
-        result = Scenes[i]->FindActor(name);
+        const int32 tag = actor->GetTagIndex();
+        if (_actorsByTag.Count() <= tag)
+            _actorsByTag.Resize(tag + 1);
+        _actorsByTag[tag].Add(actor);
     }
+}
 
+Actor* Level::FindActor(const StringView& name)
+{
+    Actor* result = nullptr;
+    ScopeLock scenesLock(ScenesLock);
+    ScopeLock lock(_lookupLocker);
+    const auto actors = _actorsByName.TryGet(GetHash(name));
+    if (actors)
+    {
+        // Different names can have the same hash, pick the first actor in the hierarchy if there are many with the same name
+        for (const auto& e : *actors)
+        {
+            if (e.Item->GetName() == name && (!result || IsActorBefore(e.Item, result)))
+                result = e.Item;
+        }
+    }
     return result;
 }
 
-Actor* Level::FindActor(const MClass* type)
+Actor* Level::FindActorWithTag(const StringView& tag)
 {
-    CHECK_RETURN(type, nullptr);
+    TagsLocker.Lock();
+    const int32 tagIndex = Tags.Find(tag);
+    TagsLocker.Unlock();
     Actor* result = nullptr;
-    ScopeLock lock(ScenesLock);
-    for (int32 i = 0; result == nullptr && i < Scenes.Count(); i++)
-        result = Scenes[i]->FindActor(type);
+    ScopeLock scenesLock(ScenesLock);
+    ScopeLock lock(_lookupLocker);
+    if (tagIndex != -1 && tagIndex < _actorsByTag.Count())
+    {
+        for (const auto& e : _actorsByTag[tagIndex])
+        {
+            if (!result || IsActorBefore(e.Item, result))
+                result = e.Item;
+        }
+    }
     return result;
 }
 
-Script* Level::FindScript(const MClass* type)
+Array<Actor*> Level::FindActorsWithTag(const StringView& tag)
 {
-    CHECK_RETURN(type, nullptr);
-    Script* result = nullptr;
-    ScopeLock lock(ScenesLock);
-    for (int32 i = 0; result == nullptr && i < Scenes.Count(); i++)
-        result = Scenes[i]->FindScript(type);
+    Array<Actor*> result;
+    TagsLocker.Lock();
+    const int32 tagIndex = Tags.Find(tag);
+    TagsLocker.Unlock();
+    ScopeLock scenesLock(ScenesLock);
+    ScopeLock lock(_lookupLocker);
+    if (tagIndex != -1 && tagIndex < _actorsByTag.Count())
+    {
+        const auto& actors = _actorsByTag[tagIndex];
+        result.EnsureCapacity(actors.Count());
+        for (const auto& e : actors)
+            result.Add(e.Item);
+        Sorting::QuickSort(result.Get(), result.Count(), &IsActorBefore);
+    }
     return result;
 }
 
-namespace
+Actor* Level::FindActor(const MClass* type)
 {
-    void GetActors(const MClass* type, Actor* actor, Array<Actor*>& result)
+    CHECK_RETURN(type, nullptr);
+    Actor* result = nullptr;
+    ScopeLock scenesLock(ScenesLock);
+    ScopeLock lock(_lookupLocker);
+    for (const auto& e : _actorsByType)
     {
-        if (actor->GetClass()->IsSubClassOf(type))
-            result.Add(actor);
-        for (auto child : actor->Children)
-            GetActors(type, child, result);
+        if (e.Key->IsSubClassOf(type))
+        {
+            for (const auto& q : e.Value)
+            {
+                if (!result || IsActorBefore(q.Item, result))
+                    result = q.Item;
+            }
+        }
     }
+    return result;
+}
 
-    void GetScripts(const MClass* type, Actor* actor, Array<Script*>& result)
+Script* Level::FindScript(const MClass* type)
+{
+    CHECK_RETURN(type, nullptr);
+    Script* result = nullptr;
+    ScopeLock scenesLock(ScenesLock);
+    ScopeLock lock(_lookupLocker);
+    for (const auto& e : _scriptsByType)
     {
-        for (auto script : actor->Scripts)
-            if (script->GetClass()->IsSubClassOf(type))
-                result.Add(script);
-        for (auto child : actor->Children)
-            GetScripts(type, child, result);
+        if (e.Key->IsSubClassOf(type))
+        {
+            for (const auto& q : e.Value)
+            {
+                if (!result || IsScriptBefore(q.Item, result))
+                    result = q.Item;
+            }
+        }
     }
+    return result;
 }
 
 Array<Actor*> Level::GetActors(const MClass* type)
 {
     Array<Actor*> result;
     CHECK_RETURN(type, result);
-    ScopeLock lock(ScenesLock);
-    for (int32 i = 0; i < Scenes.Count(); i++)
-        ::GetActors(type, Scenes[i], result);
+    ScopeLock scenesLock(ScenesLock);
+    ScopeLock lock(_lookupLocker);
+    for (const auto& e : _actorsByType)
+    {
+        if (e.Key->IsSubClassOf(type))
+        {
+            for (const auto& q : e.Value)
+                result.Add(q.Item);
+        }
+    }
+    Sorting::QuickSort(result.Get(), result.Count(), &IsActorBefore);
     return result;
 }
 
@@ -1451,9 +2086,17 @@ Array<Script*> Level::GetScripts(const MClass* type)
 {
     Array<Script*> result;
     CHECK_RETURN(type, result);
-    ScopeLock lock(ScenesLock);
-    for (int32 i = 0; i < Scenes.Count(); i++)
-        ::GetScripts(type, Scenes[i], result);
+    ScopeLock scenesLock(ScenesLock);
+    ScopeLock lock(_lookupLocker);
+    for (const auto& e : _scriptsByType)
+    {
+        if (e.Key->IsSubClassOf(type))
+        {
+            for (const auto& q : e.Value)
+                result.Add(q.Item);
+        }
+    }
+    Sorting::QuickSort(result.Get(), result.Count(), &IsScriptBefore);
     return result;
 }
 
@@ -24,6 +24,7 @@ API_CLASS(Static) class FLAXENGINE_API Level
 DECLARE_SCRIPTING_TYPE_NO_SPAWN(Level);
     friend Engine;
     friend Actor;
+    friend Script;
     friend PrefabManager;
     friend Prefab;
     friend PrefabInstanceData;
@@ -44,6 +45,16 @@ DECLARE_SCRIPTING_TYPE_NO_SPAWN(Level);
     /// </summary>
     API_FIELD(ReadOnly) static Array<Scene*> Scenes;
 
+    /// <summary>
+    /// The time budget (in milliseconds) for the main thread work of the scene loading done in the background (see LoadSceneAsync). If set, loading is split over multiple frames to reduce hitches (actors spawning, deserialization and post load; scene linking and BeginPlay are done within a single frame). Use 0 to load the whole scene within a single frame (default).
+    /// </summary>
+    API_FIELD() static float SceneLoadingTimeBudget;
+
+    /// <summary>
+    /// If checked, the actors transform changes done during the scripts update (Update, LateUpdate and FixedUpdate) are batched and propagated to the children once at the end of each tick (see BeginTransformUpdate). Disabled by default because reading the world transformation of the modified actor from other threads (eg. jobs or physics queries) during the tick is not allowed then.
+    /// </summary>
+    API_FIELD() static bool DeferTransformUpdates;
+
 public:
 
     /// <summary>
@@ -104,6 +115,26 @@ DECLARE_SCRIPTING_TYPE_NO_SPAWN(Level);
     /// <returns>Last scene load time</returns>
     API_PROPERTY() static DateTime GetLastSceneLoadTime();
 
+public:
+
+    /// <summary>
+    /// Begins the batched actors transformation update. Until the matching EndTransformUpdate call, actors transform changes done on a main thread are recorded and propagation to the children is deferred so each modified hierarchy is updated only once. Calls can be nested.
+    /// </summary>
+    /// <remarks>
+    /// Reading the world transformation (or bounds) of the actor on a main thread resolves its pending changes. Reading it from other threads before the batch end is invalid (asserted). Use it when modifying many actors at once (eg. crowd of characters placement) to skip the redundant hierarchy updates.
+    /// </remarks>
+    API_FUNCTION() static void BeginTransformUpdate();
+
+    /// <summary>
+    /// Ends the batched actors transformation update. Flushes all pending transform changes if it's the outermost batch.
+    /// </summary>
+    API_FUNCTION() static void EndTransformUpdate();
+
+    /// <summary>
+    /// Flushes all pending actors transform changes recorded during the batched transformation update.
+    /// </summary>
+    API_FUNCTION() static void FlushTransformUpdate();
+
     /// <summary>
     /// Gets the scenes count.
     /// </summary>
@@ -310,6 +341,11 @@ DECLARE_SCRIPTING_TYPE_NO_SPAWN(Level);
     /// <returns>True if loading cannot be done, otherwise false.</returns>
     API_FUNCTION() static bool LoadSceneAsync(const Guid& id);
 
+    /// <summary>
+    /// Gets the progress of the scene loading done in the background (normalized to range 0-1). Returns 1 if no scene is being loaded.
+    /// </summary>
+    API_PROPERTY() static float GetSceneLoadingProgress();
+
     /// <summary>
     /// Unloads given scene.
     /// </summary>
@@ -351,12 +387,26 @@ DECLARE_SCRIPTING_TYPE_NO_SPAWN(Level);
     API_FUNCTION() static Actor* FindActor(const Guid& id);
 
     /// <summary>
-    /// Tries to find the actor with the given name.
+    /// Tries to find the actor with the given name. Uses the lookup table of the actors in the loaded scenes (doesn't iterate over the scenes hierarchy). If many actors match, returns the first one in the scenes hierarchy order.
     /// </summary>
     /// <param name="name">The name of the actor.</param>
     /// <returns>Found actor or null.</returns>
     API_FUNCTION() static Actor* FindActor(const StringView& name);
 
+    /// <summary>
+    /// Tries to find the actor with the given tag. Uses the lookup table of the actors in the loaded scenes (doesn't iterate over the scenes hierarchy). If many actors match, returns the first one in the scenes hierarchy order.
+    /// </summary>
+    /// <param name="tag">The tag of the actor.</param>
+    /// <returns>Found actor or null.</returns>
+    API_FUNCTION() static Actor* FindActorWithTag(const StringView& tag);
+
+    /// <summary>
+    /// Finds all the actors with the given tag in all the loaded scenes.
+    /// </summary>
+    /// <param name="tag">The tag of the actor.</param>
+    /// <returns>Found actors list.</returns>
+    API_FUNCTION() static Array<Actor*> FindActorsWithTag(const StringView& tag);
+
     /// <summary>
     /// Tries to find the actor of the given type in all the loaded scenes.
     /// </summary>
@@ -395,7 +445,7 @@ DECLARE_SCRIPTING_TYPE_NO_SPAWN(Level);
     /// Finds all the actors of the given type in all the loaded scenes.
     /// </summary>
     /// <param name="type">Type of the actor to search for. Includes any actors derived from the type.</param>
-    /// <returns>Found actors list.</returns>
+    /// <returns>Found actors list (in the scenes hierarchy order).</returns>
     API_FUNCTION() static Array<Actor*> GetActors(const MClass* type);
 
     /// <summary>
@@ -492,6 +542,14 @@ DECLARE_SCRIPTING_TYPE_NO_SPAWN(Level);
     };
 
     static void callActorEvent(ActorEventType eventType, Actor* a, Actor* b);
+    static bool deferTransformUpdate(Actor* actor);
+    static void addToLookup(Actor* actor);
+    static void addToLookup(Script* script);
+    static void removeFromLookup(Actor* actor);
+    static void removeFromLookup(Script* script);
+    static void updateLookupName(Actor* actor, uint32 prevNameHash);
+    static void updateLookupTag(Actor* actor, int32 prevTag);
+    static void cancelTransformUpdate(Actor* actor);
     static bool loadScene(const Guid& sceneId);
     static bool loadScene(const String& scenePath);
     static bool loadScene(JsonAsset* sceneAsset);
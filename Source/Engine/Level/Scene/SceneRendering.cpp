@@ -40,6 +40,7 @@ int32 SceneRendering::DrawEntries::Add(Actor* obj)
     e.Actor = obj;
     e.LayerMask = obj->GetLayerMask();
     e.Bounds = obj->GetSphere();
+    e.IsDirty = false;
     return key;
 }
 
@@ -53,6 +54,34 @@ void SceneRendering::DrawEntries::Update(Actor* obj, int32 key)
     e.Bounds = obj->GetSphere();
 }
 
+void SceneRendering::DrawEntries::UpdateDeferred(Actor* obj, int32 key)
+{
+    if (List.IsEmpty())
+        return;
+    auto& e = List[key];
+    ASSERT_LOW_LAYER(obj == e.Actor);
+    if (!e.IsDirty)
+    {
+        e.IsDirty = true;
+        Dirty.Add(key);
+    }
+}
+
+void SceneRendering::DrawEntries::FlushDirty()
+{
+    for (int32 i = 0; i < Dirty.Count(); i++)
+    {
+        auto& e = List[Dirty[i]];
+        e.IsDirty = false;
+        if (e.Actor)
+        {
+            e.LayerMask = e.Actor->GetLayerMask();
+            e.Bounds = e.Actor->GetSphere();
+        }
+    }
+    Dirty.Clear();
+}
+
 void SceneRendering::DrawEntries::Remove(Actor* obj, int32 key)
 {
     if (List.IsEmpty())
@@ -66,6 +95,7 @@ void SceneRendering::DrawEntries::Remove(Actor* obj, int32 key)
 void SceneRendering::DrawEntries::Clear()
 {
     List.Clear();
+    Dirty.Clear();
 }
 
 void SceneRendering::DrawEntries::CullAndDraw(RenderContext& renderContext)
@@ -393,6 +423,21 @@ void SceneRendering::CollectPostFxVolumes(RenderContext& renderContext)
     }
 }
 
+void SceneRendering::BeginBatchUpdate()
+{
+    BatchUpdateCounter++;
+}
+
+void SceneRendering::EndBatchUpdate()
+{
+    ASSERT(BatchUpdateCounter > 0);
+    if (--BatchUpdateCounter == 0)
+    {
+        Geometry.FlushDirty();
+        Common.FlushDirty();
+    }
+}
+
 void SceneRendering::Clear()
 {
     Geometry.Clear();
@@ -49,14 +49,18 @@ class FLAXENGINE_API SceneRendering
         Actor* Actor;
         uint32 LayerMask;
         BoundingSphere Bounds;
+        bool IsDirty;
     };
 
     struct DrawEntries
     {
         Array<DrawEntry> List;
+        Array<int32> Dirty;
 
         int32 Add(Actor* obj);
         void Update(Actor* obj, int32 key);
+        void UpdateDeferred(Actor* obj, int32 key);
+        void FlushDirty();
         void Remove(Actor* obj, int32 key);
         void Clear();
         void CullAndDraw(RenderContext& renderContext);
@@ -70,6 +74,7 @@ class FLAXENGINE_API SceneRendering
     DrawEntries Common;
     Array<Actor*> CommonNoCulling;
     Array<IPostFxSettingsProvider*> PostFxProviders;
+    int32 BatchUpdateCounter = 0;
 #if USE_EDITOR
     Array<PhysicsDebugCallback> PhysicsDebug;
     Array<Actor*> ViewportIcons;
@@ -96,6 +101,16 @@ class FLAXENGINE_API SceneRendering
     /// </summary>
     void Clear();
 
+    /// <summary>
+    /// Begins the batched objects update. Bounds updates are deferred until the matching EndBatchUpdate call and then applied in a single pass (eg. used by the physics transforms writeback after the simulation). Calls can be nested.
+    /// </summary>
+    void BeginBatchUpdate();
+
+    /// <summary>
+    /// Ends the batched objects update. Flushes all deferred bounds updates if it's the outermost batch.
+    /// </summary>
+    void EndBatchUpdate();
+
 public:
 
     FORCE_INLINE int32 AddGeometry(Actor* obj)
@@ -105,7 +120,10 @@ class FLAXENGINE_API SceneRendering
 
     FORCE_INLINE void UpdateGeometry(Actor* obj, int32 key)
     {
-        Geometry.Update(obj, key);
+        if (BatchUpdateCounter)
+            Geometry.UpdateDeferred(obj, key);
+        else
+            Geometry.Update(obj, key);
     }
 
     FORCE_INLINE void RemoveGeometry(Actor* obj, int32& key)
@@ -121,7 +139,10 @@ class FLAXENGINE_API SceneRendering
 
     FORCE_INLINE void UpdateCommon(Actor* obj, int32 key)
     {
-        Common.Update(obj, key);
+        if (BatchUpdateCounter)
+            Common.UpdateDeferred(obj, key);
+        else
+            Common.Update(obj, key);
     }
 
     FORCE_INLINE void RemoveCommon(Actor* obj, int32& key)
@@ -13,9 +13,39 @@
 #include "Engine/Profiler/ProfilerCPU.h"
 #include "Engine/Threading/ThreadLocal.h"
 
+CriticalSection SceneObjectsFactory::HierarchyLocker;
+
 SceneObjectsFactory::Context::Context(ISerializeModifier* modifier)
     : Modifier(modifier)
 {
+    _context.Modifier = modifier;
+    _context.CurrentInstance = -1;
+}
+
+SceneObjectsFactory::Context::~Context()
+{
+    Array<ThreadContext> threads;
+    _threads.GetValues(threads);
+    for (auto& e : threads)
+    {
+        if (e.Modifier)
+            Delete(e.Modifier);
+    }
+}
+
+SceneObjectsFactory::Context::ThreadContext& SceneObjectsFactory::Context::GetThreadContext()
+{
+    if (!Async)
+        return _context;
+    ThreadContext& context = _threads.Get();
+    if (!context.Modifier)
+    {
+        context.Modifier = New<ISerializeModifier>();
+        context.Modifier->EngineBuild = Modifier->EngineBuild;
+        context.Modifier->IdsMapping = Modifier->IdsMapping;
+        context.CurrentInstance = -1;
+    }
+    return context;
 }
 
 SceneObject* SceneObjectsFactory::Spawn(Context& context, ISerializable::DeserializeStream& stream)
@@ -184,18 +214,19 @@ void SceneObjectsFactory::Deserialize(Context& context, SceneObject* obj, ISeria
         Deserialize(context, obj, *(ISerializable::DeserializeStream*)prefabData);
     }
 
+    auto& threadContext = context.GetThreadContext();
     int32 instanceIndex;
-    if (context.ObjectToInstance.TryGet(obj->GetID(), instanceIndex) && instanceIndex != context.CurrentInstance)
+    if (context.ObjectToInstance.TryGet(obj->GetID(), instanceIndex) && instanceIndex != threadContext.CurrentInstance)
     {
         // Apply the current prefab instance objects ids table to resolve references inside a prefab properly
-        context.CurrentInstance = instanceIndex;
+        threadContext.CurrentInstance = instanceIndex;
         auto& instance = context.Instances[instanceIndex];
         for (auto& e : instance.IdsMapping)
-            context.Modifier->IdsMapping[e.Key] = e.Value;
+            threadContext.Modifier->IdsMapping[e.Key] = e.Value;
     }
 
     // Load data
-    obj->Deserialize(stream, context.Modifier);
+    obj->Deserialize(stream, threadContext.Modifier);
 }
 
 void SceneObjectsFactory::HandleObjectDeserializationError(const ISerializable::DeserializeStream& value)
@@ -4,6 +4,8 @@
 
 #include "SceneObject.h"
 #include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Platform/CriticalSection.h"
+#include "Engine/Threading/ThreadLocal.h"
 
 /// <summary>
 /// Helper class for scene objects creation and deserialization utilities.
@@ -21,14 +23,37 @@ class FLAXENGINE_API SceneObjectsFactory
 
     struct Context
     {
+        struct ThreadContext
+        {
+            ISerializeModifier* Modifier;
+            int32 CurrentInstance;
+        };
+
         ISerializeModifier* Modifier;
-        int32 CurrentInstance = -1;
+        // True if objects are deserialized from multiple threads at once (each thread uses own modifier copy, the main Modifier is read-only then).
+        bool Async = false;
         Array<PrefabInstance> Instances;
         Dictionary<Guid, int32> ObjectToInstance;
 
         Context(ISerializeModifier* modifier);
+        ~Context();
+
+        /// <summary>
+        /// Gets the deserialization state for the current thread. In async mode each thread gets own copy of the modifier because prefab instances modify the ids mapping during deserialization.
+        /// </summary>
+        ThreadContext& GetThreadContext();
+
+    private:
+
+        ThreadContext _context;
+        ThreadLocal<ThreadContext> _threads;
     };
 
+    /// <summary>
+    /// The lock for the objects hierarchy linking during deserialization (scene objects can be deserialized from multiple threads at once).
+    /// </summary>
+    static CriticalSection HierarchyLocker;
+
     /// <summary>
     /// Creates the scene object from the specified data value. Does not perform deserialization.
     /// </summary>
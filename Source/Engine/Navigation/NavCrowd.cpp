@@ -0,0 +1,355 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#include "NavCrowd.h"
+#include "NavMesh.h"
+#include "NavMeshRuntime.h"
+#include "NavigationSettings.h"
+#include "Engine/Core/Log.h"
+#include "Engine/Profiler/ProfilerCPU.h"
+#include "Engine/Threading/Threading.h"
+#include "Engine/Threading/JobSystem.h"
+#include <ThirdParty/recastnavigation/DetourCrowd.h>
+
+namespace
+{
+    CriticalSection CrowdsLocker;
+    Array<NavCrowd*> Crowds;
+    Array<NavCrowd*> AutoUpdateCrowds;
+
+    void InitAgentParams(dtCrowdAgentParams& agentParams, const NavAgentProperties& properties)
+    {
+        Platform::MemoryClear(&agentParams, sizeof(agentParams));
+        agentParams.radius = properties.Radius;
+        agentParams.height = properties.Height;
+        agentParams.maxAcceleration = properties.MaxSpeed * 8.0f;
+        agentParams.maxSpeed = properties.MaxSpeed;
+        agentParams.collisionQueryRange = properties.Radius * 12.0f;
+        agentParams.pathOptimizationRange = properties.Radius * 30.0f;
+        agentParams.separationWeight = properties.CrowdSeparationWeight;
+        agentParams.updateFlags = DT_CROWD_ANTICIPATE_TURNS | DT_CROWD_OPTIMIZE_VIS | DT_CROWD_OPTIMIZE_TOPO | DT_CROWD_OBSTACLE_AVOIDANCE;
+        if (properties.CrowdSeparationWeight > 0.001f)
+            agentParams.updateFlags |= DT_CROWD_SEPARATION;
+        agentParams.obstacleAvoidanceType = 0;
+        agentParams.queryFilterType = 0;
+    }
+}
+
+NavCrowd::NavCrowd(const SpawnParams& params)
+    : ScriptingObject(params)
+    , _crowd(nullptr)
+    , _navMesh(nullptr)
+    , _navMeshVersion(0)
+    , _maxAgentRadius(0.0f)
+    , _maxAgents(0)
+    , _autoUpdate(false)
+{
+}
+
+NavCrowd::~NavCrowd()
+{
+    SetAutoUpdate(false);
+    {
+        ScopeLock lock(CrowdsLocker);
+        Crowds.Remove(this);
+    }
+    dtFreeCrowd(_crowd);
+}
+
+void NavCrowd::SetAutoUpdate(bool value)
+{
+    if (_autoUpdate == value)
+        return;
+    _autoUpdate = value;
+    ScopeLock lock(CrowdsLocker);
+    if (value)
+        AutoUpdateCrowds.Add(this);
+    else
+        AutoUpdateCrowds.Remove(this);
+}
+
+bool NavCrowd::Init(float maxAgentRadius, int32 maxAgents, NavMesh* navMesh)
+{
+    NavMeshRuntime* navMeshRuntime = navMesh ? navMesh->GetRuntime() : nullptr;
+    if (!navMeshRuntime)
+    {
+        const auto settings = NavigationSettings::Get();
+        if (settings->NavMeshes.HasItems())
+            navMeshRuntime = NavMeshRuntime::Get(settings->NavMeshes.First(), true);
+    }
+    return Init(maxAgentRadius, maxAgents, navMeshRuntime);
+}
+
+bool NavCrowd::Init(const NavAgentProperties& agentProperties, int32 maxAgents)
+{
+    NavMeshRuntime* navMeshRuntime = NavMeshRuntime::Get(agentProperties);
+    return Init(agentProperties.Radius, maxAgents, navMeshRuntime);
+}
+
+bool NavCrowd::Init(float maxAgentRadius, int32 maxAgents, NavMeshRuntime* navMesh)
+{
+    if (!navMesh)
+    {
+        LOG(Error, "Missing navmesh for the crowd.");
+        return true;
+    }
+    if (maxAgents <= 0 || maxAgentRadius <= 0.0f)
+    {
+        LOG(Error, "Invalid crowd parameters.");
+        return true;
+    }
+    PROFILE_CPU();
+
+    ScopeLock lock(CrowdsLocker);
+    ScopeLock crowdLock(_locker);
+    dtFreeCrowd(_crowd);
+    _crowd = nullptr;
+    _navMesh = navMesh;
+    _navMeshVersion = 0;
+    if (!Crowds.Contains(this))
+        Crowds.Add(this);
+    _maxAgentRadius = maxAgentRadius;
+    _maxAgents = maxAgents;
+
+    // Create crowd now if navmesh is ready (otherwise it will be done on the first update)
+    navMesh->ReadLock();
+    const bool failed = navMesh->GetNavMesh() && InitCrowd();
+    navMesh->ReadUnlock();
+    return failed;
+}
+
+int32 NavCrowd::AddAgent(const Vector3& position, const NavAgentProperties& properties)
+{
+    ScopeLock lock(_locker);
+    if (!_navMesh)
+        return -1;
+    Vector3 positionNavMesh;
+    Vector3::Transform(position, _navMesh->Properties.Rotation, positionNavMesh);
+    dtCrowdAgentParams agentParams;
+    InitAgentParams(agentParams, properties);
+    _navMesh->ReadLock();
+    const int32 id = SyncCrowd() ? _crowd->addAgent(&positionNavMesh.X, &agentParams) : -1;
+    _navMesh->ReadUnlock();
+    return id;
+}
+
+Vector3 NavCrowd::GetAgentPosition(int32 id) const
+{
+    ScopeLock lock(_locker);
+    Vector3 result = Vector3::Zero;
+    const dtCrowdAgent* agent = _crowd ? _crowd->getAgent(id) : nullptr;
+    if (agent && agent->active)
+    {
+        Quaternion invRotation;
+        Quaternion::Invert(_navMesh->Properties.Rotation, invRotation);
+        Vector3::Transform(*(const Vector3*)agent->npos, invRotation, result);
+    }
+    return result;
+}
+
+Vector3 NavCrowd::GetAgentVelocity(int32 id) const
+{
+    ScopeLock lock(_locker);
+    Vector3 result = Vector3::Zero;
+    const dtCrowdAgent* agent = _crowd ? _crowd->getAgent(id) : nullptr;
+    if (agent && agent->active)
+    {
+        Quaternion invRotation;
+        Quaternion::Invert(_navMesh->Properties.Rotation, invRotation);
+        Vector3::Transform(*(const Vector3*)agent->vel, invRotation, result);
+    }
+    return result;
+}
+
+void NavCrowd::GetAgentNeighbours(int32 id, Array<int32, HeapAllocation>& neighbours) const
+{
+    ScopeLock lock(_locker);
+    neighbours.Clear();
+    const dtCrowdAgent* agent = _crowd ? _crowd->getAgent(id) : nullptr;
+    if (agent && agent->active)
+    {
+        neighbours.Resize(agent->nneis);
+        for (int32 i = 0; i < agent->nneis; i++)
+            neighbours[i] = agent->neis[i].idx;
+    }
+}
+
+void NavCrowd::SetAgentProperties(int32 id, const NavAgentProperties& properties)
+{
+    ScopeLock lock(_locker);
+    if (!_crowd)
+        return;
+    dtCrowdAgentParams agentParams;
+    InitAgentParams(agentParams, properties);
+    _crowd->updateAgentParameters(id, &agentParams);
+}
+
+void NavCrowd::SetAgentMoveTarget(int32 id, const Vector3& position)
+{
+    ScopeLock lock(_locker);
+    if (!_navMesh)
+        return;
+    Vector3 positionNavMesh;
+    Vector3::Transform(position, _navMesh->Properties.Rotation, positionNavMesh);
+    _navMesh->ReadLock();
+    if (SyncCrowd())
+    {
+        dtPolyRef targetRef = 0;
+        Vector3 targetPos = positionNavMesh;
+        const auto query = _crowd->getNavMeshQuery();
+        query->findNearestPoly(&positionNavMesh.X, _crowd->getQueryExtents(), _crowd->getFilter(0), &targetRef, &targetPos.X);
+        if (targetRef)
+            _crowd->requestMoveTarget(id, targetRef, &targetPos.X);
+    }
+    _navMesh->ReadUnlock();
+}
+
+void NavCrowd::SetAgentMoveVelocity(int32 id, const Vector3& velocity)
+{
+    ScopeLock lock(_locker);
+    if (!_crowd)
+        return;
+    Vector3 velocityNavMesh;
+    Vector3::Transform(velocity, _navMesh->Properties.Rotation, velocityNavMesh);
+    _crowd->requestMoveVelocity(id, &velocityNavMesh.X);
+}
+
+void NavCrowd::ResetAgentMove(int32 id)
+{
+    ScopeLock lock(_locker);
+    if (!_crowd)
+        return;
+    _crowd->resetMoveTarget(id);
+}
+
+void NavCrowd::RemoveAgent(int32 id)
+{
+    ScopeLock lock(_locker);
+    if (!_crowd)
+        return;
+    _crowd->removeAgent(id);
+}
+
+void NavCrowd::Update(float dt)
+{
+    ScopeLock lock(_locker);
+    if (!_navMesh)
+        return;
+    PROFILE_CPU();
+    _navMesh->ReadLock();
+    if (SyncCrowd())
+    {
+        Platform::MemoryCopy(_crowd->getEditableFilter(0)->m_areaCost, NavMeshRuntime::NavAreasCosts, sizeof(NavMeshRuntime::NavAreasCosts));
+        _crowd->update(dt, nullptr);
+    }
+    _navMesh->ReadUnlock();
+}
+
+void NavCrowd::UpdateAll(float dt)
+{
+    ScopeLock lock(CrowdsLocker);
+    if (AutoUpdateCrowds.IsEmpty())
+        return;
+    PROFILE_CPU_NAMED("NavCrowd.UpdateAll");
+
+    // Crowds are independent (each uses own navmesh query) so update them in parallel (agents of a single crowd are updated on one thread)
+    Function<void(int32)> job = [dt](int32 index)
+    {
+        AutoUpdateCrowds[index]->Update(dt);
+    };
+    JobSystem::Execute(job, AutoUpdateCrowds.Count());
+}
+
+void NavCrowd::OnNavMeshDeleted(NavMeshRuntime* navMesh)
+{
+    ScopeLock lock(CrowdsLocker);
+    for (NavCrowd* crowd : Crowds)
+    {
+        if (crowd->_navMesh == navMesh)
+        {
+            ScopeLock crowdLock(crowd->_locker);
+            dtFreeCrowd(crowd->_crowd);
+            crowd->_crowd = nullptr;
+            crowd->_navMesh = nullptr;
+        }
+    }
+}
+
+bool NavCrowd::SyncCrowd()
+{
+    if (_navMesh->GetNavMesh() && (!_crowd || _navMeshVersion != _navMesh->GetNavMeshVersion()))
+    {
+        // Navmesh has been recreated so crowd has to be reinitialized
+        InitCrowd();
+    }
+
+    // Crowd cannot be used while navmesh is disposed (it references the released navmesh data)
+    return _crowd && _navMeshVersion == _navMesh->GetNavMeshVersion();
+}
+
+bool NavCrowd::InitCrowd()
+{
+    // Backup agents from the previous crowd (navmesh data is not accessed here)
+    struct AgentState
+    {
+        bool Active;
+        unsigned char TargetState;
+        dtCrowdAgentParams Params;
+        Vector3 Position;
+        Vector3 Target;
+    };
+    Array<AgentState> agents;
+    if (_crowd)
+    {
+        agents.Resize(_crowd->getAgentCount());
+        for (int32 i = 0; i < agents.Count(); i++)
+        {
+            const dtCrowdAgent* agent = _crowd->getAgent(i);
+            auto& e = agents[i];
+            e.Active = agent->active;
+            e.TargetState = agent->targetState;
+            e.Params = agent->params;
+            e.Position = *(const Vector3*)agent->npos;
+            e.Target = *(const Vector3*)agent->targetPos;
+        }
+        dtFreeCrowd(_crowd);
+    }
+
+    _crowd = dtAllocCrowd();
+    _navMeshVersion = _navMesh->GetNavMeshVersion();
+    if (!_crowd->init(_maxAgents, _maxAgentRadius, _navMesh->GetNavMesh()))
+    {
+        LOG(Error, "Failed to initialize crowd.");
+        dtFreeCrowd(_crowd);
+        _crowd = nullptr;
+        return true;
+    }
+
+    // Restore agents (keep the same IDs by filling the free slots and removing them after)
+    for (int32 i = 0; i < agents.Count(); i++)
+    {
+        auto& e = agents[i];
+        const int32 id = _crowd->addAgent(&e.Position.X, &e.Params);
+        ASSERT(id == i);
+        if (!e.Active)
+            continue;
+        if (e.TargetState == DT_CROWDAGENT_TARGET_VELOCITY)
+        {
+            _crowd->requestMoveVelocity(id, &e.Target.X);
+        }
+        else if (e.TargetState != DT_CROWDAGENT_TARGET_NONE && e.TargetState != DT_CROWDAGENT_TARGET_FAILED)
+        {
+            dtPolyRef targetRef = 0;
+            Vector3 targetPos = e.Target;
+            _crowd->getNavMeshQuery()->findNearestPoly(&e.Target.X, _crowd->getQueryExtents(), _crowd->getFilter(0), &targetRef, &targetPos.X);
+            if (targetRef)
+                _crowd->requestMoveTarget(id, targetRef, &targetPos.X);
+        }
+    }
+    for (int32 i = 0; i < agents.Count(); i++)
+    {
+        if (!agents[i].Active)
+            _crowd->removeAgent(i);
+    }
+
+    return false;
+}
@@ -0,0 +1,170 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#include "NavigationTypes.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Platform/CriticalSection.h"
+#include "Engine/Scripting/ScriptingObject.h"
+
+class NavMesh;
+class NavMeshRuntime;
+class dtCrowd;
+
+/// <summary>
+/// Navigation steering, obstacle avoidance and crowd management for a group of agents. Uses path corridors, local obstacle avoidance and neighbours queries (via spatial hash grid) on top of the navmesh data.
+/// </summary>
+/// <remarks>
+/// Crowds with AutoUpdate enabled are simulated by the navigation service every frame and different crowds are updated in parallel on Job System threads. A single crowd is always updated on one thread (the agents simulation isn't split into jobs), so split agents into multiple crowds (eg. per area) to scale for thousands of agents.
+/// The crowd functions can be called from any thread. They lock the crowd so calls made during the crowd update wait for it to end.
+/// </remarks>
+API_CLASS() class FLAXENGINE_API NavCrowd : public ScriptingObject
+{
+DECLARE_SCRIPTING_TYPE(NavCrowd);
+private:
+
+    mutable CriticalSection _locker;
+    dtCrowd* _crowd;
+    NavMeshRuntime* _navMesh;
+    int64 _navMeshVersion;
+    float _maxAgentRadius;
+    int32 _maxAgents;
+    bool _autoUpdate;
+
+public:
+
+    /// <summary>
+    /// Finalizes an instance of the <see cref="NavCrowd"/> class.
+    /// </summary>
+    ~NavCrowd();
+
+public:
+
+    /// <summary>
+    /// Gets the value indicating whether the crowd is simulated automatically by the navigation service every frame. Otherwise, call Update manually.
+    /// </summary>
+    API_PROPERTY() FORCE_INLINE bool GetAutoUpdate() const
+    {
+        return _autoUpdate;
+    }
+
+    /// <summary>
+    /// Sets the value indicating whether the crowd is simulated automatically by the navigation service every frame. Otherwise, call Update manually.
+    /// </summary>
+    API_PROPERTY() void SetAutoUpdate(bool value);
+
+    /// <summary>
+    /// Initializes the crowd.
+    /// </summary>
+    /// <param name="maxAgentRadius">The maximum radius of any agent that will be added to the crowd.</param>
+    /// <param name="maxAgents">The maximum number of agents the crowd can manage.</param>
+    /// <param name="navMesh">The navigation mesh to use for crowd movement planning. Use null to pick the first navmesh.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    API_FUNCTION() bool Init(float maxAgentRadius = 100.0f, int32 maxAgents = 25, NavMesh* navMesh = nullptr);
+
+    /// <summary>
+    /// Initializes the crowd.
+    /// </summary>
+    /// <param name="agentProperties">The properties of the agents used to pick the navmesh (and the maximum agent radius).</param>
+    /// <param name="maxAgents">The maximum number of agents the crowd can manage.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    API_FUNCTION() bool Init(const NavAgentProperties& agentProperties, int32 maxAgents = 25);
+
+    /// <summary>
+    /// Initializes the crowd.
+    /// </summary>
+    /// <param name="maxAgentRadius">The maximum radius of any agent that will be added to the crowd.</param>
+    /// <param name="maxAgents">The maximum number of agents the crowd can manage.</param>
+    /// <param name="navMesh">The navigation mesh to use for crowd movement planning.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    bool Init(float maxAgentRadius, int32 maxAgents, NavMeshRuntime* navMesh);
+
+public:
+
+    /// <summary>
+    /// Adds a new agent to the crowd.
+    /// </summary>
+    /// <param name="position">The agent position.</param>
+    /// <param name="properties">The agent properties.</param>
+    /// <returns>The agent unique ID or -1 if failed to add it (eg. too many active agents).</returns>
+    API_FUNCTION() int32 AddAgent(const Vector3& position, const NavAgentProperties& properties);
+
+    /// <summary>
+    /// Gets the agent current position.
+    /// </summary>
+    /// <param name="id">The agent ID.</param>
+    /// <returns>The agent current position.</returns>
+    API_FUNCTION() Vector3 GetAgentPosition(int32 id) const;
+
+    /// <summary>
+    /// Gets the agent current velocity (direction * speed).
+    /// </summary>
+    /// <param name="id">The agent ID.</param>
+    /// <returns>The agent current velocity (direction * speed).</returns>
+    API_FUNCTION() Vector3 GetAgentVelocity(int32 id) const;
+
+    /// <summary>
+    /// Gets the list of the agents neighbouring the given agent (within the collision query range, sorted by distance). Gathered during the last crowd update.
+    /// </summary>
+    /// <param name="id">The agent ID.</param>
+    /// <param name="neighbours">The result neighbours agents IDs.</param>
+    API_FUNCTION() void GetAgentNeighbours(int32 id, API_PARAM(Out) Array<int32, HeapAllocation>& neighbours) const;
+
+    /// <summary>
+    /// Updates the agent properties.
+    /// </summary>
+    /// <param name="id">The agent ID.</param>
+    /// <param name="properties">The agent properties.</param>
+    API_FUNCTION() void SetAgentProperties(int32 id, const NavAgentProperties& properties);
+
+    /// <summary>
+    /// Updates the agent movement target position. The path to the target is planned asynchronously by the crowd (spread over frames).
+    /// </summary>
+    /// <param name="id">The agent ID.</param>
+    /// <param name="position">The agent target position.</param>
+    API_FUNCTION() void SetAgentMoveTarget(int32 id, const Vector3& position);
+
+    /// <summary>
+    /// Updates the agent movement target velocity (direction * speed).
+    /// </summary>
+    /// <param name="id">The agent ID.</param>
+    /// <param name="velocity">The agent target velocity.</param>
+    API_FUNCTION() void SetAgentMoveVelocity(int32 id, const Vector3& velocity);
+
+    /// <summary>
+    /// Resets any movement request for the specified agent.
+    /// </summary>
+    /// <param name="id">The agent ID.</param>
+    API_FUNCTION() void ResetAgentMove(int32 id);
+
+    /// <summary>
+    /// Removes the agent from the crowd.
+    /// </summary>
+    /// <param name="id">The agent ID.</param>
+    API_FUNCTION() void RemoveAgent(int32 id);
+
+    /// <summary>
+    /// Updates the steering and positions of all agents in the crowd.
+    /// </summary>
+    /// <param name="dt">The simulation update delta time (in seconds).</param>
+    API_FUNCTION() void Update(float dt);
+
+public:
+
+    /// <summary>
+    /// Updates all the crowds that use automatic update (in parallel). Called internally by the navigation service.
+    /// </summary>
+    /// <param name="dt">The simulation update delta time (in seconds).</param>
+    static void UpdateAll(float dt);
+
+    /// <summary>
+    /// Releases the crowds that use the given navmesh (it's being deleted). Called internally by the navmesh.
+    /// </summary>
+    /// <param name="navMesh">The navmesh.</param>
+    static void OnNavMeshDeleted(NavMeshRuntime* navMesh);
+
+private:
+
+    bool SyncCrowd();
+    bool InitCrowd();
+};
@@ -11,7 +11,13 @@
 #include "NavMeshRuntime.h"
 #include "Engine/Core/Log.h"
 #include "Engine/Core/Math/BoundingBox.h"
+#include "Engine/Core/Math/Int2.h"
 #include "Engine/Core/Math/Int3.h"
+#include "Engine/Core/Math/Vector2.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Core/Collections/Sorting.h"
+#include "Engine/Level/Actors/Camera.h"
+#include "Engine/Platform/CPUInfo.h"
 #include "Engine/Physics/Colliders/BoxCollider.h"
 #include "Engine/Physics/Colliders/SphereCollider.h"
 #include "Engine/Physics/Colliders/CapsuleCollider.h"
@@ -48,6 +54,8 @@ int32 BoxTrianglesIndicesCache[] =
 
 #define NAV_MESH_TILE_MAX_EXTENT 100000000
 #define NAV_MESH_BUILD_DEBUG_DRAW_GEOMETRY 0
+#define NAV_MESH_BUILD_GEOMETRY_CACHE 1
+#define NAV_MESH_BUILD_GEOMETRY_CACHE_MAX_VERTICES (4 * 1024 * 1024)
 
 #if NAV_MESH_BUILD_DEBUG_DRAW_GEOMETRY
 #include "Engine/Debug/DebugDraw.h"
@@ -68,6 +76,130 @@ struct Modifier
     NavAreaProperties* NavArea;
 };
 
+#if NAV_MESH_BUILD_GEOMETRY_CACHE
+
+// Cache of the world-space collision geometry extracted from the mesh colliders (reused by tiles rebuilding to skip triangles extraction from physics backend for unchanged colliders)
+struct GeometryCacheEntry
+{
+    Scene* Scene;
+    CollisionData* Asset;
+    Matrix LocalToWorld;
+    Array<Vector3> VertexBuffer;
+    Array<int32> IndexBuffer;
+};
+
+CriticalSection GeometryCacheLocker;
+Dictionary<Guid, GeometryCacheEntry*> GeometryCache;
+Dictionary<CollisionData*, int32> GeometryCacheAssets; // Amount of entries that use the asset (cache listens to the asset reload/unload to drop the outdated geometry)
+int32 GeometryCacheVertices = 0;
+
+void OnGeometryCacheAssetChanged(Asset* asset);
+
+void AddGeometryCacheAsset(CollisionData* asset)
+{
+    int32* count = GeometryCacheAssets.TryGet(asset);
+    if (count)
+    {
+        (*count)++;
+        return;
+    }
+    GeometryCacheAssets.Add(asset, 1);
+    asset->OnReloading.Bind<OnGeometryCacheAssetChanged>();
+    asset->OnUnloaded.Bind<OnGeometryCacheAssetChanged>();
+}
+
+void RemoveGeometryCacheAsset(CollisionData* asset)
+{
+    int32* count = GeometryCacheAssets.TryGet(asset);
+    if (count && --(*count) == 0)
+    {
+        GeometryCacheAssets.Remove(asset);
+        asset->OnReloading.Unbind<OnGeometryCacheAssetChanged>();
+        asset->OnUnloaded.Unbind<OnGeometryCacheAssetChanged>();
+    }
+}
+
+void ClearGeometryCache()
+{
+    ScopeLock lock(GeometryCacheLocker);
+    for (auto& e : GeometryCacheAssets)
+    {
+        e.Key->OnReloading.Unbind<OnGeometryCacheAssetChanged>();
+        e.Key->OnUnloaded.Unbind<OnGeometryCacheAssetChanged>();
+    }
+    GeometryCacheAssets.Clear();
+    GeometryCache.ClearDelete();
+    GeometryCacheVertices = 0;
+}
+
+void RemoveGeometryCache(const Asset* asset, const Scene* scene)
+{
+    ScopeLock lock(GeometryCacheLocker);
+    Array<Guid> removed;
+    for (auto& e : GeometryCache)
+    {
+        if ((asset && e.Value->Asset == asset) || (scene && e.Value->Scene == scene))
+            removed.Add(e.Key);
+    }
+    for (const Guid& id : removed)
+    {
+        GeometryCacheEntry* e = GeometryCache[id];
+        GeometryCacheVertices -= e->VertexBuffer.Count();
+        RemoveGeometryCacheAsset(e->Asset);
+        GeometryCache.Remove(id);
+        Delete(e);
+    }
+}
+
+void OnGeometryCacheAssetChanged(Asset* asset)
+{
+    // Asset has been reimported or unloaded so remove the geometry extracted from it
+    RemoveGeometryCache(asset, nullptr);
+}
+
+bool GetCachedGeometry(const Guid& id, CollisionData* asset, const Matrix& localToWorld, Array<Vector3>& vb, Array<int32>& ib)
+{
+    ScopeLock lock(GeometryCacheLocker);
+    GeometryCacheEntry* e;
+    if (GeometryCache.TryGet(id, e) && e->Asset == asset && e->LocalToWorld == localToWorld)
+    {
+        vb.Add(e->VertexBuffer);
+        ib.Add(e->IndexBuffer);
+        return true;
+    }
+    return false;
+}
+
+void CacheGeometry(const Guid& id, Scene* scene, CollisionData* asset, const Matrix& localToWorld, const Array<Vector3>& vb, const Array<int32>& ib)
+{
+    ScopeLock lock(GeometryCacheLocker);
+    GeometryCacheEntry* e;
+    if (GeometryCache.TryGet(id, e))
+    {
+        GeometryCacheVertices -= e->VertexBuffer.Count();
+        RemoveGeometryCacheAsset(e->Asset);
+    }
+    else
+    {
+        if (GeometryCacheVertices + vb.Count() > NAV_MESH_BUILD_GEOMETRY_CACHE_MAX_VERTICES)
+        {
+            // Cache is full so start from scratch
+            ClearGeometryCache();
+        }
+        e = New<GeometryCacheEntry>();
+        GeometryCache.Add(id, e);
+    }
+    e->Scene = scene;
+    e->Asset = asset;
+    e->LocalToWorld = localToWorld;
+    e->VertexBuffer = vb;
+    e->IndexBuffer = ib;
+    GeometryCacheVertices += vb.Count();
+    AddGeometryCacheAsset(asset);
+}
+
+#endif
+
 struct NavigationSceneRasterization
 {
     NavMesh* NavMesh;
@@ -275,12 +407,19 @@ struct NavigationSceneRasterization
             if (!collisionData || collisionData->WaitForLoaded())
                 return true;
 
-            collisionData->ExtractGeometry(vb, ib);
-
             Matrix meshColliderToWorld;
             meshCollider->GetLocalToWorldMatrix(meshColliderToWorld);
-            for (auto& v : vb)
-                Vector3::Transform(v, meshColliderToWorld, v);
+#if NAV_MESH_BUILD_GEOMETRY_CACHE
+            if (!GetCachedGeometry(meshCollider->GetID(), collisionData, meshColliderToWorld, vb, ib))
+#endif
+            {
+                collisionData->ExtractGeometry(vb, ib);
+                for (auto& v : vb)
+                    Vector3::Transform(v, meshColliderToWorld, v);
+#if NAV_MESH_BUILD_GEOMETRY_CACHE
+                CacheGeometry(meshCollider->GetID(), meshCollider->GetScene(), collisionData, meshColliderToWorld, vb, ib);
+#endif
+            }
 
             e.RasterizeTriangles();
         }
@@ -701,12 +840,44 @@ struct BuildRequest
     BoundingBox DirtyBounds;
 };
 
+struct NavTileKey
+{
+    NavMeshRuntime* Runtime;
+    int32 X;
+    int32 Y;
+
+    bool operator==(const NavTileKey& other) const
+    {
+        return Runtime == other.Runtime && X == other.X && Y == other.Y;
+    }
+};
+
+inline uint32 GetHash(const NavTileKey& key)
+{
+    uint32 hash = GetHash((const void*)key.Runtime);
+    CombineHash(hash, GetHash(key.X));
+    CombineHash(hash, GetHash(key.Y));
+    return hash;
+}
+
 CriticalSection NavBuildQueueLocker;
 Array<BuildRequest> NavBuildQueue;
 
 CriticalSection NavBuildTasksLocker;
 int32 NavBuildTasksMaxCount = 0;
+int32 NavBuildTasksRunning = 0;
 Array<class NavMeshTileBuildTask*> NavBuildTasks;
+Array<class NavMeshTileBuildTask*> NavBuildTasksPending; // Sorted by priority (the most important task is the last one)
+Dictionary<NavTileKey, class NavMeshTileBuildTask*> NavBuildTasksLookup;
+bool NavBuildTasksPendingSorted = true;
+Array<Vector3> NavBuildPriorityLocations;
+Array<Vector3> NavBuildPriorityLocationsActive;
+
+// Tiles building statistics (since the last time the building started)
+double NavBuildStartTime = 0.0;
+int32 NavBuildTilesBuilt = 0;
+double NavBuildTilesTime = 0.0;
+double NavBuildTilesTimeMax = 0.0;
 
 class NavMeshTileBuildTask : public ThreadPoolTask
 {
@@ -721,6 +892,10 @@ class NavMeshTileBuildTask : public ThreadPoolTask
     int32 Y;
     float TileSize;
     rcConfig Config;
+    float Priority = 0.0f;
+    bool Started = false;
+    int64 Rebuild = 0;
+    double BuildTime = 0.0;
 
 public:
 
@@ -734,23 +909,109 @@ class NavMeshTileBuildTask : public ThreadPoolTask
         {
             return false;
         }
-        if (GenerateTile(NavMesh, Runtime, X, Y, TileBoundsNavMesh, WorldToNavMesh, TileSize, Config))
+        const double startTime = Platform::GetTimeSeconds();
+        do
         {
-            LOG(Warning, "Failed to generate navmesh tile at {0}x{1}.", X, Y);
-        }
+            // Tile can get dirty again during building (eg. moving obstacle) so build it again with the latest scene state
+            if (GenerateTile(NavMesh, Runtime, X, Y, TileBoundsNavMesh, WorldToNavMesh, TileSize, Config))
+            {
+                LOG(Warning, "Failed to generate navmesh tile at {0}x{1}.", X, Y);
+            }
+        } while (Platform::InterlockedExchange(&Rebuild, 0) != 0 && !IsCancelRequested());
+        BuildTime = Platform::GetTimeSeconds() - startTime;
 
         return false;
     }
 
-    void OnEnd() override
+    void OnEnd() override;
+};
+
+bool SortNavBuildTasks(NavMeshTileBuildTask* const& a, NavMeshTileBuildTask* const& b)
+{
+    return a->Priority > b->Priority;
+}
+
+float GetTileBuildPriority(const NavMeshTileBuildTask* task)
+{
+    // Use squared distance from the closest location to the tile center (on the navmesh plane)
+    if (NavBuildPriorityLocationsActive.IsEmpty())
+        return 0.0f;
+    const Vector3 tileCenter = task->TileBoundsNavMesh.GetCenter();
+    float result = MAX_float;
+    for (const Vector3& location : NavBuildPriorityLocationsActive)
+    {
+        Vector3 locationNavMesh;
+        Vector3::Transform(location, task->WorldToNavMesh, locationNavMesh);
+        result = Math::Min(result, Vector2::DistanceSquared(Vector2(locationNavMesh.X, locationNavMesh.Z), Vector2(tileCenter.X, tileCenter.Z)));
+    }
+    return result;
+}
+
+void StartTileBuildTasks()
+{
+    // Note: NavBuildTasksLocker must be locked by the caller
+
+    // Limit the amount of tiles built at once (to match thread pool size) so the most important tiles are processed first
+    static int32 MaxRunningTasks = Math::Clamp<int32>(Platform::GetCPUInfo().ProcessorCoreCount - 1, 2, PLATFORM_THREADS_LIMIT);
+    if (NavBuildTasksPending.IsEmpty() || NavBuildTasksRunning >= MaxRunningTasks)
+        return;
+    if (!NavBuildTasksPendingSorted)
+    {
+        NavBuildTasksPendingSorted = true;
+        Sorting::QuickSort(NavBuildTasksPending.Get(), NavBuildTasksPending.Count(), &SortNavBuildTasks);
+    }
+    while (NavBuildTasksPending.HasItems() && NavBuildTasksRunning < MaxRunningTasks)
+    {
+        auto task = NavBuildTasksPending.Last();
+        NavBuildTasksPending.RemoveLast();
+        task->Started = true;
+        NavBuildTasksRunning++;
+        task->Start();
+    }
+}
+
+void NavMeshTileBuildTask::OnEnd()
+{
     {
         // Remove from tasks list
         ScopeLock lock(NavBuildTasksLocker);
         NavBuildTasks.Remove(this);
+        NavBuildTasksLookup.Remove(NavTileKey{ Runtime, X, Y });
+        if (Started)
+        {
+            NavBuildTasksRunning--;
+            if (GetState() == TaskState::Finished)
+            {
+                NavBuildTilesBuilt++;
+                NavBuildTilesTime += BuildTime;
+                NavBuildTilesTimeMax = Math::Max(NavBuildTilesTimeMax, BuildTime);
+            }
+        }
+        else
+        {
+            NavBuildTasksPending.Remove(this);
+        }
         if (NavBuildTasks.IsEmpty())
+        {
             NavBuildTasksMaxCount = 0;
+            if (NavBuildTilesBuilt != 0)
+            {
+                const double totalTime = Platform::GetTimeSeconds() - NavBuildStartTime;
+                LOG(Info, "Navmesh building done. Built {0} tiles in {1} ms (tile build time avg: {2} ms, max: {3} ms)", NavBuildTilesBuilt, (int32)(totalTime * 1000.0), (float)(NavBuildTilesTime * 1000.0 / NavBuildTilesBuilt), (float)(NavBuildTilesTimeMax * 1000.0));
+                NavBuildTilesBuilt = 0;
+                NavBuildTilesTime = 0.0;
+                NavBuildTilesTimeMax = 0.0;
+            }
+        }
+        else
+        {
+            // Kick the next tiles
+            StartTileBuildTasks();
+        }
     }
-};
+
+    ThreadPoolTask::OnEnd();
+}
 
 void OnSceneUnloading(Scene* scene, const Guid& sceneId)
 {
@@ -768,6 +1029,12 @@ void OnSceneUnloading(Scene* scene, const Guid& sceneId)
 
     // Cancel active build tasks
     NavBuildTasksLocker.Lock();
+    for (int32 i = NavBuildTasksPending.Count() - 1; i >= 0; i--)
+    {
+        // Don't start not yet running tasks from this scene
+        if (NavBuildTasksPending[i]->Scene == scene)
+            NavBuildTasksPending.RemoveAtKeepOrder(i);
+    }
     for (int32 i = 0; i < NavBuildTasks.Count(); i++)
     {
         auto task = NavBuildTasks[i];
@@ -785,6 +1052,11 @@ void OnSceneUnloading(Scene* scene, const Guid& sceneId)
         }
     }
     NavBuildTasksLocker.Unlock();
+
+#if NAV_MESH_BUILD_GEOMETRY_CACHE
+    // Release the geometry of the scene colliders
+    RemoveGeometryCache(nullptr, scene);
+#endif
 }
 
 void NavMeshBuilder::Init()
@@ -792,6 +1064,14 @@ void NavMeshBuilder::Init()
     Level::SceneUnloading.Bind<OnSceneUnloading>();
 }
 
+void NavMeshBuilder::Dispose()
+{
+    Level::SceneUnloading.Unbind<OnSceneUnloading>();
+#if NAV_MESH_BUILD_GEOMETRY_CACHE
+    ClearGeometryCache();
+#endif
+}
+
 bool NavMeshBuilder::IsBuildingNavMesh()
 {
     NavBuildTasksLocker.Lock();
@@ -814,24 +1094,27 @@ float NavMeshBuilder::GetNavMeshBuildingProgress()
     return result;
 }
 
-void BuildTileAsync(NavMesh* navMesh, int32 x, int32 y, rcConfig& config, const BoundingBox& tileBoundsNavMesh, const Matrix& worldToNavMesh, float tileSize)
+void NavMeshBuilder::SetPriorityLocations(const Array<Vector3>& locations)
 {
-    NavMeshRuntime* runtime = navMesh->GetRuntime();
-    NavBuildTasksLocker.Lock();
+    ScopeLock lock(NavBuildTasksLocker);
+    NavBuildPriorityLocations = locations;
+}
 
-    // Skip if this tile is already during cooking
-    for (int32 i = 0; i < NavBuildTasks.Count(); i++)
+void BuildTileAsync(NavMesh* navMesh, NavMeshRuntime* runtime, int32 x, int32 y, rcConfig& config, const BoundingBox& tileBoundsNavMesh, const Matrix& worldToNavMesh, float tileSize)
+{
+    // Note: NavBuildTasksLocker must be locked by the caller
+
+    // Skip if this tile is already during cooking (running task will build it again to include the latest changes)
+    NavMeshTileBuildTask* task;
+    if (NavBuildTasksLookup.TryGet(NavTileKey{ runtime, x, y }, task))
     {
-        const auto task = NavBuildTasks[i];
-        if (task->X == x && task->Y == y && task->Runtime == runtime)
-        {
-            NavBuildTasksLocker.Unlock();
-            return;
-        }
+        if (task->Started)
+            Platform::InterlockedExchange(&task->Rebuild, 1);
+        return;
     }
 
     // Create task
-    auto task = New<NavMeshTileBuildTask>();
+    task = New<NavMeshTileBuildTask>();
     task->Scene = navMesh->GetScene();
     task->NavMesh = navMesh;
     task->Runtime = runtime;
@@ -841,13 +1124,14 @@ void BuildTileAsync(NavMesh* navMesh, int32 x, int32 y, rcConfig& config, const
     task->WorldToNavMesh = worldToNavMesh;
     task->TileSize = tileSize;
     task->Config = config;
+    task->Priority = GetTileBuildPriority(task);
+    if (NavBuildTasks.IsEmpty())
+        NavBuildStartTime = Platform::GetTimeSeconds();
     NavBuildTasks.Add(task);
+    NavBuildTasksPending.Add(task);
+    NavBuildTasksLookup.Add(NavTileKey{ runtime, x, y }, task);
+    NavBuildTasksPendingSorted = false;
     NavBuildTasksMaxCount++;
-
-    NavBuildTasksLocker.Unlock();
-
-    // Invoke job
-    task->Start();
 }
 
 void BuildDirtyBounds(Scene* scene, NavMesh* navMesh, const BoundingBox& dirtyBounds, bool rebuild)
@@ -904,6 +1188,7 @@ void BuildDirtyBounds(Scene* scene, NavMesh* navMesh, const BoundingBox& dirtyBo
     {
         PROFILE_CPU_NAMED("StartBuildingTiles");
 
+        ScopeLock lock(NavBuildTasksLocker);
         for (int32 y = tilesMin.Z; y < tilesMax.Z; y++)
         {
             for (int32 x = tilesMin.X; x < tilesMax.X; x++)
@@ -911,7 +1196,7 @@ void BuildDirtyBounds(Scene* scene, NavMesh* navMesh, const BoundingBox& dirtyBo
                 BoundingBox tileBoundsNavMesh;
                 if (GetNavMeshTileBounds(scene, navMesh, x, y, tileSize, tileBoundsNavMesh, worldToNavMesh))
                 {
-                    BuildTileAsync(navMesh, x, y, config, tileBoundsNavMesh, worldToNavMesh, tileSize);
+                    BuildTileAsync(navMesh, runtime, x, y, config, tileBoundsNavMesh, worldToNavMesh, tileSize);
                 }
                 else
                 {
@@ -919,6 +1204,7 @@ void BuildDirtyBounds(Scene* scene, NavMesh* navMesh, const BoundingBox& dirtyBo
                 }
             }
         }
+        StartTileBuildTasks();
     }
 }
 
@@ -1012,6 +1298,11 @@ void BuildDirtyBounds(Scene* scene, const BoundingBox& dirtyBounds, bool rebuild
 
 void BuildWholeScene(Scene* scene)
 {
+#if NAV_MESH_BUILD_GEOMETRY_CACHE
+    // Full rebuild invalidates any cached geometry (eg. modified collision assets)
+    ClearGeometryCache();
+#endif
+
     // Compute total navigation area bounds
     const BoundingBox worldBounds = scene->Navigation.GetNavigationBounds();
 
@@ -1031,6 +1322,25 @@ void ClearNavigation(Scene* scene)
 
 void NavMeshBuilder::Update()
 {
+    // Update tiles building priorities to build first the ones closest to the players (or the main camera)
+    NavBuildTasksLocker.Lock();
+    NavBuildPriorityLocationsActive = NavBuildPriorityLocations;
+    if (NavBuildPriorityLocationsActive.IsEmpty())
+    {
+        const auto camera = Camera::GetMainCamera();
+        if (camera)
+            NavBuildPriorityLocationsActive.Add(camera->GetPosition());
+    }
+    if (NavBuildTasksPending.HasItems())
+    {
+        PROFILE_CPU_NAMED("UpdateTilesPriority");
+        for (auto task : NavBuildTasksPending)
+            task->Priority = GetTileBuildPriority(task);
+        NavBuildTasksPendingSorted = false;
+        StartTileBuildTasks();
+    }
+    NavBuildTasksLocker.Unlock();
+
     ScopeLock lock(NavBuildQueueLocker);
 
     // Process nav mesh building requests and kick the tasks
@@ -1096,6 +1406,62 @@ void NavMeshBuilder::Build(Scene* scene, float timeoutMs)
     NavBuildQueue.Add(req);
 }
 
+float NavMeshBuilder::Benchmark(Scene* scene, int32 tilesCount)
+{
+    if (IsBuildingNavMesh())
+    {
+        LOG(Warning, "Cannot benchmark navmesh building while navmesh is being built.");
+        return -1.0f;
+    }
+    NavMesh* navMesh = nullptr;
+    for (NavMesh* e : scene->Navigation.Meshes)
+    {
+        if (e->Data.Tiles.HasItems() && e->GetRuntime(false))
+        {
+            navMesh = e;
+            break;
+        }
+    }
+    if (!navMesh)
+    {
+        LOG(Warning, "Missing navmesh with built tiles to benchmark on scene {0}.", scene->GetName());
+        return -1.0f;
+    }
+    PROFILE_CPU();
+
+    // Rebuild the existing tiles synchronously, first without the cached geometry and then with it
+    NavMeshRuntime* runtime = navMesh->GetRuntime();
+    const float tileSize = navMesh->Data.TileSize;
+    Matrix worldToNavMesh;
+    Matrix::RotationQuaternion(runtime->Properties.Rotation, worldToNavMesh);
+    rcConfig config;
+    InitConfig(config, navMesh);
+    Array<Int2> tiles;
+    for (const auto& tile : navMesh->Data.Tiles)
+    {
+        if (tiles.Count() < tilesCount && !tiles.Contains(Int2(tile.PosX, tile.PosY)))
+            tiles.Add(Int2(tile.PosX, tile.PosY));
+    }
+    double times[2];
+    for (int32 pass = 0; pass < 2; pass++)
+    {
+#if NAV_MESH_BUILD_GEOMETRY_CACHE
+        if (pass == 0)
+            ClearGeometryCache();
+#endif
+        const double startTime = Platform::GetTimeSeconds();
+        for (const Int2& tile : tiles)
+        {
+            BoundingBox tileBoundsNavMesh;
+            if (GetNavMeshTileBounds(scene, navMesh, tile.X, tile.Y, tileSize, tileBoundsNavMesh, worldToNavMesh))
+                GenerateTile(navMesh, runtime, tile.X, tile.Y, tileBoundsNavMesh, worldToNavMesh, tileSize, config);
+        }
+        times[pass] = (Platform::GetTimeSeconds() - startTime) * 1000.0;
+    }
+    LOG(Info, "Navmesh building benchmark. Built {0} tiles in {1} ms (cold geometry cache) and {2} ms (warm geometry cache)", tiles.Count(), (float)times[0], (float)times[1]);
+    return (float)times[1];
+}
+
 void NavMeshBuilder::Build(Scene* scene, const BoundingBox& dirtyBounds, float timeoutMs)
 {
     // Early out if scene is not using navigation
@@ -4,6 +4,8 @@
 
 #if COMPILE_WITH_NAV_MESH_BUILDER
 
+#include "Engine/Core/Collections/Array.h"
+
 class Scene;
 
 /// <summary>
@@ -14,11 +16,14 @@ class FLAXENGINE_API NavMeshBuilder
 public:
 
     static void Init();
+    static void Dispose();
     static bool IsBuildingNavMesh();
     static float GetNavMeshBuildingProgress();
     static void Update();
     static void Build(Scene* scene, float timeoutMs);
     static void Build(Scene* scene, const struct BoundingBox& dirtyBounds, float timeoutMs);
+    static void SetPriorityLocations(const Array<struct Vector3>& locations);
+    static float Benchmark(Scene* scene, int32 tilesCount);
 };
 
 #endif
@@ -1,41 +1,151 @@
 // Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
 
 #include "NavMeshRuntime.h"
+#include "NavCrowd.h"
 #include "NavigationSettings.h"
 #include "NavMesh.h"
 #include "Engine/Core/Log.h"
 #include "Engine/Core/Random.h"
+#include "Engine/Platform/CPUInfo.h"
 #include "Engine/Profiler/ProfilerCPU.h"
 #include "Engine/Threading/Threading.h"
+#include "Engine/Threading/JobSystem.h"
 #include <ThirdParty/recastnavigation/DetourNavMesh.h>
 #include <ThirdParty/recastnavigation/DetourNavMeshQuery.h>
 #include <ThirdParty/recastnavigation/RecastAlloc.h>
 
 #define MAX_NODES 2048
+#define MAX_PATH_QUERY_SLOTS 16
+#define MAX_POOLED_QUERIES 16
 #define USE_DATA_LINK 0
 #define USE_NAV_MESH_ALLOC 1
 // TODO: try not using USE_NAV_MESH_ALLOC
 
+struct NavMeshPathRequest
+{
+    uint32 ID;
+    NavMeshPathRequestStatus Status;
+    bool Restarted;
+    Vector3 StartPosition;
+    Vector3 StartPositionNavMesh;
+    Vector3 EndPositionNavMesh;
+    dtPolyRef StartPoly;
+    dtQueryFilter Filter;
+    Array<Vector3, HeapAllocation> ResultPath;
+};
+
 namespace
 {
     FORCE_INLINE void InitFilter(dtQueryFilter& filter)
     {
         Platform::MemoryCopy(filter.m_areaCost, NavMeshRuntime::NavAreasCosts, sizeof(NavMeshRuntime::NavAreasCosts));
     }
+
+    bool FindStraightPath(const NavMeshProperties& properties, const dtNavMeshQuery* query, const Vector3& startPosition, const Vector3& startPositionNavMesh, const Vector3& endPositionNavMesh, dtPolyRef startPoly, const dtPolyRef* path, int32 pathSize, dtStatus findPathStatus, Array<Vector3, HeapAllocation>& resultPath)
+    {
+        Quaternion invRotation;
+        Quaternion::Invert(properties.Rotation, invRotation);
+
+        if (pathSize == 1 && dtStatusDetail(findPathStatus, DT_PARTIAL_RESULT))
+        {
+            // TODO: skip adding 2nd end point if it's not reachable (use navmesh raycast check? or physics check? or local Z distance check?)
+            resultPath.Resize(2);
+            resultPath[0] = startPosition;
+            resultPath[1] = startPositionNavMesh;
+            query->closestPointOnPolyBoundary(startPoly, &endPositionNavMesh.X, &resultPath[1].X);
+            Vector3::Transform(resultPath[1], invRotation, resultPath[1]);
+        }
+        else
+        {
+            int straightPathCount = 0;
+            resultPath.EnsureCapacity(NAV_MESH_PATH_MAX_SIZE);
+            const auto findStraightPathStatus = query->findStraightPath(&startPositionNavMesh.X, &endPositionNavMesh.X, path, pathSize, (float*)resultPath.Get(), nullptr, nullptr, &straightPathCount, resultPath.Capacity(), DT_STRAIGHTPATH_AREA_CROSSINGS);
+            if (dtStatusFailed(findStraightPathStatus))
+            {
+                return false;
+            }
+            resultPath.Resize(straightPathCount);
+            for (auto& pos : resultPath)
+                Vector3::Transform(pos, invRotation, pos);
+        }
+
+        return true;
+    }
+
+    bool StartPathRequest(const NavMeshProperties& properties, dtNavMeshQuery* query, NavMeshPathRequest& request)
+    {
+        InitFilter(request.Filter);
+        Vector3 extent = properties.DefaultQueryExtent;
+
+        request.StartPoly = 0;
+        query->findNearestPoly(&request.StartPositionNavMesh.X, &extent.X, &request.Filter, &request.StartPoly, nullptr);
+        if (!request.StartPoly)
+        {
+            return false;
+        }
+        dtPolyRef endPoly = 0;
+        query->findNearestPoly(&request.EndPositionNavMesh.X, &extent.X, &request.Filter, &endPoly, nullptr);
+        if (!endPoly)
+        {
+            return false;
+        }
+
+        return !dtStatusFailed(query->initSlicedFindPath(request.StartPoly, endPoly, &request.StartPositionNavMesh.X, &request.EndPositionNavMesh.X, &request.Filter));
+    }
+}
+
+namespace
+{
+    // Acquires the navmesh query from the pool for the current scope.
+    struct NavMeshQueryScope
+    {
+        const NavMeshRuntime* Runtime;
+        dtNavMeshQuery* Query;
+
+        NavMeshQueryScope(const NavMeshRuntime* runtime)
+            : Runtime(runtime)
+            , Query(runtime->AcquireNavMeshQuery())
+        {
+        }
+
+        ~NavMeshQueryScope()
+        {
+            Runtime->ReleaseNavMeshQuery(Query);
+        }
+
+        NavMeshQueryScope(const NavMeshQueryScope&) = delete;
+        NavMeshQueryScope& operator=(const NavMeshQueryScope&) = delete;
+
+        FORCE_INLINE dtNavMeshQuery* operator->() const
+        {
+            return Query;
+        }
+
+        FORCE_INLINE operator dtNavMeshQuery*() const
+        {
+            return Query;
+        }
+    };
 }
 
 NavMeshRuntime::NavMeshRuntime(const NavMeshProperties& properties)
     : Properties(properties)
 {
     _navMesh = nullptr;
-    _navMeshQuery = dtAllocNavMeshQuery();
+    _navMeshVersion = 1;
     _tileSize = 0;
+    _pathRequestsCounter = 0;
 }
 
 NavMeshRuntime::~NavMeshRuntime()
 {
+    NavCrowd::OnNavMeshDeleted(this);
     dtFreeNavMesh(_navMesh);
-    dtFreeNavMeshQuery(_navMeshQuery);
+    for (auto& e : _queries)
+        dtFreeNavMeshQuery(e.Query);
+    for (auto& slot : _pathQuerySlots)
+        dtFreeNavMeshQuery(slot.Query);
+    _pathRequests.ClearDelete();
 }
 
 int32 NavMeshRuntime::GetTilesCapacity() const
@@ -43,11 +153,55 @@ int32 NavMeshRuntime::GetTilesCapacity() const
     return _navMesh ? _navMesh->getMaxTiles() : 0;
 }
 
+dtNavMeshQuery* NavMeshRuntime::AcquireNavMeshQuery() const
+{
+    if (!_navMesh)
+        return nullptr;
+    QueryEntry e = { nullptr, 0 };
+    _queriesLocker.Lock();
+    if (_queries.HasItems())
+    {
+        e = _queries.Last();
+        _queries.RemoveLast();
+    }
+    _queriesLocker.Unlock();
+    if (!e.Query)
+        e.Query = dtAllocNavMeshQuery();
+    if (e.Version != _navMeshVersion)
+    {
+        // Navmesh has been recreated so reinitialize the query
+        if (dtStatusFailed(e.Query->init(_navMesh, MAX_NODES)))
+        {
+            LOG(Error, "Failed to initialize navmesh {0} query.", Properties.Name);
+            dtFreeNavMeshQuery(e.Query);
+            return nullptr;
+        }
+    }
+    return e.Query;
+}
+
+void NavMeshRuntime::ReleaseNavMeshQuery(dtNavMeshQuery* query) const
+{
+    if (!query)
+        return;
+
+    // Keep only a limited amount of the free queries (each query holds the nodes pool)
+    _queriesLocker.Lock();
+    if (_queries.Count() < MAX_POOLED_QUERIES)
+    {
+        _queries.Add({ query, _navMeshVersion });
+        query = nullptr;
+    }
+    _queriesLocker.Unlock();
+    if (query)
+        dtFreeNavMeshQuery(query);
+}
+
 bool NavMeshRuntime::FindDistanceToWall(const Vector3& startPosition, NavMeshHit& hitInfo, float maxDistance) const
 {
-    ScopeLock lock(Locker);
+    ScopeReadLock lock(_queryLocker);
 
-    const auto query = GetNavMeshQuery();
+    const NavMeshQueryScope query(this);
     if (!query || !_navMesh)
     {
         return false;
@@ -83,9 +237,9 @@ bool NavMeshRuntime::FindDistanceToWall(const Vector3& startPosition, NavMeshHit
 bool NavMeshRuntime::FindPath(const Vector3& startPosition, const Vector3& endPosition, Array<Vector3, HeapAllocation>& resultPath) const
 {
     resultPath.Clear();
-    ScopeLock lock(Locker);
+    ScopeReadLock lock(_queryLocker);
 
-    const auto query = GetNavMeshQuery();
+    const NavMeshQueryScope query(this);
     if (!query || !_navMesh)
     {
         return false;
@@ -120,40 +274,14 @@ bool NavMeshRuntime::FindPath(const Vector3& startPosition, const Vector3& endPo
         return false;
     }
 
-    Quaternion invRotation;
-    Quaternion::Invert(Properties.Rotation, invRotation);
-
-    if (pathSize == 1 && dtStatusDetail(findPathStatus, DT_PARTIAL_RESULT))
-    {
-        // TODO: skip adding 2nd end point if it's not reachable (use navmesh raycast check? or physics check? or local Z distance check?)
-        resultPath.Resize(2);
-        resultPath[0] = startPosition;
-        resultPath[1] = startPositionNavMesh;
-        query->closestPointOnPolyBoundary(startPoly, &endPositionNavMesh.X, &resultPath[1].X);
-        Vector3::Transform(resultPath[1], invRotation, resultPath[1]);
-    }
-    else
-    {
-        int straightPathCount = 0;
-        resultPath.EnsureCapacity(NAV_MESH_PATH_MAX_SIZE);
-        const auto findStraightPathStatus = query->findStraightPath(&startPositionNavMesh.X, &endPositionNavMesh.X, path, pathSize, (float*)resultPath.Get(), nullptr, nullptr, &straightPathCount, resultPath.Capacity(), DT_STRAIGHTPATH_AREA_CROSSINGS);
-        if (dtStatusFailed(findStraightPathStatus))
-        {
-            return false;
-        }
-        resultPath.Resize(straightPathCount);
-        for (auto& pos : resultPath)
-            Vector3::Transform(pos, invRotation, pos);
-    }
-
-    return true;
+    return FindStraightPath(Properties, query, startPosition, startPositionNavMesh, endPositionNavMesh, startPoly, path, pathSize, findPathStatus, resultPath);
 }
 
 bool NavMeshRuntime::TestPath(const Vector3& startPosition, const Vector3& endPosition) const
 {
-    ScopeLock lock(Locker);
+    ScopeReadLock lock(_queryLocker);
 
-    const auto query = GetNavMeshQuery();
+    const NavMeshQueryScope query(this);
     if (!query || !_navMesh)
     {
         return false;
@@ -198,9 +326,9 @@ bool NavMeshRuntime::TestPath(const Vector3& startPosition, const Vector3& endPo
 
 bool NavMeshRuntime::ProjectPoint(const Vector3& point, Vector3& result) const
 {
-    ScopeLock lock(Locker);
+    ScopeReadLock lock(_queryLocker);
 
-    const auto query = GetNavMeshQuery();
+    const NavMeshQueryScope query(this);
     if (!query || !_navMesh)
     {
         return false;
@@ -229,9 +357,9 @@ bool NavMeshRuntime::ProjectPoint(const Vector3& point, Vector3& result) const
 
 bool NavMeshRuntime::FindRandomPoint(Vector3& result) const
 {
-    ScopeLock lock(Locker);
+    ScopeReadLock lock(_queryLocker);
 
-    const auto query = GetNavMeshQuery();
+    const NavMeshQueryScope query(this);
     if (!query || !_navMesh)
     {
         return false;
@@ -256,9 +384,9 @@ bool NavMeshRuntime::FindRandomPoint(Vector3& result) const
 
 bool NavMeshRuntime::FindRandomPointAroundCircle(const Vector3& center, float radius, Vector3& result) const
 {
-    ScopeLock lock(Locker);
+    ScopeReadLock lock(_queryLocker);
 
-    const auto query = GetNavMeshQuery();
+    const NavMeshQueryScope query(this);
     if (!query || !_navMesh)
     {
         return false;
@@ -294,9 +422,9 @@ bool NavMeshRuntime::FindRandomPointAroundCircle(const Vector3& center, float ra
 
 bool NavMeshRuntime::RayCast(const Vector3& startPosition, const Vector3& endPosition, NavMeshHit& hitInfo) const
 {
-    ScopeLock lock(Locker);
+    ScopeReadLock lock(_queryLocker);
 
-    const auto query = GetNavMeshQuery();
+    const NavMeshQueryScope query(this);
     if (!query || !_navMesh)
     {
         return false;
@@ -336,9 +464,184 @@ bool NavMeshRuntime::RayCast(const Vector3& startPosition, const Vector3& endPos
     return result;
 }
 
+uint32 NavMeshRuntime::RequestPath(const Vector3& startPosition, const Vector3& endPosition)
+{
+    auto request = New<NavMeshPathRequest>();
+    request->Status = NavMeshPathRequestStatus::Pending;
+    request->Restarted = false;
+    request->StartPosition = startPosition;
+    Vector3::Transform(startPosition, Properties.Rotation, request->StartPositionNavMesh);
+    Vector3::Transform(endPosition, Properties.Rotation, request->EndPositionNavMesh);
+    request->StartPoly = 0;
+
+    ScopeLock lock(_pathRequestsLocker);
+    if (++_pathRequestsCounter == 0)
+        _pathRequestsCounter = 1;
+    request->ID = _pathRequestsCounter;
+    _pathRequests.Add(request->ID, request);
+    _pathRequestsQueue.Add(request);
+    return request->ID;
+}
+
+NavMeshPathRequestStatus NavMeshRuntime::GetPathRequest(uint32 requestId, Array<Vector3, HeapAllocation>& resultPath)
+{
+    ScopeLock lock(_pathRequestsLocker);
+    NavMeshPathRequest* request;
+    if (!_pathRequests.TryGet(requestId, request))
+        return NavMeshPathRequestStatus::Invalid;
+    const auto status = request->Status;
+    if (status != NavMeshPathRequestStatus::Pending)
+    {
+        // Release completed request
+        resultPath.Swap(request->ResultPath);
+        _pathRequests.Remove(requestId);
+        Delete(request);
+    }
+    return status;
+}
+
+void NavMeshRuntime::CancelPathRequest(uint32 requestId)
+{
+    ScopeLock lock(_pathRequestsLocker);
+    NavMeshPathRequest* request;
+    if (!_pathRequests.TryGet(requestId, request))
+        return;
+    if (request->Status == NavMeshPathRequestStatus::Pending)
+    {
+        _pathRequestsQueue.RemoveKeepOrder(request);
+        for (auto& slot : _pathQuerySlots)
+        {
+            if (slot.Active == request)
+                slot.Active = nullptr;
+        }
+    }
+    _pathRequests.Remove(requestId);
+    Delete(request);
+}
+
+void NavMeshRuntime::UpdatePathRequests(int32 maxIterations)
+{
+    ScopeLock lock(_pathRequestsLocker);
+    int32 activeCount = 0;
+    for (const auto& slot : _pathQuerySlots)
+    {
+        if (slot.Active)
+            activeCount++;
+    }
+    if (activeCount == 0 && _pathRequestsQueue.IsEmpty())
+        return;
+
+    PROFILE_CPU_NAMED("NavMeshRuntime.UpdatePathRequests");
+
+    ScopeReadLock queryLock(_queryLocker);
+    if (!_navMesh)
+        return;
+
+    // Ensure to have enough query slots (each slot keeps the sliced path search state between updates so the count never decreases)
+    const int32 maxSlots = Math::Clamp<int32>((int32)Platform::GetCPUInfo().ProcessorCoreCount, 1, MAX_PATH_QUERY_SLOTS);
+    const int32 slotsCount = Math::Min(activeCount + _pathRequestsQueue.Count(), maxSlots);
+    while (_pathQuerySlots.Count() < slotsCount)
+    {
+        auto& slot = _pathQuerySlots.AddOne();
+        slot.Query = dtAllocNavMeshQuery();
+        slot.Version = 0;
+        slot.Active = nullptr;
+    }
+
+    // Process requests in parallel, each slot pulls the queued requests until the iterations budget is used
+    // Note: calling thread executes the slots too so it never waits for the other jobs while holding the locks
+    int64 queueIndex = 0;
+    const int32 slotIterations = Math::Max(maxIterations / _pathQuerySlots.Count(), 1);
+    Function<void(int32)> job = [this, slotIterations, &queueIndex](int32 slotIndex)
+    {
+        UpdatePathQuerySlot(_pathQuerySlots[slotIndex], slotIterations, &queueIndex);
+    };
+    JobSystem::Execute(job, _pathQuerySlots.Count());
+
+    // Remove dequeued requests
+    const int32 dequeued = Math::Min((int32)queueIndex, _pathRequestsQueue.Count());
+    if (dequeued == _pathRequestsQueue.Count())
+    {
+        _pathRequestsQueue.Clear();
+    }
+    else if (dequeued != 0)
+    {
+        for (int32 i = dequeued; i < _pathRequestsQueue.Count(); i++)
+            _pathRequestsQueue[i - dequeued] = _pathRequestsQueue[i];
+        _pathRequestsQueue.Resize(_pathRequestsQueue.Count() - dequeued);
+    }
+}
+
+void NavMeshRuntime::UpdatePathQuerySlot(PathQuerySlot& slot, int32 maxIterations, int64 volatile* queueIndex)
+{
+    if (slot.Version != _navMeshVersion)
+    {
+        // Navmesh has been recreated so reinitialize the query and restart the active search
+        slot.Version = _navMeshVersion;
+        if (dtStatusFailed(slot.Query->init(_navMesh, MAX_NODES)))
+        {
+            LOG(Error, "Failed to initialize navmesh {0} query.", Properties.Name);
+        }
+        if (slot.Active && !StartPathRequest(Properties, slot.Query, *slot.Active))
+        {
+            slot.Active->Status = NavMeshPathRequestStatus::Failed;
+            slot.Active = nullptr;
+        }
+    }
+
+    while (maxIterations > 0)
+    {
+        if (!slot.Active)
+        {
+            // Pick the next queued request
+            const int64 index = Platform::InterlockedIncrement(queueIndex) - 1;
+            if (index >= _pathRequestsQueue.Count())
+                break;
+            auto request = _pathRequestsQueue[(int32)index];
+            if (!StartPathRequest(Properties, slot.Query, *request))
+            {
+                request->Status = NavMeshPathRequestStatus::Failed;
+                continue;
+            }
+            slot.Active = request;
+        }
+        auto& request = *slot.Active;
+
+        // Continue the sliced search
+        int32 iterations = 0;
+        const dtStatus status = slot.Query->updateSlicedFindPath(maxIterations, &iterations);
+        maxIterations -= Math::Max(iterations, 1);
+        if (dtStatusFailed(status))
+        {
+            // Navmesh tiles could be modified during search so retry it once
+            if (!request.Restarted)
+            {
+                request.Restarted = true;
+                if (StartPathRequest(Properties, slot.Query, request))
+                    continue;
+            }
+            request.Status = NavMeshPathRequestStatus::Failed;
+            slot.Active = nullptr;
+        }
+        else if (dtStatusSucceed(status))
+        {
+            // Build the result path
+            dtPolyRef path[NAV_MESH_PATH_MAX_SIZE];
+            int32 pathSize;
+            const dtStatus findPathStatus = slot.Query->finalizeSlicedFindPath(path, &pathSize, NAV_MESH_PATH_MAX_SIZE);
+            if (!dtStatusFailed(findPathStatus) && FindStraightPath(Properties, slot.Query, request.StartPosition, request.StartPositionNavMesh, request.EndPositionNavMesh, request.StartPoly, path, pathSize, findPathStatus, request.ResultPath))
+                request.Status = NavMeshPathRequestStatus::Succeed;
+            else
+                request.Status = NavMeshPathRequestStatus::Failed;
+            slot.Active = nullptr;
+        }
+    }
+}
+
 void NavMeshRuntime::SetTileSize(float tileSize)
 {
     ScopeLock lock(Locker);
+    ScopeWriteLock writeLock(_queryLocker);
 
     // Skip if the same or invalid
     if (Math::NearEqual(_tileSize, tileSize) || tileSize < 1)
@@ -349,6 +652,7 @@ void NavMeshRuntime::SetTileSize(float tileSize)
     {
         dtFreeNavMesh(_navMesh);
         _navMesh = nullptr;
+        _navMeshVersion++;
         _tiles.Clear();
     }
 
@@ -358,6 +662,7 @@ void NavMeshRuntime::SetTileSize(float tileSize)
 void NavMeshRuntime::EnsureCapacity(int32 tilesToAddCount)
 {
     ScopeLock lock(Locker);
+    ScopeWriteLock writeLock(_queryLocker);
 
     const int32 newTilesCount = _tiles.Count() + tilesToAddCount;
     const int32 capacity = GetTilesCapacity();
@@ -382,12 +687,9 @@ void NavMeshRuntime::EnsureCapacity(int32 tilesToAddCount)
         dtFreeNavMesh(_navMesh);
     }
 
-    // Allocate new navmesh
+    // Allocate new navmesh (queries get reinitialized on the next use)
     _navMesh = dtAllocNavMesh();
-    if (dtStatusFailed(_navMeshQuery->init(_navMesh, MAX_NODES)))
-    {
-        LOG(Error, "Failed to initialize navmesh {0}.", Properties.Name);
-    }
+    _navMeshVersion++;
 
     // Prepare parameters
     dtNavMeshParams params;
@@ -441,6 +743,7 @@ void NavMeshRuntime::AddTiles(NavMesh* navMesh)
     PROFILE_CPU_NAMED("NavMeshRuntime.AddTiles");
 
     ScopeLock lock(Locker);
+    ScopeWriteLock writeLock(_queryLocker);
 
     // Validate data (must match navmesh) or init navmesh to match the tiles options
     if (_navMesh)
@@ -474,6 +777,7 @@ void NavMeshRuntime::AddTile(NavMesh* navMesh, NavMeshTileData& tileData)
     PROFILE_CPU_NAMED("NavMeshRuntime.AddTile");
 
     ScopeLock lock(Locker);
+    ScopeWriteLock writeLock(_queryLocker);
 
     // Validate data (must match navmesh) or init navmesh to match the tiles options
     if (_navMesh)
@@ -509,6 +813,7 @@ void NavMeshRuntime::RemoveTiles(NavMesh* navMesh)
 void NavMeshRuntime::RemoveTile(int32 x, int32 y, int32 layer)
 {
     ScopeLock lock(Locker);
+    ScopeWriteLock writeLock(_queryLocker);
 
     // Skip if no data
     if (!_navMesh)
@@ -541,6 +846,7 @@ void NavMeshRuntime::RemoveTile(int32 x, int32 y, int32 layer)
 void NavMeshRuntime::RemoveTiles(bool (* prediction)(const NavMeshRuntime* navMesh, const NavMeshTile& tile, void* customData), void* userData)
 {
     ScopeLock lock(Locker);
+    ScopeWriteLock writeLock(_queryLocker);
 
     // Skip if no data
     ASSERT(prediction);
@@ -649,7 +955,7 @@ void DrawPoly(NavMeshRuntime* navMesh, const Matrix& navMeshToWorld, const dtMes
 
 void NavMeshRuntime::DebugDraw()
 {
-    ScopeLock lock(Locker);
+    ScopeReadLock lock(_queryLocker);
 
     const dtNavMesh* dtNavMesh = GetNavMesh();
     const int tilesCount = dtNavMesh ? dtNavMesh->getMaxTiles() : 0;
@@ -682,10 +988,14 @@ void NavMeshRuntime::DebugDraw()
 
 void NavMeshRuntime::Dispose()
 {
+    ScopeLock lock(Locker);
+    ScopeWriteLock writeLock(_queryLocker);
+
     if (_navMesh)
     {
         dtFreeNavMesh(_navMesh);
         _navMesh = nullptr;
+        _navMeshVersion++;
     }
     _tiles.Resize(0);
 }
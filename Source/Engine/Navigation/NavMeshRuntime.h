@@ -3,13 +3,16 @@
 #pragma once
 
 #include "Engine/Core/Types/BaseTypes.h"
+#include "Engine/Core/Collections/Dictionary.h"
 #include "Engine/Platform/CriticalSection.h"
+#include "Engine/Threading/ReadWriteLock.h"
 #include "NavMeshData.h"
 #include "NavigationTypes.h"
 
 class dtNavMesh;
 class dtNavMeshQuery;
 class NavMesh;
+struct NavMeshPathRequest;
 
 /// <summary>
 /// The navigation mesh tile data.
@@ -49,10 +52,31 @@ class FLAXENGINE_API NavMeshRuntime
 
 private:
 
+    struct QueryEntry
+    {
+        dtNavMeshQuery* Query;
+        int64 Version;
+    };
+
+    struct PathQuerySlot
+    {
+        dtNavMeshQuery* Query;
+        int64 Version;
+        NavMeshPathRequest* Active;
+    };
+
     dtNavMesh* _navMesh;
-    dtNavMeshQuery* _navMeshQuery;
+    int64 _navMeshVersion;
     float _tileSize;
     Array<NavMeshTile> _tiles;
+    ReadWriteLock _queryLocker;
+    mutable CriticalSection _queriesLocker;
+    mutable Array<QueryEntry> _queries;
+    CriticalSection _pathRequestsLocker;
+    uint32 _pathRequestsCounter;
+    Dictionary<uint32, NavMeshPathRequest*> _pathRequests;
+    Array<NavMeshPathRequest*> _pathRequestsQueue;
+    Array<PathQuerySlot> _pathQuerySlots;
 
 public:
 
@@ -62,7 +86,7 @@ class FLAXENGINE_API NavMeshRuntime
 public:
 
     /// <summary>
-    /// The object locker.
+    /// The object locker. Used to synchronize navmesh modifications (queries don't use it and can run in parallel).
     /// </summary>
     CriticalSection Locker;
 
@@ -84,9 +108,42 @@ class FLAXENGINE_API NavMeshRuntime
         return _navMesh;
     }
 
-    dtNavMeshQuery* GetNavMeshQuery() const
+    /// <summary>
+    /// Gets the navmesh version. Gets incremented every time the Detour navmesh object gets recreated (eg. on capacity change) so any objects that cache it have to be reinitialized.
+    /// </summary>
+    FORCE_INLINE int64 GetNavMeshVersion() const
+    {
+        return _navMeshVersion;
+    }
+
+    /// <summary>
+    /// Acquires the navmesh query object from the pool (each concurrent caller uses own query). Returns null if navmesh is not initialized or query init failed.
+    /// </summary>
+    /// <remarks>
+    /// Call it only within ReadLock/ReadUnlock scope and release the query with <see cref="ReleaseNavMeshQuery"/> before the read lock is released (navmesh can be recreated after that).
+    /// </remarks>
+    dtNavMeshQuery* AcquireNavMeshQuery() const;
+
+    /// <summary>
+    /// Returns the navmesh query object acquired with <see cref="AcquireNavMeshQuery"/> back to the pool.
+    /// </summary>
+    /// <param name="query">The query object. Can be null.</param>
+    void ReleaseNavMeshQuery(dtNavMeshQuery* query) const;
+
+    /// <summary>
+    /// Locks the navmesh for reading (multiple threads can query navmesh at once). Prevents navmesh modifications.
+    /// </summary>
+    FORCE_INLINE void ReadLock() const
+    {
+        _queryLocker.ReadLock();
+    }
+
+    /// <summary>
+    /// Unlocks the navmesh after reading.
+    /// </summary>
+    FORCE_INLINE void ReadUnlock() const
     {
-        return _navMeshQuery;
+        _queryLocker.ReadUnlock();
     }
 
     int32 GetTilesCapacity() const;
@@ -152,6 +209,36 @@ class FLAXENGINE_API NavMeshRuntime
     /// <returns>True if ray hits an matching object, otherwise false.</returns>
     bool RayCast(const Vector3& startPosition, const Vector3& endPosition, NavMeshHit& hitInfo) const;
 
+public:
+
+    /// <summary>
+    /// Requests the asynchronous path finding between the two positions. Requests are processed in batches during engine update (on job system threads) with a limited amount of iterations per frame.
+    /// </summary>
+    /// <param name="startPosition">The start position.</param>
+    /// <param name="endPosition">The end position.</param>
+    /// <returns>The request identifier used to query the result. Zero if failed.</returns>
+    uint32 RequestPath(const Vector3& startPosition, const Vector3& endPosition);
+
+    /// <summary>
+    /// Gets the asynchronous path request result. Completed requests are released after this call (result can be taken only once).
+    /// </summary>
+    /// <param name="requestId">The request identifier.</param>
+    /// <param name="resultPath">The result path (valid only if request succeed).</param>
+    /// <returns>The request status.</returns>
+    NavMeshPathRequestStatus GetPathRequest(uint32 requestId, Array<Vector3, HeapAllocation>& resultPath);
+
+    /// <summary>
+    /// Cancels the asynchronous path request.
+    /// </summary>
+    /// <param name="requestId">The request identifier.</param>
+    void CancelPathRequest(uint32 requestId);
+
+    /// <summary>
+    /// Processes the pending asynchronous path requests. Searches are distributed over the job system threads and the ones that didn't finish within the given budget are resumed on the next update.
+    /// </summary>
+    /// <param name="maxIterations">The maximum amount of path finding iterations (visited nodes) to perform by all requests.</param>
+    void UpdatePathRequests(int32 maxIterations);
+
 public:
 
     /// <summary>
@@ -212,4 +299,5 @@ class FLAXENGINE_API NavMeshRuntime
 private:
 
     void AddTileInternal(NavMesh* navMesh, NavMeshTileData& tileData);
+    void UpdatePathQuerySlot(PathQuerySlot& slot, int32 maxIterations, int64 volatile* queueIndex);
 };
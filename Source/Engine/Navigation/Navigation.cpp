@@ -4,6 +4,7 @@
 #include "NavigationSettings.h"
 #include "NavMeshRuntime.h"
 #include "NavMeshBuilder.h"
+#include "NavCrowd.h"
 #include "Engine/Core/Config/GameSettings.h"
 #include "Engine/Content/Content.h"
 #include "Engine/Content/JsonAsset.h"
@@ -15,6 +16,7 @@
 #include "NavMesh.h"
 
 #include "Engine/Engine/EngineService.h"
+#include "Engine/Engine/Time.h"
 #include "Engine/Profiler/ProfilerCPU.h"
 #include "Engine/Serialization/Serialization.h"
 #include <ThirdParty/recastnavigation/DetourNavMesh.h>
@@ -162,9 +164,7 @@ class NavigationService : public EngineService
     }
 
     bool Init() override;
-#if COMPILE_WITH_NAV_MESH_BUILDER
     void Update() override;
-#endif
     void Dispose() override;
 };
 
@@ -222,6 +222,7 @@ void NavigationSettings::Deserialize(DeserializeStream& stream, ISerializeModifi
 {
     DESERIALIZE(AutoAddMissingNavMeshes);
     DESERIALIZE(AutoRemoveMissingNavMeshes);
+    DESERIALIZE(MaxPathRequestsIterations);
     DESERIALIZE(CellHeight);
     DESERIALIZE(CellSize);
     DESERIALIZE(TileSize);
@@ -266,17 +267,27 @@ bool NavigationService::Init()
     return false;
 }
 
-#if COMPILE_WITH_NAV_MESH_BUILDER
-
 void NavigationService::Update()
 {
+#if COMPILE_WITH_NAV_MESH_BUILDER
     NavMeshBuilder::Update();
-}
-
 #endif
 
+    // Process async path requests
+    const int32 maxIterations = NavigationSettings::Get()->MaxPathRequestsIterations;
+    for (auto navMesh : NavMeshes)
+        navMesh->UpdatePathRequests(maxIterations);
+
+    // Simulate crowds
+    NavCrowd::UpdateAll(Time::Update.DeltaTime.GetTotalSeconds());
+}
+
 void NavigationService::Dispose()
 {
+#if COMPILE_WITH_NAV_MESH_BUILDER
+    NavMeshBuilder::Dispose();
+#endif
+
     // Release nav meshes
     for (auto navMesh : NavMeshes)
     {
@@ -336,6 +347,26 @@ bool Navigation::RayCast(const Vector3& startPosition, const Vector3& endPositio
     return NavMeshes.First()->RayCast(startPosition, endPosition, hitInfo);
 }
 
+uint32 Navigation::RequestPath(const Vector3& startPosition, const Vector3& endPosition)
+{
+    if (NavMeshes.IsEmpty())
+        return 0;
+    return NavMeshes.First()->RequestPath(startPosition, endPosition);
+}
+
+NavMeshPathRequestStatus Navigation::GetPathRequest(uint32 requestId, Array<Vector3, HeapAllocation>& resultPath)
+{
+    if (NavMeshes.IsEmpty())
+        return NavMeshPathRequestStatus::Invalid;
+    return NavMeshes.First()->GetPathRequest(requestId, resultPath);
+}
+
+void Navigation::CancelPathRequest(uint32 requestId)
+{
+    if (NavMeshes.HasItems())
+        NavMeshes.First()->CancelPathRequest(requestId);
+}
+
 #if COMPILE_WITH_NAV_MESH_BUILDER
 
 bool Navigation::IsBuildingNavMesh()
@@ -358,6 +389,16 @@ void Navigation::BuildNavMesh(Scene* scene, const BoundingBox& dirtyBounds, floa
     NavMeshBuilder::Build(scene, dirtyBounds, timeoutMs);
 }
 
+void Navigation::SetNavMeshBuildPriorityLocations(const Array<Vector3, HeapAllocation>& locations)
+{
+    NavMeshBuilder::SetPriorityLocations(locations);
+}
+
+float Navigation::BenchmarkNavMeshBuild(Scene* scene, int32 tilesCount)
+{
+    return scene ? NavMeshBuilder::Benchmark(scene, tilesCount) : -1.0f;
+}
+
 #endif
 
 #if COMPILE_WITH_DEBUG_DRAW
@@ -73,6 +73,30 @@ DECLARE_SCRIPTING_TYPE_NO_SPAWN(Navigation);
     /// <returns>True if ray hits an matching object, otherwise false.</returns>
     API_FUNCTION() static bool RayCast(const Vector3& startPosition, const Vector3& endPosition, API_PARAM(Out) NavMeshHit& hitInfo);
 
+public:
+
+    /// <summary>
+    /// Requests the asynchronous path finding between the two positions. Requests are processed in batches during engine update (in parallel, with a limited amount of path finding iterations per frame, see NavigationSettings.MaxPathRequestsIterations). Use it to replan paths for many agents without stalling game logic.
+    /// </summary>
+    /// <param name="startPosition">The start position.</param>
+    /// <param name="endPosition">The end position.</param>
+    /// <returns>The request identifier used to query the result. Zero if failed.</returns>
+    API_FUNCTION() static uint32 RequestPath(const Vector3& startPosition, const Vector3& endPosition);
+
+    /// <summary>
+    /// Gets the asynchronous path request result. Completed requests are released after this call (result can be taken only once).
+    /// </summary>
+    /// <param name="requestId">The request identifier.</param>
+    /// <param name="resultPath">The result path (valid only if request succeed).</param>
+    /// <returns>The request status.</returns>
+    API_FUNCTION() static NavMeshPathRequestStatus GetPathRequest(uint32 requestId, API_PARAM(Out) Array<Vector3, HeapAllocation>& resultPath);
+
+    /// <summary>
+    /// Cancels the asynchronous path request.
+    /// </summary>
+    /// <param name="requestId">The request identifier.</param>
+    API_FUNCTION() static void CancelPathRequest(uint32 requestId);
+
 public:
 
 #if COMPILE_WITH_NAV_MESH_BUILDER
@@ -108,6 +132,20 @@ DECLARE_SCRIPTING_TYPE_NO_SPAWN(Navigation);
     /// <param name="timeoutMs">The timeout to wait before building Nav Mesh (in milliseconds).</param>
     API_FUNCTION() static void BuildNavMesh(Scene* scene, const BoundingBox& dirtyBounds, float timeoutMs = 50);
 
+    /// <summary>
+    /// Sets the locations (eg. players positions) used to prioritize the navmesh tiles building. Tiles closer to those locations are built first. Use empty list to prioritize by the main camera location.
+    /// </summary>
+    /// <param name="locations">The locations (in world space).</param>
+    API_FUNCTION() static void SetNavMeshBuildPriorityLocations(const Array<Vector3, HeapAllocation>& locations);
+
+    /// <summary>
+    /// Measures the navmesh building performance by rebuilding the given amount of the already built tiles of the scene navmesh on the calling thread (without and then with the cached colliders geometry). Logs the results.
+    /// </summary>
+    /// <param name="scene">The scene with the built navmesh.</param>
+    /// <param name="tilesCount">The amount of tiles to rebuild.</param>
+    /// <returns>The time of the tiles rebuilding with the cached geometry (in milliseconds) or -1 if failed.</returns>
+    API_FUNCTION() static float BenchmarkNavMeshBuild(Scene* scene, int32 tilesCount = 16);
+
 #endif
 
 #if COMPILE_WITH_DEBUG_DRAW
@@ -23,6 +23,8 @@ public NavigationSettings()
             navMesh.Agent.Height = 144.0f;
             navMesh.Agent.StepHeight = 35.0f;
             navMesh.Agent.MaxSlopeAngle = 60.0f;
+            navMesh.Agent.MaxSpeed = 500.0f;
+            navMesh.Agent.CrowdSeparationWeight = 2.0f;
             navMesh.DefaultQueryExtent = new Vector3(50.0f, 250.0f, 50.0f);
 
             // Init nav areas
@@ -53,6 +55,8 @@ private void UpgradeToNavMeshes()
             navMesh.Agent.Height = 144.0f;
             navMesh.Agent.StepHeight = 35.0f;
             navMesh.Agent.MaxSlopeAngle = 60.0f;
+            navMesh.Agent.MaxSpeed = 500.0f;
+            navMesh.Agent.CrowdSeparationWeight = 2.0f;
             navMesh.DefaultQueryExtent = new Vector3(50.0f, 250.0f, 50.0f);
         }
 
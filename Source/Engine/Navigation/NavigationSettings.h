@@ -26,6 +26,12 @@ DECLARE_SCRIPTING_TYPE_MINIMAL(NavigationSettings);
     API_FIELD(Attributes="EditorOrder(110), EditorDisplay(\"Navigation\")")
     bool AutoRemoveMissingNavMeshes = true;
 
+    /// <summary>
+    /// The maximum amount of path finding iterations (visited nodes) performed per frame on the asynchronous path requests (per navmesh). Requests that exceed it are resumed in the next frame.
+    /// </summary>
+    API_FIELD(Attributes="Limit(1), EditorOrder(120), EditorDisplay(\"Navigation\")")
+    int32 MaxPathRequestsIterations = 4096;
+
 public:
 
     /// <summary>
@@ -43,6 +43,18 @@ DECLARE_SCRIPTING_TYPE_MINIMAL(NavAgentProperties);
     API_FIELD(Attributes="EditorOrder(30)")
     float MaxSlopeAngle = 60.0f;
 
+    /// <summary>
+    /// The maximum movement speed (units/second). Used by the crowd simulation (see NavCrowd).
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(40)")
+    float MaxSpeed = 500.0f;
+
+    /// <summary>
+    /// The crowd agent separation weight. Defines how aggressive the agent should be at avoiding collisions with other agents in the crowd (higher value keeps agents farther away from each other). Used by the crowd simulation (see NavCrowd).
+    /// </summary>
+    API_FIELD(Attributes="EditorOrder(50), Limit(0)")
+    float CrowdSeparationWeight = 2.0f;
+
     bool operator==(const NavAgentProperties& other) const;
 
     bool operator!=(const NavAgentProperties& other) const
@@ -144,6 +156,32 @@ DECLARE_SCRIPTING_TYPE_MINIMAL(NavMeshHit);
     API_FIELD() Vector3 Normal;
 };
 
+/// <summary>
+/// The asynchronous navigation path request status.
+/// </summary>
+API_ENUM() enum class NavMeshPathRequestStatus
+{
+    /// <summary>
+    /// Unknown request (invalid identifier or the result has been already taken).
+    /// </summary>
+    Invalid,
+
+    /// <summary>
+    /// The request is queued or during processing.
+    /// </summary>
+    Pending,
+
+    /// <summary>
+    /// The path has been found (it may be partial).
+    /// </summary>
+    Succeed,
+
+    /// <summary>
+    /// The path could not be found.
+    /// </summary>
+    Failed,
+};
+
 /// <summary>
 /// The navigation area properties container for navmesh building and navigation runtime.
 /// </summary>
@@ -0,0 +1,203 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#include "Engine/Platform/Platform.h"
+#include "Engine/Core/Math/Math.h"
+
+/// <summary>
+/// Bit-level data writer and reader over the raw bytes buffer. Used to pack the network data tighter than the byte-aligned <see cref="NetworkMessage"/> read/write functions.
+/// </summary>
+/// <remarks>
+/// Writing or reading past the buffer end doesn't modify the memory but sets the overflow flag (the whole data should be discarded then).
+/// </remarks>
+class NetworkBitStream
+{
+private:
+
+    uint8* _buffer;
+    uint32 _sizeBits;
+    uint32 _positionBits = 0;
+    bool _overflow = false;
+
+public:
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="NetworkBitStream"/> class.
+    /// </summary>
+    /// <param name="buffer">The data buffer.</param>
+    /// <param name="size">The size of the data buffer (in bytes).</param>
+    NetworkBitStream(uint8* buffer, uint32 size)
+        : _buffer(buffer)
+        , _sizeBits(size * 8)
+    {
+    }
+
+public:
+
+    /// <summary>
+    /// Gets the current position in the buffer (in bits).
+    /// </summary>
+    FORCE_INLINE uint32 GetPositionBits() const
+    {
+        return _positionBits;
+    }
+
+    /// <summary>
+    /// Sets the current position in the buffer (in bits). Can be used to rollback the written data. Clears the overflow flag.
+    /// </summary>
+    FORCE_INLINE void SetPositionBits(uint32 position)
+    {
+        _positionBits = position;
+        _overflow = false;
+    }
+
+    /// <summary>
+    /// Gets the size of the written/read data (in bytes, rounded up).
+    /// </summary>
+    FORCE_INLINE uint32 GetPositionBytes() const
+    {
+        return (_positionBits + 7) / 8;
+    }
+
+    /// <summary>
+    /// Returns true if any read or write went past the buffer end.
+    /// </summary>
+    FORCE_INLINE bool HasOverflow() const
+    {
+        return _overflow;
+    }
+
+public:
+
+    /// <summary>
+    /// Writes the given amount of the lowest bits of the value.
+    /// </summary>
+    /// <param name="value">The value.</param>
+    /// <param name="bits">The amount of bits to write (1-32).</param>
+    void WriteBits(uint32 value, int32 bits)
+    {
+        if (_positionBits + bits > _sizeBits)
+        {
+            _overflow = true;
+            return;
+        }
+        while (bits > 0)
+        {
+            const uint32 bitOffset = _positionBits & 7;
+            const int32 count = Math::Min(8 - (int32)bitOffset, bits);
+            const uint32 mask = ((1u << count) - 1) << bitOffset;
+            uint8& dst = _buffer[_positionBits >> 3];
+            dst = (uint8)((dst & ~mask) | ((value << bitOffset) & mask));
+            value >>= count;
+            bits -= count;
+            _positionBits += count;
+        }
+    }
+
+    /// <summary>
+    /// Reads the value from the given amount of bits.
+    /// </summary>
+    /// <param name="bits">The amount of bits to read (1-32).</param>
+    /// <returns>The value.</returns>
+    uint32 ReadBits(int32 bits)
+    {
+        if (_positionBits + bits > _sizeBits)
+        {
+            _overflow = true;
+            return 0;
+        }
+        uint32 value = 0;
+        int32 shift = 0;
+        while (bits > 0)
+        {
+            const uint32 bitOffset = _positionBits & 7;
+            const int32 count = Math::Min(8 - (int32)bitOffset, bits);
+            const uint32 part = (_buffer[_positionBits >> 3] >> bitOffset) & ((1u << count) - 1);
+            value |= part << shift;
+            shift += count;
+            bits -= count;
+            _positionBits += count;
+        }
+        return value;
+    }
+
+    /// <summary>
+    /// Writes the boolean value (as a single bit).
+    /// </summary>
+    FORCE_INLINE void WriteBool(bool value)
+    {
+        WriteBits(value ? 1 : 0, 1);
+    }
+
+    /// <summary>
+    /// Reads the boolean value (from a single bit).
+    /// </summary>
+    FORCE_INLINE bool ReadBool()
+    {
+        return ReadBits(1) != 0;
+    }
+
+    /// <summary>
+    /// Writes the unsigned integer using variable-length encoding (7 bits groups, small values use less space).
+    /// </summary>
+    void WriteVarUInt(uint32 value)
+    {
+        do
+        {
+            const uint32 group = value & 0x7f;
+            value >>= 7;
+            WriteBits(group | (value != 0 ? 0x80 : 0), 8);
+        } while (value != 0 && !_overflow);
+    }
+
+    /// <summary>
+    /// Reads the unsigned integer written with variable-length encoding.
+    /// </summary>
+    uint32 ReadVarUInt()
+    {
+        uint32 value = 0;
+        for (int32 shift = 0; shift < 35 && !_overflow; shift += 7)
+        {
+            const uint32 group = ReadBits(8);
+            value |= (group & 0x7f) << shift;
+            if ((group & 0x80) == 0)
+                break;
+        }
+        return value;
+    }
+
+    /// <summary>
+    /// Writes the raw bytes.
+    /// </summary>
+    void WriteBytes(const void* data, int32 size)
+    {
+        const uint8* bytes = (const uint8*)data;
+        if ((_positionBits & 7) == 0 && _positionBits + size * 8 <= _sizeBits)
+        {
+            // Fast path for the aligned data
+            Platform::MemoryCopy(_buffer + (_positionBits >> 3), bytes, size);
+            _positionBits += size * 8;
+            return;
+        }
+        for (int32 i = 0; i < size; i++)
+            WriteBits(bytes[i], 8);
+    }
+
+    /// <summary>
+    /// Reads the raw bytes.
+    /// </summary>
+    void ReadBytes(void* data, int32 size)
+    {
+        uint8* bytes = (uint8*)data;
+        if ((_positionBits & 7) == 0 && _positionBits + size * 8 <= _sizeBits)
+        {
+            // Fast path for the aligned data
+            Platform::MemoryCopy(bytes, _buffer + (_positionBits >> 3), size);
+            _positionBits += size * 8;
+            return;
+        }
+        for (int32 i = 0; i < size; i++)
+            bytes[i] = (uint8)ReadBits(8);
+    }
+};
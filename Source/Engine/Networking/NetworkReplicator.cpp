@@ -0,0 +1,759 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#include "NetworkReplicator.h"
+#include "NetworkBitStream.h"
+#include "NetworkEvent.h"
+#include "NetworkPeer.h"
+#include "Engine/Core/Log.h"
+#include "Engine/Core/Collections/Sorting.h"
+#include "Engine/Profiler/ProfilerCPU.h"
+#include "Engine/Threading/JobSystem.h"
+
+// The message identifiers used by the replication (first byte of the message)
+#define NETWORK_REPLICATION_MESSAGE_SNAPSHOT 0xF1
+#define NETWORK_REPLICATION_MESSAGE_ACK 0xF2
+
+// The amount of the sent snapshots tracked per connection (waiting for the acknowledgement)
+#define NETWORK_REPLICATION_SNAPSHOTS_HISTORY 32
+
+// The amount of the received states stored per object on a client (used as delta baselines). Server sends the full state if there are too many not acknowledged updates since the baseline.
+#define NETWORK_REPLICATION_OBJECT_HISTORY 16
+
+// The minimum bandwidth budget (in bytes) to start a new snapshot message
+#define NETWORK_REPLICATION_MIN_MESSAGE_SIZE 64
+
+// The maximum amount of the bandwidth budget that can be accumulated (in seconds)
+#define NETWORK_REPLICATION_MAX_BUDGET_TIME 0.25f
+
+// The minimum amount of client connections to build the snapshots on multiple threads
+#define NETWORK_REPLICATION_JOBS_MIN_CONNECTIONS 8
+
+struct NetworkReplicator::ObjectData
+{
+    NetworkReplicationObject Desc;
+    bool Registered;
+    uint32 Generation = 0;
+
+    // Layout of the quantized object state (fields are stored in the same format as sent)
+    Array<int32> FieldOffsets;
+    int32 StateSize;
+    Array<byte> State;
+
+    // Client-only ring of the received states (baselines for the following deltas)
+    uint32 HistorySeqs[NETWORK_REPLICATION_OBJECT_HISTORY];
+    int32 HistoryCount;
+    int32 HistoryNext;
+    Array<byte> History;
+    uint32 AppliedSeq;
+    bool HasApplied;
+
+    void ResetHistory()
+    {
+        HistoryCount = 0;
+        HistoryNext = 0;
+        HasApplied = false;
+    }
+
+    const byte* FindHistory(uint32 seq) const
+    {
+        for (int32 i = 0; i < HistoryCount; i++)
+        {
+            if (HistorySeqs[i] == seq)
+                return History.Get() + i * StateSize;
+        }
+        return nullptr;
+    }
+
+    void AddHistory(uint32 seq, const byte* state)
+    {
+        if (FindHistory(seq))
+            return;
+        HistorySeqs[HistoryNext] = seq;
+        Platform::MemoryCopy(History.Get() + HistoryNext * StateSize, state, StateSize);
+        HistoryNext = (HistoryNext + 1) % NETWORK_REPLICATION_OBJECT_HISTORY;
+        HistoryCount = Math::Min(HistoryCount + 1, NETWORK_REPLICATION_OBJECT_HISTORY);
+    }
+};
+
+struct NetworkReplicator::ConnectionData
+{
+    struct ObjectState
+    {
+        uint32 Generation = 0;
+        bool HasBaseline = false;
+        uint32 BaselineSeq = 0;
+        uint32 MinBaselineSeq = 0;
+        int32 SentSinceBaseline = 0;
+        float Accumulator = 0.0f;
+        Array<byte> Baseline;
+    };
+
+    struct SentObject
+    {
+        int32 Index;
+        uint32 Generation;
+        int32 StateStart;
+    };
+
+    struct SentSnapshot
+    {
+        uint32 Seq = 0;
+        bool Acked = true;
+        Array<SentObject> Objects;
+        Array<byte> States;
+    };
+
+    struct Candidate
+    {
+        int32 Index;
+        float Priority;
+
+        static bool SortByPriority(const Candidate& a, const Candidate& b)
+        {
+            return a.Priority > b.Priority;
+        }
+    };
+
+    NetworkConnection Connection;
+    bool HasViewer = false;
+    Vector3 Viewer = Vector3::Zero;
+    float Budget = 0.0f;
+    uint32 NextSeq = 1;
+    Array<ObjectState> Objects;
+    SentSnapshot Sent[NETWORK_REPLICATION_SNAPSHOTS_HISTORY];
+    Array<Candidate> Candidates;
+    Array<byte> Outgoing;
+    Array<int32> OutgoingSizes;
+};
+
+FORCE_INLINE uint32 GetBitsMask(int32 bits)
+{
+    return bits >= 32 ? MAX_uint32 : (1u << bits) - 1;
+}
+
+FORCE_INLINE int32 GetFieldStateSize(const NetworkReplicationField& field)
+{
+    return field.Type == NetworkReplicationFieldType::Raw ? field.Size : sizeof(uint32);
+}
+
+void CaptureField(const NetworkReplicationField& field, const byte* src, byte* dst)
+{
+    switch (field.Type)
+    {
+    case NetworkReplicationFieldType::Raw:
+        Platform::MemoryCopy(dst, src, field.Size);
+        break;
+    case NetworkReplicationFieldType::UInt:
+    {
+        uint32 value;
+        switch (field.Size)
+        {
+        case 1:
+            value = *(const uint8*)src;
+            break;
+        case 2:
+            value = *(const uint16*)src;
+            break;
+        default:
+            value = *(const uint32*)src;
+            break;
+        }
+        value &= GetBitsMask(field.Bits);
+        Platform::MemoryCopy(dst, &value, sizeof(uint32));
+        break;
+    }
+    case NetworkReplicationFieldType::Float:
+    {
+        const float alpha = Math::Saturate((*(const float*)src - field.Min) / (field.Max - field.Min));
+        const uint32 value = (uint32)((double)alpha * GetBitsMask(field.Bits) + 0.5);
+        Platform::MemoryCopy(dst, &value, sizeof(uint32));
+        break;
+    }
+    }
+}
+
+void ApplyField(const NetworkReplicationField& field, const byte* src, byte* dst)
+{
+    switch (field.Type)
+    {
+    case NetworkReplicationFieldType::Raw:
+        Platform::MemoryCopy(dst, src, field.Size);
+        break;
+    case NetworkReplicationFieldType::UInt:
+    {
+        const uint32 value = *(const uint32*)src;
+        switch (field.Size)
+        {
+        case 1:
+            *(uint8*)dst = (uint8)value;
+            break;
+        case 2:
+            *(uint16*)dst = (uint16)value;
+            break;
+        default:
+            *(uint32*)dst = value;
+            break;
+        }
+        break;
+    }
+    case NetworkReplicationFieldType::Float:
+    {
+        const double alpha = (double)*(const uint32*)src / GetBitsMask(field.Bits);
+        *(float*)dst = (float)(field.Min + (field.Max - field.Min) * alpha);
+        break;
+    }
+    }
+}
+
+void WriteField(NetworkBitStream& stream, const NetworkReplicationField& field, const byte* src)
+{
+    if (field.Type == NetworkReplicationFieldType::Raw)
+        stream.WriteBytes(src, field.Size);
+    else
+        stream.WriteBits(*(const uint32*)src, field.Bits);
+}
+
+void ReadField(NetworkBitStream& stream, const NetworkReplicationField& field, byte* dst)
+{
+    if (field.Type == NetworkReplicationFieldType::Raw)
+    {
+        stream.ReadBytes(dst, field.Size);
+    }
+    else
+    {
+        const uint32 value = stream.ReadBits(field.Bits);
+        Platform::MemoryCopy(dst, &value, sizeof(uint32));
+    }
+}
+
+NetworkReplicator::NetworkReplicator(NetworkPeer* peer, bool isServer)
+    : _peer(peer)
+    , _isServer(isServer)
+{
+    ASSERT(peer);
+}
+
+NetworkReplicator::~NetworkReplicator()
+{
+    _objects.ClearDelete();
+    _connections.ClearDelete();
+}
+
+bool NetworkReplicator::RegisterObject(const NetworkReplicationObject& obj)
+{
+    if (_objectsLookup.ContainsKey(obj.Id))
+    {
+        LOG(Error, "Network object with id {0} is already registered.", obj.Id);
+        return true;
+    }
+    if (obj.Data == nullptr || obj.Fields.IsEmpty())
+    {
+        LOG(Error, "Invalid network object with id {0}.", obj.Id);
+        return true;
+    }
+    for (const NetworkReplicationField& field : obj.Fields)
+    {
+        const bool valid = field.Type == NetworkReplicationFieldType::Raw ? field.Size > 0 :
+                           field.Bits > 0 && field.Bits <= 32 &&
+                           (field.Type == NetworkReplicationFieldType::Float ? field.Max > field.Min : field.Size == 1 || field.Size == 2 || field.Size == 4);
+        if (!valid)
+        {
+            LOG(Error, "Invalid field at offset {1} of the network object with id {0}.", obj.Id, field.Offset);
+            return true;
+        }
+    }
+
+    // Reuse the unregistered object slot
+    int32 index = 0;
+    while (index < _objects.Count() && _objects[index]->Registered)
+        index++;
+    if (index == _objects.Count())
+        _objects.Add(New<ObjectData>());
+    ObjectData& data = *_objects[index];
+    data.Desc = obj;
+    data.Registered = true;
+    data.FieldOffsets.Resize(obj.Fields.Count());
+    data.StateSize = 0;
+    for (int32 i = 0; i < obj.Fields.Count(); i++)
+    {
+        data.FieldOffsets[i] = data.StateSize;
+        data.StateSize += GetFieldStateSize(obj.Fields[i]);
+    }
+    data.State.Resize(data.StateSize);
+    data.ResetHistory();
+    if (!_isServer)
+        data.History.Resize(data.StateSize * NETWORK_REPLICATION_OBJECT_HISTORY);
+    _objectsLookup.Add(obj.Id, index);
+
+    return false;
+}
+
+void NetworkReplicator::UnregisterObject(uint32 id)
+{
+    int32 index;
+    if (!_objectsLookup.TryGet(id, index))
+        return;
+    _objectsLookup.Remove(id);
+
+    // Keep the slot but change its generation to reset the per-connection state
+    ObjectData& data = *_objects[index];
+    data.Registered = false;
+    data.Generation++;
+    data.Desc.Data = nullptr;
+    data.Desc.Position = nullptr;
+}
+
+void NetworkReplicator::SetViewerPosition(const NetworkConnection& connection, const Vector3& position)
+{
+    ConnectionData* data;
+    if (_connectionsLookup.TryGet(connection.ConnectionId, data))
+    {
+        data->HasViewer = true;
+        data->Viewer = position;
+    }
+}
+
+bool NetworkReplicator::ProcessEvent(const NetworkEvent& e)
+{
+    switch (e.EventType)
+    {
+    case NetworkEventType::Connected:
+        OnConnected(e.Sender);
+        return false;
+    case NetworkEventType::Disconnected:
+    case NetworkEventType::Timeout:
+        OnDisconnected(e.Sender);
+        return false;
+    case NetworkEventType::Message:
+    {
+        if (e.Message.Length == 0)
+            return false;
+        const uint8 messageId = e.Message.Buffer[0];
+        if (messageId == NETWORK_REPLICATION_MESSAGE_SNAPSHOT && !_isServer)
+            OnSnapshot(e.Message);
+        else if (messageId == NETWORK_REPLICATION_MESSAGE_ACK && _isServer)
+            OnAck(e.Message, e.Sender);
+        else
+            return false;
+        _peer->RecycleMessage(e.Message);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+void NetworkReplicator::Update(float deltaTime)
+{
+    PROFILE_CPU();
+
+    if (!_isServer)
+    {
+        // Acknowledge received snapshots
+        if (_pendingAck)
+        {
+            _pendingAck = false;
+            NetworkMessage message = _peer->BeginSendMessage();
+            message.WriteUInt8(NETWORK_REPLICATION_MESSAGE_ACK);
+            message.WriteUInt32(_latestSeq);
+            message.WriteUInt32(_ackBits);
+
+            // Report objects that couldn't be decoded so server sends their full state
+            const int32 resyncCount = Math::Min(_resyncIds.Count(), ((int32)message.BufferSize - (int32)message.Position - 3) / (int32)sizeof(uint32));
+            message.WriteUInt16((uint16)resyncCount);
+            for (int32 i = 0; i < resyncCount; i++)
+                message.WriteUInt32(_resyncIds[i]);
+            for (int32 i = resyncCount; i < _resyncIds.Count(); i++)
+                _resyncIds[i - resyncCount] = _resyncIds[i];
+            _resyncIds.Resize(_resyncIds.Count() - resyncCount);
+            message.Length = message.Position;
+            _peer->EndSendMessage(Channel, message);
+        }
+        return;
+    }
+    if (_connections.IsEmpty())
+        return;
+
+    // Capture objects state (shared by all connections)
+    for (ObjectData* obj : _objects)
+    {
+        if (!obj->Registered)
+            continue;
+        const byte* data = (const byte*)obj->Desc.Data;
+        for (int32 i = 0; i < obj->Desc.Fields.Count(); i++)
+        {
+            const NetworkReplicationField& field = obj->Desc.Fields[i];
+            CaptureField(field, data + field.Offset, obj->State.Get() + obj->FieldOffsets[i]);
+        }
+    }
+
+    // Build snapshots for each connection
+    if (_connections.Count() >= NETWORK_REPLICATION_JOBS_MIN_CONNECTIONS)
+    {
+        Function<void(int32)> job = [this, deltaTime](int32 index)
+        {
+            BuildSnapshots(*_connections[index], deltaTime);
+        };
+        JobSystem::Execute(job, _connections.Count());
+    }
+    else
+    {
+        for (ConnectionData* connection : _connections)
+            BuildSnapshots(*connection, deltaTime);
+    }
+
+    // Send snapshots (peer messages pool is not thread-safe)
+    for (ConnectionData* connection : _connections)
+    {
+        int32 offset = 0;
+        for (const int32 size : connection->OutgoingSizes)
+        {
+            NetworkMessage message = _peer->BeginSendMessage();
+            Platform::MemoryCopy(message.Buffer, connection->Outgoing.Get() + offset, size);
+            message.Length = message.Position = size;
+            _peer->EndSendMessage(Channel, message, connection->Connection);
+            offset += size;
+        }
+    }
+}
+
+void NetworkReplicator::OnConnected(const NetworkConnection& connection)
+{
+    if (_isServer)
+    {
+        if (_connectionsLookup.ContainsKey(connection.ConnectionId))
+            return;
+        auto data = New<ConnectionData>();
+        data->Connection = connection;
+        _connections.Add(data);
+        _connectionsLookup.Add(connection.ConnectionId, data);
+    }
+    else
+    {
+        // Server restarts the snapshots numbering for the new connection
+        for (ObjectData* obj : _objects)
+            obj->ResetHistory();
+        _hasReceived = false;
+        _pendingAck = false;
+        _resyncIds.Clear();
+    }
+}
+
+void NetworkReplicator::OnDisconnected(const NetworkConnection& connection)
+{
+    ConnectionData* data;
+    if (_isServer && _connectionsLookup.TryGet(connection.ConnectionId, data))
+    {
+        _connectionsLookup.Remove(connection.ConnectionId);
+        _connections.Remove(data);
+        Delete(data);
+    }
+}
+
+void NetworkReplicator::OnSnapshot(const NetworkMessage& message)
+{
+    PROFILE_CPU();
+    NetworkBitStream stream(message.Buffer, message.Length);
+    stream.ReadBits(8);
+    const uint32 seq = stream.ReadBits(32);
+    const int32 count = (int32)stream.ReadBits(16);
+    const uint32 sizeBits = message.Length * 8;
+
+    // Read objects (state is decoded in-place of the object state buffer)
+    bool failed = false;
+    for (int32 i = 0; i < count; i++)
+    {
+        const uint32 id = stream.ReadVarUInt();
+        const uint32 payloadEnd = stream.ReadBits(16) + stream.GetPositionBits();
+        if (stream.HasOverflow() || payloadEnd > sizeBits)
+        {
+            failed = true;
+            break;
+        }
+        int32 index;
+        if (!_objectsLookup.TryGet(id, index))
+        {
+            // Skip not registered object (server sends the full state once it gets reported)
+            if (!_resyncIds.Contains(id))
+                _resyncIds.Add(id);
+            stream.SetPositionBits(payloadEnd);
+            continue;
+        }
+        ObjectData& obj = *_objects[index];
+        const int32 fieldsCount = obj.Desc.Fields.Count();
+        byte* state = obj.State.Get();
+
+        // Get the delta baseline
+        if (stream.ReadBool())
+        {
+            const byte* baseline = obj.FindHistory(seq - stream.ReadVarUInt());
+            if (!baseline)
+            {
+                // Skip object without the baseline (server sends the full state once it gets reported)
+                if (!_resyncIds.Contains(id))
+                    _resyncIds.Add(id);
+                stream.SetPositionBits(payloadEnd);
+                continue;
+            }
+            Platform::MemoryCopy(state, baseline, obj.StateSize);
+        }
+
+        // Read changed fields
+        const uint32 maskStart = stream.GetPositionBits();
+        stream.SetPositionBits(maskStart + fieldsCount);
+        for (int32 fieldIndex = 0; fieldIndex < fieldsCount; fieldIndex++)
+        {
+            const uint32 dataPosition = stream.GetPositionBits();
+            stream.SetPositionBits(maskStart + fieldIndex);
+            const bool changed = stream.ReadBool();
+            stream.SetPositionBits(dataPosition);
+            if (changed)
+                ReadField(stream, obj.Desc.Fields[fieldIndex], state + obj.FieldOffsets[fieldIndex]);
+        }
+        if (stream.GetPositionBits() != payloadEnd)
+        {
+            // Skip object with different fields layout
+            if (!_resyncIds.Contains(id))
+                _resyncIds.Add(id);
+            stream.SetPositionBits(payloadEnd);
+            continue;
+        }
+
+        // Apply the newest state to the object
+        obj.AddHistory(seq, state);
+        if (!obj.HasApplied || seq > obj.AppliedSeq)
+        {
+            obj.HasApplied = true;
+            obj.AppliedSeq = seq;
+            byte* data = (byte*)obj.Desc.Data;
+            for (int32 fieldIndex = 0; fieldIndex < fieldsCount; fieldIndex++)
+            {
+                const NetworkReplicationField& field = obj.Desc.Fields[fieldIndex];
+                ApplyField(field, state + obj.FieldOffsets[fieldIndex], data + field.Offset);
+            }
+        }
+    }
+
+    // Acknowledge snapshots with the valid structure (objects that failed to decode are reported separately so server doesn't use them as baselines)
+    if (failed)
+        return;
+    if (!_hasReceived || seq > _latestSeq)
+    {
+        const uint32 shift = seq - _latestSeq;
+        if (!_hasReceived || shift > 32)
+            _ackBits = 0;
+        else
+            _ackBits = (shift < 32 ? _ackBits << shift : 0) | (1u << (shift - 1));
+        _latestSeq = seq;
+        _hasReceived = true;
+    }
+    else if (seq < _latestSeq && _latestSeq - seq <= 32)
+    {
+        _ackBits |= 1u << (_latestSeq - seq - 1);
+    }
+    _pendingAck = true;
+}
+
+void NetworkReplicator::OnAck(const NetworkMessage& message, const NetworkConnection& sender)
+{
+    ConnectionData* connection;
+    if (!_connectionsLookup.TryGet(sender.ConnectionId, connection) || message.Length < 9)
+        return;
+    NetworkMessage reader = message;
+    reader.Position = 1;
+    const uint32 latestSeq = reader.ReadUInt32();
+    const uint32 ackBits = reader.ReadUInt32();
+    AckSnapshot(*connection, latestSeq);
+    for (uint32 i = 0; i < 32; i++)
+    {
+        if (ackBits & (1u << i))
+            AckSnapshot(*connection, latestSeq - i - 1);
+    }
+
+    // Send the full state of the objects that client failed to decode (ignore baselines from the snapshots sent so far as client might not have them)
+    if (message.Length < 11)
+        return;
+    const int32 resyncCount = reader.ReadUInt16();
+    for (int32 i = 0; i < resyncCount && reader.Position + sizeof(uint32) <= message.Length; i++)
+    {
+        const uint32 id = reader.ReadUInt32();
+        int32 index;
+        if (!_objectsLookup.TryGet(id, index) || index >= connection->Objects.Count())
+            continue;
+        auto& state = connection->Objects[index];
+        state.HasBaseline = false;
+        state.SentSinceBaseline = 0;
+        state.MinBaselineSeq = connection->NextSeq;
+    }
+}
+
+void NetworkReplicator::AckSnapshot(ConnectionData& connection, uint32 seq)
+{
+    auto& sent = connection.Sent[seq % NETWORK_REPLICATION_SNAPSHOTS_HISTORY];
+    if (sent.Seq != seq || sent.Acked)
+        return;
+    sent.Acked = true;
+
+    // Use the acknowledged objects state as baselines for the next deltas
+    for (const auto& e : sent.Objects)
+    {
+        if (e.Index >= connection.Objects.Count() || _objects[e.Index]->Generation != e.Generation)
+            continue;
+        auto& state = connection.Objects[e.Index];
+        if (state.Generation != e.Generation || seq < state.MinBaselineSeq || (state.HasBaseline && state.BaselineSeq >= seq))
+            continue;
+        const int32 stateSize = _objects[e.Index]->StateSize;
+        state.Baseline.Set(sent.States.Get() + e.StateStart, stateSize);
+        state.BaselineSeq = seq;
+        state.HasBaseline = true;
+        state.SentSinceBaseline = 0;
+    }
+}
+
+void NetworkReplicator::BuildSnapshots(ConnectionData& connection, float deltaTime)
+{
+    PROFILE_CPU();
+    connection.Outgoing.Clear();
+    connection.OutgoingSizes.Clear();
+    connection.Candidates.Clear();
+    if (connection.Objects.Count() < _objects.Count())
+        connection.Objects.Resize(_objects.Count());
+
+    // Refill the bandwidth budget
+    const float maxBudget = Math::Max((float)BytesPerSecond * NETWORK_REPLICATION_MAX_BUDGET_TIME, (float)NETWORK_REPLICATION_MIN_MESSAGE_SIZE);
+    connection.Budget = Math::Min(connection.Budget + (float)BytesPerSecond * deltaTime, maxBudget);
+
+    // Gather relevant objects that changed since the acknowledged baseline
+    for (int32 i = 0; i < _objects.Count(); i++)
+    {
+        const ObjectData& obj = *_objects[i];
+        auto& state = connection.Objects[i];
+        if (state.Generation != obj.Generation)
+        {
+            state.Generation = obj.Generation;
+            state.HasBaseline = false;
+            state.MinBaselineSeq = 0;
+            state.SentSinceBaseline = 0;
+            state.Accumulator = 0.0f;
+        }
+        if (!obj.Registered)
+            continue;
+        float priority = obj.Desc.Priority;
+        if (connection.HasViewer && obj.Desc.Position)
+        {
+            const float distance = Vector3::Distance(connection.Viewer, *obj.Desc.Position);
+            if (distance > obj.Desc.RelevancyDistance)
+                continue;
+
+            // Closer objects are more important
+            if (obj.Desc.RelevancyDistance < MAX_float)
+                priority *= Math::Max(1.0f - distance / obj.Desc.RelevancyDistance, 0.1f);
+        }
+        if (state.HasBaseline && Platform::MemoryCompare(state.Baseline.Get(), obj.State.Get(), obj.StateSize) == 0)
+        {
+            state.Accumulator = 0.0f;
+            continue;
+        }
+
+        // Accumulate priority over time so low priority objects are not starved
+        state.Accumulator += priority * Math::Max(deltaTime, ZeroTolerance);
+        connection.Candidates.Add({ i, state.Accumulator });
+    }
+    if (connection.Candidates.IsEmpty())
+        return;
+    Sorting::QuickSort(connection.Candidates.Get(), connection.Candidates.Count(), &ConnectionData::Candidate::SortByPriority);
+
+    // Write snapshot messages within the bandwidth budget
+    const int32 messageSize = _peer->Config.MessageSize;
+    int32 candidateIndex = 0;
+    while (candidateIndex < connection.Candidates.Count() && connection.Budget >= NETWORK_REPLICATION_MIN_MESSAGE_SIZE)
+    {
+        const int32 start = connection.Outgoing.Count();
+        const int32 size = Math::Min(messageSize, (int32)connection.Budget);
+        connection.Outgoing.AddUninitialized(size);
+        NetworkBitStream stream(connection.Outgoing.Get() + start, size);
+        const uint32 seq = connection.NextSeq;
+        stream.WriteBits(NETWORK_REPLICATION_MESSAGE_SNAPSHOT, 8);
+        stream.WriteBits(seq, 32);
+        const uint32 countPosition = stream.GetPositionBits();
+        stream.WriteBits(0, 16);
+        auto& sent = connection.Sent[seq % NETWORK_REPLICATION_SNAPSHOTS_HISTORY];
+        sent.Objects.Clear();
+        sent.States.Clear();
+        int32 count = 0;
+        for (; candidateIndex < connection.Candidates.Count() && count < MAX_uint16; candidateIndex++)
+        {
+            const int32 objectIndex = connection.Candidates[candidateIndex].Index;
+            const ObjectData& obj = *_objects[objectIndex];
+            auto& state = connection.Objects[objectIndex];
+            const byte* objState = obj.State.Get();
+
+            // Write object header
+            const uint32 objectStart = stream.GetPositionBits();
+            stream.WriteVarUInt(obj.Desc.Id);
+            const uint32 payloadSizePosition = stream.GetPositionBits();
+            stream.WriteBits(0, 16);
+            const uint32 payloadStart = stream.GetPositionBits();
+
+            // Encode against the acknowledged baseline (full state if client might not have it anymore)
+            const bool useBaseline = state.HasBaseline && state.SentSinceBaseline < NETWORK_REPLICATION_OBJECT_HISTORY / 2;
+            stream.WriteBool(useBaseline);
+            if (useBaseline)
+                stream.WriteVarUInt(seq - state.BaselineSeq);
+            const int32 fieldsCount = obj.Desc.Fields.Count();
+            for (int32 fieldIndex = 0; fieldIndex < fieldsCount; fieldIndex++)
+            {
+                const int32 offset = obj.FieldOffsets[fieldIndex];
+                stream.WriteBool(!useBaseline || Platform::MemoryCompare(state.Baseline.Get() + offset, objState + offset, GetFieldStateSize(obj.Desc.Fields[fieldIndex])) != 0);
+            }
+            for (int32 fieldIndex = 0; fieldIndex < fieldsCount; fieldIndex++)
+            {
+                const int32 offset = obj.FieldOffsets[fieldIndex];
+                if (!useBaseline || Platform::MemoryCompare(state.Baseline.Get() + offset, objState + offset, GetFieldStateSize(obj.Desc.Fields[fieldIndex])) != 0)
+                    WriteField(stream, obj.Desc.Fields[fieldIndex], objState + offset);
+            }
+
+            const uint32 payloadEnd = stream.GetPositionBits();
+            if (stream.HasOverflow() || payloadEnd - payloadStart > MAX_uint16)
+            {
+                stream.SetPositionBits(objectStart);
+                if (count == 0 && size == messageSize)
+                {
+                    LOG(Warning, "Network object with id {0} doesn't fit into a single message.", obj.Desc.Id);
+                    continue;
+                }
+                break;
+            }
+            stream.SetPositionBits(payloadSizePosition);
+            stream.WriteBits(payloadEnd - payloadStart, 16);
+            stream.SetPositionBits(payloadEnd);
+
+            // Remember the sent state to use it as a baseline once client acknowledges it
+            sent.Objects.Add({ objectIndex, obj.Generation, sent.States.Count() });
+            sent.States.Add(objState, obj.StateSize);
+            state.SentSinceBaseline++;
+            state.Accumulator = 0.0f;
+            count++;
+        }
+        if (count == 0)
+        {
+            // Wait for more bandwidth budget
+            connection.Outgoing.Resize(start);
+            sent.Acked = true;
+            break;
+        }
+
+        // Finalize message
+        const uint32 endPosition = stream.GetPositionBits();
+        stream.SetPositionBits(countPosition);
+        stream.WriteBits(count, 16);
+        stream.SetPositionBits(endPosition);
+        const int32 written = (int32)stream.GetPositionBytes();
+        connection.Outgoing.Resize(start + written);
+        connection.OutgoingSizes.Add(written);
+        connection.Budget -= (float)written;
+        sent.Seq = seq;
+        sent.Acked = false;
+        connection.NextSeq++;
+    }
+}
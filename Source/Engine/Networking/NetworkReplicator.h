@@ -0,0 +1,237 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#include "Types.h"
+#include "NetworkChannelType.h"
+#include "Engine/Core/Math/Vector3.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+
+/// <summary>
+/// The replicated field value encoding.
+/// </summary>
+enum class NetworkReplicationFieldType : byte
+{
+    /// <summary>
+    /// The raw bytes (sent as-is).
+    /// </summary>
+    Raw,
+
+    /// <summary>
+    /// The unsigned integer (1, 2 or 4 bytes) packed into the given amount of bits. Boolean fields can use a single bit.
+    /// </summary>
+    UInt,
+
+    /// <summary>
+    /// The floating point value quantized within the given range into the given amount of bits.
+    /// </summary>
+    Float,
+};
+
+/// <summary>
+/// The replicated object field description.
+/// </summary>
+struct FLAXENGINE_API NetworkReplicationField
+{
+    /// <summary>
+    /// The value encoding.
+    /// </summary>
+    NetworkReplicationFieldType Type;
+
+    /// <summary>
+    /// The amount of bits used to send the value (for UInt and Float fields).
+    /// </summary>
+    byte Bits;
+
+    /// <summary>
+    /// The offset of the field data (in bytes) from the object data start.
+    /// </summary>
+    uint16 Offset;
+
+    /// <summary>
+    /// The size of the field data (in bytes).
+    /// </summary>
+    uint16 Size;
+
+    /// <summary>
+    /// The minimum value (for Float fields).
+    /// </summary>
+    float Min;
+
+    /// <summary>
+    /// The maximum value (for Float fields).
+    /// </summary>
+    float Max;
+
+public:
+
+    /// <summary>
+    /// Creates the raw bytes field.
+    /// </summary>
+    static NetworkReplicationField Raw(uint16 offset, uint16 size)
+    {
+        return { NetworkReplicationFieldType::Raw, 0, offset, size, 0.0f, 0.0f };
+    }
+
+    /// <summary>
+    /// Creates the unsigned integer field packed into the given amount of bits.
+    /// </summary>
+    static NetworkReplicationField UInt(uint16 offset, uint16 size, byte bits)
+    {
+        return { NetworkReplicationFieldType::UInt, bits, offset, size, 0.0f, 0.0f };
+    }
+
+    /// <summary>
+    /// Creates the float field quantized within the given range into the given amount of bits.
+    /// </summary>
+    static NetworkReplicationField Float(uint16 offset, float min, float max, byte bits)
+    {
+        return { NetworkReplicationFieldType::Float, bits, offset, sizeof(float), min, max };
+    }
+};
+
+/// <summary>
+/// The replicated object description.
+/// </summary>
+struct FLAXENGINE_API NetworkReplicationObject
+{
+    /// <summary>
+    /// The unique object identifier. Server and clients have to register the object using the same identifier and fields layout.
+    /// </summary>
+    uint32 Id = 0;
+
+    /// <summary>
+    /// The object data. Server reads the fields from it and clients write the received fields into it.
+    /// </summary>
+    void* Data = nullptr;
+
+    /// <summary>
+    /// The replicated fields.
+    /// </summary>
+    Array<NetworkReplicationField> Fields;
+
+    /// <summary>
+    /// The object position used for the relevancy and priority. Null if object is always relevant.
+    /// </summary>
+    const Vector3* Position = nullptr;
+
+    /// <summary>
+    /// The maximum distance from the connection viewer to the object position to replicate the object.
+    /// </summary>
+    float RelevancyDistance = MAX_float;
+
+    /// <summary>
+    /// The replication priority. Objects with higher priority are sent more often when the connection bandwidth is limited.
+    /// </summary>
+    float Priority = 1.0f;
+};
+
+/// <summary>
+/// High-level objects state replication on top of the <see cref="NetworkPeer"/>. Server sends the registered objects fields to the connected clients as delta-compressed bit-packed snapshots.
+/// </summary>
+/// <remarks>
+/// Each client acknowledges received snapshots and server encodes the changed fields against the last acknowledged object state (per-connection baseline). Objects that client fails to decode (eg. not registered or with a missing baseline) are reported with the acknowledgement and server sends their full state. Objects out of the connection viewer relevancy distance are not sent. Changed objects are sent by priority (accumulated over time and scaled by the distance to the viewer) within the connection bandwidth budget.
+/// Replication messages start with a reserved byte and should be passed to <see cref="ProcessEvent"/> before the game messages handling. Objects spawning is not replicated: server and clients have to register objects with the same identifiers.
+/// </remarks>
+class FLAXENGINE_API NetworkReplicator
+{
+private:
+
+    struct ObjectData;
+    struct ConnectionData;
+
+    NetworkPeer* _peer;
+    bool _isServer;
+    Array<ObjectData*> _objects;
+    Dictionary<uint32, int32> _objectsLookup;
+
+    // Server
+    Array<ConnectionData*> _connections;
+    Dictionary<uint32, ConnectionData*> _connectionsLookup;
+
+    // Client
+    uint32 _latestSeq = 0;
+    uint32 _ackBits = 0;
+    bool _hasReceived = false;
+    bool _pendingAck = false;
+    Array<uint32> _resyncIds;
+
+public:
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="NetworkReplicator"/> class.
+    /// </summary>
+    /// <param name="peer">The network peer to use for messages sending.</param>
+    /// <param name="isServer">True if peer is a server (sends objects state), otherwise it's a client (receives objects state).</param>
+    NetworkReplicator(NetworkPeer* peer, bool isServer);
+
+    /// <summary>
+    /// Finalizes an instance of the <see cref="NetworkReplicator"/> class.
+    /// </summary>
+    ~NetworkReplicator();
+
+public:
+
+    /// <summary>
+    /// The outgoing bandwidth limit per client connection (in bytes per second).
+    /// </summary>
+    int32 BytesPerSecond = 32 * 1024;
+
+    /// <summary>
+    /// The channel used to send the snapshots and acknowledgements.
+    /// </summary>
+    NetworkChannelType Channel = NetworkChannelType::Unreliable;
+
+public:
+
+    /// <summary>
+    /// Returns true if replicator works as a server.
+    /// </summary>
+    FORCE_INLINE bool IsServer() const
+    {
+        return _isServer;
+    }
+
+    /// <summary>
+    /// Registers the object for the replication.
+    /// </summary>
+    /// <param name="obj">The object description.</param>
+    /// <returns>True if failed (eg. object with the same identifier is already registered or fields are invalid), otherwise false.</returns>
+    bool RegisterObject(const NetworkReplicationObject& obj);
+
+    /// <summary>
+    /// Unregisters the object from the replication.
+    /// </summary>
+    /// <param name="id">The object identifier.</param>
+    void UnregisterObject(uint32 id);
+
+    /// <summary>
+    /// Sets the viewer location of the client connection (used for the objects relevancy and priority). Connections without a viewer receive all the objects.
+    /// </summary>
+    /// <param name="connection">The client connection.</param>
+    /// <param name="position">The viewer position.</param>
+    void SetViewerPosition(const NetworkConnection& connection, const Vector3& position);
+
+    /// <summary>
+    /// Processes the network event received by the peer. Tracks the client connections on a server and consumes the replication messages.
+    /// </summary>
+    /// <param name="e">The network event.</param>
+    /// <returns>True if event was a replication message (it has been recycled), otherwise false.</returns>
+    bool ProcessEvent(const NetworkEvent& e);
+
+    /// <summary>
+    /// Updates the replication. Server sends the objects snapshots to the clients and clients send the acknowledgements to the server.
+    /// </summary>
+    /// <param name="deltaTime">The time elapsed since the last update (in seconds).</param>
+    void Update(float deltaTime);
+
+private:
+
+    void OnConnected(const NetworkConnection& connection);
+    void OnDisconnected(const NetworkConnection& connection);
+    void OnSnapshot(const NetworkMessage& message);
+    void OnAck(const NetworkMessage& message, const NetworkConnection& sender);
+    void AckSnapshot(ConnectionData& connection, uint32 seq);
+    void BuildSnapshots(ConnectionData& connection, float deltaTime);
+};
@@ -2,6 +2,9 @@
 
 #pragma once
 
+struct Vector3;
+struct Quaternion;
+
 /// <summary>
 /// A base interface for all physical actors types/owners that can responds on transformation changed event.
 /// </summary>
@@ -22,7 +25,9 @@ class FLAXENGINE_API IPhysicsActor
     /// Called when actor's active transformation gets changed after the physics simulation step during.
     /// </summary>
     /// <remarks>
-    /// This event is called internally by the Physics service and should not be used by the others.
+    /// This event is called internally by the Physics service and should not be used by the others. Pose is gathered by the physics backend (possibly on job system threads) before calling this method on a main thread.
     /// </remarks>
-    virtual void OnActiveTransformChanged() = 0;
+    /// <param name="position">The world-space position of the physics actor.</param>
+    /// <param name="orientation">The world-space orientation of the physics actor.</param>
+    virtual void OnActiveTransformChanged(const Vector3& position, const Quaternion& orientation) = 0;
 };
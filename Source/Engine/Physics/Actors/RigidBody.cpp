@@ -401,13 +401,14 @@ void* RigidBody::GetPhysicsActor() const
     return _actor;
 }
 
-void RigidBody::OnActiveTransformChanged()
+void RigidBody::OnActiveTransformChanged(const Vector3& position, const Quaternion& orientation)
 {
     // Change actor transform (but with locking)
     ASSERT(!_isUpdatingTransform);
     _isUpdatingTransform = true;
     Transform transform;
-    PhysicsBackend::GetRigidActorPose(GetPhysicsActor(), transform.Translation, transform.Orientation);
+    transform.Translation = position;
+    transform.Orientation = orientation;
     transform.Scale = _transform.Scale;
     if (_parent)
     {
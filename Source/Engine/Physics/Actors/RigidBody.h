@@ -558,7 +558,7 @@ DECLARE_SCENE_OBJECT(RigidBody);
 
     // [IPhysicsActor]
     void* GetPhysicsActor() const override;
-    void OnActiveTransformChanged() override;
+    void OnActiveTransformChanged(const Vector3& position, const Quaternion& orientation) override;
 
 protected:
 
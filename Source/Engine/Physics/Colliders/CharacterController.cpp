@@ -270,13 +270,13 @@ RigidBody* CharacterController::GetAttachedRigidBody() const
     return nullptr;
 }
 
-void CharacterController::OnActiveTransformChanged()
+void CharacterController::OnActiveTransformChanged(const Vector3& position, const Quaternion& orientation)
 {
     // Change actor transform (but with locking)
     ASSERT(!_isUpdatingTransform);
     _isUpdatingTransform = true;
     Transform transform;
-    PhysicsBackend::GetRigidActorPose(PhysicsBackend::GetShapeActor(_shape), transform.Translation, transform.Orientation);
+    transform.Translation = position;
     transform.Orientation = _transform.Orientation;
     transform.Scale = _transform.Scale;
     SetTransform(transform);
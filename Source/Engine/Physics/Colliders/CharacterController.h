@@ -212,7 +212,7 @@ DECLARE_SCENE_OBJECT(CharacterController);
     RigidBody* GetAttachedRigidBody() const override;
 
     // [IPhysicsActor]
-    void OnActiveTransformChanged() override;
+    void OnActiveTransformChanged(const Vector3& position, const Quaternion& orientation) override;
     void* GetPhysicsActor() const override;
 
 protected:
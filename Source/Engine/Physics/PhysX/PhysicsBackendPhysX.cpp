@@ -19,10 +19,14 @@
 #include "Engine/Physics/Joints/SphericalJoint.h"
 #include "Engine/Physics/Joints/D6Joint.h"
 #include "Engine/Physics/Colliders/Collider.h"
+#include "Engine/Level/Level.h"
+#include "Engine/Level/Scene/Scene.h"
 #include "Engine/Platform/CPUInfo.h"
 #include "Engine/Platform/CriticalSection.h"
 #include "Engine/Profiler/ProfilerCPU.h"
 #include "Engine/Serialization/WriteStream.h"
+#include "Engine/Threading/JobSystem.h"
+#include "Engine/Threading/Threading.h"
 #include <ThirdParty/PhysX/PxPhysicsAPI.h>
 #include <ThirdParty/PhysX/PxQueryFiltering.h>
 #include <ThirdParty/PhysX/extensions/PxFixedJoint.h>
@@ -53,12 +57,25 @@
 // Temporary result buffer size
 #define PHYSX_HIT_BUFFER_SIZE	128
 
+// Minimum amount of active actors to gather their poses in parallel (using Job System)
+#define PHYSX_ACTIVE_TRANSFORMS_JOBS_THRESHOLD 1024
+
+// Amount of active actors processed by a single job when gathering poses in parallel
+#define PHYSX_ACTIVE_TRANSFORMS_JOB_BATCH_SIZE 256
+
 struct ActionDataPhysX
 {
     PhysicsBackend::ActionType Type;
     PxActor* Actor;
 };
 
+struct ActiveTransformPhysX
+{
+    IPhysicsActor* Actor;
+    Vector3 Position;
+    Quaternion Orientation;
+};
+
 struct ScenePhysX
 {
     PxScene* Scene = nullptr;
@@ -73,6 +90,7 @@ struct ScenePhysX
     Array<PhysicsColliderActor*> RemoveColliders;
     Array<Joint*> RemoveJoints;
     Array<ActionDataPhysX> Actions;
+    Array<ActiveTransformPhysX> ActiveTransforms;
 #if WITH_VEHICLE
     Array<WheeledVehicle*> WheelVehicles;
     PxBatchQuery* WheelRaycastBatchQuery = nullptr;
@@ -352,6 +370,7 @@ namespace
 
     CriticalSection FlushLocker;
     Array<PxBase*> DeleteObjects;
+    volatile int64 PosesVersion = 0;
 
     bool _queriesHitTriggers = true;
     PhysicsCombineMode _frictionCombineMode = PhysicsCombineMode::Average;
@@ -1217,15 +1236,65 @@ void PhysicsBackend::EndSimulateScene(void* scene)
         PxActor** activeActors = scenePhysX->Scene->getActiveActors(activeActorsCount);
         if (activeActorsCount > 0)
         {
-            // Update changed transformations
-            // TODO: use jobs system if amount if huge
-            for (uint32 i = 0; i < activeActorsCount; i++)
+            // Gather changed transformations (pose reading is thread-safe after the simulation results fetch)
+            auto& activeTransforms = scenePhysX->ActiveTransforms;
+            activeTransforms.Resize((int32)activeActorsCount, false);
+            const auto gatherPoses = [activeActors, &activeTransforms](int32 start, int32 end)
+            {
+                for (int32 i = start; i < end; i++)
+                {
+                    const auto pxActor = (PxRigidActor*)activeActors[i];
+                    auto& e = activeTransforms[i];
+                    e.Actor = static_cast<IPhysicsActor*>(pxActor->userData);
+                    if (e.Actor)
+                    {
+                        const PxTransform pose = pxActor->getGlobalPose();
+                        e.Position = P2C(pose.p);
+                        e.Orientation = P2C(pose.q);
+                    }
+                }
+            };
+            if (activeActorsCount >= PHYSX_ACTIVE_TRANSFORMS_JOBS_THRESHOLD)
             {
-                const auto pxActor = (PxRigidActor*)*activeActors++;
-                auto actor = static_cast<IPhysicsActor*>(pxActor->userData);
-                if (actor)
-                    actor->OnActiveTransformChanged();
+                PROFILE_CPU_NAMED("GatherPoses");
+                const int32 jobCount = Math::DivideAndRoundUp<int32>((int32)activeActorsCount, PHYSX_ACTIVE_TRANSFORMS_JOB_BATCH_SIZE);
+                Function<void(int32)> job = [&gatherPoses, activeActorsCount](int32 jobIndex)
+                {
+                    const int32 start = jobIndex * PHYSX_ACTIVE_TRANSFORMS_JOB_BATCH_SIZE;
+                    gatherPoses(start, Math::Min<int32>(start + PHYSX_ACTIVE_TRANSFORMS_JOB_BATCH_SIZE, (int32)activeActorsCount));
+                };
+                JobSystem::Execute(job, jobCount);
+            }
+            else
+            {
+                gatherPoses(0, (int32)activeActorsCount);
+            }
+
+            // Update changed transformations (hierarchy update and events have to run on a main thread, rendering bounds are updated at once after the writeback)
+            Array<Scene*, InlinedAllocation<8>> scenes;
+            {
+                ScopeLock lock(Level::ScenesLock);
+                scenes.Add(Level::Scenes.Get(), Level::Scenes.Count());
+            }
+            for (Scene* scene : scenes)
+                scene->Rendering.BeginBatchUpdate();
+            const int64 posesVersion = Platform::AtomicRead(&PosesVersion);
+            for (int32 i = 0; i < activeTransforms.Count(); i++)
+            {
+                auto& e = activeTransforms[i];
+                if (!e.Actor)
+                    continue;
+                if (Platform::AtomicRead(&PosesVersion) != posesVersion)
+                {
+                    // Transform change callback has moved other actors so the gathered pose can be outdated
+                    const PxTransform pose = ((PxRigidActor*)activeActors[i])->getGlobalPose();
+                    e.Position = P2C(pose.p);
+                    e.Orientation = P2C(pose.q);
+                }
+                e.Actor->OnActiveTransformChanged(e.Position, e.Orientation);
             }
+            for (Scene* scene : scenes)
+                scene->Rendering.EndBatchUpdate();
         }
     }
 
@@ -1684,6 +1753,7 @@ void PhysicsBackend::SetRigidActorPose(void* actor, const Vector3& position, con
     {
         auto actorPhysX = (PxRigidActor*)actor;
         actorPhysX->setGlobalPose(trans, wakeUp);
+        Platform::InterlockedIncrement(&PosesVersion);
     }
 }
 
@@ -2465,6 +2535,7 @@ void PhysicsBackend::SetControllerPosition(void* controller, const Vector3& valu
 {
     auto controllerPhysX = (PxCapsuleController*)controller;
     controllerPhysX->setPosition(PxExtendedVec3(value.X, value.Y, value.Z));
+    Platform::InterlockedIncrement(&PosesVersion);
 }
 
 int32 PhysicsBackend::MoveController(void* controller, void* shape, const Vector3& displacement, float minMoveDistance, float deltaTime)
@@ -65,9 +65,11 @@ class AndroidAssetFile : public AndroidFile
 
     // [AndroidFile]
     bool Read(void* buffer, uint32 bytesToRead, uint32* bytesRead = nullptr) override;
+    bool ReadAt(void* buffer, uint32 bytesToRead, uint64 offset, uint32* bytesRead = nullptr) override;
     bool Write(const void* buffer, uint32 bytesToWrite, uint32* bytesWritten = nullptr) override;
     void Close() override;
     uint32 GetSize() const override;
+    uint64 GetSize64() const override;
     DateTime GetLastWriteTime() const override;
     uint32 GetPosition() const override;
     void SetPosition(uint32 seek) override;
@@ -586,11 +586,22 @@ void AndroidAssetFile::Close()
     }
 }
 
+bool AndroidAssetFile::ReadAt(void* buffer, uint32 bytesToRead, uint64 offset, uint32* bytesRead)
+{
+    AAsset_seek64(_asset, (off64_t)offset, SEEK_SET);
+    return Read(buffer, bytesToRead, bytesRead);
+}
+
 uint32 AndroidAssetFile::GetSize() const
 {
     return AAsset_getLength(_asset);
 }
 
+uint64 AndroidAssetFile::GetSize64() const
+{
+    return AAsset_getLength64(_asset);
+}
+
 DateTime AndroidAssetFile::GetLastWriteTime() const
 {
     return DateTime::MinValue();
@@ -5,9 +5,38 @@
 #include "Engine/Core/Types/String.h"
 #include "Engine/Core/Types/StringBuilder.h"
 #include "Engine/Core/Types/DataContainer.h"
+#include "Engine/Core/Collections/Array.h"
 #include "Engine/Core/Log.h"
 #include "Engine/Profiler/ProfilerCPU.h"
 
+bool FileBase::ReadAt(void* buffer, uint32 bytesToRead, uint64 offset, uint32* bytesRead)
+{
+    if (offset <= MAX_uint32)
+    {
+        SetPosition((uint32)offset);
+        return Read(buffer, bytesToRead, bytesRead);
+    }
+
+    // File pointer can be set only within 32-bit range so reach larger offsets by reading the data before
+    SetPosition(MAX_uint32);
+    uint64 skip = offset - MAX_uint32;
+    Array<byte> skipBuffer;
+    skipBuffer.Resize((int32)Math::Min<uint64>(skip, 64 * 1024));
+    while (skip != 0)
+    {
+        const uint32 size = (uint32)Math::Min<uint64>(skip, skipBuffer.Count());
+        uint32 skipped = 0;
+        if (Read(skipBuffer.Get(), size, &skipped) || skipped != size)
+        {
+            if (bytesRead)
+                *bytesRead = 0;
+            return true;
+        }
+        skip -= size;
+    }
+    return Read(buffer, bytesToRead, bytesRead);
+}
+
 bool FileBase::ReadAllBytes(const StringView& path, byte* data, int32 length)
 {
     PROFILE_CPU_NAMED("File::ReadAllBytes");
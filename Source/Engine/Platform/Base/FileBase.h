@@ -53,6 +53,16 @@ class FLAXENGINE_API FileBase : public NonCopyable
     /// <returns>True if cannot read data, otherwise false.</returns>
     virtual bool Read(void* buffer, uint32 bytesToRead, uint32* bytesRead = nullptr) = 0;
 
+    /// <summary>
+    /// Reads data from a file at the given offset (positional read). Doesn't use the file pointer (its position is undefined after this call).
+    /// </summary>
+    /// <param name="buffer">Output buffer to read data to it.</param>
+    /// <param name="bytesToRead">The maximum amount bytes to read.</param>
+    /// <param name="offset">The file offset (in bytes) to read data from.</param>
+    /// <param name="bytesRead">A pointer to the variable that receives the number of bytes read.</param>
+    /// <returns>True if cannot read data, otherwise false.</returns>
+    virtual bool ReadAt(void* buffer, uint32 bytesToRead, uint64 offset, uint32* bytesRead = nullptr);
+
     /// <summary>
     /// Writes data to a file.
     /// </summary>
@@ -75,6 +85,15 @@ class FLAXENGINE_API FileBase : public NonCopyable
     /// <returns>File size in bytes.</returns>
     virtual uint32 GetSize() const = 0;
 
+    /// <summary>
+    /// Gets size of the file (in bytes). Supports files larger than 4GB.
+    /// </summary>
+    /// <returns>File size in bytes.</returns>
+    virtual uint64 GetSize64() const
+    {
+        return GetSize();
+    }
+
     /// <summary>
     /// Retrieves the date and time that a file was last modified (in UTC).
     /// </summary>
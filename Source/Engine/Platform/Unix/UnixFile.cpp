@@ -99,6 +99,21 @@ bool UnixFile::Read(void* buffer, uint32 bytesToRead, uint32* bytesRead)
     return true;
 }
 
+bool UnixFile::ReadAt(void* buffer, uint32 bytesToRead, uint64 offset, uint32* bytesRead)
+{
+    const ssize_t tmp = pread(_handle, buffer, bytesToRead, (off_t)offset);
+    if (tmp != -1)
+    {
+        if (bytesRead)
+            *bytesRead = tmp;
+        return false;
+    }
+    if (bytesRead)
+        *bytesRead = 0;
+    LOG_UNIX_LAST_ERROR;
+    return true;
+}
+
 bool UnixFile::Write(const void* buffer, uint32 bytesToWrite, uint32* bytesWritten)
 {
     const ssize_t tmp = write(_handle, buffer, bytesToWrite);
@@ -130,6 +145,13 @@ uint32 UnixFile::GetSize() const
     return fileInfo.st_size;
 }
 
+uint64 UnixFile::GetSize64() const
+{
+    struct stat fileInfo;
+    fstat(_handle, &fileInfo);
+    return fileInfo.st_size;
+}
+
 DateTime UnixFile::GetLastWriteTime() const
 {
     struct stat fileInfo;
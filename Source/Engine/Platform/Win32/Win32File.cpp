@@ -50,6 +50,34 @@ bool Win32File::Read(void* buffer, uint32 bytesToRead, uint32* bytesRead)
     return true;
 }
 
+bool Win32File::ReadAt(void* buffer, uint32 bytesToRead, uint64 offset, uint32* bytesRead)
+{
+    // Read data using the offset from overlapped structure (file is opened for synchronous access so it's blocking)
+    OVERLAPPED overlapped;
+    Platform::MemoryClear(&overlapped, sizeof(overlapped));
+    overlapped.Offset = (DWORD)(offset & MAX_uint32);
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
+    DWORD tmp;
+    if (ReadFile(_handle, buffer, bytesToRead, &tmp, &overlapped))
+    {
+        if (bytesRead)
+            *bytesRead = tmp;
+        return false;
+    }
+
+    // Reading past the end of file is not an error
+    if (GetLastError() == ERROR_HANDLE_EOF)
+    {
+        if (bytesRead)
+            *bytesRead = 0;
+        return false;
+    }
+
+    if (bytesRead)
+        *bytesRead = 0;
+    return true;
+}
+
 bool Win32File::Write(const void* buffer, uint32 bytesToWrite, uint32* bytesWritten)
 {
     // Try to write data
@@ -82,6 +110,13 @@ uint32 Win32File::GetSize() const
     return (uint32)result.QuadPart;
 }
 
+uint64 Win32File::GetSize64() const
+{
+    LARGE_INTEGER result;
+    GetFileSizeEx(_handle, &result);
+    return (uint64)result.QuadPart;
+}
+
 DateTime Win32File::GetLastWriteTime() const
 {
     FILETIME lpLastWriteTime;
@@ -7,6 +7,40 @@
 #include "Engine/Threading/Threading.h"
 #include "IncludeFreeType.h"
 
+// The maximum amount of the cached text layouts per font (least recently used are removed first)
+#define FONT_LAYOUT_CACHE_SIZE 256
+
+// The size of the filter of the missed text layouts per font (layout is cached when it misses the second time)
+#define FONT_LAYOUT_CACHE_MISSES_SIZE 512
+
+// The maximum length of the text to cache its layout
+#define FONT_LAYOUT_CACHE_MAX_TEXT_LENGTH 2048
+
+// The flat kerning table value used for pairs that were not cached yet
+#define FONT_KERNING_UNKNOWN MAX_int16
+
+static uint32 GetLayoutHash(const StringView& text, const TextLayoutOptions& layout)
+{
+    // Layout location is not used by the text processing (lines are relative to the layout bounds)
+    uint32 hash = GetHash(text);
+    CombineHash(hash, GetHash(layout.Bounds.GetWidth()));
+    CombineHash(hash, GetHash(layout.Bounds.GetHeight()));
+    CombineHash(hash, (uint32)layout.HorizontalAlignment | (uint32)layout.VerticalAlignment << 8 | (uint32)layout.TextWrapping << 16);
+    CombineHash(hash, GetHash(layout.Scale));
+    CombineHash(hash, GetHash(layout.BaseLinesGapScale));
+    return hash;
+}
+
+static bool IsLayoutEqual(const TextLayoutOptions& a, const TextLayoutOptions& b)
+{
+    return a.Bounds.Size == b.Bounds.Size &&
+            a.HorizontalAlignment == b.HorizontalAlignment &&
+            a.VerticalAlignment == b.VerticalAlignment &&
+            a.TextWrapping == b.TextWrapping &&
+            a.Scale == b.Scale &&
+            a.BaseLinesGapScale == b.BaseLinesGapScale;
+}
+
 Font::Font(FontAsset* parentAsset, int32 size)
     : ManagedScriptingObject(SpawnParams(Guid::New(), Font::TypeInitializer))
     , _asset(parentAsset)
@@ -30,10 +64,20 @@ Font::~Font()
 {
     if (_asset)
         _asset->_fonts.Remove(this);
+    if (_flatKerning)
+        Allocator::Free(_flatKerning);
 }
 
 void Font::GetCharacter(Char c, FontCharacterEntry& result)
 {
+    // Use fast path for the most common characters
+    const bool isFlat = c < FONT_FLAT_CHARACTERS;
+    if (isFlat && _flatCharacters[c].IsValid)
+    {
+        result = _flatCharacters[c];
+        return;
+    }
+
     // Try to get the character or cache it if cannot be found
     if (!_characters.TryGet(c, result))
     {
@@ -49,14 +93,29 @@ void Font::GetCharacter(Char c, FontCharacterEntry& result)
 
         // Add to the dictionary
         _characters.Add(c, result);
+        if (isFlat)
+            _flatCharacters[c] = result;
+    }
+    else if (isFlat)
+    {
+        _flatCharacters[c] = result;
     }
 }
 
 int32 Font::GetKerning(Char first, Char second) const
 {
+    if (!_hasKerning)
+        return 0;
+
+    // Use fast path for the most common characters
+    const bool isFlat = first < FONT_FLAT_KERNING_CHARACTERS && second < FONT_FLAT_KERNING_CHARACTERS;
+    const int32 flatIndex = first * FONT_FLAT_KERNING_CHARACTERS + second;
+    if (isFlat && _flatKerning && _flatKerning[flatIndex] != FONT_KERNING_UNKNOWN)
+        return _flatKerning[flatIndex];
+
     int32 kerning = 0;
     const uint32 key = (uint32)first << 16 | second;
-    if (_hasKerning && !_kerningTable.TryGet(key, kerning))
+    if (!_kerningTable.TryGet(key, kerning))
     {
         // This thread race condition may happen in editor but in game we usually do all stuff with fonts on main thread (chars caching)
         ScopeLock lock(_asset->Locker);
@@ -79,6 +138,23 @@ int32 Font::GetKerning(Char first, Char second) const
         }
     }
 
+    if (isFlat)
+    {
+        if (!_flatKerning)
+        {
+            ScopeLock lock(_asset->Locker);
+            if (!_flatKerning)
+            {
+                const int32 count = FONT_FLAT_KERNING_CHARACTERS * FONT_FLAT_KERNING_CHARACTERS;
+                auto flatKerning = (int16*)Allocator::Allocate(count * sizeof(int16));
+                for (int32 i = 0; i < count; i++)
+                    flatKerning[i] = FONT_KERNING_UNKNOWN;
+                _flatKerning = flatKerning;
+            }
+        }
+        _flatKerning[flatIndex] = (int16)kerning;
+    }
+
     return kerning;
 }
 
@@ -100,9 +176,128 @@ void Font::Invalidate()
         FontManager::Invalidate(i->Value);
     }
     _characters.Clear();
+    for (FontCharacterEntry& e : _flatCharacters)
+        e.IsValid = false;
+    ClearLayoutCache();
+}
+
+void Font::ClearLayoutCache()
+{
+    ScopeLock lock(_asset->Locker);
+
+    _layoutCache.Clear();
+    _layoutCacheLookup.Clear();
+    _layoutCacheFirst = _layoutCacheLast = -1;
+    _layoutCacheMisses.Clear();
+}
+
+bool Font::TryGetLayout(const StringView& text, const TextLayoutOptions& layout, uint32 key, Array<FontLineCache>& outputLines)
+{
+    ScopeLock lock(_asset->Locker);
+
+    int32 index;
+    if (_layoutCacheLookup.TryGet(key, index))
+    {
+        const LayoutCacheEntry& e = _layoutCache[index];
+        if (e.Text == text && IsLayoutEqual(e.Layout, layout))
+        {
+            if (index != _layoutCacheFirst)
+            {
+                UnlinkLayout(index);
+                LinkLayoutFirst(index);
+            }
+            outputLines.Add(e.Lines);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Font::UnlinkLayout(int32 index)
+{
+    LayoutCacheEntry& e = _layoutCache[index];
+    if (e.Prev != -1)
+        _layoutCache[e.Prev].Next = e.Next;
+    else
+        _layoutCacheFirst = e.Next;
+    if (e.Next != -1)
+        _layoutCache[e.Next].Prev = e.Prev;
+    else
+        _layoutCacheLast = e.Prev;
+}
+
+void Font::LinkLayoutFirst(int32 index)
+{
+    LayoutCacheEntry& e = _layoutCache[index];
+    e.Prev = -1;
+    e.Next = _layoutCacheFirst;
+    if (_layoutCacheFirst != -1)
+        _layoutCache[_layoutCacheFirst].Prev = index;
+    else
+        _layoutCacheLast = index;
+    _layoutCacheFirst = index;
 }
 
 void Font::ProcessText(const StringView& text, Array<FontLineCache>& outputLines, const TextLayoutOptions& layout)
+{
+    if (text.IsEmpty() || text.Length() > FONT_LAYOUT_CACHE_MAX_TEXT_LENGTH)
+    {
+        ProcessTextInternal(text, outputLines, layout);
+        return;
+    }
+
+    // Try to reuse the cached layout for the same text
+    const uint32 key = GetLayoutHash(text, layout);
+    if (TryGetLayout(text, layout, key, outputLines))
+        return;
+
+    // Process text
+    const int32 start = outputLines.Count();
+    ProcessTextInternal(text, outputLines, layout);
+
+    // Skip caching the layout that missed for the first time (eg. text that changes every frame)
+    ScopeLock lock(_asset->Locker);
+    if (_layoutCacheMisses.IsEmpty())
+    {
+        _layoutCacheMisses.Resize(FONT_LAYOUT_CACHE_MISSES_SIZE);
+        Platform::MemoryClear(_layoutCacheMisses.Get(), _layoutCacheMisses.Count() * sizeof(uint32));
+    }
+    uint32& missedKey = _layoutCacheMisses[key % FONT_LAYOUT_CACHE_MISSES_SIZE];
+    if (missedKey != key)
+    {
+        missedKey = key;
+        return;
+    }
+
+    // Cache layout (reuse the least recently used entry if cache is full, or the entry with the same hash)
+    int32 index;
+    if (_layoutCacheLookup.TryGet(key, index))
+    {
+        UnlinkLayout(index);
+    }
+    else if (_layoutCache.Count() < FONT_LAYOUT_CACHE_SIZE)
+    {
+        _layoutCache.EnsureCapacity(FONT_LAYOUT_CACHE_SIZE);
+        index = _layoutCache.Count();
+        _layoutCache.AddOne();
+        _layoutCacheLookup.Add(key, index);
+    }
+    else
+    {
+        index = _layoutCacheLast;
+        UnlinkLayout(index);
+        _layoutCacheLookup.Remove(_layoutCache[index].Key);
+        _layoutCacheLookup.Add(key, index);
+    }
+    LinkLayoutFirst(index);
+    LayoutCacheEntry& e = _layoutCache[index];
+    e.Key = key;
+    e.Text = text;
+    e.Layout = layout;
+    e.Lines.Set(outputLines.Get() + start, outputLines.Count() - start);
+}
+
+void Font::ProcessTextInternal(const StringView& text, Array<FontLineCache>& outputLines, const TextLayoutOptions& layout)
 {
     float cursorX = 0;
     int32 kerning;
@@ -14,6 +14,10 @@ class FontAsset;
 // The default DPI that engine is using
 #define DefaultDPI 96
 
+// The amount of the first characters (Latin) that use flat arrays for the glyphs and kerning lookups instead of hash maps
+#define FONT_FLAT_CHARACTERS 256
+#define FONT_FLAT_KERNING_CHARACTERS 128
+
 /// <summary>
 /// The text range.
 /// </summary>
@@ -220,6 +224,27 @@ DECLARE_SCRIPTING_TYPE_NO_SPAWN(Font);
     bool _hasKerning;
     Dictionary<Char, FontCharacterEntry> _characters;
     mutable Dictionary<uint32, int32> _kerningTable;
+    FontCharacterEntry _flatCharacters[FONT_FLAT_CHARACTERS];
+    mutable int16* _flatKerning = nullptr;
+
+    struct LayoutCacheEntry
+    {
+        uint32 Key;
+        int32 Prev; // More recently used entry index (or -1)
+        int32 Next; // Less recently used entry index (or -1)
+        String Text;
+        TextLayoutOptions Layout;
+        Array<FontLineCache> Lines;
+    };
+
+    // Text layouts cache entries (linked in the order of use, evicted entries are reused) with the lookup by the layout hash
+    Array<LayoutCacheEntry> _layoutCache;
+    Dictionary<uint32, int32> _layoutCacheLookup;
+    int32 _layoutCacheFirst = -1;
+    int32 _layoutCacheLast = -1;
+
+    // Hashes of the recently missed layouts (layout is cached on the second miss so the texts that change every frame don't evict the others)
+    Array<uint32> _layoutCacheMisses;
 
 public:
 
@@ -313,6 +338,11 @@ DECLARE_SCRIPTING_TYPE_NO_SPAWN(Font);
     /// </summary>
     API_FUNCTION() void Invalidate();
 
+    /// <summary>
+    /// Clears the cached text layouts (results of the text processing are cached for the most recently used texts).
+    /// </summary>
+    API_FUNCTION() void ClearLayoutCache();
+
 public:
 
     /// <summary>
@@ -459,6 +489,13 @@ DECLARE_SCRIPTING_TYPE_NO_SPAWN(Font);
     /// </summary>
     void FlushFaceSize() const;
 
+private:
+
+    bool TryGetLayout(const StringView& text, const TextLayoutOptions& layout, uint32 key, Array<FontLineCache>& outputLines);
+    void UnlinkLayout(int32 index);
+    void LinkLayoutFirst(int32 index);
+    void ProcessTextInternal(const StringView& text, Array<FontLineCache>& outputLines, const TextLayoutOptions& layout);
+
 public:
 
     // [Object]
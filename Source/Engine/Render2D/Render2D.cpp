@@ -43,6 +43,9 @@
 #define RENDER2D_INITIAL_IB_CAPACITY (1024)
 #define RENDER2D_INITIAL_DRAW_CALL_CAPACITY (512)
 
+// The maximum amount of the following draw calls checked when searching for the draw calls to batch together
+#define RENDER2D_BATCH_REORDER_WINDOW 32
+
 #define RENDER2D_BLUR_MAX_SAMPLES 64
 
 // The format for the blur effect temporary buffer
@@ -177,6 +180,27 @@ struct ClipMask
     Rectangle Bounds;
 };
 
+// Draw commands recording
+struct RecordingState
+{
+    Render2DCommandList* List;
+    int32 DrawCallsStart;
+    uint32 VBIndex;
+    uint32 IBIndex;
+};
+
+// Draw call screen-space bounds
+struct DrawCallBounds
+{
+    Vector2 Min;
+    Vector2 Max;
+
+    FORCE_INLINE bool Intersects(const DrawCallBounds& other) const
+    {
+        return Min.X < other.Max.X && other.Min.X < Max.X && Min.Y < other.Max.Y && other.Min.Y < Max.Y;
+    }
+};
+
 Render2D::RenderingFeatures Render2D::Features = RenderingFeatures::VertexSnapping;
 
 namespace
@@ -194,6 +218,14 @@ namespace
     Array<Vector2> Lines2;
     bool IsScissorsRectEmpty;
     bool IsScissorsRectEnabled;
+    Array<RecordingState, InlinedAllocation<8>> RecordingStack;
+
+    // Batching
+    Array<DrawCallBounds> ReorderBounds;
+    Array<bool> ReorderPlaced;
+    Array<int32> ReorderOrder;
+    Array<Render2DDrawCall> ReorderDrawCalls;
+    Array<byte> ReorderIndices;
 
     // Transform
     // Note: we use Matrix3x3 instead of Matrix because we use only 2D transformations on CPU side
@@ -465,6 +497,102 @@ bool CanBatchDrawCalls(const Render2DDrawCall& d1, const Render2DDrawCall& d2)
     return d1.Type == d2.Type && CanDrawCallBatch[(int32)d1.Type](d1, d2);
 }
 
+FORCE_INLINE bool IsReorderBarrier(const Render2DDrawCall& d)
+{
+    // Scissors change the state for all the following draw calls and blur reads the output contents
+    return d.Type == DrawCallType::ClipScissors || d.Type == DrawCallType::Blur;
+}
+
+void ReorderBatches()
+{
+    const int32 count = DrawCalls.Count();
+    if (count < 3)
+        return;
+    PROFILE_CPU();
+    const Render2DVertex* vertices = (const Render2DVertex*)VB.Data.Get();
+    const uint32* indices = (const uint32*)IB.Data.Get();
+
+    // Calculate draw calls bounds (with a small margin for vertex snapping and antialiasing)
+    ReorderBounds.Resize(count, false);
+    for (int32 i = 0; i < count; i++)
+    {
+        const Render2DDrawCall& d = DrawCalls[i];
+        DrawCallBounds& bounds = ReorderBounds[i];
+        bounds.Min = Vector2(MAX_float);
+        bounds.Max = Vector2(MIN_float);
+        for (uint32 j = 0; j < d.CountIB; j++)
+        {
+            const Vector2& position = vertices[indices[d.StartIB + j]].Position;
+            bounds.Min = Vector2::Min(bounds.Min, position);
+            bounds.Max = Vector2::Max(bounds.Max, position);
+        }
+        bounds.Min -= 1.0f;
+        bounds.Max += 1.0f;
+    }
+
+    // Pull the following batchable draw calls up to the batch start if they don't overlap with any draw call they would skip over
+    ReorderPlaced.Resize(count, false);
+    ReorderPlaced.SetAll(false);
+    ReorderOrder.Clear();
+    ReorderOrder.EnsureCapacity(count);
+    Array<int32, InlinedAllocation<RENDER2D_BATCH_REORDER_WINDOW>> skipped;
+    bool anyMoved = false;
+    for (int32 i = 0; i < count; i++)
+    {
+        if (ReorderPlaced[i])
+            continue;
+        ReorderPlaced[i] = true;
+        ReorderOrder.Add(i);
+        const Render2DDrawCall& batchStart = DrawCalls[i];
+        if (IsReorderBarrier(batchStart) || CanDrawCallBatch[(int32)batchStart.Type] == CanDrawCallCallbackFalse)
+            continue;
+        skipped.Clear();
+        const int32 end = Math::Min(count, i + 1 + RENDER2D_BATCH_REORDER_WINDOW);
+        for (int32 j = i + 1; j < end; j++)
+        {
+            if (ReorderPlaced[j])
+                continue;
+            const Render2DDrawCall& d = DrawCalls[j];
+            if (IsReorderBarrier(d))
+                break;
+            if (CanBatchDrawCalls(batchStart, d))
+            {
+                bool overlaps = false;
+                for (int32 k = 0; k < skipped.Count() && !overlaps; k++)
+                    overlaps = ReorderBounds[skipped[k]].Intersects(ReorderBounds[j]);
+                if (!overlaps)
+                {
+                    ReorderPlaced[j] = true;
+                    ReorderOrder.Add(j);
+                    anyMoved |= skipped.HasItems();
+                    continue;
+                }
+            }
+            skipped.Add(j);
+        }
+    }
+    if (!anyMoved)
+        return;
+
+    // Rebuild draw calls and index buffer in the new order (batched draw calls need to use continuous indices range)
+    ReorderDrawCalls.Clear();
+    ReorderDrawCalls.EnsureCapacity(count);
+    ReorderIndices.Clear();
+    ReorderIndices.EnsureCapacity(IB.Data.Count());
+    uint32 startIB = 0;
+    for (int32 i = 0; i < count; i++)
+    {
+        Render2DDrawCall& d = ReorderDrawCalls.AddOne();
+        d = DrawCalls[ReorderOrder[i]];
+        ReorderIndices.Add((const byte*)(indices + d.StartIB), d.CountIB * sizeof(uint32));
+        d.StartIB = startIB;
+        startIB += d.CountIB;
+    }
+    ReorderIndices.Add(IB.Data.Get() + startIB * sizeof(uint32), IB.Data.Count() - startIB * sizeof(uint32));
+    DrawCalls.Swap(ReorderDrawCalls);
+    IB.Data.Swap(ReorderIndices);
+}
+
 void DrawBatch(int32 startIndex, int32 count);
 
 bool CachedPSO::Init(GPUShader* shader, bool useDepth)
@@ -614,6 +742,11 @@ void Render2DService::Dispose()
     DrawCalls.Resize(0);
     Lines.Resize(0);
     Lines2.Resize(0);
+    ReorderBounds.Resize(0);
+    ReorderPlaced.Resize(0);
+    ReorderOrder.Resize(0);
+    ReorderDrawCalls.Resize(0);
+    ReorderIndices.Resize(0);
 
     GUIShader = nullptr;
 
@@ -669,6 +802,7 @@ void Render2D::Begin(GPUContext* context, GPUTextureView* output, GPUTextureView
     View = viewport;
     ViewProjection = viewProjection;
     DrawCalls.Clear();
+    RecordingStack.Clear();
 
     // Initialize default transform
     const Matrix3x3 defaultTransform = Matrix3x3::Identity;
@@ -701,6 +835,11 @@ void Render2D::End()
     RENDER2D_CHECK_RENDERING_STATE;
     ASSERT(Context != nullptr && Output != nullptr);
     ASSERT(GUIShader != nullptr);
+    if (RecordingStack.HasItems())
+    {
+        LOG(Warning, "Render2D commands recording was not ended.");
+        RecordingStack.Clear();
+    }
 
     // Skip if has nothing to draw
     if (DrawCalls.IsEmpty())
@@ -727,6 +866,12 @@ void Render2D::End()
         shader = GUIShader->GetShader();
     }
 
+    // Group non-overlapping draw calls to reduce state changes
+    if (((int32)Features & (int32)RenderingFeatures::BatchReordering) != 0)
+    {
+        ReorderBatches();
+    }
+
     // Flush geometry buffers
     VB.Flush(Context);
     IB.Flush(Context);
@@ -793,6 +938,129 @@ void Render2D::EndFrame()
     FontManager::Flush();
 }
 
+Render2DCommandList::Render2DCommandList(const SpawnParams& params)
+    : ScriptingObject(params)
+{
+}
+
+void Render2D::BeginRecording(Render2DCommandList* list)
+{
+    RENDER2D_CHECK_RENDERING_STATE;
+    CHECK(list);
+
+    RecordingState& state = RecordingStack.AddOne();
+    state.List = list;
+    state.DrawCallsStart = DrawCalls.Count();
+    state.VBIndex = VBIndex;
+    state.IBIndex = IBIndex;
+}
+
+void Render2D::EndRecording()
+{
+    RENDER2D_CHECK_RENDERING_STATE;
+    PROFILE_CPU();
+
+    if (RecordingStack.IsEmpty())
+    {
+        LOG(Error, "Render2D::EndRecording called without BeginRecording.");
+        return;
+    }
+    const RecordingState state = RecordingStack.Pop();
+    Render2DCommandList& list = *state.List;
+
+    // Copy geometry (indices are relative to the first recorded vertex)
+    list._vertices.Set(VB.Data.Get() + state.VBIndex * sizeof(Render2DVertex), (VBIndex - state.VBIndex) * sizeof(Render2DVertex));
+    list._indices.Set((const uint32*)IB.Data.Get() + state.IBIndex, IBIndex - state.IBIndex);
+    for (uint32& index : list._indices)
+        index -= state.VBIndex;
+
+    // Copy draw calls
+    const int32 drawCallsCount = DrawCalls.Count() - state.DrawCallsStart;
+    list._drawCalls.Resize(drawCallsCount * sizeof(Render2DDrawCall), false);
+    list._hasScissors = false;
+    auto drawCalls = (Render2DDrawCall*)list._drawCalls.Get();
+    for (int32 i = 0; i < drawCallsCount; i++)
+    {
+        Render2DDrawCall& d = drawCalls[i];
+        d = DrawCalls[state.DrawCallsStart + i];
+        d.StartIB -= state.IBIndex;
+        list._hasScissors |= d.Type == DrawCallType::ClipScissors;
+    }
+
+    list._isValid = true;
+}
+
+void OnClipScissors();
+
+void Render2D::Replay(const Render2DCommandList* listPtr, const Vector2& offset)
+{
+    RENDER2D_CHECK_RENDERING_STATE;
+    if (!listPtr || !listPtr->_isValid)
+        return;
+    const Render2DCommandList& list = *listPtr;
+
+    Vector2 delta;
+    Matrix3x3::Transform2DVector(offset, TransformCached, delta);
+    if (((int32)Features & (int32)RenderingFeatures::VertexSnapping) != 0)
+    {
+        // Move the recorded geometry by whole pixels only to keep it aligned to the pixel grid
+        delta = Vector2(Math::Round(delta.X), Math::Round(delta.Y));
+    }
+    const bool hasOffset = !delta.IsZero();
+
+    // Write geometry
+    const uint32 verticesCount = list._vertices.Count() / sizeof(Render2DVertex);
+    Render2DVertex* vertices = VB.WriteReserve<Render2DVertex>(verticesCount);
+    Platform::MemoryCopy(vertices, list._vertices.Get(), list._vertices.Count());
+    if (hasOffset)
+    {
+        for (uint32 i = 0; i < verticesCount; i++)
+        {
+            vertices[i].Position += delta;
+            vertices[i].ClipMask.TopLeft += delta;
+        }
+    }
+    const int32 indicesCount = list._indices.Count();
+    uint32* indices = IB.WriteReserve<uint32>(indicesCount);
+    for (int32 i = 0; i < indicesCount; i++)
+        indices[i] = list._indices[i] + VBIndex;
+
+    // Add draw calls
+    const int32 drawCallsCount = list._drawCalls.Count() / sizeof(Render2DDrawCall);
+    const Render2DDrawCall* drawCalls = (const Render2DDrawCall*)list._drawCalls.Get();
+    for (int32 i = 0; i < drawCallsCount; i++)
+    {
+        Render2DDrawCall& d = DrawCalls.AddOne();
+        d = drawCalls[i];
+        d.StartIB += IBIndex;
+        if (hasOffset)
+        {
+            switch (d.Type)
+            {
+            case DrawCallType::ClipScissors:
+                d.AsClipScissors.X += delta.X;
+                d.AsClipScissors.Y += delta.Y;
+                break;
+            case DrawCallType::Blur:
+                d.AsBlur.UpperLeftX += delta.X;
+                d.AsBlur.UpperLeftY += delta.Y;
+                d.AsBlur.BottomRightX += delta.X;
+                d.AsBlur.BottomRightY += delta.Y;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    VBIndex += verticesCount;
+    IBIndex += indicesCount;
+
+    // Restore the current clipping (recorded scissors end with the clipping state at the recording time)
+    if (list._hasScissors)
+        OnClipScissors();
+}
+
 void Render2D::PushTransform(const Matrix3x3& transform)
 {
     RENDER2D_CHECK_RENDERING_STATE;
@@ -3,8 +3,9 @@
 #pragma once
 
 #include "Engine/Core/Math/Color.h"
-#include "Engine/Scripting/ScriptingType.h"
+#include "Engine/Scripting/ScriptingObject.h"
 #include "Engine/Core/Types/Span.h"
+#include "Engine/Core/Collections/Array.h"
 
 struct SpriteHandle;
 struct TextLayoutOptions;
@@ -20,6 +21,44 @@ class GPUContext;
 class RenderTask;
 class MaterialBase;
 class TextureBase;
+class Render2D;
+
+/// <summary>
+/// The recorded Render2D draw commands that can be replayed multiple times (retained-mode geometry caching for the UI). Recorded geometry stays valid until invalidated by the owner (eg. when control layout or style changes).
+/// </summary>
+/// <remarks>
+/// Recorded geometry is in the output space with baked tint, clipping and referenced textures/materials (owner has to invalidate the cache if any of those gets modified or released).
+/// </remarks>
+API_CLASS(Sealed) class FLAXENGINE_API Render2DCommandList : public ScriptingObject
+{
+DECLARE_SCRIPTING_TYPE(Render2DCommandList);
+    friend Render2D;
+private:
+
+    bool _isValid = false;
+    bool _hasScissors = false;
+    Array<byte> _vertices;
+    Array<uint32> _indices;
+    Array<byte> _drawCalls;
+
+public:
+
+    /// <summary>
+    /// Returns true if the commands list has been recorded and can be replayed.
+    /// </summary>
+    API_PROPERTY() FORCE_INLINE bool IsValid() const
+    {
+        return _isValid;
+    }
+
+    /// <summary>
+    /// Invalidates the recorded commands (memory is kept for the next recording).
+    /// </summary>
+    API_FUNCTION() FORCE_INLINE void Invalidate()
+    {
+        _isValid = false;
+    }
+};
 
 /// <summary>
 /// Rendering 2D shapes and text using Graphics Device.
@@ -42,6 +81,11 @@ DECLARE_SCRIPTING_TYPE_NO_SPAWN(Render2D);
         /// Enables automatic geometry vertices snapping to integer coordinates in screen space. Reduces aliasing and sampling artifacts. Might be disabled for 3D projection viewport or for complex UI transformations.
         /// </summary>
         VertexSnapping = 1,
+
+        /// <summary>
+        /// Enables draw calls reordering before the rendering to group non-overlapping draw calls that use the same texture or material. Reduces the amount of the GPU state changes and draw calls but adds the CPU cost of the reordering pass (disabled by default).
+        /// </summary>
+        BatchReordering = 2,
     };
 
 public:
@@ -112,6 +156,26 @@ DECLARE_SCRIPTING_TYPE_NO_SPAWN(Render2D);
     /// </summary>
     static void EndFrame();
 
+public:
+
+    /// <summary>
+    /// Begins the draw commands recording. All the following draw calls are rendered and also recorded into the given list (until EndRecording). Recordings can be nested.
+    /// </summary>
+    /// <param name="list">The output commands list.</param>
+    API_FUNCTION() static void BeginRecording(Render2DCommandList* list);
+
+    /// <summary>
+    /// Ends the draw commands recording started with BeginRecording.
+    /// </summary>
+    API_FUNCTION() static void EndRecording();
+
+    /// <summary>
+    /// Draws the recorded commands list. Skips invalid lists.
+    /// </summary>
+    /// <param name="list">The commands list to draw.</param>
+    /// <param name="offset">The translation offset to apply to the recorded geometry (in the current transformation space). Rounded to whole pixels if vertex snapping is enabled.</param>
+    API_FUNCTION() static void Replay(const Render2DCommandList* list, API_PARAM(Ref) const Vector2& offset);
+
 public:
 
     /// <summary>
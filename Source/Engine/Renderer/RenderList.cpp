@@ -569,6 +569,7 @@ void RenderList::ExecuteDrawCalls(const RenderContext& renderContext, DrawCallsL
     {
         // Prepare buffer memory
         int32 batchesCount = 0;
+        bool anyInstancesBuffer = false;
         for (int32 i = 0; i < list.Batches.Count(); i++)
         {
             auto& batch = list.Batches[i];
@@ -580,11 +581,12 @@ void RenderList::ExecuteDrawCalls(const RenderContext& renderContext, DrawCallsL
             auto& batch = BatchedDrawCalls[list.PreBatchedDrawCalls[i]];
             if (batch.Instances.Count() > 1)
                 batchesCount += batch.Instances.Count();
+            anyInstancesBuffer |= batch.InstancesBuffer != nullptr;
         }
         if (batchesCount == 0)
         {
-            // Faster path if none of the draw batches requires instancing
-            useInstancing = false;
+            // Faster path if none of the draw batches requires instancing (GPU-generated instances use own buffers)
+            useInstancing = anyInstancesBuffer;
             goto DRAW;
         }
         _instanceBuffer.Clear();
@@ -701,12 +703,22 @@ void RenderList::ExecuteDrawCalls(const RenderContext& renderContext, DrawCallsL
             }
 
             bindParams.FirstDrawCall = &drawCall;
-            bindParams.DrawCallsCount = batch.Instances.Count();
+            bindParams.DrawCallsCount = batch.InstancesBuffer ? MAX_int32 : batch.Instances.Count(); // GPU-generated instances count is unknown so always use the instanced shader
             drawCall.Material->Bind(bindParams);
 
             context->BindIB(drawCall.Geometry.IndexBuffer);
 
-            if (drawCall.InstanceCount == 0)
+            if (batch.InstancesBuffer)
+            {
+                // Instances count is generated on the GPU
+                vbCount = 3;
+                vb[vbCount] = batch.InstancesBuffer;
+                vbOffsets[vbCount] = 0;
+                vbCount++;
+                context->BindVB(ToSpan(vb, vbCount), vbOffsets);
+                context->DrawIndexedInstancedIndirect(drawCall.Draw.IndirectArgsBuffer, drawCall.Draw.IndirectArgsOffset);
+            }
+            else if (drawCall.InstanceCount == 0)
             {
                 ASSERT_LOW_LAYER(batch.Instances.Count() == 1);
                 context->BindVB(ToSpan(vb, vbCount), vbOffsets);
@@ -764,6 +776,21 @@ void RenderList::ExecuteDrawCalls(const RenderContext& renderContext, DrawCallsL
             auto drawCall = batch.DrawCall;
             bindParams.FirstDrawCall = &drawCall;
 
+            if (batch.InstancesBuffer)
+            {
+                // GPU-generated instances exist only in the instances buffer so draw them with the instanced shader and indirect arguments
+                GPUBuffer* vb[4] = { drawCall.Geometry.VertexBuffers[0], drawCall.Geometry.VertexBuffers[1], drawCall.Geometry.VertexBuffers[2], batch.InstancesBuffer };
+                uint32 vbOffsets[4] = { drawCall.Geometry.VertexBuffersOffsets[0], drawCall.Geometry.VertexBuffersOffsets[1], drawCall.Geometry.VertexBuffersOffsets[2], 0 };
+                bindParams.DrawCallsCount = MAX_int32;
+                drawCall.Material->Bind(bindParams);
+                bindParams.DrawCallsCount = 1;
+
+                context->BindIB(drawCall.Geometry.IndexBuffer);
+                context->BindVB(ToSpan(vb, 4), vbOffsets);
+                context->DrawIndexedInstancedIndirect(drawCall.Draw.IndirectArgsBuffer, drawCall.Draw.IndirectArgsOffset);
+                continue;
+            }
+
             for (int32 j = 0; j < batch.Instances.Count(); j++)
             {
                 auto& instance = batch.Instances[j];
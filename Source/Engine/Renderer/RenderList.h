@@ -288,6 +288,9 @@ struct BatchedDrawCall
 {
     DrawCall DrawCall;
     Array<struct InstanceData, RenderListAllocation> Instances;
+
+    // The GPU-generated instances buffer (vertex buffer with InstanceData elements) drawn with the indirect draw arguments from DrawCall. Null if instances are provided by the CPU.
+    GPUBuffer* InstancesBuffer = nullptr;
 };
 
 /// <summary>
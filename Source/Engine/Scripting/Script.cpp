@@ -11,6 +11,7 @@
 #include "Engine/Level/Actor.h"
 #include "Engine/Level/Level.h"
 #include "Engine/Level/Scene/Scene.h"
+#include "Engine/Level/SceneObjectsFactory.h"
 #include "Engine/Serialization/Serialization.h"
 #include "Engine/Threading/Threading.h"
 
@@ -292,12 +293,14 @@ void Script::BeginPlay(SceneBeginData* data)
 
     // Set flag
     Flags |= ObjectFlags::IsDuringPlay;
+    Level::addToLookup(this);
 }
 
 void Script::EndPlay()
 {
     // Clear flag
     Flags &= ~ObjectFlags::IsDuringPlay;
+    Level::removeFromLookup(this);
 
     // Cleanup managed object
     DestroyManaged();
@@ -338,6 +341,7 @@ void Script::Deserialize(DeserializeStream& stream, ISerializeModifier* modifier
                 }
                 else
                 {
+                    ScopeLock lock(SceneObjectsFactory::HierarchyLocker);
                     if (_parent)
                         _parent->Scripts.RemoveKeepOrder(this);
                     _parent = parent;
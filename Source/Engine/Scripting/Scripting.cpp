@@ -7,6 +7,7 @@
 #include "FlaxEngine.Gen.h"
 #include "Engine/Threading/Threading.h"
 #include "Engine/Threading/ThreadLocal.h"
+#include "Engine/Threading/ReadWriteLock.h"
 #include "Engine/Threading/IRunnable.h"
 #include "Engine/Platform/FileSystem.h"
 #include "Engine/Platform/File.h"
@@ -23,6 +24,7 @@
 #include "Engine/Level/Level.h"
 #include "Engine/Core/ObjectsRemovalService.h"
 #include "Engine/Core/Types/TimeSpan.h"
+#include "Engine/Core/Types/Pair.h"
 #include "Engine/Profiler/ProfilerCPU.h"
 #include "Engine/Content/Asset.h"
 #include "Engine/Content/Content.h"
@@ -59,7 +61,6 @@ namespace
 {
     MDomain* _rootDomain = nullptr;
     MDomain* _scriptsDomain = nullptr;
-    CriticalSection _objectsLocker;
 #define USE_OBJECTS_DISPOSE_CRASHES_DEBUGGING 0
 #if USE_OBJECTS_DISPOSE_CRASHES_DEBUGGING
     struct ScriptingObjectData
@@ -95,10 +96,56 @@ namespace
         }
     };
 
-    Dictionary<Guid, ScriptingObjectData> _objectsDictionary(1024 * 16);
+    typedef ScriptingObjectData ObjectsDictionaryValue;
 #else
-    Dictionary<Guid, ScriptingObject*> _objectsDictionary(1024 * 16);
+    typedef ScriptingObject* ObjectsDictionaryValue;
 #endif
+
+    // Objects registry is split into shards (by the object ID hash) with own readers-writer lock so lookups from many threads don't block each other (only writes to the same shard block them)
+#define SCRIPTING_OBJECTS_SHARDS 64
+    struct ObjectsShard
+    {
+        ReadWriteLock Locker;
+        Dictionary<Guid, ObjectsDictionaryValue> Objects;
+    };
+
+    ObjectsShard _objectsShards[SCRIPTING_OBJECTS_SHARDS];
+
+    FORCE_INLINE ObjectsShard& GetObjectsShard(const Guid& id)
+    {
+        return _objectsShards[GetHash(id) & (SCRIPTING_OBJECTS_SHARDS - 1)];
+    }
+
+    // Object which managed instance deleted event is in progress (see Scripting::OnManagedInstanceDeleted)
+    CriticalSection _managedInstanceDeletedLocker;
+    volatile int64 _managedInstanceDeletedObject = 0;
+
+    template<typename Callback>
+    void ForEachObject(Callback callback)
+    {
+        // Callback is called with the shard unlocked (it can register, unregister or delete objects) so objects are gathered before
+        Array<Pair<Guid, ObjectsDictionaryValue>> objects;
+        for (ObjectsShard& shard : _objectsShards)
+        {
+            shard.Locker.ReadLock();
+            objects.Clear();
+            objects.EnsureCapacity(shard.Objects.Count());
+            for (auto i = shard.Objects.Begin(); i.IsNotEnd(); ++i)
+                objects.Add(ToPair(i->Key, i->Value));
+            shard.Locker.ReadUnlock();
+
+            for (auto& e : objects)
+            {
+                // Skip objects removed by the previous callbacks
+                shard.Locker.ReadLock();
+                const ObjectsDictionaryValue* value = shard.Objects.TryGet(e.First);
+                const bool isValid = value && (ScriptingObject*)*value == (ScriptingObject*)e.Second;
+                shard.Locker.ReadUnlock();
+                if (isValid)
+                    callback(e.Second);
+            }
+        }
+    }
     bool _isEngineAssemblyLoaded = false;
     bool _hasGameModulesLoaded = false;
     MMethod* _method_Update = nullptr;
@@ -506,18 +553,13 @@ void Scripting::Release()
     MCore::GC::WaitForPendingFinalizers();
 
     // Release managed objects instances for persistent objects (assets etc.)
-    _objectsLocker.Lock();
+    ForEachObject([](ObjectsDictionaryValue& obj)
     {
-        for (auto i = _objectsDictionary.Begin(); i.IsNotEnd(); ++i)
-        {
-            auto obj = i->Value;
 #if USE_OBJECTS_DISPOSE_CRASHES_DEBUGGING
-            LOG(Info, "[OnScriptingDispose] obj = 0x{0:x}, {1}", (uint64)obj.Ptr, String(obj.TypeName));
+        LOG(Info, "[OnScriptingDispose] obj = 0x{0:x}, {1}", (uint64)obj.Ptr, String(obj.TypeName));
 #endif
-            obj->OnScriptingDispose();
-        }
-    }
-    _objectsLocker.Unlock();
+        obj->OnScriptingDispose();
+    });
 
     // Unload assemblies (from back to front)
     {
@@ -607,22 +649,19 @@ void Scripting::Reload(bool canTriggerSceneReload)
     MCore::GC::WaitForPendingFinalizers();
 
     // Destroy objects from game assemblies (eg. not released objects that might crash if persist in memory after reload)
-    _objectsLocker.Lock();
     {
         const auto flaxModule = GetBinaryModuleFlaxEngine();
-        for (auto i = _objectsDictionary.Begin(); i.IsNotEnd(); ++i)
+        ForEachObject([flaxModule](ObjectsDictionaryValue& obj)
         {
-            auto obj = i->Value;
             if (obj->GetTypeHandle().Module == flaxModule)
-                continue;
+                return;
 
 #if USE_OBJECTS_DISPOSE_CRASHES_DEBUGGING
             LOG(Info, "[OnScriptingDispose] obj = 0x{0:x}, {1}", (uint64)obj.Ptr, String(obj.TypeName));
 #endif
             obj->OnScriptingDispose();
-        }
+        });
     }
-    _objectsLocker.Unlock();
 
     // Unload all game modules
     LOG(Info, "Unloading game binary modules");
@@ -752,18 +791,11 @@ ScriptingObject* Scripting::FindObject(Guid id, MClass* type)
     }
 
     // Try to find it
-#if USE_OBJECTS_DISPOSE_CRASHES_DEBUGGING
-    ScriptingObjectData data;
-    _objectsLocker.Lock();
-    _objectsDictionary.TryGet(id, data);
-    _objectsLocker.Unlock();
-    auto result = data.Ptr;
-#else
-    ScriptingObject* result = nullptr;
-    _objectsLocker.Lock();
-    _objectsDictionary.TryGet(id, result);
-    _objectsLocker.Unlock();
-#endif
+    ObjectsShard& shard = GetObjectsShard(id);
+    shard.Locker.ReadLock();
+    const ObjectsDictionaryValue* value = shard.Objects.TryGet(id);
+    ScriptingObject* result = value ? (ScriptingObject*)*value : nullptr;
+    shard.Locker.ReadUnlock();
     if (result)
     {
         // Check type
@@ -806,18 +838,11 @@ ScriptingObject* Scripting::TryFindObject(Guid id, MClass* type)
     }
 
     // Try to find it
-#if USE_OBJECTS_DISPOSE_CRASHES_DEBUGGING
-    ScriptingObjectData data;
-    _objectsLocker.Lock();
-    _objectsDictionary.TryGet(id, data);
-    _objectsLocker.Unlock();
-    auto result = data.Ptr;
-#else
-    ScriptingObject* result = nullptr;
-    _objectsLocker.Lock();
-    _objectsDictionary.TryGet(id, result);
-    _objectsLocker.Unlock();
-#endif
+    ObjectsShard& shard = GetObjectsShard(id);
+    shard.Locker.ReadLock();
+    const ObjectsDictionaryValue* value = shard.Objects.TryGet(id);
+    ScriptingObject* result = value ? (ScriptingObject*)*value : nullptr;
+    shard.Locker.ReadUnlock();
 
     // Check type
     if (result && type && !result->Is(type))
@@ -836,13 +861,15 @@ ScriptingObject* Scripting::FindObject(const MObject* managedInstance)
 
     // TODO: optimize it by reading the unmanagedPtr or _internalId from managed Object property
 
-    ScopeLock lock(_objectsLocker);
-
-    for (auto i = _objectsDictionary.Begin(); i.IsNotEnd(); ++i)
+    for (ObjectsShard& shard : _objectsShards)
     {
-        const auto obj = i->Value;
-        if (obj->GetManagedInstance() == managedInstance)
-            return obj;
+        ScopeReadLock lock(shard.Locker);
+        for (auto i = shard.Objects.Begin(); i.IsNotEnd(); ++i)
+        {
+            const auto obj = i->Value;
+            if (obj->GetManagedInstance() == managedInstance)
+                return obj;
+        }
     }
     return nullptr;
 }
@@ -852,20 +879,30 @@ void Scripting::OnManagedInstanceDeleted(ScriptingObject* obj)
     PROFILE_CPU();
     ASSERT(obj);
 
-    // Validate if object still exists
-    _objectsLocker.Lock();
-    if (_objectsDictionary.ContainsValue(obj))
+    // Validate if object still exists (object can be already deleted so find it by the pointer only)
+    // Event is called without shard lock, object marked as in progress before unlocking the shard so unregistering it on other thread waits for the event end
+    ScopeLock lock(_managedInstanceDeletedLocker);
+    bool contains = false;
+    for (ObjectsShard& shard : _objectsShards)
     {
-#if USE_OBJECTS_DISPOSE_CRASHES_DEBUGGING
-        LOG(Info, "[OnManagedInstanceDeleted] obj = 0x{0:x}, {1}", (uint64)obj, String(ScriptingObjectData(obj).TypeName));
-#endif
-        obj->OnManagedInstanceDeleted();
+        shard.Locker.ReadLock();
+        contains = shard.Objects.ContainsValue(obj);
+        if (contains)
+            Platform::AtomicStore(&_managedInstanceDeletedObject, (int64)obj);
+        shard.Locker.ReadUnlock();
+        if (contains)
+            break;
     }
-    else
+    if (!contains)
     {
         //LOG(Warning, "Object finalization called for already removed object (address={0:x})", (uint64)obj);
+        return;
     }
-    _objectsLocker.Unlock();
+#if USE_OBJECTS_DISPOSE_CRASHES_DEBUGGING
+    LOG(Info, "[OnManagedInstanceDeleted] obj = 0x{0:x}, {1}", (uint64)obj, String(ScriptingObjectData(obj).TypeName));
+#endif
+    obj->OnManagedInstanceDeleted();
+    Platform::AtomicStore(&_managedInstanceDeletedObject, 0);
 }
 
 bool Scripting::HasGameModulesLoaded()
@@ -892,56 +929,68 @@ bool Scripting::IsTypeFromGameScripts(MClass* type)
 
 void Scripting::RegisterObject(ScriptingObject* obj)
 {
-    ScopeLock lock(_objectsLocker);
+    ObjectsShard& shard = GetObjectsShard(obj->GetID());
+    ScopeWriteLock lock(shard.Locker);
 
-    //ASSERT(!_objectsDictionary.ContainsValue(obj));
+    //ASSERT(!shard.Objects.ContainsValue(obj));
 #if ENABLE_ASSERTION
-#if USE_OBJECTS_DISPOSE_CRASHES_DEBUGGING
-    ScriptingObjectData other;
-    if (_objectsDictionary.TryGet(obj->GetID(), other))
-#else
-    ScriptingObject* other;
-    if (_objectsDictionary.TryGet(obj->GetID(), other))
-#endif
+    ObjectsDictionaryValue other;
+    if (shard.Objects.TryGet(obj->GetID(), other))
     {
         // Something went wrong...
         LOG(Error, "Objects registry already contains object with ID={0} (type '{3}')! Trying to register object {1} (type '{2}').", obj->GetID(), obj->ToString(), String(obj->GetClass()->GetFullName()), String(other->GetClass()->GetFullName()));
-        _objectsDictionary.Remove(obj->GetID());
+        shard.Objects.Remove(obj->GetID());
     }
 #else
-	ASSERT(!_objectsDictionary.ContainsKey(obj->_id));
+	ASSERT(!shard.Objects.ContainsKey(obj->_id));
 #endif
 
 #if USE_OBJECTS_DISPOSE_CRASHES_DEBUGGING
     LOG(Info, "[RegisterObject] obj = 0x{0:x}, {1}", (uint64)obj, String(ScriptingObjectData(obj).TypeName));
 #endif
-    _objectsDictionary.Add(obj->GetID(), obj);
+    shard.Objects.Add(obj->GetID(), obj);
 }
 
 void Scripting::UnregisterObject(ScriptingObject* obj)
 {
-    ScopeLock lock(_objectsLocker);
+    {
+        ObjectsShard& shard = GetObjectsShard(obj->GetID());
+        ScopeWriteLock lock(shard.Locker);
 
-    //ASSERT(!obj->_id.IsValid() || _objectsDictionary.ContainsValue(obj));
+        //ASSERT(!obj->_id.IsValid() || shard.Objects.ContainsValue(obj));
 
 #if USE_OBJECTS_DISPOSE_CRASHES_DEBUGGING
-    LOG(Info, "[UnregisterObject] obj = 0x{0:x}, {1}", (uint64)obj, String(ScriptingObjectData(obj).TypeName));
+        LOG(Info, "[UnregisterObject] obj = 0x{0:x}, {1}", (uint64)obj, String(ScriptingObjectData(obj).TypeName));
 #endif
-    _objectsDictionary.Remove(obj->GetID());
+        shard.Objects.Remove(obj->GetID());
+    }
+
+    // Wait for the managed instance deleted event of this object to end before it gets deleted
+    if (Platform::AtomicRead(&_managedInstanceDeletedObject) == (int64)obj)
+    {
+        ScopeLock lock(_managedInstanceDeletedLocker);
+    }
 }
 
 void Scripting::OnObjectIdChanged(ScriptingObject* obj, const Guid& oldId)
 {
-    ScopeLock lock(_objectsLocker);
-
     ASSERT(obj && oldId.IsValid());
     ASSERT(obj->GetID() != oldId);
-    ASSERT(_objectsDictionary.ContainsKey(oldId));
-    //ASSERT(_objectsDictionary.ContainsValue(obj));
-    ASSERT(!_objectsDictionary.ContainsKey(obj->GetID()));
 
-    _objectsDictionary.Remove(oldId);
-    _objectsDictionary.Add(obj->GetID(), obj);
+    // Move object between shards (never lock two shards at once)
+    {
+        ObjectsShard& shard = GetObjectsShard(oldId);
+        ScopeWriteLock lock(shard.Locker);
+        ASSERT(shard.Objects.ContainsKey(oldId));
+        //ASSERT(shard.Objects.ContainsValue(obj));
+        shard.Objects.Remove(oldId);
+    }
+    {
+        ObjectsShard& shard = GetObjectsShard(obj->GetID());
+        ScopeWriteLock lock(shard.Locker);
+        ASSERT(!shard.Objects.ContainsKey(obj->GetID()));
+        shard.Objects.Add(obj->GetID(), obj);
+    }
 }
 
 bool initFlaxEngine()
@@ -2,8 +2,14 @@
 
 #include "FileReadStream.h"
 #include "Engine/Core/Log.h"
+#include "Engine/Core/Math/Math.h"
 #include "Engine/Platform/File.h"
 
+// Size of the buffer used when reading file sequentially (in bytes)
+#define FILESTREAM_READAHEAD_SIZE (64 * 1024)
+// Amount of subsequent sequential buffer refills after which readahead is used
+#define FILESTREAM_READAHEAD_THRESHOLD 2
+
 FileReadStream* FileReadStream::Open(const StringView& path)
 {
     const auto file = File::Open(path, FileMode::OpenExisting, FileAccess::Read, FileShare::Read);
@@ -22,8 +28,12 @@ void FileReadStream::Unlink()
 
 FileReadStream::FileReadStream(File* file)
     : _file(file)
+    , _bufferPosition(0)
     , _virtualPosInBuffer(0)
     , _bufferSize(0)
+    , _sequentialReads(0)
+    , _buffer(_inlineBuffer)
+    , _readaheadBuffer(nullptr)
 {
     ASSERT_LOW_LAYER(_file);
 }
@@ -33,18 +43,56 @@ FileReadStream::~FileReadStream()
     // Ensure to be file closed and deleted
     if (_file)
         Delete(_file);
+    if (_readaheadBuffer)
+        Allocator::Free(_readaheadBuffer);
 }
 
-void FileReadStream::Flush()
+uint64 FileReadStream::GetLength64() const
+{
+    return _file->GetSize64();
+}
+
+void FileReadStream::SetPosition64(uint64 seek)
+{
+    // Seek within the buffered data
+    if (seek >= _bufferPosition && seek <= _bufferPosition + _bufferSize)
+    {
+        _virtualPosInBuffer = (uint32)(seek - _bufferPosition);
+        return;
+    }
+
+    // Invalidate buffer (it will be filled on the next read)
+    _bufferPosition = seek;
+    _virtualPosInBuffer = 0;
+    _bufferSize = 0;
+    _sequentialReads = 0;
+}
+
+void FileReadStream::FillBuffer()
 {
-    // Check if need to flush
-    /*if (_virtualPosInBuffer > 0)
+    // Detect sequential reading to use the larger buffer (random access reads only a small block to prevent overfetching)
+    const uint64 position = _bufferPosition + _virtualPosInBuffer;
+    if (_bufferSize != 0 && _virtualPosInBuffer == _bufferSize)
+        _sequentialReads++;
+    else
+        _sequentialReads = 0;
+    uint32 size = FILESTREAM_BUFFER_SIZE;
+    _buffer = _inlineBuffer;
+    if (_sequentialReads >= FILESTREAM_READAHEAD_THRESHOLD)
     {
-        // Update buffer
-        uint32 bytesRead;
-        _hasError |= _file->Read(_buffer, FILESTREAM_BUFFER_SIZE, &bytesRead) != 0;
-        _virtualPosInBuffer = 0;
-    }*/
+        if (!_readaheadBuffer)
+            _readaheadBuffer = (byte*)Allocator::Allocate(FILESTREAM_READAHEAD_SIZE);
+        _buffer = _readaheadBuffer;
+        size = FILESTREAM_READAHEAD_SIZE;
+    }
+
+    _bufferPosition = position;
+    _virtualPosInBuffer = 0;
+    _hasError |= _file->ReadAt(_buffer, size, position, &_bufferSize) != 0;
+}
+
+void FileReadStream::Flush()
+{
 }
 
 void FileReadStream::Close()
@@ -57,72 +105,56 @@ void FileReadStream::Close()
 
 uint32 FileReadStream::GetLength()
 {
-    return _file->GetSize();
+    return (uint32)GetLength64();
 }
 
 uint32 FileReadStream::GetPosition()
 {
-    return _file->GetPosition() - _bufferSize + _virtualPosInBuffer;
+    return (uint32)GetPosition64();
 }
 
 void FileReadStream::SetPosition(uint32 seek)
 {
-    // Seek
-    _file->SetPosition(seek);
-
-    // Update buffer
-    _hasError |= _file->Read(_buffer, FILESTREAM_BUFFER_SIZE, &_bufferSize) != 0;
-    _virtualPosInBuffer = 0;
+    SetPosition64(seek);
 }
 
 void FileReadStream::ReadBytes(void* data, uint32 bytes)
 {
-    // Skip if nothing to read
-    if (bytes == 0)
-    {
-        return;
-    }
-
-    // Ensure to flush the buffer if it's empty
-    if (_bufferSize == 0)
+    while (bytes != 0)
     {
-        CHECK(_virtualPosInBuffer == 0);
-        _hasError |= _file->Read(_buffer, FILESTREAM_BUFFER_SIZE, &_bufferSize) != 0;
-    }
-
-    // Check if buffer has enough data for this read
-    const uint32 bufferBytesLeft = static_cast<uint32>(_bufferSize - _virtualPosInBuffer);
-    if (bytes <= bufferBytesLeft)
-    {
-        Platform::MemoryCopy(data, _buffer + _virtualPosInBuffer, bytes);
-        _virtualPosInBuffer += bytes;
-    }
-    else
-    {
-        // Flush already buffered bytes and read more it the buffer (reduce amount of flushes)
-        if (_virtualPosInBuffer > 0)
+        // Copy buffered data
+        const uint32 bufferBytesLeft = _bufferSize - _virtualPosInBuffer;
+        if (bufferBytesLeft != 0)
         {
-            Platform::MemoryCopy(data, _buffer + _virtualPosInBuffer, bufferBytesLeft);
-            data = (byte*)data + bufferBytesLeft;
-            bytes -= bufferBytesLeft;
-            _virtualPosInBuffer = 0;
-            _hasError |= _file->Read(_buffer, FILESTREAM_BUFFER_SIZE, &_bufferSize) != 0;
+            const uint32 count = Math::Min(bytes, bufferBytesLeft);
+            Platform::MemoryCopy(data, _buffer + _virtualPosInBuffer, count);
+            _virtualPosInBuffer += count;
+            data = (byte*)data + count;
+            bytes -= count;
+            continue;
         }
 
-        // Read as much as can using whole buffer
-        while (bytes >= FILESTREAM_BUFFER_SIZE)
+        // Read large blocks directly to the output (skip the buffer)
+        if (bytes >= FILESTREAM_READAHEAD_SIZE)
         {
-            Platform::MemoryCopy(data, _buffer, FILESTREAM_BUFFER_SIZE);
-            data = (byte*)data + FILESTREAM_BUFFER_SIZE;
-            bytes -= FILESTREAM_BUFFER_SIZE;
-            _hasError |= _file->Read(_buffer, FILESTREAM_BUFFER_SIZE, &_bufferSize) != 0;
+            const uint64 position = GetPosition64();
+            uint32 bytesRead = 0;
+            _hasError |= _file->ReadAt(data, bytes, position, &bytesRead) != 0;
+            _bufferPosition = position + bytesRead;
+            _virtualPosInBuffer = 0;
+            _bufferSize = 0;
+            if (bytesRead != bytes)
+                _hasError = true;
+            return;
         }
 
-        // Read the rest of the buffer but without flushing its data
-        if (bytes > 0)
+        // Refill the buffer
+        FillBuffer();
+        if (_bufferSize == 0)
         {
-            Platform::MemoryCopy(data, _buffer, bytes);
-            _virtualPosInBuffer = bytes;
+            // End of file
+            _hasError = true;
+            return;
         }
     }
 }
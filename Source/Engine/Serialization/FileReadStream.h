@@ -8,15 +8,22 @@
 /// <summary>
 /// Implementation of the stream that has access to the file and is optimized for fast reading from it
 /// </summary>
+/// <remarks>
+/// Uses positional reads (doesn't depend on the file pointer). Seeks within the buffered data don't access the file and sequential reading uses a larger readahead buffer.
+/// </remarks>
 /// <seealso cref="ReadStream" />
 class FLAXENGINE_API FileReadStream : public ReadStream
 {
 private:
 
     File* _file;
+    uint64 _bufferPosition; // Position of the buffer start in the file
     uint32 _virtualPosInBuffer; // Current position in the buffer (index)
     uint32 _bufferSize; // Amount of loaded bytes from the file to the buffer
-    byte _buffer[FILESTREAM_BUFFER_SIZE];
+    uint32 _sequentialReads; // Amount of the buffer refills that continued the previous one
+    byte* _buffer; // Points to the inlined buffer or readahead buffer
+    byte* _readaheadBuffer;
+    byte _inlineBuffer[FILESTREAM_BUFFER_SIZE];
 
 public:
     NON_COPYABLE(FileReadStream);
@@ -57,6 +64,33 @@ class FLAXENGINE_API FileReadStream : public ReadStream
     /// <returns>Created file reader stream or null if cannot perform that action</returns>
     static FileReadStream* Open(const StringView& path);
 
+public:
+
+    /// <summary>
+    /// Gets the length of the stream (supports files larger than 4GB).
+    /// </summary>
+    /// <returns>The length in bytes.</returns>
+    uint64 GetLength64() const;
+
+    /// <summary>
+    /// Gets the current position in the stream (supports files larger than 4GB).
+    /// </summary>
+    /// <returns>The position in bytes.</returns>
+    FORCE_INLINE uint64 GetPosition64() const
+    {
+        return _bufferPosition + _virtualPosInBuffer;
+    }
+
+    /// <summary>
+    /// Sets the current position in the stream (supports files larger than 4GB). Doesn't access the file if the target position is within the buffered data.
+    /// </summary>
+    /// <param name="seek">The position in bytes.</param>
+    void SetPosition64(uint64 seek);
+
+private:
+
+    void FillBuffer();
+
 public:
 
     // [ReadStream]
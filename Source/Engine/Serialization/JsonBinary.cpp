@@ -0,0 +1,386 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#include "JsonBinary.h"
+#include "MemoryWriteStream.h"
+#include "Engine/Core/Log.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
+#include "Engine/Core/Types/StringView.h"
+#include "Engine/Platform/StringUtils.h"
+#include "Engine/Profiler/ProfilerCPU.h"
+
+#define JSON_BINARY_MAGIC 0x4E534A46 // 'FJSN'
+#define JSON_BINARY_VERSION 1
+
+// The maximum nesting level of the arrays and objects (limits the recursion when reading not trusted data)
+#define JSON_BINARY_MAX_DEPTH 512
+
+namespace
+{
+    enum class Tag : byte
+    {
+        Null = 0,
+        False = 1,
+        True = 2,
+        Int = 3,
+        Uint = 4,
+        Int64 = 5,
+        Uint64 = 6,
+        Double = 7,
+        String = 8,
+        Guid = 9,
+        Array = 10,
+        Object = 11,
+    };
+
+    // Checks if string is an object id serialized by the JsonWriter (32 lowercase hex digits)
+    bool IsGuidText(const char* str, uint32 length)
+    {
+        if (length != 32)
+            return false;
+        for (uint32 i = 0; i < 32; i++)
+        {
+            const char c = str[i];
+            if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f')))
+                return false;
+        }
+        return true;
+    }
+
+    struct Writer
+    {
+        MemoryWriteStream& Stream;
+        Dictionary<StringAnsiView, uint32> KeysLookup;
+        Array<StringAnsiView> Keys;
+
+        Writer(MemoryWriteStream& stream)
+            : Stream(stream)
+        {
+        }
+
+        void GatherKeys(const rapidjson_flax::Value& value)
+        {
+            if (value.IsObject())
+            {
+                for (auto i = value.MemberBegin(); i != value.MemberEnd(); ++i)
+                {
+                    const StringAnsiView key(i->name.GetString(), (int32)i->name.GetStringLength());
+                    if (!KeysLookup.ContainsKey(key))
+                    {
+                        KeysLookup.Add(key, Keys.Count());
+                        Keys.Add(key);
+                    }
+                    GatherKeys(i->value);
+                }
+            }
+            else if (value.IsArray())
+            {
+                for (auto i = value.Begin(); i != value.End(); ++i)
+                    GatherKeys(*i);
+            }
+        }
+
+        void WriteValue(const rapidjson_flax::Value& value)
+        {
+            switch (value.GetType())
+            {
+            case rapidjson::kNullType:
+                Stream.WriteByte((byte)Tag::Null);
+                break;
+            case rapidjson::kFalseType:
+                Stream.WriteByte((byte)Tag::False);
+                break;
+            case rapidjson::kTrueType:
+                Stream.WriteByte((byte)Tag::True);
+                break;
+            case rapidjson::kNumberType:
+                if (value.IsDouble())
+                {
+                    Stream.WriteByte((byte)Tag::Double);
+                    Stream.WriteDouble(value.GetDouble());
+                }
+                else if (value.IsInt())
+                {
+                    Stream.WriteByte((byte)Tag::Int);
+                    Stream.WriteInt32(value.GetInt());
+                }
+                else if (value.IsUint())
+                {
+                    Stream.WriteByte((byte)Tag::Uint);
+                    Stream.WriteUint32(value.GetUint());
+                }
+                else if (value.IsInt64())
+                {
+                    Stream.WriteByte((byte)Tag::Int64);
+                    Stream.WriteInt64(value.GetInt64());
+                }
+                else
+                {
+                    Stream.WriteByte((byte)Tag::Uint64);
+                    Stream.WriteUint64(value.GetUint64());
+                }
+                break;
+            case rapidjson::kStringType:
+            {
+                const char* str = value.GetString();
+                const uint32 length = value.GetStringLength();
+                if (IsGuidText(str, length))
+                {
+                    uint32 guid[4];
+                    for (int32 i = 0; i < 4; i++)
+                        StringUtils::ParseHex(str + i * 8, 8, &guid[i]);
+                    Stream.WriteByte((byte)Tag::Guid);
+                    Stream.WriteBytes(guid, sizeof(guid));
+                }
+                else
+                {
+                    Stream.WriteByte((byte)Tag::String);
+                    Stream.WriteUint32(length);
+                    Stream.WriteBytes(str, length);
+                }
+                break;
+            }
+            case rapidjson::kArrayType:
+                Stream.WriteByte((byte)Tag::Array);
+                Stream.WriteUint32(value.Size());
+                for (auto i = value.Begin(); i != value.End(); ++i)
+                    WriteValue(*i);
+                break;
+            case rapidjson::kObjectType:
+                Stream.WriteByte((byte)Tag::Object);
+                Stream.WriteUint32(value.MemberCount());
+                for (auto i = value.MemberBegin(); i != value.MemberEnd(); ++i)
+                {
+                    Stream.WriteUint32(KeysLookup[StringAnsiView(i->name.GetString(), (int32)i->name.GetStringLength())]);
+                    WriteValue(i->value);
+                }
+                break;
+            }
+        }
+    };
+
+    // Generates SAX events for the document from the binary data
+    struct Reader
+    {
+        const byte* Position;
+        const byte* End;
+        Array<StringAnsiView> Keys;
+        int32 Depth = 0;
+        bool Failed = false;
+
+        template<typename T>
+        FORCE_INLINE bool Read(T& result)
+        {
+            if (Position + sizeof(T) > End)
+            {
+                Failed = true;
+                return false;
+            }
+            Platform::MemoryCopy(&result, Position, sizeof(T));
+            Position += sizeof(T);
+            return true;
+        }
+
+        // Checks if the data has the given amount of bytes left (without pointers overflow for corrupted sizes)
+        FORCE_INLINE bool HasBytes(uint64 size) const
+        {
+            return size <= (uint64)(End - Position);
+        }
+
+        bool ReadKeys()
+        {
+            uint32 count;
+            if (!Read(count) || !HasBytes((uint64)count * sizeof(uint32)))
+                return false;
+            Keys.Resize(count);
+            for (uint32 i = 0; i < count; i++)
+            {
+                uint32 length;
+                if (!Read(length) || !HasBytes(length))
+                    return false;
+                Keys[i] = StringAnsiView((const char*)Position, (int32)length);
+                Position += length;
+            }
+            return true;
+        }
+
+        template<typename Handler>
+        bool ReadValue(Handler& handler)
+        {
+            byte tag;
+            if (!Read(tag))
+                return false;
+            switch ((Tag)tag)
+            {
+            case Tag::Null:
+                return handler.Null();
+            case Tag::False:
+                return handler.Bool(false);
+            case Tag::True:
+                return handler.Bool(true);
+            case Tag::Int:
+            {
+                int32 v;
+                return Read(v) && handler.Int(v);
+            }
+            case Tag::Uint:
+            {
+                uint32 v;
+                return Read(v) && handler.Uint(v);
+            }
+            case Tag::Int64:
+            {
+                int64 v;
+                return Read(v) && handler.Int64(v);
+            }
+            case Tag::Uint64:
+            {
+                uint64 v;
+                return Read(v) && handler.Uint64(v);
+            }
+            case Tag::Double:
+            {
+                double v;
+                return Read(v) && handler.Double(v);
+            }
+            case Tag::String:
+            {
+                uint32 length;
+                if (!Read(length) || !HasBytes(length))
+                    return false;
+                const char* str = (const char*)Position;
+                Position += length;
+                return handler.String(str, length, true);
+            }
+            case Tag::Guid:
+            {
+                uint32 guid[4];
+                if (!Read(guid))
+                    return false;
+                static const char* digits = "0123456789abcdef";
+                char text[32];
+                for (int32 i = 0; i < 4; i++)
+                {
+                    uint32 n = guid[i];
+                    for (int32 j = 7; j >= 0; j--)
+                    {
+                        text[i * 8 + j] = digits[n & 0xf];
+                        n >>= 4;
+                    }
+                }
+                return handler.String(text, 32, true);
+            }
+            case Tag::Array:
+            {
+                // Each item takes at least a single byte
+                uint32 count;
+                if (!Read(count) || !HasBytes(count) || Depth >= JSON_BINARY_MAX_DEPTH || !handler.StartArray())
+                    return false;
+                Depth++;
+                for (uint32 i = 0; i < count; i++)
+                {
+                    if (!ReadValue(handler))
+                        return false;
+                }
+                Depth--;
+                return handler.EndArray(count);
+            }
+            case Tag::Object:
+            {
+                // Each member takes at least a key index and a value tag
+                uint32 count;
+                if (!Read(count) || !HasBytes((uint64)count * (sizeof(uint32) + 1)) || Depth >= JSON_BINARY_MAX_DEPTH || !handler.StartObject())
+                    return false;
+                Depth++;
+                for (uint32 i = 0; i < count; i++)
+                {
+                    uint32 keyIndex;
+                    if (!Read(keyIndex) || keyIndex >= (uint32)Keys.Count())
+                        return false;
+                    const StringAnsiView& key = Keys[keyIndex];
+                    if (!handler.Key(key.Get(), key.Length(), true) || !ReadValue(handler))
+                        return false;
+                }
+                Depth--;
+                return handler.EndObject(count);
+            }
+            default:
+                return false;
+            }
+        }
+
+        template<typename Handler>
+        bool operator()(Handler& handler)
+        {
+            if (!ReadValue(handler))
+            {
+                Failed = true;
+                return false;
+            }
+            return true;
+        }
+    };
+}
+
+bool JsonBinary::IsBinary(const void* data, uint32 length)
+{
+    uint32 magic;
+    if (length < sizeof(magic) + sizeof(int32))
+        return false;
+    Platform::MemoryCopy(&magic, data, sizeof(magic));
+    return magic == JSON_BINARY_MAGIC;
+}
+
+void JsonBinary::Write(const rapidjson_flax::Value& value, MemoryWriteStream& stream)
+{
+    PROFILE_CPU();
+
+    // Header
+    stream.WriteUint32(JSON_BINARY_MAGIC);
+    stream.WriteInt32(JSON_BINARY_VERSION);
+
+    // Keys table
+    Writer writer(stream);
+    writer.GatherKeys(value);
+    stream.WriteUint32(writer.Keys.Count());
+    for (const StringAnsiView& key : writer.Keys)
+    {
+        stream.WriteUint32(key.Length());
+        stream.WriteBytes(key.Get(), key.Length());
+    }
+
+    // Values
+    writer.WriteValue(value);
+}
+
+bool JsonBinary::Read(const void* data, uint32 length, rapidjson_flax::Document& document)
+{
+    PROFILE_CPU();
+    if (!IsBinary(data, length))
+    {
+        LOG(Error, "Invalid binary json data.");
+        return true;
+    }
+    Reader reader;
+    reader.Position = (const byte*)data + sizeof(uint32);
+    reader.End = (const byte*)data + length;
+    int32 version = 0;
+    reader.Read(version);
+    if (version != JSON_BINARY_VERSION)
+    {
+        LOG(Error, "Unsupported binary json data version {0}.", version);
+        return true;
+    }
+    if (!reader.ReadKeys())
+    {
+        LOG(Error, "Corrupted binary json data.");
+        return true;
+    }
+    document.Populate(reader);
+    if (reader.Failed || reader.Position != reader.End || document.HasParseError())
+    {
+        LOG(Error, "Corrupted binary json data.");
+        return true;
+    }
+    return false;
+}
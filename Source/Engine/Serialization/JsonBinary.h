@@ -0,0 +1,41 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#include "Json.h"
+
+class MemoryWriteStream;
+
+/// <summary>
+/// Compact binary encoding of the json documents used for the cooked data (eg. scenes).
+/// Values are stored with type tags, object keys are stored once in a shared keys table and the objects ids are stored as raw bytes.
+/// Loading it skips the text parsing (no numbers/escapes/ids parsing) and builds the document directly from the sequential data stream.
+/// </summary>
+class FLAXENGINE_API JsonBinary
+{
+public:
+
+    /// <summary>
+    /// Checks if the given data is in the binary json format (rather than text).
+    /// </summary>
+    /// <param name="data">The data.</param>
+    /// <param name="length">The data length (in bytes).</param>
+    /// <returns>True if data uses the binary json format, otherwise false.</returns>
+    static bool IsBinary(const void* data, uint32 length);
+
+    /// <summary>
+    /// Writes the json value in the binary format.
+    /// </summary>
+    /// <param name="value">The json value (eg. document root).</param>
+    /// <param name="stream">The output stream.</param>
+    static void Write(const rapidjson_flax::Value& value, MemoryWriteStream& stream);
+
+    /// <summary>
+    /// Reads the json document from the binary format.
+    /// </summary>
+    /// <param name="data">The data.</param>
+    /// <param name="length">The data length (in bytes).</param>
+    /// <param name="document">The output document.</param>
+    /// <returns>True if failed, otherwise false.</returns>
+    static bool Read(const void* data, uint32 length, rapidjson_flax::Document& document);
+};
@@ -3,6 +3,7 @@
 #if COMPILE_WITH_SHADER_COMPILER
 
 #include "ShaderCompiler.h"
+#include "ShadersCompilation.h"
 #include "Engine/Core/Log.h"
 #include "Engine/Core/Collections/Dictionary.h"
 #include "Engine/Engine/Globals.h"
@@ -11,13 +12,21 @@
 #include "Engine/Graphics/RenderTools.h"
 #include "Engine/Threading/Threading.h"
 #include "Engine/Profiler/ProfilerCPU.h"
+#include "Engine/Threading/ThreadPool.h"
+#include "Engine/Serialization/MemoryReadStream.h"
 #include "Engine/Serialization/MemoryWriteStream.h"
+#include "Engine/Utilities/Crc.h"
 #include "Engine/Utilities/StringConverter.h"
+#include "FlaxEngine.Gen.h"
 #if USE_EDITOR
 #include "Editor/Editor.h"
 #include "Editor/ProjectInfo.h"
 #endif
 
+// Enables caching compiled shader functions (in project cache folder) to skip compilation of the unchanged shaders
+#define SHADER_FUNCTIONS_CACHE 1
+#define SHADER_FUNCTIONS_CACHE_VERSION 1
+
 namespace IncludedFiles
 {
     struct File
@@ -25,11 +34,40 @@ namespace IncludedFiles
         String Path;
         DateTime LastEditTime;
         Array<byte> Source;
+        uint32 Hash;
     };
 
     CriticalSection Locker;
     Dictionary<String, File*> Files;
 
+    File* Get(const String& path)
+    {
+        // Try to reuse file
+        File* result = nullptr;
+        if (!Files.TryGet(path, result) || FileSystem::GetFileLastEditTime(path) > result->LastEditTime)
+        {
+            // Remove old one
+            if (result)
+            {
+                Delete(result);
+                Files.Remove(path);
+            }
+
+            // Load file
+            result = New<File>();
+            result->Path = path;
+            result->LastEditTime = FileSystem::GetFileLastEditTime(path);
+            if (::File::ReadAllBytes(result->Path, result->Source))
+            {
+                Delete(result);
+                return nullptr;
+            }
+            result->Hash = Crc::MemCrc32(result->Source.Get(), result->Source.Count());
+            Files.Add(path, result);
+        }
+        return result;
+    }
+
 #if USE_EDITOR
     bool FindProject(const ProjectInfo* project, HashSet<const ProjectInfo*>& projects, const StringView& projectName, String& path)
     {
@@ -56,7 +94,138 @@ namespace IncludedFiles
 #endif
 }
 
-bool ShaderCompiler::Compile(ShaderCompilationContext* context)
+namespace
+{
+    struct ShaderFunctionResult
+    {
+        Array<byte> Data;
+        Array<ShaderCompiler::ShaderResourceBuffer> ConstantBuffers;
+        Array<String> Includes;
+        bool Failed = true;
+    };
+}
+
+#if SHADER_FUNCTIONS_CACHE
+
+namespace ShaderFunctionsCache
+{
+    struct KeyBuilder
+    {
+        uint32 Crc = 0;
+        uint64 Fnv = 14695981039346656037ull;
+        uint32 Length = 0;
+
+        void Append(const void* data, int32 length)
+        {
+            Crc = Crc::MemCrc32(data, length, Crc);
+            const byte* ptr = (const byte*)data;
+            for (int32 i = 0; i < length; i++)
+            {
+                Fnv ^= ptr[i];
+                Fnv *= 1099511628211ull;
+            }
+            Length += (uint32)length;
+        }
+
+        void Append(const char* text)
+        {
+            if (text)
+                Append(text, StringUtils::Length(text) + 1);
+        }
+    };
+
+    String GetPath(const ShaderCompilationContext* context, const ShaderFunctionMeta& meta, ShaderProfile profile)
+    {
+        // Key the function by the shader source, function name, macros and compiler options (includes are validated on load)
+        const auto options = context->Options;
+        KeyBuilder key;
+        const uint32 header[] = { SHADER_FUNCTIONS_CACHE_VERSION, FLAXENGINE_VERSION_BUILD, (uint32)profile, options->NoOptimize ? 1u : 0u, options->TreatWarningsAsErrors ? 1u : 0u };
+        key.Append(header, sizeof(header));
+        for (const ShaderMacro& macro : options->Macros)
+        {
+            key.Append(macro.Name);
+            key.Append(macro.Definition);
+        }
+        key.Append(meta.Name.Get());
+        key.Append(options->Source, (int32)options->SourceLength);
+        const Guid id(key.Crc, (uint32)key.Fnv, (uint32)(key.Fnv >> 32), key.Length);
+        return Globals::ProjectCacheFolder / TEXT("Shaders/Functions") / ::ToString(profile) / id.ToString(Guid::FormatType::N) + TEXT(".bin");
+    }
+
+    bool Load(const String& path, int32 constantBuffersCount, ShaderFunctionResult& result)
+    {
+        Array<byte> data;
+        if (!FileSystem::FileExists(path) || File::ReadAllBytes(path, data) || data.Count() < 4 * sizeof(int32))
+            return true;
+        MemoryReadStream stream(data.Get(), data.Count());
+        int32 version, includesCount;
+        stream.ReadInt32(&version);
+        stream.ReadInt32(&includesCount);
+        if (version != SHADER_FUNCTIONS_CACHE_VERSION || includesCount < 0)
+            return true;
+
+        // Validate included files contents
+        result.Includes.Resize(includesCount);
+        for (String& include : result.Includes)
+        {
+            uint32 hash;
+            stream.ReadString(&include, 11);
+            stream.ReadUint32(&hash);
+            ScopeLock lock(IncludedFiles::Locker);
+            const IncludedFiles::File* file = IncludedFiles::Get(include);
+            if (!file || file->Hash != hash)
+                return true;
+        }
+
+        // Read constant buffers usage and the compiled functions data
+        int32 cbsCount;
+        stream.ReadInt32(&cbsCount);
+        if (cbsCount != constantBuffersCount || stream.GetLength() - stream.GetPosition() < cbsCount * sizeof(ShaderCompiler::ShaderResourceBuffer) + sizeof(int32))
+            return true;
+        result.ConstantBuffers.Resize(cbsCount);
+        stream.Read(result.ConstantBuffers.Get(), cbsCount);
+        int32 dataSize;
+        stream.ReadInt32(&dataSize);
+        if (dataSize < 0 || (int32)(stream.GetLength() - stream.GetPosition()) != dataSize)
+            return true;
+        result.Data.Set(stream.GetPositionHandle(), dataSize);
+        result.Failed = false;
+        return false;
+    }
+
+    void Store(const String& path, const ShaderFunctionResult& result)
+    {
+        MemoryWriteStream stream(result.Data.Count() + 1024);
+        stream.WriteInt32(SHADER_FUNCTIONS_CACHE_VERSION);
+        stream.WriteInt32(result.Includes.Count());
+        for (const String& include : result.Includes)
+        {
+            ScopeLock lock(IncludedFiles::Locker);
+            const IncludedFiles::File* file = IncludedFiles::Get(include);
+            if (!file)
+                return;
+            stream.WriteString(include, 11);
+            stream.WriteUint32(file->Hash);
+        }
+        stream.WriteInt32(result.ConstantBuffers.Count());
+        stream.Write(result.ConstantBuffers.Get(), result.ConstantBuffers.Count());
+        stream.WriteInt32(result.Data.Count());
+        stream.WriteBytes(result.Data.Get(), result.Data.Count());
+        const String directory = StringUtils::GetDirectoryName(path);
+        if (!FileSystem::DirectoryExists(directory))
+            FileSystem::CreateDirectory(directory);
+
+        // Write to the temporary file and move it so other processes never read partially written entries
+        // Note: the same function can be compiled at once by many threads (eg. shader with different permutations) so use unique temporary file
+        const String tmpPath = String::Format(TEXT("{0}.{1}.{2}.tmp"), path, Platform::GetCurrentProcessId(), Platform::GetCurrentThreadID());
+        if (File::WriteAllBytes(tmpPath, stream.GetHandle(), (int32)stream.GetPosition()) || FileSystem::MoveFile(path, tmpPath, true))
+            FileSystem::DeleteFile(tmpPath);
+    }
+}
+
+#endif
+
+bool ShaderCompiler::Prepare(ShaderCompilationContext* context)
 {
     // Clear cache
     _globalMacros.Clear();
@@ -67,9 +236,7 @@ bool ShaderCompiler::Compile(ShaderCompilationContext* context)
     _context = context;
 
     // Prepare
-    auto output = context->Output;
     auto meta = context->Meta;
-    const int32 shadersCount = meta->GetShadersCount();
     if (OnCompileBegin())
         return true;
     _globalMacros.Add({ nullptr, nullptr });
@@ -79,6 +246,17 @@ bool ShaderCompiler::Compile(ShaderCompilationContext* context)
     for (int32 i = 0; i < meta->CB.Count(); i++)
         _constantBuffers.Add({ meta->CB[i].Slot, false, 0 });
 
+    return false;
+}
+
+bool ShaderCompiler::Compile(ShaderCompilationContext* context)
+{
+    if (Prepare(context))
+        return true;
+    auto output = context->Output;
+    auto meta = context->Meta;
+    const int32 shadersCount = meta->GetShadersCount();
+
     // [Output] Version number
     output->WriteInt32(8);
 
@@ -206,28 +384,12 @@ bool ShaderCompiler::GetIncludedFileSource(ShaderCompilationContext* context, co
         return true;
     }
 
-    // Try to reuse file
-    IncludedFiles::File* result = nullptr;
-    if (!IncludedFiles::Files.TryGet(path, result) || FileSystem::GetFileLastEditTime(path) > result->LastEditTime)
+    // Load file
+    IncludedFiles::File* result = IncludedFiles::Get(path);
+    if (!result)
     {
-        // Remove old one
-        if (result)
-        {
-            Delete(result);
-            IncludedFiles::Files.Remove(path);
-        }
-
-        // Load file
-        result = New<IncludedFiles::File>();
-        result->Path = path;
-        result->LastEditTime = FileSystem::GetFileLastEditTime(path);
-        if (File::ReadAllBytes(result->Path, result->Source))
-        {
-            LOG(Error, "Failed to load shader source file '{0}' included in '{1}' (path: '{2}')", String(includedFile), String(sourceFile), path);
-            Delete(result);
-            return true;
-        }
-        IncludedFiles::Files.Add(path, result);
+        LOG(Error, "Failed to load shader source file '{0}' included in '{1}' (path: '{2}')", String(includedFile), String(sourceFile), path);
+        return true;
     }
 
     context->Includes.Add(path);
@@ -254,88 +416,101 @@ bool ShaderCompiler::CompileShaders()
 #define PROFILE_COMPILE_SHADER(s)
 #endif
 
-    // Generate vertex shaders cache
-    for (int32 i = 0; i < meta->VS.Count(); i++)
-    {
-        auto& shader = meta->VS[i];
-        ASSERT(shader.GetStage() == ShaderStage::Vertex && (shader.Flags & ShaderFlags::Hidden) == 0);
-        PROFILE_COMPILE_SHADER(shader);
-        if (CompileShader(shader, &WriteCustomDataVS))
-        {
-            LOG(Error, "Failed to compile \'{0}\'", String(shader.Name));
-            return true;
-        }
+    // Gather all shader functions (in the output order)
+    Array<ShaderFunctionMeta*> functions;
+    Array<WritePermutationData> customDataWrites;
+    functions.EnsureCapacity(meta->GetShadersCount());
+    customDataWrites.EnsureCapacity(meta->GetShadersCount());
+#define ADD_SHADERS(shaders, stage, customDataWrite) \
+    for (auto& shader : meta->shaders) \
+    { \
+        ASSERT(shader.GetStage() == ShaderStage::stage && (shader.Flags & ShaderFlags::Hidden) == 0); \
+        functions.Add(&shader); \
+        customDataWrites.Add(customDataWrite); \
     }
-
-    // Generate hull shaders cache
-    for (int32 i = 0; i < meta->HS.Count(); i++)
+    ADD_SHADERS(VS, Vertex, &WriteCustomDataVS);
+    ADD_SHADERS(HS, Hull, &WriteCustomDataHS);
+    ADD_SHADERS(DS, Domain, nullptr);
+    ADD_SHADERS(GS, Geometry, nullptr);
+    ADD_SHADERS(PS, Pixel, nullptr);
+    ADD_SHADERS(CS, Compute, nullptr);
+#undef ADD_SHADERS
+
+    // Compile all shader functions in parallel (each job uses a separate compiler and output stream)
+    Array<ShaderFunctionResult> results;
+    results.Resize(functions.Count());
+    Function<void(int32)> job = [this, &functions, &customDataWrites, &results](int32 index)
     {
-        auto& shader = meta->HS[i];
-        ASSERT(shader.GetStage() == ShaderStage::Hull && (shader.Flags & ShaderFlags::Hidden) == 0);
+        auto& shader = *functions[index];
         PROFILE_COMPILE_SHADER(shader);
-        if (CompileShader(shader, &WriteCustomDataHS))
+        ShaderFunctionResult& result = results[index];
+#if SHADER_FUNCTIONS_CACHE
+        const bool useCache = !_context->Options->GenerateDebugData;
+        String cachePath;
+        if (useCache)
         {
-            LOG(Error, "Failed to compile \'{0}\'", String(shader.Name));
-            return true;
+            cachePath = ShaderFunctionsCache::GetPath(_context, shader, _profile);
+            if (!ShaderFunctionsCache::Load(cachePath, _context->Meta->CB.Count(), result))
+                return;
         }
-    }
-
-    // Generate domain shaders cache
-    for (int32 i = 0; i < meta->DS.Count(); i++)
-    {
-        auto& shader = meta->DS[i];
-        ASSERT(shader.GetStage() == ShaderStage::Domain && (shader.Flags & ShaderFlags::Hidden) == 0);
-        PROFILE_COMPILE_SHADER(shader);
-        if (CompileShader(shader))
-        {
-            LOG(Error, "Failed to compile \'{0}\'", String(shader.Name));
-            return true;
-        }
-    }
-
-    // Generate geometry shaders cache
-    for (int32 i = 0; i < meta->GS.Count(); i++)
-    {
-        auto& shader = meta->GS[i];
-        ASSERT(shader.GetStage() == ShaderStage::Geometry && (shader.Flags & ShaderFlags::Hidden) == 0);
-        PROFILE_COMPILE_SHADER(shader);
-        if (CompileShader(shader))
+#endif
+        ShaderCompiler* compiler = ShadersCompilation::RequestCompiler(_profile);
+        if (compiler == nullptr)
+            return;
+        MemoryWriteStream output(32 * 1024);
+        ShaderCompilationContext context(_context->Options, _context->Meta);
+        context.Output = &output;
+        result.Failed = compiler->CompileShaderFunction(&context, shader, customDataWrites[index]);
+        if (!result.Failed)
         {
-            LOG(Error, "Failed to compile \'{0}\'", String(shader.Name));
-            return true;
+            result.Data.Set(output.GetHandle(), (int32)output.GetPosition());
+            result.ConstantBuffers = compiler->_constantBuffers;
+            for (auto& include : context.Includes)
+                result.Includes.Add(include.Item);
         }
-    }
+        compiler->_context = nullptr;
+        ShadersCompilation::FreeCompiler(compiler);
+#if SHADER_FUNCTIONS_CACHE
+        if (useCache && !result.Failed)
+            ShaderFunctionsCache::Store(cachePath, result);
+#endif
+    };
+    ThreadPool::Execute(job, functions.Count());
 
-    // Generate pixel shaders cache
-    for (int32 i = 0; i < meta->PS.Count(); i++)
+    // Write the results to the output
+    for (int32 i = 0; i < functions.Count(); i++)
     {
-        auto& shader = meta->PS[i];
-        ASSERT(shader.GetStage() == ShaderStage::Pixel && (shader.Flags & ShaderFlags::Hidden) == 0);
-        PROFILE_COMPILE_SHADER(shader);
-        if (CompileShader(shader))
+        const ShaderFunctionResult& result = results[i];
+        if (result.Failed)
         {
-            LOG(Error, "Failed to compile \'{0}\'", String(shader.Name));
+            LOG(Error, "Failed to compile \'{0}\'", String(functions[i]->Name));
             return true;
         }
-    }
-
-    // Generate compute shaders cache
-    for (int32 i = 0; i < meta->CS.Count(); i++)
-    {
-        auto& shader = meta->CS[i];
-        ASSERT(shader.GetStage() == ShaderStage::Compute && (shader.Flags & ShaderFlags::Hidden) == 0);
-        PROFILE_COMPILE_SHADER(shader);
-        if (CompileShader(shader))
+        _context->Output->WriteBytes(result.Data.Get(), result.Data.Count());
+        for (int32 j = 0; j < _constantBuffers.Count(); j++)
         {
-            LOG(Error, "Failed to compile \'{0}\'", String(shader.Name));
-            return true;
+            const auto& cb = result.ConstantBuffers[j];
+            if (cb.IsUsed)
+            {
+                _constantBuffers[j].IsUsed = true;
+                _constantBuffers[j].Size = cb.Size;
+            }
         }
+        for (const String& include : result.Includes)
+            _context->Includes.Add(include);
     }
 
 #undef PROFILE_COMPILE_SHADER
     return false;
 }
 
+bool ShaderCompiler::CompileShaderFunction(ShaderCompilationContext* context, ShaderFunctionMeta& meta, WritePermutationData customDataWrite)
+{
+    if (Prepare(context))
+        return true;
+    return CompileShader(meta, customDataWrite);
+}
+
 bool ShaderCompiler::OnCompileBegin()
 {
     // Setup global macros
@@ -11,6 +11,9 @@
 /// <summary>
 /// Base class for the objects that can compile shaders source code.
 /// </summary>
+/// <remarks>
+/// Shader functions are compiled in parallel on the Thread Pool threads (see ThreadPool::Execute, each one uses a separate compiler instance from the shaders compilation service pool) so compiler implementations cannot share the compilation state between instances.
+/// </remarks>
 class ShaderCompiler
 {
 public:
@@ -26,6 +29,8 @@ class ShaderCompiler
 
     Array<char> _funcNameDefineBuffer;
 
+    bool Prepare(ShaderCompilationContext* context);
+
 protected:
 
     ShaderProfile _profile;
@@ -91,6 +96,7 @@ class ShaderCompiler
     virtual bool CompileShader(ShaderFunctionMeta& meta, WritePermutationData customDataWrite = nullptr) = 0;
 
     bool CompileShaders();
+    bool CompileShaderFunction(ShaderCompilationContext* context, ShaderFunctionMeta& meta, WritePermutationData customDataWrite);
 
     virtual bool OnCompileBegin();
     virtual bool OnCompileEnd();
@@ -45,6 +45,7 @@ class FLAXENGINE_API ShadersCompilation
 
 private:
 
+    friend class ShaderCompiler;
     static ShaderCompiler* CreateCompiler(ShaderProfile profile);
     static ShaderCompiler* RequestCompiler(ShaderProfile profile);
     static void FreeCompiler(ShaderCompiler* compiler);
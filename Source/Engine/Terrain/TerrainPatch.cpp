@@ -14,6 +14,7 @@
 #include "Engine/Graphics/Async/GPUTask.h"
 #include "Engine/Threading/Threading.h"
 #if TERRAIN_EDITING
+#include "Engine/Core/SIMD.h"
 #include "Engine/Core/Math/Packed.h"
 #include "Engine/Graphics/PixelFormatExtensions.h"
 #include "Engine/Graphics/RenderTools.h"
@@ -34,6 +35,9 @@
 
 #define TERRAIN_PATCH_COLLISION_QUANTIZATION ((float)0x7fff)
 
+// The minimum ratio of the new patch height range to the current one to keep using the current range after heightmap modification (reduces full heightmap and collision updates)
+#define TERRAIN_PATCH_HEIGHT_RANGE_SHRINK_THRESHOLD 0.5f
+
 struct TerrainCollisionDataHeader
 {
     int32 LOD;
@@ -66,6 +70,7 @@ void TerrainPatch::Init(Terrain* terrain, int16 x, int16 z)
     _heightfield = nullptr;
 #if TERRAIN_UPDATING
     _cachedHeightMap.Resize(0);
+    _cachedChunkHeightRanges.Resize(0);
     _cachedHolesMask.Resize(0);
     _wasHeightModified = false;
     for (int32 i = 0; i < TERRAIN_MAX_SPLATMAPS_COUNT; i++)
@@ -184,12 +189,53 @@ FORCE_INLINE bool ReadIsHole(const Color32& raw)
     return (raw.B + raw.A) >= (int32)(1.9f * MAX_uint8);
 }
 
-void CalculateHeightmapRange(Terrain* terrain, TerrainDataUpdateInfo& info, const float* heightmap, float chunkOffsets[TerrainPatch::CHUNKS_COUNT], float chunkHeights[TerrainPatch::CHUNKS_COUNT])
+FORCE_INLINE bool GetChunkModifiedRange(int32 chunkX, int32 chunkZ, int32 vertexCountEdge, const Int2& modifiedStart, const Int2& modifiedEnd, Int2& start, Int2& end)
+{
+    // Chunk vertices range includes both edges (edge samples are shared with the neighbour chunks)
+    start = Int2::Max(modifiedStart - Int2(chunkX, chunkZ), Int2::Zero);
+    end = Int2::Min(modifiedEnd - Int2(chunkX, chunkZ), Int2(vertexCountEdge));
+    return start.X < end.X && start.Y < end.Y;
+}
+
+void CalculateChunkHeightRange(const TerrainDataUpdateInfo& info, const float* heightmap, int32 chunkX, int32 chunkZ, float& minHeight, float& maxHeight)
+{
+    SimdVector4 minHeights = SIMD::Splat(MAX_float);
+    SimdVector4 maxHeights = SIMD::Splat(MIN_float);
+    minHeight = MAX_float;
+    maxHeight = MIN_float;
+    for (int32 z = 0; z < info.VertexCountEdge; z++)
+    {
+        const float* row = heightmap + (chunkZ + z) * info.HeightmapSize + chunkX;
+        int32 x = 0;
+        for (; x + 4 <= info.VertexCountEdge; x += 4)
+        {
+            const SimdVector4 heights = SIMD::LoadUnaligned(row + x);
+            minHeights = SIMD::Min(minHeights, heights);
+            maxHeights = SIMD::Max(maxHeights, heights);
+        }
+        for (; x < info.VertexCountEdge; x++)
+        {
+            minHeight = Math::Min(minHeight, row[x]);
+            maxHeight = Math::Max(maxHeight, row[x]);
+        }
+    }
+    SimdVector4 result[2];
+    SIMD::Store(&result[0], minHeights);
+    SIMD::Store(&result[1], maxHeights);
+    for (int32 i = 0; i < 4; i++)
+    {
+        minHeight = Math::Min(minHeight, ((const float*)&result[0])[i]);
+        maxHeight = Math::Max(maxHeight, ((const float*)&result[1])[i]);
+    }
+}
+
+void CalculateHeightmapRange(Terrain* terrain, TerrainDataUpdateInfo& info, const float* heightmap, const Int2& modifiedOffset, const Int2& modifiedSize, Vector2 chunkRanges[TerrainPatch::CHUNKS_COUNT], float chunkOffsets[TerrainPatch::CHUNKS_COUNT], float chunkHeights[TerrainPatch::CHUNKS_COUNT])
 {
     PROFILE_CPU_NAMED("Terrain.CalculateRange");
 
     // Note: terrain heightmap doesn't store raw height values but normalized into per-patch dimensions (height = normHeight * chunkPatch + patchOffset)
 
+    const Int2 modifiedEnd = modifiedOffset + modifiedSize;
     float minPatchHeight = MAX_float;
     float maxPatchHeight = MIN_float;
 
@@ -198,27 +244,17 @@ void CalculateHeightmapRange(Terrain* terrain, TerrainDataUpdateInfo& info, cons
         const int32 chunkX = (chunkIndex % TerrainPatch::CHUNKS_COUNT_EDGE) * info.ChunkSize;
         const int32 chunkZ = (chunkIndex / TerrainPatch::CHUNKS_COUNT_EDGE) * info.ChunkSize;
 
-        float minHeight = MAX_float;
-        float maxHeight = MIN_float;
-
-        for (int32 z = 0; z < info.VertexCountEdge; z++)
-        {
-            const int32 sz = (chunkZ + z) * info.HeightmapSize;
-            for (int32 x = 0; x < info.VertexCountEdge; x++)
-            {
-                const int32 sx = chunkX + x;
-                const float height = heightmap[sz + sx];
-
-                minHeight = Math::Min(minHeight, height);
-                maxHeight = Math::Max(maxHeight, height);
-            }
-        }
+        // Recalculate only modified chunks (others use the cached range)
+        auto& range = chunkRanges[chunkIndex];
+        Int2 start, end;
+        if (GetChunkModifiedRange(chunkX, chunkZ, info.VertexCountEdge, modifiedOffset, modifiedEnd, start, end))
+            CalculateChunkHeightRange(info, heightmap, chunkX, chunkZ, range.X, range.Y);
 
-        chunkOffsets[chunkIndex] = minHeight;
-        chunkHeights[chunkIndex] = Math::Max(maxHeight - minHeight, 1.0f);
+        chunkOffsets[chunkIndex] = range.X;
+        chunkHeights[chunkIndex] = Math::Max(range.Y - range.X, 1.0f);
 
-        minPatchHeight = Math::Min(minPatchHeight, minHeight);
-        maxPatchHeight = Math::Max(maxPatchHeight, maxHeight);
+        minPatchHeight = Math::Min(minPatchHeight, range.X);
+        maxPatchHeight = Math::Max(maxPatchHeight, range.Y);
     }
 
     // Align the patch heightmap range error to reduce artifacts on patch edges (each patch has own height range)
@@ -230,14 +266,19 @@ void CalculateHeightmapRange(Terrain* terrain, TerrainDataUpdateInfo& info, cons
     info.PatchHeight = Math::Max(maxPatchHeight - minPatchHeight, 1.0f);
 }
 
+void CalculateHeightmapRange(Terrain* terrain, TerrainDataUpdateInfo& info, const float* heightmap, float chunkOffsets[TerrainPatch::CHUNKS_COUNT], float chunkHeights[TerrainPatch::CHUNKS_COUNT])
+{
+    Vector2 chunkRanges[TerrainPatch::CHUNKS_COUNT];
+    CalculateHeightmapRange(terrain, info, heightmap, Int2::Zero, Int2(info.HeightmapSize), chunkRanges, chunkOffsets, chunkHeights);
+}
+
 void UpdateHeightMap(const TerrainDataUpdateInfo& info, const float* heightmap, const Int2& modifiedOffset, const Int2& modifiedSize, const byte* data)
 {
     PROFILE_CPU_NAMED("Terrain.UpdateHeightMap");
 
-    // TODO: use offset and size to improve performance of the data updating
-
     const auto heightmapPtr = heightmap;
     const auto ptr = (Color32*)data;
+    const Int2 modifiedEnd = modifiedOffset + modifiedSize;
 
     for (int32 chunkIndex = 0; chunkIndex < TerrainPatch::CHUNKS_COUNT; chunkIndex++)
     {
@@ -250,12 +291,17 @@ void UpdateHeightMap(const TerrainDataUpdateInfo& info, const float* heightmap,
         const int32 chunkHeightmapX = chunkX * info.ChunkSize;
         const int32 chunkHeightmapZ = chunkZ * info.ChunkSize;
 
-        for (int32 z = 0; z < info.VertexCountEdge; z++)
+        // Skip unmodified chunks and samples
+        Int2 start, end;
+        if (!GetChunkModifiedRange(chunkHeightmapX, chunkHeightmapZ, info.VertexCountEdge, modifiedOffset, modifiedEnd, start, end))
+            continue;
+
+        for (int32 z = start.Y; z < end.Y; z++)
         {
             const int32 tz = (chunkTextureZ + z) * info.TextureSize;
             const int32 sz = (chunkHeightmapZ + z) * info.HeightmapSize;
 
-            for (int32 x = 0; x < info.VertexCountEdge; x++)
+            for (int32 x = start.X; x < end.X; x++)
             {
                 const int32 tx = chunkTextureX + x;
                 const int32 sx = chunkHeightmapX + x;
@@ -277,10 +323,9 @@ void UpdateSplatMap(const TerrainDataUpdateInfo& info, const Color32* splatMap,
 {
     PROFILE_CPU_NAMED("Terrain.UpdateSplatMap");
 
-    // TODO: use offset and size to improve performance of the data updating
-
     const auto splatPtr = splatMap;
     const auto ptr = (Color32*)data;
+    const Int2 modifiedEnd = modifiedOffset + modifiedSize;
     for (int32 chunkIndex = 0; chunkIndex < TerrainPatch::CHUNKS_COUNT; chunkIndex++)
     {
         const int32 chunkX = (chunkIndex % TerrainPatch::CHUNKS_COUNT_EDGE);
@@ -292,12 +337,17 @@ void UpdateSplatMap(const TerrainDataUpdateInfo& info, const Color32* splatMap,
         const int32 chunkHeightmapX = chunkX * info.ChunkSize;
         const int32 chunkHeightmapZ = chunkZ * info.ChunkSize;
 
-        for (int32 z = 0; z < info.VertexCountEdge; z++)
+        // Skip unmodified chunks and samples
+        Int2 start, end;
+        if (!GetChunkModifiedRange(chunkHeightmapX, chunkHeightmapZ, info.VertexCountEdge, modifiedOffset, modifiedEnd, start, end))
+            continue;
+
+        for (int32 z = start.Y; z < end.Y; z++)
         {
             const int32 tz = (chunkTextureZ + z) * info.TextureSize;
             const int32 sz = (chunkHeightmapZ + z) * info.HeightmapSize;
 
-            for (int32 x = 0; x < info.VertexCountEdge; x++)
+            for (int32 x = start.X; x < end.X; x++)
             {
                 const int32 tx = chunkTextureX + x;
                 const int32 sx = chunkHeightmapX + x;
@@ -315,15 +365,29 @@ void UpdateSplatMap(const TerrainDataUpdateInfo& info, const Color32* splatMap,
     UpdateSplatMap(info, splatMap, Int2::Zero, Int2(info.HeightmapSize), data);
 }
 
+FORCE_INLINE void AddQuadNormals(Vector3* row0, Vector3* row1, int32 x, const Vector3& n0, const Vector3& n1)
+{
+    // Apply normal to each vertex using it
+    const Vector3 n2 = n0 + n1;
+    row0[x] += n1;
+    row1[x] += n2;
+    row0[x + 1] += n2;
+    row1[x + 1] += n0;
+}
+
 void UpdateNormalsAndHoles(const TerrainDataUpdateInfo& info, const float* heightmap, const byte* holesMask, const Int2& modifiedOffset, const Int2& modifiedSize, const byte* data)
 {
     PROFILE_CPU_NAMED("Terrain.CalculateNormals");
 
-    // Expand the area for the normals to prevent issues on the edges (for the averaged normals)
+    // Expand the area to write by 2 samples:
+    // - the normals kernel reads the neighbour heights (+/-1 sample) so the modified sample changes the normals of the vertices one sample away,
+    // - the vertices at the chunk edge are shared by the neighbour chunks (stored in both chunks data) so one more sample updates both copies.
+    // Then expand the area for the normals by 2 to include all quads used by the written vertices
     const int32 heightMapSize = info.HeightmapSize;
-    const Int2 modifiedEnd = modifiedOffset + modifiedSize;
-    const Int2 normalsStart = Int2::Max(Int2::Zero, modifiedOffset - 1);
-    const Int2 normalsEnd = Int2::Min(heightMapSize, modifiedEnd + 1);
+    const Int2 writeStart = Int2::Max(Int2::Zero, modifiedOffset - 2);
+    const Int2 writeEnd = Int2::Min(heightMapSize, modifiedOffset + modifiedSize + 2);
+    const Int2 normalsStart = Int2::Max(Int2::Zero, writeStart - 2);
+    const Int2 normalsEnd = Int2::Min(heightMapSize, writeEnd + 2);
     const Int2 normalsSize = normalsEnd - normalsStart;
 
     // Prepare memory
@@ -334,73 +398,58 @@ void UpdateNormalsAndHoles(const TerrainDataUpdateInfo& info, const float* heigh
     Platform::MemoryClear(normalsPerVertex, normalsLength * sizeof(Vector3));
 
     // Calculate per-quad normals and apply them to nearby vertices
+    // Quad triangles normals depend only on heights: n0 = normalize(h00 - h10, units, h00 - h01), n1 = normalize(h01 - h11, units, h10 - h11)
+    const SimdVector4 one = SIMD::Splat(1.0f);
+    const SimdVector4 units = SIMD::Splat((float)TERRAIN_UNITS_PER_VERTEX);
+    const SimdVector4 unitsSq = SIMD::Mul(units, units);
+    SimdVector4 quads[6];
     for (int32 z = normalsStart.Y; z < normalsEnd.Y - 1; z++)
     {
-        for (int32 x = normalsStart.X; x < normalsEnd.X - 1; x++)
-        {
-            // Get four vertices from the quad
-#define GET_VERTEX(a, b) \
-	int32 i##a##b = (z + (b) - normalsStart.Y) * normalsSize.X + (x + (a) - normalsStart.X); \
-	int32 h##a##b = (z + (b)) * heightMapSize + (x + (a)); \
-	Vector3 v##a##b; v##a##b.X = (x + (a)) * TERRAIN_UNITS_PER_VERTEX; \
-	v##a##b.Y = heightmap[h##a##b]; \
-	v##a##b.Z = (z + (b)) * TERRAIN_UNITS_PER_VERTEX
-            GET_VERTEX(0, 0);
-            GET_VERTEX(1, 0);
-            GET_VERTEX(0, 1);
-            GET_VERTEX(1, 1);
-#undef GET_VERTEX
-
-            // TODO: use SIMD for those calculations
-
-            // Calculate normals for quad two vertices
-            Vector3 n0 = Vector3::Normalize((v00 - v01) ^ (v01 - v10));
-            Vector3 n1 = Vector3::Normalize((v11 - v10) ^ (v10 - v01));
-            Vector3 n2 = n0 + n1;
+        const float* h0 = heightmap + z * heightMapSize;
+        const float* h1 = h0 + heightMapSize;
+        Vector3* row0 = normalsPerVertex + (z - normalsStart.Y) * normalsSize.X;
+        Vector3* row1 = row0 + normalsSize.X;
+        int32 x = normalsStart.X;
 
-            // Apply normal to each vertex using it
-            normalsPerVertex[i00] += n1;
-            normalsPerVertex[i01] += n2;
-            normalsPerVertex[i10] += n2;
-            normalsPerVertex[i11] += n0;
+        // Process 4 quads at once
+        for (; x + 4 < normalsEnd.X; x += 4)
+        {
+            const SimdVector4 h00 = SIMD::LoadUnaligned(h0 + x);
+            const SimdVector4 h10 = SIMD::LoadUnaligned(h0 + x + 1);
+            const SimdVector4 h01 = SIMD::LoadUnaligned(h1 + x);
+            const SimdVector4 h11 = SIMD::LoadUnaligned(h1 + x + 1);
+            const SimdVector4 n0x = SIMD::Sub(h00, h10);
+            const SimdVector4 n0z = SIMD::Sub(h00, h01);
+            const SimdVector4 n1x = SIMD::Sub(h01, h11);
+            const SimdVector4 n1z = SIMD::Sub(h10, h11);
+            const SimdVector4 n0Scale = SIMD::Div(one, SIMD::Sqrt(SIMD::Add(SIMD::Add(SIMD::Mul(n0x, n0x), SIMD::Mul(n0z, n0z)), unitsSq)));
+            const SimdVector4 n1Scale = SIMD::Div(one, SIMD::Sqrt(SIMD::Add(SIMD::Add(SIMD::Mul(n1x, n1x), SIMD::Mul(n1z, n1z)), unitsSq)));
+            SIMD::Store(&quads[0], SIMD::Mul(n0x, n0Scale));
+            SIMD::Store(&quads[1], SIMD::Mul(units, n0Scale));
+            SIMD::Store(&quads[2], SIMD::Mul(n0z, n0Scale));
+            SIMD::Store(&quads[3], SIMD::Mul(n1x, n1Scale));
+            SIMD::Store(&quads[4], SIMD::Mul(units, n1Scale));
+            SIMD::Store(&quads[5], SIMD::Mul(n1z, n1Scale));
+            const float* q = (const float*)quads;
+            for (int32 i = 0; i < 4; i++)
+            {
+                const Vector3 n0(q[i], q[4 + i], q[8 + i]);
+                const Vector3 n1(q[12 + i], q[16 + i], q[20 + i]);
+                AddQuadNormals(row0, row1, x + i - normalsStart.X, n0, n1);
+            }
         }
-    }
 
-    // Smooth normals
-    for (int32 z = 1; z < normalsSize.Y - 1; z++)
-    {
-        for (int32 x = 1; x < normalsSize.X - 1; x++)
+        // Process remaining quads
+        for (; x < normalsEnd.X - 1; x++)
         {
-            // Get four normals for the nearby quads
-#define GET_NORMAL(a, b) \
-	int32 i##a##b = (z + (b - 1)) * normalsSize.X + (x + (a - 1)); \
-	Vector3 n##a##b = Vector3::NormalizeFast(normalsPerVertex[i##a##b])
-            GET_NORMAL(0, 0);
-            GET_NORMAL(1, 0);
-            GET_NORMAL(0, 1);
-            GET_NORMAL(1, 1);
-            GET_NORMAL(2, 0);
-            GET_NORMAL(2, 1);
-            GET_NORMAL(0, 2);
-            GET_NORMAL(1, 2);
-            GET_NORMAL(2, 2);
-#undef GET_VERTEX
-
-            // TODO: use SIMD for those calculations
-
-            /*
-             * The current vertex is (11). Calculate average for the nearby vertices.
-             * 00   01   02
-             * 10  (11)  12
-             * 20   21   22
-             */
-
-            const Vector3 avg = (n00 + n01 + n02 + n10 + n11 + n12 + n20 + n21 + n22) * (1.0f / 9.0f);
-
-            // Smooth normals by performing interpolation to average for nearby quads
-            normalsPerVertex[i11] = Vector3::Lerp(n11, avg, 0.6f);
+            const float h00 = h0[x], h10 = h0[x + 1], h01 = h1[x], h11 = h1[x + 1];
+            const Vector3 n0 = Vector3::Normalize(Vector3(h00 - h10, TERRAIN_UNITS_PER_VERTEX, h00 - h01));
+            const Vector3 n1 = Vector3::Normalize(Vector3(h01 - h11, TERRAIN_UNITS_PER_VERTEX, h10 - h11));
+            AddQuadNormals(row0, row1, x - normalsStart.X, n0, n1);
         }
     }
+    for (int32 i = 0; i < normalsLength; i++)
+        normalsPerVertex[i] = Vector3::NormalizeFast(normalsPerVertex[i]);
 
     // Write back to the data container
     const auto ptr = (Color32*)data;
@@ -415,40 +464,42 @@ void UpdateNormalsAndHoles(const TerrainDataUpdateInfo& info, const float* heigh
         const int32 chunkHeightmapX = chunkX * info.ChunkSize;
         const int32 chunkHeightmapZ = chunkZ * info.ChunkSize;
 
-        // Skip unmodified chunks
-        if (chunkHeightmapX >= modifiedEnd.X || chunkHeightmapX + info.ChunkSize < modifiedOffset.X ||
-            chunkHeightmapZ >= modifiedEnd.Y || chunkHeightmapZ + info.ChunkSize < modifiedOffset.Y)
+        // Skip unmodified chunks and samples
+        Int2 start, end;
+        if (!GetChunkModifiedRange(chunkHeightmapX, chunkHeightmapZ, info.VertexCountEdge, writeStart, writeEnd, start, end))
             continue;
 
-        // TODO: adjust loop range to reduce iterations count for edge cases (skip checking unmodified samples)
-        for (int32 z = 0; z < info.VertexCountEdge; z++)
+        for (int32 z = start.Y; z < end.Y; z++)
         {
-            // Skip unmodified columns
-            const int32 dz = chunkHeightmapZ + z - modifiedOffset.Y;
-            if (dz < 0 || dz >= modifiedSize.Y)
-                continue;
-            const int32 hz = (chunkHeightmapZ + z) * heightMapSize;
-            const int32 sz = (chunkHeightmapZ + z - normalsStart.Y) * normalsSize.X;
+            const int32 hz = chunkHeightmapZ + z;
             const int32 tz = (chunkTextureZ + z) * info.TextureSize;
+            const Vector3* normalsRow = normalsPerVertex + (hz - normalsStart.Y) * normalsSize.X;
+            const bool smoothZ = hz > 0 && hz < heightMapSize - 1;
 
-            // TODO: adjust loop range to reduce iterations count for edge cases (skip checking unmodified samples)
-            for (int32 x = 0; x < info.VertexCountEdge; x++)
+            for (int32 x = start.X; x < end.X; x++)
             {
-                // Skip unmodified rows
-                const int32 dx = chunkHeightmapX + x - modifiedOffset.X;
-                if (dx < 0 || dx >= modifiedSize.X)
-                    continue;
                 const int32 hx = chunkHeightmapX + x;
-                const int32 sx = chunkHeightmapX + x - normalsStart.X;
-                const int32 tx = chunkTextureX + x;
-
-                const int32 textureIndex = tz + tx;
-                const int32 heightmapIndex = hz + hx;
-                const int32 normalIndex = sz + sx;
-#if BUILD_DEBUG
-                ASSERT(normalIndex >= 0 && normalIndex < normalsLength);
-#endif
-                Vector3 normal = Vector3::NormalizeFast(normalsPerVertex[normalIndex]) * 0.5f + 0.5f;
+                const int32 sx = hx - normalsStart.X;
+                const int32 textureIndex = tz + chunkTextureX + x;
+                const int32 heightmapIndex = hz * heightMapSize + hx;
+                Vector3 normal = normalsRow[sx];
+                if (smoothZ && hx > 0 && hx < heightMapSize - 1)
+                {
+                    /*
+                     * The current vertex is (11). Calculate average for the nearby vertices.
+                     * 00   01   02
+                     * 10  (11)  12
+                     * 20   21   22
+                     */
+                    const Vector3* n0 = normalsRow - normalsSize.X + sx;
+                    const Vector3* n1 = normalsRow + sx;
+                    const Vector3* n2 = normalsRow + normalsSize.X + sx;
+                    const Vector3 avg = (n0[-1] + n0[0] + n0[1] + n1[-1] + n1[0] + n1[1] + n2[-1] + n2[0] + n2[1]) * (1.0f / 9.0f);
+
+                    // Smooth normals by performing interpolation to average for nearby quads
+                    normal = Vector3::Lerp(normal, avg, 0.6f);
+                }
+                normal = Vector3::NormalizeFast(normal) * 0.5f + 0.5f;
 
                 if (holesMask && !holesMask[heightmapIndex])
                     normal = Vector3::One;
@@ -633,9 +684,7 @@ bool ModifyCollision(const TerrainDataUpdateInfo& info, TextureBase::InitData* i
     Int2 samplesSize = Vector2::CeilToInt(modifiedSizeRatio * (float)heightFieldSize);
     samplesSize.X = Math::Max(samplesSize.X, 1);
     samplesSize.Y = Math::Max(samplesSize.Y, 1);
-    Int2 samplesEnd = samplesOffset + samplesSize;
-    samplesEnd.X = Math::Min(samplesEnd.X, heightFieldSize);
-    samplesEnd.Y = Math::Min(samplesEnd.Y, heightFieldSize);
+    const Int2 samplesEnd = samplesOffset + samplesSize;
 
     // Allocate data
     const int32 heightFieldDataLength = samplesSize.X * samplesSize.Y;
@@ -653,36 +702,25 @@ bool ModifyCollision(const TerrainDataUpdateInfo& info, TextureBase::InitData* i
         const int32 chunkTextureX = chunkX * vertexCountEdgeMip;
         const int32 chunkStartX = chunkX * heightFieldChunkSize;
 
-        // Skip unmodified chunks
-        if (chunkStartX >= samplesEnd.X || chunkStartX + vertexCountEdgeMip < samplesOffset.X)
-            continue;
-
         for (int32 chunkZ = 0; chunkZ < TerrainPatch::CHUNKS_COUNT_EDGE; chunkZ++)
         {
             const int32 chunkTextureZ = chunkZ * vertexCountEdgeMip;
             const int32 chunkStartZ = chunkZ * heightFieldChunkSize;
 
-            // Skip unmodified chunks
-            if (chunkStartZ >= samplesEnd.Y || chunkStartZ + vertexCountEdgeMip < samplesOffset.Y)
+            // Skip unmodified chunks and samples
+            Int2 start, end;
+            if (!GetChunkModifiedRange(chunkStartX, chunkStartZ, vertexCountEdgeMip, samplesOffset, samplesEnd, start, end))
                 continue;
 
-            // TODO: adjust loop range to reduce iterations count for edge cases (skip checking unmodified samples)
-            for (int32 z = 0; z < vertexCountEdgeMip; z++)
+            for (int32 z = start.Y; z < end.Y; z++)
             {
-                // Skip unmodified columns
                 const int32 heightmapZ = chunkStartZ + z;
                 const int32 heightmapLocalZ = heightmapZ - samplesOffset.Y;
-                if (heightmapLocalZ < 0 || heightmapLocalZ >= samplesSize.Y)
-                    continue;
 
-                // TODO: adjust loop range to reduce iterations count for edge cases (skip checking unmodified samples)
-                for (int32 x = 0; x < vertexCountEdgeMip; x++)
+                for (int32 x = start.X; x < end.X; x++)
                 {
-                    // Skip unmodified rows
                     const int32 heightmapX = chunkStartX + x;
                     const int32 heightmapLocalX = heightmapX - samplesOffset.X;
-                    if (heightmapLocalX < 0 || heightmapLocalX >= samplesSize.X)
-                        continue;
 
                     const int32 textureIndex = (chunkTextureZ + z) * textureSizeMip + chunkTextureX + x;
 
@@ -935,6 +973,7 @@ bool TerrainPatch::SetupHeightMap(int32 heightMapLength, const float* heightMap,
 #if TERRAIN_UPDATING
     // Invalidate cache
     _cachedHeightMap.Resize(0);
+    _cachedChunkHeightRanges.Resize(0);
     _cachedHolesMask.Resize(0);
     _wasHeightModified = false;
 #endif
@@ -1191,6 +1230,7 @@ void TerrainPatch::CacheHeightData()
     // Allocate data
     const int32 heightMapLength = heightMapSize * heightMapSize;
     _cachedHeightMap.Resize(heightMapLength);
+    _cachedChunkHeightRanges.Resize(0);
     _cachedHolesMask.Resize(heightMapLength);
     _wasHeightModified = false;
 
@@ -1351,12 +1391,7 @@ bool TerrainPatch::ModifyHeightMap(const float* samples, const Int2& modifiedOff
 
         for (int32 z = 0; z < modifiedSize.Y; z++)
         {
-            // TODO: use batches row mem copy
-
-            for (int32 x = 0; x < modifiedSize.X; x++)
-            {
-                heightMap[(z + modifiedOffset.Y) * heightMapSize + (x + modifiedOffset.X)] = samples[z * modifiedSize.X + x];
-            }
+            Platform::MemoryCopy(heightMap + (z + modifiedOffset.Y) * heightMapSize + modifiedOffset.X, samples + z * modifiedSize.X, modifiedSize.X * sizeof(*samples));
         }
     }
 
@@ -1370,11 +1405,27 @@ bool TerrainPatch::ModifyHeightMap(const float* samples, const Int2& modifiedOff
     info.PatchOffset = 0.0f;
     info.PatchHeight = 1.0f;
 
-    // Process heightmap to get per-patch height normalization values
+    // Process heightmap to get per-patch height normalization values (recalculate only modified chunks if ranges are cached)
     float chunkOffsets[CHUNKS_COUNT];
     float chunkHeights[CHUNKS_COUNT];
-    CalculateHeightmapRange(_terrain, info, heightMap, chunkOffsets, chunkHeights);
-    // TODO: maybe calculate chunk ranges for only modified chunks
+    if (_cachedChunkHeightRanges.Count() == CHUNKS_COUNT)
+    {
+        CalculateHeightmapRange(_terrain, info, heightMap, modifiedOffset, modifiedSize, _cachedChunkHeightRanges.Get(), chunkOffsets, chunkHeights);
+    }
+    else
+    {
+        _cachedChunkHeightRanges.Resize(CHUNKS_COUNT);
+        CalculateHeightmapRange(_terrain, info, heightMap, Int2::Zero, Int2(heightMapSize), _cachedChunkHeightRanges.Get(), chunkOffsets, chunkHeights);
+    }
+
+    // Keep the current patch height range if the modified heights still fit into it (only the modified area needs to be updated then)
+    if (info.PatchOffset >= _yOffset &&
+        info.PatchOffset + info.PatchHeight <= _yOffset + _yHeight &&
+        info.PatchHeight >= _yHeight * TERRAIN_PATCH_HEIGHT_RANGE_SHRINK_THRESHOLD)
+    {
+        info.PatchOffset = _yOffset;
+        info.PatchHeight = _yHeight;
+    }
     const bool wasHeightRangeChanged = Math::NotNearEqual(_yOffset, info.PatchOffset) || Math::NotNearEqual(_yHeight, info.PatchHeight);
 
     // Check if has allocated texture
@@ -1459,12 +1510,7 @@ bool TerrainPatch::ModifyHolesMask(const byte* samples, const Int2& modifiedOffs
 
         for (int32 z = 0; z < modifiedSize.Y; z++)
         {
-            // TODO: use batches row mem copy
-
-            for (int32 x = 0; x < modifiedSize.X; x++)
-            {
-                holesMask[(z + modifiedOffset.Y) * heightMapSize + (x + modifiedOffset.X)] = samples[z * modifiedSize.X + x];
-            }
+            Platform::MemoryCopy(holesMask + (z + modifiedOffset.Y) * heightMapSize + modifiedOffset.X, samples + z * modifiedSize.X, modifiedSize.X * sizeof(*samples));
         }
     }
 
@@ -1539,12 +1585,7 @@ bool TerrainPatch::ModifySplatMap(int32 index, const Color32* samples, const Int
 
         for (int32 z = 0; z < modifiedSize.Y; z++)
         {
-            // TODO: use batches row mem copy
-
-            for (int32 x = 0; x < modifiedSize.X; x++)
-            {
-                splatMap[(z + modifiedOffset.Y) * heightMapSize + (x + modifiedOffset.X)] = samples[z * modifiedSize.X + x];
-            }
+            Platform::MemoryCopy(splatMap + (z + modifiedOffset.Y) * heightMapSize + modifiedOffset.X, samples + z * modifiedSize.X, modifiedSize.X * sizeof(*samples));
         }
     }
 
@@ -44,6 +44,7 @@ class FLAXENGINE_API TerrainPatch : public ISerializable
     float _collisionScaleXZ;
 #if TERRAIN_UPDATING
     Array<float> _cachedHeightMap;
+    Array<Vector2> _cachedChunkHeightRanges;
     Array<byte> _cachedHolesMask;
     Array<Color32> _cachedSplatMap[TERRAIN_MAX_SPLATMAPS_COUNT];
     bool _wasHeightModified;
@@ -0,0 +1,117 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#include "Engine/Content/Loading/ContentLoadingQueue.h"
+#include <ThirdParty/catch2/catch.hpp>
+
+// Loading task that is only queued (never executed).
+class TestLoadTask : public ContentLoadTask
+{
+public:
+
+    TestLoadTask()
+        : ContentLoadTask(Type::Custom)
+    {
+    }
+
+    void Add(ContentLoadingQueue& queue, Priority priority)
+    {
+        queue.SetPriority(this, priority);
+        queue.Add(this);
+    }
+
+protected:
+
+    // [ContentLoadTask]
+    Result run() override
+    {
+        return Result::Ok;
+    }
+};
+
+TEST_CASE("ContentLoadingQueue")
+{
+    using Priority = ContentLoadTask::Priority;
+    ContentLoadingQueue queue;
+    TestLoadTask a, b, c, d, e;
+
+    SECTION("Test Lanes Order")
+    {
+        // Higher priority classes go first, the same class keeps the FIFO order
+        a.Add(queue, Priority::Normal);
+        b.Add(queue, Priority::Prefetch);
+        c.Add(queue, Priority::Urgent);
+        d.Add(queue, Priority::Blocking);
+        e.Add(queue, Priority::Normal);
+        CHECK(queue.Count() == 5);
+        CHECK(queue.Count(Priority::Normal) == 2);
+        CHECK(queue.Pop() == &d);
+        CHECK(queue.Pop() == &c);
+        CHECK(queue.Pop() == &a);
+        CHECK(queue.Pop() == &e);
+        CHECK(queue.Pop() == &b);
+        CHECK(queue.Pop() == nullptr);
+        CHECK(queue.Count() == 0);
+    }
+
+    SECTION("Test Priority Change")
+    {
+        a.Add(queue, Priority::Normal);
+        b.Add(queue, Priority::Prefetch);
+        c.Add(queue, Priority::Normal);
+        queue.SetPriority(&b, Priority::Urgent);
+        CHECK(queue.Count(Priority::Prefetch) == 0);
+        CHECK(queue.Count(Priority::Urgent) == 1);
+        CHECK(queue.Pop() == &b);
+        CHECK(queue.Pop() == &a);
+        CHECK(queue.Pop() == &c);
+    }
+
+    SECTION("Test Deadline Promotion")
+    {
+        // Task that missed its deadline is moved to the urgent lane, the others keep their order
+        a.Add(queue, Priority::Normal);
+        b.Add(queue, Priority::Prefetch);
+        c.Add(queue, Priority::Normal);
+        d.Add(queue, Priority::Normal);
+        const double time = Platform::GetTimeSeconds();
+        queue.SetDeadline(&b, time);
+        queue.SetDeadline(&c, time + 1000.0);
+        CHECK(queue.Pop() == &b);
+        CHECK(b.GetPriority() == Priority::Urgent);
+        CHECK(queue.Pop() == &a);
+        CHECK(queue.Pop() == &c);
+        CHECK(c.GetPriority() == Priority::Normal);
+        CHECK(queue.Pop() == &d);
+        CHECK(queue.Pop() == nullptr);
+    }
+
+    SECTION("Test Deadline Before Add")
+    {
+        a.Add(queue, Priority::Normal);
+        queue.SetDeadline(&b, Platform::GetTimeSeconds());
+        b.Add(queue, Priority::Prefetch);
+        CHECK(queue.Pop() == &b);
+        CHECK(queue.Pop() == &a);
+    }
+
+    SECTION("Test Remove")
+    {
+        a.Add(queue, Priority::Normal);
+        b.Add(queue, Priority::Normal);
+        c.Add(queue, Priority::Urgent);
+        queue.SetDeadline(&c, Platform::GetTimeSeconds() + 1000.0);
+        CHECK(queue.Remove(&b));
+        CHECK(!queue.Remove(&b));
+        CHECK(!queue.Remove(&d));
+        CHECK(queue.Count() == 2);
+        CHECK(queue.Remove(&c));
+        CHECK(queue.Count(Priority::Urgent) == 0);
+
+        // Removed tasks are skipped and can be queued again
+        CHECK(queue.Pop() == &a);
+        CHECK(queue.Pop() == nullptr);
+        b.Add(queue, Priority::Normal);
+        CHECK(queue.Count() == 1);
+        CHECK(queue.Pop() == &b);
+    }
+}
@@ -0,0 +1,173 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#include "Engine/ContentImporters/Types.h"
+
+#if COMPILE_WITH_ASSETS_IMPORTER
+
+#include "Engine/ContentImporters/DerivedDataCache.h"
+#include "Engine/Content/Storage/FlaxChunk.h"
+#include "Engine/Engine/Globals.h"
+#include "Engine/Platform/File.h"
+#include "Engine/Platform/FileSystem.h"
+#include <ThirdParty/catch2/catch.hpp>
+
+static void InitTestData(AssetInitData& data, int32 seed)
+{
+    data.Header.TypeName = TEXT("FlaxEngine.Texture");
+    data.SerializedVersion = 4 + seed;
+    byte customData[32];
+    for (int32 i = 0; i < ARRAY_COUNT(customData); i++)
+        customData[i] = (byte)(i + seed);
+    data.CustomData.Copy(customData, ARRAY_COUNT(customData));
+    for (int32 chunkIndex : { 0, 3 })
+    {
+        auto chunk = New<FlaxChunk>();
+        chunk->Flags = chunkIndex == 3 ? FlaxChunkFlags::CompressedLZ4 : FlaxChunkFlags::None;
+        Array<byte> chunkData;
+        chunkData.Resize(1000 + chunkIndex * 100);
+        for (int32 i = 0; i < chunkData.Count(); i++)
+            chunkData[i] = (byte)(i * 7 + seed + chunkIndex);
+        chunk->Data.Copy(chunkData);
+        data.Header.Chunks[chunkIndex] = chunk;
+    }
+}
+
+static void ReleaseTestData(AssetInitData& data)
+{
+    data.Header.DeleteChunks();
+}
+
+static bool IsSameData(const AssetInitData& a, const AssetInitData& b)
+{
+    if (a.Header.TypeName != b.Header.TypeName || a.SerializedVersion != b.SerializedVersion || a.CustomData.Length() != b.CustomData.Length())
+        return false;
+    if (Platform::MemoryCompare(a.CustomData.Get(), b.CustomData.Get(), a.CustomData.Length()) != 0)
+        return false;
+    for (int32 i = 0; i < ASSET_FILE_DATA_CHUNKS; i++)
+    {
+        const FlaxChunk* chunkA = a.Header.Chunks[i];
+        const FlaxChunk* chunkB = b.Header.Chunks[i];
+        if (!chunkA || !chunkB)
+        {
+            if (chunkA != chunkB)
+                return false;
+            continue;
+        }
+        if (chunkA->Flags != chunkB->Flags || chunkA->Data.Length() != chunkB->Data.Length())
+            return false;
+        if (Platform::MemoryCompare(chunkA->Data.Get(), chunkB->Data.Get(), chunkA->Data.Length()) != 0)
+            return false;
+    }
+    return true;
+}
+
+TEST_CASE("DerivedDataCache")
+{
+    // Use a temporary cache location
+    String tempFolder;
+    FileSystem::GetSpecialFolderPath(SpecialFolder::Temporary, tempFolder);
+    tempFolder /= TEXT("FlaxTestDerivedDataCache");
+    const String prevCacheFolder = Globals::ProjectCacheFolder;
+    const uint64 prevMaxSize = DerivedDataCache::MaxSize;
+    Globals::ProjectCacheFolder = tempFolder;
+    DerivedDataCache::Clear();
+    FileSystem::CreateDirectory(tempFolder);
+    const String sourcePath = tempFolder / TEXT("Source.bin");
+    const String indexPath = DerivedDataCache::GetFolder() / TEXT("Index.bin");
+
+    SECTION("Test Compute Key")
+    {
+        const byte sourceData[] = { 1, 2, 3, 4, 5 };
+        REQUIRE(!File::WriteAllBytes(sourcePath, sourceData, ARRAY_COUNT(sourceData)));
+        Guid key1, key2;
+        REQUIRE(!DerivedDataCache::ComputeKey(sourcePath, TEXT("Texture"), 1, "options", key1));
+        REQUIRE(!DerivedDataCache::ComputeKey(sourcePath, TEXT("Texture"), 1, "options", key2));
+        CHECK(key1 == key2);
+        REQUIRE(!DerivedDataCache::ComputeKey(sourcePath, TEXT("Texture"), 1, "options2", key2));
+        CHECK(key1 != key2);
+        REQUIRE(!DerivedDataCache::ComputeKey(sourcePath, TEXT("Texture"), 2, "options", key2));
+        CHECK(key1 != key2);
+        REQUIRE(!DerivedDataCache::ComputeKey(sourcePath, TEXT("Model"), 1, "options", key2));
+        CHECK(key1 != key2);
+        const byte sourceData2[] = { 1, 2, 3, 4, 6 };
+        REQUIRE(!File::WriteAllBytes(sourcePath, sourceData2, ARRAY_COUNT(sourceData2)));
+        REQUIRE(!DerivedDataCache::ComputeKey(sourcePath, TEXT("Texture"), 1, "options", key2));
+        CHECK(key1 != key2);
+        CHECK(DerivedDataCache::ComputeKey(tempFolder / TEXT("Missing.bin"), TEXT("Texture"), 1, "options", key2));
+    }
+
+    SECTION("Test Store And Load")
+    {
+        const Guid key(1, 2, 3, 4);
+        AssetInitData data, loaded;
+        const auto stats = DerivedDataCache::GetStats();
+        CHECK(DerivedDataCache::Load(key, loaded));
+        CHECK(DerivedDataCache::GetStats().Misses == stats.Misses + 1);
+
+        InitTestData(data, 0);
+        DerivedDataCache::Store(key, data);
+        CHECK(DerivedDataCache::GetStats().Entries == 1);
+        REQUIRE(!DerivedDataCache::Load(key, loaded));
+        CHECK(IsSameData(data, loaded));
+        CHECK(DerivedDataCache::GetStats().Hits == stats.Hits + 1);
+        ReleaseTestData(data);
+        ReleaseTestData(loaded);
+    }
+
+    SECTION("Test Index Saved On Store")
+    {
+        // Index has to be up to date without the explicit flush (eg. editor crash)
+        const Guid key(5, 6, 7, 8);
+        AssetInitData data;
+        InitTestData(data, 1);
+        DerivedDataCache::Store(key, data);
+        ReleaseTestData(data);
+        Array<byte> index;
+        REQUIRE(!File::ReadAllBytes(indexPath, index));
+        CHECK(index.Count() == 3 * sizeof(int32) + DerivedDataCache::GetStats().Entries * (sizeof(Guid) + sizeof(uint64) + sizeof(int64)));
+        CHECK(!FileSystem::FileExists(indexPath + TEXT(".tmp")));
+    }
+
+    SECTION("Test Corrupted Entry")
+    {
+        const Guid key(9, 10, 11, 12);
+        AssetInitData data, loaded;
+        InitTestData(data, 2);
+        DerivedDataCache::Store(key, data);
+        ReleaseTestData(data);
+        const String entryPath = DerivedDataCache::GetFolder() / key.ToString(Guid::FormatType::N) + TEXT(".ddc");
+        Array<byte> entryData;
+        REQUIRE(!File::ReadAllBytes(entryPath, entryData));
+        entryData.Resize(entryData.Count() / 2);
+        REQUIRE(!File::WriteAllBytes(entryPath, entryData));
+        CHECK(DerivedDataCache::Load(key, loaded));
+        CHECK(DerivedDataCache::GetStats().Entries == 0);
+        CHECK(!FileSystem::FileExists(entryPath));
+        ReleaseTestData(loaded);
+    }
+
+    SECTION("Test Eviction")
+    {
+        // Each entry takes a few kilobytes so only the recently used ones fit
+        DerivedDataCache::MaxSize = 6 * 1024;
+        AssetInitData data, loaded;
+        InitTestData(data, 3);
+        const int32 evictions = DerivedDataCache::GetStats().Evictions;
+        for (uint32 i = 0; i < 4; i++)
+            DerivedDataCache::Store(Guid(100, 0, 0, i), data);
+        ReleaseTestData(data);
+        const auto stats = DerivedDataCache::GetStats();
+        CHECK(stats.Evictions > evictions);
+        CHECK(stats.Size <= DerivedDataCache::MaxSize);
+        CHECK(DerivedDataCache::Load(Guid(100, 0, 0, 0), loaded));
+        CHECK(!DerivedDataCache::Load(Guid(100, 0, 0, 3), loaded));
+        ReleaseTestData(loaded);
+    }
+
+    DerivedDataCache::Clear();
+    FileSystem::DeleteDirectory(tempFolder);
+    DerivedDataCache::MaxSize = prevMaxSize;
+    Globals::ProjectCacheFolder = prevCacheFolder;
+}
+
+#endif
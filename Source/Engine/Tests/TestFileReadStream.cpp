@@ -0,0 +1,222 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#include "Engine/Serialization/FileReadStream.h"
+#include "Engine/Platform/File.h"
+#include "Engine/Platform/FileSystem.h"
+#include "Engine/Core/Types/String.h"
+#include "Engine/Core/Types/StringView.h"
+#include "Engine/Core/Types/DateTime.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Math/Math.h"
+#include <ThirdParty/catch2/catch.hpp>
+
+static byte GetTestByte(uint64 position)
+{
+    return (byte)(position ^ (position >> 8) ^ (position >> 16) ^ (position >> 32));
+}
+
+static bool IsTestData(const byte* data, uint32 size, uint64 position)
+{
+    for (uint32 i = 0; i < size; i++)
+    {
+        if (data[i] != GetTestByte(position + i))
+            return false;
+    }
+    return true;
+}
+
+// File larger than 4GB with generated contents that uses the default positional read implementation (via the file pointer).
+class TestLargeFile : public FileBase
+{
+public:
+
+    uint64 Size;
+    uint64 Position = 0;
+
+    TestLargeFile(uint64 size)
+        : Size(size)
+    {
+    }
+
+public:
+
+    // [FileBase]
+    bool Read(void* buffer, uint32 bytesToRead, uint32* bytesRead) override
+    {
+        const uint32 count = (uint32)Math::Min<uint64>(bytesToRead, Position < Size ? Size - Position : 0);
+        for (uint32 i = 0; i < count; i++)
+            ((byte*)buffer)[i] = GetTestByte(Position + i);
+        Position += count;
+        if (bytesRead)
+            *bytesRead = count;
+        return false;
+    }
+
+    bool Write(const void* buffer, uint32 bytesToWrite, uint32* bytesWritten) override
+    {
+        return true;
+    }
+
+    void Close() override
+    {
+    }
+
+    uint32 GetSize() const override
+    {
+        return (uint32)Math::Min<uint64>(Size, MAX_uint32);
+    }
+
+    uint64 GetSize64() const override
+    {
+        return Size;
+    }
+
+    DateTime GetLastWriteTime() const override
+    {
+        return DateTime::MinValue();
+    }
+
+    uint32 GetPosition() const override
+    {
+        return (uint32)Position;
+    }
+
+    void SetPosition(uint32 seek) override
+    {
+        Position = seek;
+    }
+
+    bool IsOpened() const override
+    {
+        return true;
+    }
+};
+
+TEST_CASE("FileReadStream")
+{
+    // Size that isn't aligned to any of the buffers
+    const uint32 fileSize = 300 * 1024 + 123;
+    Array<byte> fileData;
+    fileData.Resize(fileSize);
+    for (uint32 i = 0; i < fileSize; i++)
+        fileData[i] = GetTestByte(i);
+    String path;
+    FileSystem::GetSpecialFolderPath(SpecialFolder::Temporary, path);
+    path /= TEXT("FlaxTestFileReadStream.bin");
+    REQUIRE(!File::WriteAllBytes(path, fileData));
+
+    SECTION("Test Sequential Read")
+    {
+        // Small reads go over the 4KB buffer refills and then over the readahead buffer boundaries
+        FileReadStream* stream = FileReadStream::Open(path);
+        REQUIRE(stream);
+        CHECK(stream->GetLength64() == fileSize);
+        byte data[1000];
+        uint64 position = 0;
+        while (position < fileSize)
+        {
+            const uint32 size = (uint32)Math::Min<uint64>(sizeof(data), fileSize - position);
+            stream->ReadBytes(data, size);
+            CHECK(IsTestData(data, size, position));
+            position += size;
+            CHECK(stream->GetPosition64() == position);
+        }
+        CHECK(!stream->HasError());
+        Delete(stream);
+    }
+
+    SECTION("Test Seek")
+    {
+        FileReadStream* stream = FileReadStream::Open(path);
+        REQUIRE(stream);
+        byte data[64];
+        const uint32 positions[] = { 0, 10, 5, 4090, 4096, 70000, 69990, 65535, 65536, 131072 - 3, 200000, 100, fileSize - 64 };
+        for (const uint32 position : positions)
+        {
+            stream->SetPosition64(position);
+            CHECK(stream->GetPosition64() == position);
+            stream->ReadBytes(data, sizeof(data));
+            CHECK(IsTestData(data, sizeof(data), position));
+        }
+
+        // Seek within the readahead buffer
+        stream->SetPosition64(0);
+        for (int32 i = 0; i < 8; i++)
+            stream->ReadBytes(data, sizeof(data));
+        stream->SetPosition64(20000);
+        for (int32 i = 0; i < 200; i++)
+            stream->ReadBytes(data, sizeof(data));
+        stream->SetPosition64(20000 + 100 * sizeof(data) + 7);
+        stream->ReadBytes(data, sizeof(data));
+        CHECK(IsTestData(data, sizeof(data), 20000 + 100 * sizeof(data) + 7));
+        CHECK(!stream->HasError());
+        Delete(stream);
+    }
+
+    SECTION("Test Large Read")
+    {
+        // Reads larger than the readahead buffer skip the buffer
+        FileReadStream* stream = FileReadStream::Open(path);
+        REQUIRE(stream);
+        Array<byte> data;
+        data.Resize(150 * 1024);
+        byte small[10];
+        stream->ReadBytes(small, sizeof(small));
+        stream->ReadBytes(data.Get(), data.Count());
+        CHECK(IsTestData(data.Get(), data.Count(), sizeof(small)));
+        stream->ReadBytes(small, sizeof(small));
+        CHECK(IsTestData(small, sizeof(small), sizeof(small) + data.Count()));
+        CHECK(!stream->HasError());
+        Delete(stream);
+    }
+
+    SECTION("Test Read Past End")
+    {
+        FileReadStream* stream = FileReadStream::Open(path);
+        REQUIRE(stream);
+        byte data[100];
+        stream->SetPosition64(fileSize - 50);
+        stream->ReadBytes(data, sizeof(data));
+        CHECK(stream->HasError());
+        Delete(stream);
+    }
+
+    SECTION("Test ReadAt")
+    {
+        auto file = File::Open(path, FileMode::OpenExisting, FileAccess::Read, FileShare::Read);
+        REQUIRE(file);
+        CHECK(file->GetSize64() == fileSize);
+        byte data[5000];
+        uint32 bytesRead = 0;
+        CHECK(!file->ReadAt(data, sizeof(data), 123456, &bytesRead));
+        CHECK(bytesRead == sizeof(data));
+        CHECK(IsTestData(data, sizeof(data), 123456));
+        CHECK(!file->ReadAt(data, 100, 7, &bytesRead));
+        CHECK(bytesRead == 100);
+        CHECK(IsTestData(data, 100, 7));
+        CHECK(!file->ReadAt(data, sizeof(data), fileSize - 10, &bytesRead));
+        CHECK(bytesRead == 10);
+        CHECK(IsTestData(data, 10, fileSize - 10));
+        Delete(file);
+    }
+
+    SECTION("Test ReadAt Above 4GB")
+    {
+        // Default implementation reaches the offsets that don't fit into the 32-bit file pointer by reading the data before them
+        TestLargeFile file(5ull * 1024 * 1024 * 1024);
+        byte data[256];
+        uint32 bytesRead = 0;
+        const uint64 offsets[] = { 1000, (uint64)MAX_uint32 - 10, (uint64)MAX_uint32, (uint64)MAX_uint32 + 1, (uint64)MAX_uint32 + 100000 };
+        for (const uint64 offset : offsets)
+        {
+            CHECK(!file.ReadAt(data, sizeof(data), offset, &bytesRead));
+            CHECK(bytesRead == sizeof(data));
+            CHECK(IsTestData(data, sizeof(data), offset));
+        }
+        file.Size = (uint64)MAX_uint32 + 100;
+        CHECK(file.ReadAt(data, sizeof(data), (uint64)MAX_uint32 + 1000, &bytesRead));
+        CHECK(bytesRead == 0);
+    }
+
+    FileSystem::DeleteFile(path);
+}
@@ -0,0 +1,141 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#include "Engine/Serialization/JsonBinary.h"
+#include "Engine/Serialization/MemoryWriteStream.h"
+#include "Engine/Core/Collections/Array.h"
+#include <ThirdParty/catch2/catch.hpp>
+
+static void WriteBinary(const char* json, Array<byte>& data)
+{
+    rapidjson_flax::Document document;
+    document.Parse(json);
+    REQUIRE(!document.HasParseError());
+    MemoryWriteStream stream(1024);
+    JsonBinary::Write(document, stream);
+    data.Set(stream.GetHandle(), stream.GetPosition());
+}
+
+static bool RoundTrip(const char* json, rapidjson_flax::Document& result)
+{
+    Array<byte> data;
+    WriteBinary(json, data);
+    return JsonBinary::Read(data.Get(), data.Count(), result);
+}
+
+static bool ContainsText(const Array<byte>& data, const char* text)
+{
+    const int32 length = StringUtils::Length(text);
+    for (int32 i = 0; i + length <= data.Count(); i++)
+    {
+        if (Platform::MemoryCompare(data.Get() + i, text, length) == 0)
+            return true;
+    }
+    return false;
+}
+
+TEST_CASE("JsonBinary")
+{
+    SECTION("Test Tags Round Trip")
+    {
+        const char* json = "{\"null\":null,\"false\":false,\"true\":true,\"int\":-5,\"uint\":3000000000,\"int64\":-8000000000,\"uint64\":18000000000000000000,"
+                           "\"double\":1.5,\"string\":\"text\",\"empty\":\"\",\"guid\":\"0123456789abcdef0123456789abcdef\",\"array\":[1,\"a\",[],{}],\"object\":{\"int\":1,\"nested\":{\"x\":2}}}";
+        rapidjson_flax::Document expected;
+        expected.Parse(json);
+        rapidjson_flax::Document result;
+        REQUIRE(!RoundTrip(json, result));
+        CHECK(result == expected);
+        CHECK(result["null"].IsNull());
+        CHECK(result["false"].IsFalse());
+        CHECK(result["true"].IsTrue());
+        CHECK(result["int"].IsInt());
+        CHECK(result["int"].GetInt() == -5);
+        CHECK(!result["uint"].IsInt());
+        CHECK(result["uint"].GetUint() == 3000000000u);
+        CHECK(!result["int64"].IsInt());
+        CHECK(result["int64"].GetInt64() == -8000000000ll);
+        CHECK(!result["uint64"].IsInt64());
+        CHECK(result["uint64"].GetUint64() == 18000000000000000000ull);
+        CHECK(result["double"].IsDouble());
+        CHECK(result["double"].GetDouble() == 1.5);
+        CHECK(result["string"] == "text");
+        CHECK(result["empty"] == "");
+        CHECK(result["guid"] == "0123456789abcdef0123456789abcdef");
+        CHECK(result["array"].Size() == 4);
+        CHECK(result["object"]["nested"]["x"].GetInt() == 2);
+    }
+
+    SECTION("Test Guid Strings")
+    {
+        // Only ids written by the engine (lowercase hex) are packed, other strings of the same length stay strings
+        const char* lower = "\"0123456789abcdef0123456789abcdef\"";
+        const char* upper = "\"0123456789ABCDEF0123456789ABCDEF\"";
+        const char* mixed = "\"0123456789abcdef0123456789abcdeF\"";
+        const char* notHex = "\"0123456789abcdef0123456789abcdeg\"";
+        const char* shorter = "\"0123456789abcdef0123456789abcde\"";
+        Array<byte> data;
+        WriteBinary(lower, data);
+        CHECK(!ContainsText(data, "0123456789abcdef"));
+        for (const char* json : { upper, mixed, notHex, shorter })
+        {
+            WriteBinary(json, data);
+            CHECK(ContainsText(data, json + 1));
+            rapidjson_flax::Document expected, result;
+            expected.Parse(json);
+            REQUIRE(!RoundTrip(json, result));
+            CHECK(result == expected);
+        }
+        rapidjson_flax::Document result;
+        REQUIRE(!RoundTrip(upper, result));
+        CHECK(result == "0123456789ABCDEF0123456789ABCDEF");
+    }
+
+    SECTION("Test Truncated Data")
+    {
+        Array<byte> data;
+        WriteBinary("{\"a\":[1,2.5,\"text\",{\"b\":null}],\"c\":\"0123456789abcdef0123456789abcdef\",\"d\":-8000000000}", data);
+        for (int32 length = 0; length < data.Count(); length++)
+        {
+            rapidjson_flax::Document result;
+            CHECK(JsonBinary::Read(data.Get(), length, result));
+        }
+    }
+
+    SECTION("Test Corrupted Data")
+    {
+        Array<byte> data, corrupted;
+        WriteBinary("{\"a\":[1,2.5,\"text\",{\"b\":null}],\"c\":\"0123456789abcdef0123456789abcdef\",\"d\":true}", data);
+        for (int32 i = 0; i < data.Count(); i++)
+        {
+            for (const byte value : { (byte)0x00, (byte)0x0b, (byte)0x7f, (byte)0xff })
+            {
+                // Any single byte change has to be either read or fail without crashing
+                corrupted = data;
+                corrupted[i] = value;
+                rapidjson_flax::Document result;
+                JsonBinary::Read(corrupted.Get(), corrupted.Count(), result);
+            }
+        }
+
+        // Trailing data
+        corrupted = data;
+        corrupted.Add(0);
+        rapidjson_flax::Document result;
+        CHECK(JsonBinary::Read(corrupted.Get(), corrupted.Count(), result));
+    }
+
+    SECTION("Test Nesting Limit")
+    {
+        // Header and empty keys table followed by deeply nested arrays with a single item
+        Array<byte> data;
+        WriteBinary("[]", data);
+        data.Resize(data.Count() - 5);
+        for (int32 i = 0; i < 100000; i++)
+        {
+            const byte item[] = { 10, 1, 0, 0, 0 };
+            data.Add(item, ARRAY_COUNT(item));
+        }
+        data.Add(0);
+        rapidjson_flax::Document result;
+        CHECK(JsonBinary::Read(data.Get(), data.Count(), result));
+    }
+}
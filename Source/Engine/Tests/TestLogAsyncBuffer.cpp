@@ -0,0 +1,101 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#include "Engine/Core/LogAsyncBuffer.h"
+#include "Engine/Core/Collections/Array.h"
+#include <ThirdParty/catch2/catch.hpp>
+
+namespace
+{
+    const int32 TerminatorLength = ARRAY_COUNT(PLATFORM_LINE_TERMINATOR) - 1;
+    const Char* Messages[] = { TEXT("a"), TEXT("Log message"), TEXT("Longer log message with some text") };
+
+    struct TestReader
+    {
+        Array<const Char*> Expected;
+        int32 Read = 0;
+        int32 Invalid = 0;
+
+        bool Pop(LogAsyncBuffer& buffer)
+        {
+            return buffer.Pop([this](const Char* text, int32 length)
+            {
+                const StringView expected(Expected[Read++]);
+                if (length != expected.Length() + TerminatorLength ||
+                    Platform::MemoryCompare(text, expected.Get(), expected.Length() * sizeof(Char)) != 0 ||
+                    Platform::MemoryCompare(text + expected.Length(), TEXT(PLATFORM_LINE_TERMINATOR), TerminatorLength * sizeof(Char)) != 0)
+                    Invalid++;
+            });
+        }
+    };
+}
+
+TEST_CASE("LogAsyncBuffer")
+{
+    LogAsyncBuffer buffer(512);
+    TestReader reader;
+
+    SECTION("Test Wraparound")
+    {
+        // Messages of different sizes end at the different offsets so some don't fit at the buffer end and are moved to the start
+        for (int32 i = 0; i < 200; i++)
+        {
+            const Char* msg = Messages[i % ARRAY_COUNT(Messages)];
+            reader.Expected.Add(msg);
+            REQUIRE(!buffer.Push(StringView(msg)));
+            if (i % 3 == 2)
+                CHECK(reader.Pop(buffer));
+        }
+        reader.Pop(buffer);
+        CHECK(reader.Read == 200);
+        CHECK(reader.Invalid == 0);
+        CHECK(!reader.Pop(buffer));
+    }
+
+    SECTION("Test Dropped Messages")
+    {
+        // Full buffer drops the new messages until the space gets released
+        int32 pushed = 0, dropped = 0;
+        for (int32 i = 0; i < 100; i++)
+        {
+            if (buffer.Push(StringView(Messages[1])))
+                dropped++;
+            else
+                pushed++;
+        }
+        CHECK(pushed > 0);
+        CHECK(pushed + dropped == 100);
+        CHECK(dropped > 0);
+        for (int32 i = 0; i < pushed; i++)
+            reader.Expected.Add(Messages[1]);
+        CHECK(reader.Pop(buffer));
+        CHECK(reader.Read == pushed);
+        CHECK(reader.Invalid == 0);
+        CHECK(!buffer.Push(StringView(Messages[1])));
+
+        // Message larger than half of the buffer is always dropped
+        Char text[200];
+        for (int32 i = 0; i < ARRAY_COUNT(text); i++)
+            text[i] = 'x';
+        CHECK(buffer.Push(StringView(text, ARRAY_COUNT(text))));
+    }
+
+    SECTION("Test Drain")
+    {
+        // Single read drains all the pending messages in order (eg. when disposing the log)
+        for (int32 i = 0; i < 8; i++)
+        {
+            reader.Expected.Add(Messages[i % ARRAY_COUNT(Messages)]);
+            REQUIRE(!buffer.Push(StringView(reader.Expected.Last())));
+        }
+        CHECK(reader.Pop(buffer));
+        CHECK(reader.Read == 8);
+        CHECK(reader.Invalid == 0);
+        CHECK(!reader.Pop(buffer));
+
+        // Whole space is available again (except the buffer end that is skipped when the record doesn't fit)
+        int32 pushed = 0;
+        while (!buffer.Push(StringView(Messages[0])))
+            pushed++;
+        CHECK(pushed >= 512 / 32 - 1);
+    }
+}
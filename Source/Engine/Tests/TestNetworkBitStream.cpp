@@ -0,0 +1,137 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#include "Engine/Networking/NetworkBitStream.h"
+#include <ThirdParty/catch2/catch.hpp>
+
+TEST_CASE("NetworkBitStream")
+{
+    SECTION("Test Bits Round Trip")
+    {
+        byte buffer[256] = {};
+        NetworkBitStream writer(buffer, sizeof(buffer));
+        for (int32 bits = 1; bits <= 32; bits++)
+            writer.WriteBits(0xA5C3F00Fu, bits);
+        writer.WriteBool(true);
+        writer.WriteBool(false);
+        CHECK(!writer.HasOverflow());
+        CHECK(writer.GetPositionBits() == 32 * 33 / 2 + 2);
+        CHECK(writer.GetPositionBytes() == (32 * 33 / 2 + 2 + 7) / 8);
+
+        NetworkBitStream reader(buffer, writer.GetPositionBytes());
+        for (int32 bits = 1; bits <= 32; bits++)
+            CHECK(reader.ReadBits(bits) == (bits == 32 ? 0xA5C3F00Fu : 0xA5C3F00Fu & ((1u << bits) - 1)));
+        CHECK(reader.ReadBool());
+        CHECK(!reader.ReadBool());
+        CHECK(!reader.HasOverflow());
+    }
+
+    SECTION("Test VarUInt Round Trip")
+    {
+        // Values at the 7 bits groups boundaries
+        const uint32 values[] = { 0, 1, 127, 128, 16383, 16384, 2097151, 2097152, MAX_uint32 };
+        const uint32 sizes[] = { 1, 1, 1, 2, 2, 3, 3, 4, 5 };
+        byte buffer[64];
+        for (int32 i = 0; i < ARRAY_COUNT(values); i++)
+        {
+            // Write after a single bit to test the unaligned data too
+            NetworkBitStream writer(buffer, sizeof(buffer));
+            writer.WriteBool(true);
+            writer.WriteVarUInt(values[i]);
+            CHECK(writer.GetPositionBits() == 1 + sizes[i] * 8);
+            NetworkBitStream reader(buffer, sizeof(buffer));
+            CHECK(reader.ReadBool());
+            CHECK(reader.ReadVarUInt() == values[i]);
+            CHECK(!reader.HasOverflow());
+        }
+    }
+
+    SECTION("Test Bytes Round Trip")
+    {
+        byte data[33];
+        for (int32 i = 0; i < ARRAY_COUNT(data); i++)
+            data[i] = (byte)(i * 37 + 11);
+        for (const int32 offset : { 0, 3, 8 })
+        {
+            byte buffer[64] = {};
+            NetworkBitStream writer(buffer, sizeof(buffer));
+            writer.WriteBits(0x55, offset);
+            writer.WriteBytes(data, sizeof(data));
+            CHECK(!writer.HasOverflow());
+            byte result[33] = {};
+            NetworkBitStream reader(buffer, sizeof(buffer));
+            CHECK(reader.ReadBits(offset) == (0x55u & ((1u << offset) - 1)));
+            reader.ReadBytes(result, sizeof(result));
+            CHECK(!reader.HasOverflow());
+            CHECK(Platform::MemoryCompare(data, result, sizeof(data)) == 0);
+        }
+    }
+
+    SECTION("Test Write Overflow")
+    {
+        // Writing past the end doesn't modify the memory
+        byte buffer[8] = { 0, 0, 0, 0, 0xEE, 0xEE, 0xEE, 0xEE };
+        NetworkBitStream writer(buffer, 4);
+        writer.WriteBits(MAX_uint32, 30);
+        CHECK(!writer.HasOverflow());
+        writer.WriteBits(MAX_uint32, 3);
+        CHECK(writer.HasOverflow());
+        CHECK(writer.GetPositionBits() == 30);
+        CHECK(buffer[3] == 0x3F);
+        writer.SetPositionBits(30);
+        CHECK(!writer.HasOverflow());
+        writer.WriteBits(MAX_uint32, 2);
+        CHECK(!writer.HasOverflow());
+        CHECK(buffer[3] == 0xFF);
+        const byte bytes[2] = { 1, 2 };
+        writer.SetPositionBits(24);
+        writer.WriteBytes(bytes, sizeof(bytes));
+        CHECK(writer.HasOverflow());
+        writer.SetPositionBits(32);
+        writer.WriteVarUInt(1);
+        CHECK(writer.HasOverflow());
+        for (int32 i = 4; i < ARRAY_COUNT(buffer); i++)
+            CHECK(buffer[i] == 0xEE);
+    }
+
+    SECTION("Test Read Overflow")
+    {
+        byte buffer[8] = { 0x12, 0x34, 0x56, 0x78, 0xEE, 0xEE, 0xEE, 0xEE };
+        NetworkBitStream reader(buffer, 4);
+        CHECK(reader.ReadBits(32) == 0x78563412u);
+        CHECK(!reader.HasOverflow());
+        CHECK(reader.ReadBits(1) == 0);
+        CHECK(reader.HasOverflow());
+        byte result[2] = { 0xAA, 0xAA };
+        reader.SetPositionBits(24);
+        reader.ReadBytes(result, sizeof(result));
+        CHECK(reader.HasOverflow());
+        CHECK(result[0] == 0x78);
+
+        // Truncated variable-length value
+        byte varBuffer[2] = { 0xFF, 0xFF };
+        NetworkBitStream varReader(varBuffer, sizeof(varBuffer));
+        varReader.ReadVarUInt();
+        CHECK(varReader.HasOverflow());
+    }
+
+    SECTION("Test Neighbour Bits")
+    {
+        // Overwriting the bits in the middle of the byte keeps the other bits
+        byte buffer[4] = { 0xFF, 0xFF, 0xFF, 0xFF };
+        NetworkBitStream writer(buffer, sizeof(buffer));
+        writer.SetPositionBits(5);
+        writer.WriteBits(0, 6);
+        CHECK(buffer[0] == 0x1F);
+        CHECK(buffer[1] == 0xF8);
+        CHECK(buffer[2] == 0xFF);
+        writer.SetPositionBits(20);
+        writer.WriteBits(0x5, 3);
+        CHECK(buffer[2] == 0xDF);
+        CHECK(buffer[3] == 0xFF);
+        NetworkBitStream reader(buffer, sizeof(buffer));
+        reader.SetPositionBits(5);
+        CHECK(reader.ReadBits(6) == 0);
+        reader.SetPositionBits(20);
+        CHECK(reader.ReadBits(3) == 0x5);
+    }
+}
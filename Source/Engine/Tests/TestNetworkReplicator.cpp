@@ -0,0 +1,305 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#include "Engine/Networking/NetworkReplicator.h"
+#include "Engine/Networking/INetworkDriver.h"
+#include "Engine/Networking/NetworkPeer.h"
+#include "Engine/Networking/NetworkEvent.h"
+#include "Engine/Core/Collections/Array.h"
+#include <ThirdParty/catch2/catch.hpp>
+
+// In-process driver that delivers the messages directly to the remote driver (can drop the sent messages to simulate the packets loss).
+class TestLoopbackDriver : public INetworkDriver
+{
+public:
+
+    NetworkPeer* Host = nullptr;
+    TestLoopbackDriver* Remote = nullptr;
+    uint32 ConnectionId = 0;
+    Array<NetworkEvent> Events;
+    bool DropMessages = false;
+    int32 SentMessages = 0;
+    uint32 LastMessageSize = 0;
+
+    void PushEvent(NetworkEventType type, uint32 senderId, const NetworkMessage& message = NetworkMessage())
+    {
+        NetworkEvent e;
+        e.EventType = type;
+        e.Message = message;
+        e.Sender.ConnectionId = senderId;
+        Events.Add(e);
+    }
+
+public:
+
+    // [INetworkDriver]
+    bool Initialize(NetworkPeer* host, const NetworkConfig& config) override
+    {
+        Host = host;
+        return false;
+    }
+
+    void Dispose() override
+    {
+    }
+
+    bool Listen() override
+    {
+        return false;
+    }
+
+    bool Connect() override
+    {
+        PushEvent(NetworkEventType::Connected, Remote->ConnectionId);
+        Remote->PushEvent(NetworkEventType::Connected, ConnectionId);
+        return false;
+    }
+
+    void Disconnect() override
+    {
+    }
+
+    void Disconnect(const NetworkConnection& connection) override
+    {
+    }
+
+    bool PopEvent(NetworkEvent* eventPtr) override
+    {
+        if (Events.IsEmpty())
+            return false;
+        *eventPtr = Events[0];
+        Events.RemoveAtKeepOrder(0);
+        return true;
+    }
+
+    void SendMessage(NetworkChannelType channelType, const NetworkMessage& message) override
+    {
+        SentMessages++;
+        LastMessageSize = message.Length;
+        if (DropMessages)
+            return;
+        NetworkMessage received = Remote->Host->CreateMessage();
+        Platform::MemoryCopy(received.Buffer, message.Buffer, message.Length);
+        received.Length = message.Length;
+        Remote->PushEvent(NetworkEventType::Message, ConnectionId, received);
+    }
+
+    void SendMessage(NetworkChannelType channelType, const NetworkMessage& message, NetworkConnection target) override
+    {
+        SendMessage(channelType, message);
+    }
+
+    void SendMessage(NetworkChannelType channelType, const NetworkMessage& message, const Array<NetworkConnection, HeapAllocation>& targets) override
+    {
+        for (int32 i = 0; i < targets.Count(); i++)
+            SendMessage(channelType, message);
+    }
+};
+
+// Network peer using the loopback driver with the replicator on top of it.
+class TestPeer
+{
+public:
+
+    TestLoopbackDriver Driver;
+    NetworkPeer* Peer;
+    Array<byte> MessageBuffer;
+    NetworkReplicator* Replicator;
+
+    TestPeer(uint32 connectionId, bool isServer)
+    {
+        Peer = New<NetworkPeer>();
+        Peer->HostId = (int32)connectionId;
+        Peer->Config.MessageSize = 512;
+        Peer->Config.MessagePoolSize = 64;
+        MessageBuffer.Resize((Peer->Config.MessagePoolSize + 1) * Peer->Config.MessageSize);
+        Peer->MessageBuffer = MessageBuffer.Get();
+        for (uint32 messageId = Peer->Config.MessagePoolSize; messageId > 0; messageId--)
+            Peer->MessagePool.Push(messageId);
+        Peer->NetworkDriver = &Driver;
+        Driver.Initialize(Peer, Peer->Config);
+        Driver.ConnectionId = connectionId;
+        Replicator = New<NetworkReplicator>(Peer, isServer);
+    }
+
+    ~TestPeer()
+    {
+        Delete(Replicator);
+        Peer->NetworkDriver = nullptr;
+        Peer->MessageBuffer = nullptr;
+        Delete(Peer);
+    }
+
+    void Update(float deltaTime)
+    {
+        // Replicator processes the received messages before sending its own
+        NetworkEvent e;
+        while (Peer->PopEvent(e))
+        {
+            if (!Replicator->ProcessEvent(e) && e.EventType == NetworkEventType::Message)
+                Peer->RecycleMessage(e.Message);
+        }
+        Replicator->Update(deltaTime);
+    }
+};
+
+struct TestObject
+{
+    Vector3 Position;
+    float Health;
+    uint32 Ammo;
+    uint8 Flags;
+};
+
+static NetworkReplicationObject GetReplicationObject(uint32 id, TestObject& data)
+{
+    NetworkReplicationObject obj;
+    obj.Id = id;
+    obj.Data = &data;
+    obj.Fields.Add(NetworkReplicationField::Raw(OFFSET_OF(TestObject, Position), sizeof(Vector3)));
+    obj.Fields.Add(NetworkReplicationField::Float(OFFSET_OF(TestObject, Health), 0.0f, 100.0f, 16));
+    obj.Fields.Add(NetworkReplicationField::UInt(OFFSET_OF(TestObject, Ammo), sizeof(uint32), 10));
+    obj.Fields.Add(NetworkReplicationField::UInt(OFFSET_OF(TestObject, Flags), sizeof(uint8), 1));
+    return obj;
+}
+
+static bool IsSameObject(const TestObject& a, const TestObject& b)
+{
+    return a.Position == b.Position && Math::Abs(a.Health - b.Health) < 0.01f && a.Ammo == b.Ammo && a.Flags == b.Flags;
+}
+
+TEST_CASE("NetworkReplicator")
+{
+    const float deltaTime = 1.0f / 30.0f;
+    TestPeer server(1, true);
+    TestPeer client(2, false);
+    server.Driver.Remote = &client.Driver;
+    client.Driver.Remote = &server.Driver;
+    client.Driver.Connect();
+    TestObject serverObject = { Vector3(1.0f, 2.0f, 3.0f), 50.0f, 30, 1 };
+    TestObject clientObject = { Vector3::Zero, 0.0f, 0, 0 };
+    REQUIRE(!server.Replicator->RegisterObject(GetReplicationObject(1, serverObject)));
+    REQUIRE(!client.Replicator->RegisterObject(GetReplicationObject(1, clientObject)));
+    CHECK(server.Replicator->RegisterObject(GetReplicationObject(1, serverObject)));
+
+    // Send the full state and acknowledge it
+    server.Update(deltaTime);
+    client.Update(deltaTime);
+    REQUIRE(server.Driver.SentMessages == 1);
+    CHECK(client.Driver.SentMessages == 1);
+    CHECK(IsSameObject(serverObject, clientObject));
+    const uint32 fullSize = server.Driver.LastMessageSize;
+
+    SECTION("Test Delta")
+    {
+        // Unchanged objects are not sent
+        server.Update(deltaTime);
+        client.Update(deltaTime);
+        CHECK(server.Driver.SentMessages == 1);
+
+        // Only the changed fields are sent
+        serverObject.Health = 75.0f;
+        server.Update(deltaTime);
+        client.Update(deltaTime);
+        CHECK(server.Driver.SentMessages == 2);
+        CHECK(server.Driver.LastMessageSize < fullSize);
+        CHECK(IsSameObject(serverObject, clientObject));
+        serverObject.Position.Y = 5.0f;
+        serverObject.Flags = 0;
+        server.Update(deltaTime);
+        client.Update(deltaTime);
+        CHECK(server.Driver.SentMessages == 3);
+        CHECK(server.Driver.LastMessageSize < fullSize);
+        CHECK(IsSameObject(serverObject, clientObject));
+    }
+
+    SECTION("Test Unacknowledged Fallback")
+    {
+        // Server sends the full state when there are too many updates since the acknowledged baseline
+        client.Driver.DropMessages = true;
+        int32 updates = 0;
+        uint32 size = 0;
+        do
+        {
+            serverObject.Ammo++;
+            server.Update(deltaTime);
+            client.Update(deltaTime);
+            CHECK(IsSameObject(serverObject, clientObject));
+            size = server.Driver.LastMessageSize;
+            updates++;
+        } while (size < fullSize && updates < 32);
+        CHECK(size == fullSize);
+        CHECK(updates > 1);
+
+        // Acknowledged full state is used as the baseline again
+        client.Driver.DropMessages = false;
+        server.Update(deltaTime);
+        client.Update(deltaTime);
+        serverObject.Ammo++;
+        server.Update(deltaTime);
+        client.Update(deltaTime);
+        CHECK(server.Driver.LastMessageSize < fullSize);
+        CHECK(IsSameObject(serverObject, clientObject));
+    }
+
+    SECTION("Test Missing Baseline")
+    {
+        // Client loses the received states so it can't decode the delta but still acknowledges the snapshot
+        client.Replicator->UnregisterObject(1);
+        REQUIRE(!client.Replicator->RegisterObject(GetReplicationObject(1, clientObject)));
+        serverObject.Health = 20.0f;
+        server.Update(deltaTime);
+        client.Update(deltaTime);
+        CHECK(server.Driver.LastMessageSize < fullSize);
+        CHECK(client.Driver.SentMessages == 2);
+        CHECK(!IsSameObject(serverObject, clientObject));
+
+        // Server sends the full state of the reported object
+        server.Update(deltaTime);
+        client.Update(deltaTime);
+        CHECK(server.Driver.LastMessageSize == fullSize);
+        CHECK(IsSameObject(serverObject, clientObject));
+
+        // Acknowledged full state is used as the baseline again
+        serverObject.Health = 30.0f;
+        server.Update(deltaTime);
+        client.Update(deltaTime);
+        CHECK(server.Driver.LastMessageSize < fullSize);
+        CHECK(IsSameObject(serverObject, clientObject));
+    }
+
+    SECTION("Test Unknown Object")
+    {
+        // Client skips the not registered object and receives its full state after registering it
+        TestObject serverObject2 = { Vector3(4.0f, 5.0f, 6.0f), 10.0f, 7, 0 };
+        TestObject clientObject2 = { Vector3::Zero, 0.0f, 0, 0 };
+        REQUIRE(!server.Replicator->RegisterObject(GetReplicationObject(2, serverObject2)));
+        server.Update(deltaTime);
+        client.Update(deltaTime);
+        CHECK(server.Driver.SentMessages == 2);
+        CHECK(client.Driver.SentMessages == 2);
+        REQUIRE(!client.Replicator->RegisterObject(GetReplicationObject(2, clientObject2)));
+        server.Update(deltaTime);
+        client.Update(deltaTime);
+        CHECK(server.Driver.SentMessages == 3);
+        CHECK(server.Driver.LastMessageSize == fullSize);
+        CHECK(IsSameObject(serverObject2, clientObject2));
+        CHECK(IsSameObject(serverObject, clientObject));
+    }
+
+    SECTION("Test Unregister Object")
+    {
+        server.Replicator->UnregisterObject(1);
+        server.Update(deltaTime);
+        client.Update(deltaTime);
+        CHECK(server.Driver.SentMessages == 1);
+
+        // Server sends the full state of the object registered again
+        serverObject.Ammo = 5;
+        REQUIRE(!server.Replicator->RegisterObject(GetReplicationObject(1, serverObject)));
+        server.Update(deltaTime);
+        client.Update(deltaTime);
+        CHECK(server.Driver.SentMessages == 2);
+        CHECK(server.Driver.LastMessageSize == fullSize);
+        CHECK(IsSameObject(serverObject, clientObject));
+    }
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#include "Engine/Core/ObjectsRemovalService.h"
+#include "Engine/Core/Types/String.h"
+#include <ThirdParty/catch2/catch.hpp>
+
+// Object that counts the delete calls instead of deleting itself.
+class TestRemovalObject : public Object
+{
+public:
+
+    int32 Deleted = 0;
+
+    String ToString() const override
+    {
+        return String::Empty;
+    }
+
+    void OnDeleteObject() override
+    {
+        Deleted++;
+    }
+};
+
+// Flushes the pool in small steps until the object gets deleted, returns the elapsed time (in seconds).
+static float FlushUntilDeleted(TestRemovalObject& obj, float maxTime, bool useGameTime = false)
+{
+    const float step = 1.0f / 30.0f;
+    float time = 0.0f;
+    while (obj.Deleted == 0 && time < maxTime)
+    {
+        ObjectsRemovalService::Flush(useGameTime ? 0.0f : step, useGameTime ? step : 0.0f);
+        time += step;
+    }
+    return time;
+}
+
+TEST_CASE("ObjectsRemovalService")
+{
+    TestRemovalObject obj;
+
+    SECTION("Test Immediate")
+    {
+        ObjectsRemovalService::Add(&obj, 0.0f);
+        CHECK(ObjectsRemovalService::HasNewItemsForFlush());
+        ObjectsRemovalService::Flush();
+        CHECK(obj.Deleted == 1);
+        CHECK(!ObjectsRemovalService::IsInPool(&obj));
+    }
+
+    SECTION("Test Level0")
+    {
+        ObjectsRemovalService::Add(&obj, 1.0f);
+        CHECK(ObjectsRemovalService::IsInPool(&obj));
+        ObjectsRemovalService::Flush(0.9f, 0.0f);
+        CHECK(obj.Deleted == 0);
+        ObjectsRemovalService::Flush(0.2f, 0.0f);
+        CHECK(obj.Deleted == 1);
+    }
+
+    SECTION("Test Cascade")
+    {
+        // Timer far enough to land in the second level gets cascaded to the first one before expiring
+        ObjectsRemovalService::Add(&obj, 10.0f);
+        const float time = FlushUntilDeleted(obj, 20.0f);
+        CHECK(obj.Deleted == 1);
+        CHECK(time >= 10.0f - 0.02f);
+        CHECK(time <= 10.0f + 0.05f);
+    }
+
+    SECTION("Test Overflow")
+    {
+        // Timer out of the wheels range is kept in the overflow list until it fits
+        ObjectsRemovalService::Add(&obj, 300.0f);
+        ObjectsRemovalService::Flush(200.0f, 0.0f);
+        CHECK(obj.Deleted == 0);
+        ObjectsRemovalService::Flush(99.0f, 0.0f);
+        CHECK(obj.Deleted == 0);
+        const float time = FlushUntilDeleted(obj, 5.0f);
+        CHECK(obj.Deleted == 1);
+        CHECK(time <= 1.05f);
+    }
+
+    SECTION("Test Game Time")
+    {
+        ObjectsRemovalService::Add(&obj, 1.0f, true);
+        ObjectsRemovalService::Flush(5.0f, 0.0f);
+        CHECK(obj.Deleted == 0);
+        ObjectsRemovalService::Flush(0.0f, 1.1f);
+        CHECK(obj.Deleted == 1);
+    }
+
+    SECTION("Test Re-add")
+    {
+        // Timer of the previous registration is stale
+        ObjectsRemovalService::Add(&obj, 1.0f);
+        ObjectsRemovalService::Add(&obj, 3.0f);
+        ObjectsRemovalService::Flush(1.5f, 0.0f);
+        CHECK(obj.Deleted == 0);
+        ObjectsRemovalService::Flush(1.6f, 0.0f);
+        CHECK(obj.Deleted == 1);
+
+        // Shorter timeout overrides the longer one
+        ObjectsRemovalService::Add(&obj, 20.0f);
+        ObjectsRemovalService::Add(&obj, 1.0f);
+        ObjectsRemovalService::Flush(1.1f, 0.0f);
+        CHECK(obj.Deleted == 2);
+        ObjectsRemovalService::Flush(20.0f, 0.0f);
+        CHECK(obj.Deleted == 2);
+    }
+
+    SECTION("Test Cancel")
+    {
+        ObjectsRemovalService::Add(&obj, 1.0f);
+        ObjectsRemovalService::Dereference(&obj);
+        CHECK(!ObjectsRemovalService::IsInPool(&obj));
+        ObjectsRemovalService::Flush(2.0f, 0.0f);
+        CHECK(obj.Deleted == 0);
+
+        // Canceled timer doesn't delete the object registered again
+        ObjectsRemovalService::Add(&obj, 1.0f);
+        ObjectsRemovalService::Dereference(&obj);
+        ObjectsRemovalService::Add(&obj, 3.0f);
+        ObjectsRemovalService::Flush(1.5f, 0.0f);
+        CHECK(obj.Deleted == 0);
+        ObjectsRemovalService::Flush(1.6f, 0.0f);
+        CHECK(obj.Deleted == 1);
+    }
+
+    // Don't leave the object in the pool
+    ObjectsRemovalService::Dereference(&obj);
+}
@@ -61,6 +61,39 @@ struct TIsPODType<JobData>
     enum { Value = false };
 };
 
+// Shared state of the JobSystem::Execute call (released by the last thread that uses it)
+struct JobExecuteData
+{
+    Function<void(int32)> Job;
+    int64 JobCount;
+    volatile int64 NextIndex = 0;
+    volatile int64 DoneCount = 0;
+    volatile int64 Refs = 1;
+    CriticalSection Locker;
+    ConditionVariable DoneSignal;
+
+    void Work()
+    {
+        int64 index;
+        while ((index = Platform::InterlockedIncrement(&NextIndex) - 1) < JobCount)
+        {
+            Job((int32)index);
+            if (Platform::InterlockedIncrement(&DoneCount) == JobCount)
+            {
+                Locker.Lock();
+                DoneSignal.NotifyAll();
+                Locker.Unlock();
+            }
+        }
+    }
+
+    void Release()
+    {
+        if (Platform::InterlockedDecrement(&Refs) == 0)
+            Delete(this);
+    }
+};
+
 class JobSystemThread : public IRunnable
 {
 public:
@@ -287,6 +320,43 @@ void JobSystem::Wait(int64 label)
 #endif
 }
 
+void JobSystem::Execute(const Function<void(int32)>& job, int32 jobCount)
+{
+#if JOB_SYSTEM_ENABLED
+    PROFILE_CPU();
+    if (jobCount <= 1 || ThreadsCount == 0)
+    {
+        for (int32 i = 0; i < jobCount; i++)
+            job(i);
+        return;
+    }
+
+    // Dispatch helper jobs that pull the job indices (they can start late so the data is released by the last user)
+    auto data = New<JobExecuteData>();
+    data->Job = job;
+    data->JobCount = jobCount;
+    const int32 helpersCount = Math::Min(jobCount - 1, ThreadsCount);
+    data->Refs += helpersCount;
+    Function<void(int32)> helper = [data](int32)
+    {
+        data->Work();
+        data->Release();
+    };
+    Dispatch(helper, helpersCount);
+
+    // Help with the execution and wait for the indices taken by the other threads
+    data->Work();
+    data->Locker.Lock();
+    while (Platform::AtomicRead(&data->DoneCount) < data->JobCount)
+        data->DoneSignal.Wait(data->Locker);
+    data->Locker.Unlock();
+    data->Release();
+#else
+    for (int32 i = 0; i < jobCount; i++)
+        job(i);
+#endif
+}
+
 void JobSystem::SetJobStartingOnDispatch(bool value)
 {
 #if JOB_SYSTEM_ENABLED
@@ -30,6 +30,16 @@ DECLARE_SCRIPTING_TYPE_MINIMAL(JobSystem);
     /// <param name="label">The label.</param>
     API_FUNCTION() static void Wait(int64 label);
 
+    /// <summary>
+    /// Executes the job on the job system threads and waits for it to finish. The calling thread executes the job too (it doesn't wait for the jobs dispatched before) and only this execution is tracked, so it's safe to use from any thread (unlike Dispatch and Wait that use the shared jobs counter).
+    /// </summary>
+    /// <remarks>
+    /// Long-running work (eg. assets importing) should not use the job system as it delays the jobs the main thread waits for every frame.
+    /// </remarks>
+    /// <param name="job">The job. Argument is an index of the job execution.</param>
+    /// <param name="jobCount">The job executions count.</param>
+    API_FUNCTION() static void Execute(const Function<void(int32)>& job, int32 jobCount = 1);
+
     /// <summary>
     /// Sets whether automatically start jobs execution on Dispatch. If disabled jobs won't be executed until it gets re-enabled. Can be used to optimize execution of multiple dispatches that should overlap.
     /// </summary>
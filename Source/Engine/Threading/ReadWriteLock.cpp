@@ -0,0 +1,108 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#include "ReadWriteLock.h"
+#include "Engine/Core/Compiler.h"
+
+// The maximum amount of different locks held for reading by a single thread at once (deeper nesting is not tracked and can deadlock when writer is pending)
+#define READ_WRITE_LOCK_MAX_HELD 16
+
+namespace
+{
+    // Read locks held by the current thread (used to skip waiting for the pending writer on nested read locking)
+    struct ReadLockHeld
+    {
+        const ReadWriteLock* Lock;
+        int32 Depth;
+    };
+
+    THREADLOCAL ReadLockHeld ReadLocksHeld[READ_WRITE_LOCK_MAX_HELD];
+    THREADLOCAL int32 ReadLocksHeldCount = 0;
+
+    ReadLockHeld* FindReadLockHeld(const ReadWriteLock* lock)
+    {
+        for (int32 i = 0; i < ReadLocksHeldCount; i++)
+        {
+            if (ReadLocksHeld[i].Lock == lock)
+                return &ReadLocksHeld[i];
+        }
+        return nullptr;
+    }
+}
+
+void ReadWriteLock::ReadLock() const
+{
+    if (IsWriteLockedByCurrentThread())
+        return;
+    if (ReadLockHeld* held = FindReadLockHeld(this))
+    {
+        // Nested read lock (the outer one already blocks writers)
+        held->Depth++;
+        return;
+    }
+    while (true)
+    {
+        Platform::InterlockedIncrement(&_readers);
+        if (Platform::AtomicRead(&_writers) == 0)
+            break;
+
+        // Writer is pending or active so back off and wait for it to end
+        if (Platform::InterlockedDecrement(&_readers) == 0)
+        {
+            _waitLocker.Lock();
+            _readersSignal.NotifyAll();
+            _waitLocker.Unlock();
+        }
+        _waitLocker.Lock();
+        while (Platform::AtomicRead(&_writers) != 0)
+            _writerSignal.Wait(_waitLocker);
+        _waitLocker.Unlock();
+    }
+    if (ReadLocksHeldCount < READ_WRITE_LOCK_MAX_HELD)
+        ReadLocksHeld[ReadLocksHeldCount++] = { this, 1 };
+}
+
+void ReadWriteLock::ReadUnlock() const
+{
+    if (IsWriteLockedByCurrentThread())
+        return;
+    if (ReadLockHeld* held = FindReadLockHeld(this))
+    {
+        if (--held->Depth != 0)
+            return;
+        *held = ReadLocksHeld[--ReadLocksHeldCount];
+    }
+    if (Platform::InterlockedDecrement(&_readers) == 0 && Platform::AtomicRead(&_writers) != 0)
+    {
+        // Wake up the pending writer
+        _waitLocker.Lock();
+        _readersSignal.NotifyAll();
+        _waitLocker.Unlock();
+    }
+}
+
+void ReadWriteLock::WriteLock()
+{
+    _writeLocker.Lock();
+    if (_writeDepth++ == 0)
+    {
+        Platform::InterlockedIncrement(&_writers);
+        _waitLocker.Lock();
+        while (Platform::AtomicRead(&_readers) != 0)
+            _readersSignal.Wait(_waitLocker);
+        _waitLocker.Unlock();
+        Platform::AtomicStore(&_writerThread, (int64)Platform::GetCurrentThreadID());
+    }
+}
+
+void ReadWriteLock::WriteUnlock()
+{
+    if (--_writeDepth == 0)
+    {
+        Platform::AtomicStore(&_writerThread, 0);
+        Platform::InterlockedDecrement(&_writers);
+        _waitLocker.Lock();
+        _writerSignal.NotifyAll();
+        _waitLocker.Unlock();
+    }
+    _writeLocker.Unlock();
+}
@@ -0,0 +1,117 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#pragma once
+
+#include "Engine/Platform/Platform.h"
+#include "Engine/Platform/CriticalSection.h"
+#include "Engine/Platform/ConditionVariable.h"
+
+/// <summary>
+/// Lightweight readers-writer lock. Allows multiple threads to read the shared data at once while writers get exclusive access.
+/// Readers use only atomic operations (no blocking unless writer is active). Writer locking is recursive (the same thread can lock it multiple times). Read locking is recursive too (nested read lock doesn't wait for the pending writer).
+/// </summary>
+/// <remarks>
+/// Taking the read lock on a thread that holds the write lock is allowed (reading is nested within the writing, the write lock cannot be released before read unlock). Upgrading the read lock into the write lock is not supported.
+/// </remarks>
+class FLAXENGINE_API ReadWriteLock
+{
+private:
+
+    mutable volatile int64 _readers = 0;
+    mutable volatile int64 _writers = 0;
+    volatile int64 _writerThread = 0;
+    int32 _writeDepth = 0;
+    CriticalSection _writeLocker;
+    mutable CriticalSection _waitLocker;
+    mutable ConditionVariable _readersSignal;
+    mutable ConditionVariable _writerSignal;
+
+public:
+
+    ReadWriteLock() = default;
+    ReadWriteLock(const ReadWriteLock&) = delete;
+    ReadWriteLock& operator=(const ReadWriteLock&) = delete;
+
+public:
+
+    /// <summary>
+    /// Locks for reading. Waits for the active writer (if any) to end.
+    /// </summary>
+    void ReadLock() const;
+
+    /// <summary>
+    /// Unlocks after reading.
+    /// </summary>
+    void ReadUnlock() const;
+
+    /// <summary>
+    /// Locks for writing. Blocks new readers and waits for the active readers to end.
+    /// </summary>
+    void WriteLock();
+
+    /// <summary>
+    /// Unlocks after writing.
+    /// </summary>
+    void WriteUnlock();
+
+    /// <summary>
+    /// Returns true if the current thread holds the write lock.
+    /// </summary>
+    FORCE_INLINE bool IsWriteLockedByCurrentThread() const
+    {
+        // Writer thread id is set only by the thread that holds the write lock so other threads never see it matching
+        return (uint64)Platform::AtomicRead((volatile int64*)&_writerThread) == Platform::GetCurrentThreadID();
+    }
+};
+
+/// <summary>
+/// Scope read locker for readers-writer lock.
+/// </summary>
+class ScopeReadLock
+{
+private:
+
+    const ReadWriteLock* _lock;
+
+    ScopeReadLock(const ScopeReadLock&) = delete;
+    ScopeReadLock& operator=(const ScopeReadLock&) = delete;
+
+public:
+
+    ScopeReadLock(const ReadWriteLock& lock)
+        : _lock(&lock)
+    {
+        _lock->ReadLock();
+    }
+
+    ~ScopeReadLock()
+    {
+        _lock->ReadUnlock();
+    }
+};
+
+/// <summary>
+/// Scope write locker for readers-writer lock.
+/// </summary>
+class ScopeWriteLock
+{
+private:
+
+    ReadWriteLock* _lock;
+
+    ScopeWriteLock(const ScopeWriteLock&) = delete;
+    ScopeWriteLock& operator=(const ScopeWriteLock&) = delete;
+
+public:
+
+    ScopeWriteLock(ReadWriteLock& lock)
+        : _lock(&lock)
+    {
+        _lock->WriteLock();
+    }
+
+    ~ScopeWriteLock()
+    {
+        _lock->WriteUnlock();
+    }
+};
@@ -12,6 +12,7 @@
 #include "Engine/Platform/ConditionVariable.h"
 #include "Engine/Platform/CPUInfo.h"
 #include "Engine/Platform/Thread.h"
+#include "Engine/Profiler/ProfilerCPU.h"
 
 FLAXENGINE_API bool IsInMainThread()
 {
@@ -25,6 +26,39 @@ namespace ThreadPoolImpl
     ConcurrentTaskQueue<ThreadPoolTask> Jobs; // Hello Steve!
     ConditionVariable JobsSignal;
     CriticalSection JobsMutex;
+
+    // Shared state of the ThreadPool::Execute call (released by the last user as helper tasks can start after the execution end)
+    struct ExecuteData
+    {
+        Function<void(int32)> Job;
+        int64 JobCount;
+        volatile int64 NextIndex = 0;
+        volatile int64 DoneCount = 0;
+        volatile int64 Refs = 1;
+        CriticalSection Locker;
+        ConditionVariable DoneSignal;
+
+        void Work()
+        {
+            int64 index;
+            while ((index = Platform::InterlockedIncrement(&NextIndex) - 1) < JobCount)
+            {
+                Job((int32)index);
+                if (Platform::InterlockedIncrement(&DoneCount) == JobCount)
+                {
+                    Locker.Lock();
+                    DoneSignal.NotifyAll();
+                    Locker.Unlock();
+                }
+            }
+        }
+
+        void Release()
+        {
+            if (Platform::InterlockedDecrement(&Refs) == 0)
+                Delete(this);
+        }
+    };
 }
 
 void ThreadPoolTask::Enqueue()
@@ -100,6 +134,39 @@ void ThreadPoolService::Dispose()
     ThreadPoolImpl::Threads.ClearDelete();
 }
 
+void ThreadPool::Execute(const Function<void(int32)>& job, int32 jobCount)
+{
+    PROFILE_CPU();
+    if (jobCount <= 1 || ThreadPoolImpl::Threads.Count() == 0)
+    {
+        for (int32 i = 0; i < jobCount; i++)
+            job(i);
+        return;
+    }
+
+    // Start helper tasks that pull the job indices
+    auto data = New<ThreadPoolImpl::ExecuteData>();
+    data->Job = job;
+    data->JobCount = jobCount;
+    const int32 helpersCount = Math::Min(jobCount - 1, ThreadPoolImpl::Threads.Count());
+    data->Refs += helpersCount;
+    Function<void()> helper = [data]
+    {
+        data->Work();
+        data->Release();
+    };
+    for (int32 i = 0; i < helpersCount; i++)
+        Task::StartNew(helper);
+
+    // Help with the execution and wait for the indices taken by the other threads
+    data->Work();
+    data->Locker.Lock();
+    while (Platform::AtomicRead(&data->DoneCount) < data->JobCount)
+        data->DoneSignal.Wait(data->Locker);
+    data->Locker.Unlock();
+    data->Release();
+}
+
 int32 ThreadPool::ThreadProc()
 {
     ThreadPoolTask* task;
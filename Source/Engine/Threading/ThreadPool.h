@@ -3,14 +3,27 @@
 #pragma once
 
 #include "Engine/Core/Types/BaseTypes.h"
+#include "Engine/Core/Delegate.h"
 
 /// <summary>
 /// Main engine thread pool for threaded tasks system.
 /// </summary>
-class ThreadPool
+class FLAXENGINE_API ThreadPool
 {
     friend class ThreadPoolTask;
     friend class ThreadPoolService;
+public:
+
+    /// <summary>
+    /// Executes the job on the thread pool threads and waits for it to finish. The calling thread executes the job too and only this execution is tracked, so it's safe to use from any thread.
+    /// </summary>
+    /// <remarks>
+    /// Use it for the long-running work (eg. assets importing) instead of the job system that executes the jobs the main thread waits for every frame.
+    /// </remarks>
+    /// <param name="job">The job. Argument is an index of the job execution.</param>
+    /// <param name="jobCount">The job executions count.</param>
+    static void Execute(const Function<void(int32)>& job, int32 jobCount = 1);
+
 private:
 
     static int32 ThreadProc();
@@ -12,6 +12,7 @@
 #include "Engine/Graphics/Textures/TextureUtils.h"
 #include "Engine/Graphics/PixelFormatExtensions.h"
 #include "Engine/Platform/File.h"
+#include "Engine/Threading/ThreadPool.h"
 
 #define STBI_ASSERT(x) ASSERT(x)
 #define STBI_MALLOC(sz) Allocator::Allocate(sz)
@@ -51,6 +52,23 @@
 #include <ThirdParty/bc7enc16/bc7enc16.h>
 #endif
 
+// The amount of 4x4 blocks rows compressed by a single job
+#define STB_JOB_BLOCK_ROWS 8
+// The amount of pixel rows converted by a single job
+#define STB_JOB_PIXEL_ROWS 32
+
+/// <summary>
+/// The range of texture mip rows processed by a single job during texture conversion.
+/// </summary>
+struct StbRowsRange
+{
+    const TextureMipData* Src;
+    TextureMipData* Dst;
+    int32 Width;
+    int32 StartRow;
+    int32 EndRow;
+};
+
 static void stbWrite(void* context, void* data, int size)
 {
     auto file = (FileWriteStream*)context;
@@ -469,10 +487,13 @@ bool TextureTool::ImportTextureStb(ImageType type, const StringView& path, Textu
     // Generate mip maps chain
     if (useMipLevels && options.GenerateMipMaps)
     {
+        // Each mip is downscaled from the previous one so array slices are processed in parallel
         for (int32 arrayIndex = 0; arrayIndex < arraySize; arrayIndex++)
+            textureDataSrc->Items[arrayIndex].Mips.Resize(mipLevels);
+        int64 failed = 0;
+        Function<void(int32)> job = [textureDataSrc, mipLevels, &failed](int32 arrayIndex)
         {
             auto& slice = textureDataSrc->Items[arrayIndex];
-            slice.Mips.Resize(mipLevels);
             for (int32 mipIndex = 1; mipIndex < mipLevels; mipIndex++)
             {
                 const auto& srcMip = slice.Mips[mipIndex - 1];
@@ -481,10 +502,16 @@ bool TextureTool::ImportTextureStb(ImageType type, const StringView& path, Textu
                 auto dstMipHeight = Math::Max(textureDataSrc->Height >> mipIndex, 1);
                 if (ResizeStb(textureDataSrc->Format, dstMip, srcMip, dstMipWidth, dstMipHeight))
                 {
-                    errorMsg = TEXT("Failed to generate mip texture.");
-                    return true;
+                    Platform::AtomicStore(&failed, 1);
+                    return;
                 }
             }
+        };
+        ThreadPool::Execute(job, arraySize);
+        if (failed)
+        {
+            errorMsg = TEXT("Failed to generate mip texture.");
+            return true;
         }
     }
 
@@ -560,6 +587,29 @@ bool TextureTool::ConvertStb(TextureData& dst, const TextureData& src, const Pix
             break;
         }
         bool isDstSRGB = PixelFormatExtensions::IsSRGB(dstFormat);
+        switch (dstFormat)
+        {
+        case PixelFormat::BC1_UNorm:
+        case PixelFormat::BC1_UNorm_sRGB:
+        case PixelFormat::BC3_UNorm:
+        case PixelFormat::BC3_UNorm_sRGB:
+        {
+            // stb_dxt initializes lookup tables on the first use (not thread-safe) so do it before spawning jobs
+            byte dummyDst[16];
+            Color32 dummySrc[16];
+            Platform::MemoryClear(dummySrc, sizeof(dummySrc));
+            stb_compress_dxt_block(dummyDst, (byte*)&dummySrc, 0, STB_DXT_HIGHQUAL);
+            break;
+        }
+        case PixelFormat::BC4_UNorm:
+        case PixelFormat::BC5_UNorm:
+        case PixelFormat::BC7_UNorm:
+        case PixelFormat::BC7_UNorm_sRGB:
+            break;
+        default:
+            LOG(Warning, "Cannot compress image. Unsupported format {0}", static_cast<int32>(dstFormat));
+            return true;
+        }
 
         // bc7enc init
         bc7enc16_compress_block_params params;
@@ -569,15 +619,14 @@ bool TextureTool::ConvertStb(TextureData& dst, const TextureData& src, const Pix
             bc7enc16_compress_block_init();
         }
 
-        // Compress all array slices
+        // Allocate all array slices and mip levels and split them into ranges of blocks rows
+        Array<StbRowsRange> ranges;
         for (int32 arrayIndex = 0; arrayIndex < arraySize; arrayIndex++)
         {
             const auto& srcSlice = textureData->Items[arrayIndex];
             auto& dstSlice = dst.Items[arrayIndex];
             auto mipLevels = srcSlice.Mips.Count();
             dstSlice.Mips.Resize(mipLevels, false);
-
-            // Compress all mip levels
             for (int32 mipIndex = 0; mipIndex < mipLevels; mipIndex++)
             {
                 const auto& srcMip = srcSlice.Mips[mipIndex];
@@ -593,58 +642,68 @@ bool TextureTool::ConvertStb(TextureData& dst, const TextureData& src, const Pix
                 dstMip.Lines = blocksHeight;
                 dstMip.Data.Allocate(dstMip.DepthPitch);
 
-                // Compress texture
-                for (int32 yBlock = 0; yBlock < blocksHeight; yBlock++)
+                for (int32 yBlock = 0; yBlock < blocksHeight; yBlock += STB_JOB_BLOCK_ROWS)
+                    ranges.Add({ &srcMip, &dstMip, blocksWidth, yBlock, Math::Min(yBlock + STB_JOB_BLOCK_ROWS, blocksHeight) });
+            }
+        }
+
+        // Compress texture blocks (in parallel)
+        Function<void(int32)> job = [&ranges, &params, sampler, isDstSRGB, dstFormat, bytesPerBlock](int32 index)
+        {
+            const StbRowsRange& range = ranges[index];
+            const TextureMipData& srcMip = *range.Src;
+            TextureMipData& dstMip = *range.Dst;
+            const int32 blocksWidth = range.Width;
+            for (int32 yBlock = range.StartRow; yBlock < range.EndRow; yBlock++)
+            {
+                for (int32 xBlock = 0; xBlock < blocksWidth; xBlock++)
                 {
-                    for (int32 xBlock = 0; xBlock < blocksWidth; xBlock++)
+                    // Sample source texture 4x4 block
+                    Color32 srcBlock[16];
+                    for (int32 y = 0; y < 4; y++)
                     {
-                        // Sample source texture 4x4 block
-                        Color32 srcBlock[16];
-                        for (int32 y = 0; y < 4; y++)
+                        for (int32 x = 0; x < 4; x++)
                         {
-                            for (int32 x = 0; x < 4; x++)
-                            {
-                                Color color = TextureTool::SamplePoint(sampler, xBlock * 4 + x, yBlock * 4 + y, srcMip.Data.Get(), srcMip.RowPitch);
-                                if (isDstSRGB)
-                                    color = Color::LinearToSrgb(color);
-                                srcBlock[y * 4 + x] = Color32(color);
-                            }
+                            Color color = TextureTool::SamplePoint(sampler, xBlock * 4 + x, yBlock * 4 + y, srcMip.Data.Get(), srcMip.RowPitch);
+                            if (isDstSRGB)
+                                color = Color::LinearToSrgb(color);
+                            srcBlock[y * 4 + x] = Color32(color);
                         }
+                    }
 
-                        // Compress block
-                        byte* dstBlock = dstMip.Data.Get() + (yBlock * blocksWidth + xBlock) * bytesPerBlock;
-                        switch (dstFormat)
-                        {
-                        case PixelFormat::BC1_UNorm:
-                        case PixelFormat::BC1_UNorm_sRGB:
-                            stb_compress_dxt_block(dstBlock, (byte*)&srcBlock, 0, STB_DXT_HIGHQUAL);
-                            break;
-                        case PixelFormat::BC3_UNorm:
-                        case PixelFormat::BC3_UNorm_sRGB:
-                            stb_compress_dxt_block(dstBlock, (byte*)&srcBlock, 1, STB_DXT_HIGHQUAL);
-                            break;
-                        case PixelFormat::BC4_UNorm:
-                            for (int32 i = 1; i < 16; i++)
-                                ((byte*)&srcBlock)[i] = srcBlock[i].R;
-                            stb_compress_bc4_block(dstBlock, (byte*)&srcBlock);
-                            break;
-                        case PixelFormat::BC5_UNorm:
-                            for (int32 i = 0; i < 16; i++)
-                                ((uint16*)&srcBlock)[i] = srcBlock[i].R << 8 | srcBlock[i].G;
-                            stb_compress_bc5_block(dstBlock, (byte*)&srcBlock);
-                            break;
-                        case PixelFormat::BC7_UNorm:
-                        case PixelFormat::BC7_UNorm_sRGB:
-                            bc7enc16_compress_block(dstBlock, &srcBlock, &params);
-                            break;
-                        default:
-                            LOG(Warning, "Cannot compress image. Unsupported format {0}", static_cast<int32>(dstFormat));
-                            return true;
-                        }
+                    // Compress block
+                    byte* dstBlock = dstMip.Data.Get() + (yBlock * blocksWidth + xBlock) * bytesPerBlock;
+                    switch (dstFormat)
+                    {
+                    case PixelFormat::BC1_UNorm:
+                    case PixelFormat::BC1_UNorm_sRGB:
+                        stb_compress_dxt_block(dstBlock, (byte*)&srcBlock, 0, STB_DXT_HIGHQUAL);
+                        break;
+                    case PixelFormat::BC3_UNorm:
+                    case PixelFormat::BC3_UNorm_sRGB:
+                        stb_compress_dxt_block(dstBlock, (byte*)&srcBlock, 1, STB_DXT_HIGHQUAL);
+                        break;
+                    case PixelFormat::BC4_UNorm:
+                        for (int32 i = 1; i < 16; i++)
+                            ((byte*)&srcBlock)[i] = srcBlock[i].R;
+                        stb_compress_bc4_block(dstBlock, (byte*)&srcBlock);
+                        break;
+                    case PixelFormat::BC5_UNorm:
+                        for (int32 i = 0; i < 16; i++)
+                            ((uint16*)&srcBlock)[i] = srcBlock[i].R << 8 | srcBlock[i].G;
+                        stb_compress_bc5_block(dstBlock, (byte*)&srcBlock);
+                        break;
+                    case PixelFormat::BC7_UNorm:
+                    case PixelFormat::BC7_UNorm_sRGB:
+                        bc7enc16_compress_block(dstBlock, &srcBlock, &params);
+                        break;
+                    default:
+                        break;
                     }
                 }
             }
-        }
+        };
+        ThreadPool::Execute(job, ranges.Count());
     }
     else
 #endif
@@ -657,15 +716,14 @@ bool TextureTool::ConvertStb(TextureData& dst, const TextureData& src, const Pix
             return true;
         }
 
-        // Convert all array slices
+        // Allocate all array slices and mip levels and split them into ranges of rows
+        Array<StbRowsRange> ranges;
         for (int32 arrayIndex = 0; arrayIndex < arraySize; arrayIndex++)
         {
             const auto& srcSlice = textureData->Items[arrayIndex];
             auto& dstSlice = dst.Items[arrayIndex];
             auto mipLevels = srcSlice.Mips.Count();
             dstSlice.Mips.Resize(mipLevels, false);
-
-            // Convert all mip levels
             for (int32 mipIndex = 0; mipIndex < mipLevels; mipIndex++)
             {
                 const auto& srcMip = srcSlice.Mips[mipIndex];
@@ -679,20 +737,30 @@ bool TextureTool::ConvertStb(TextureData& dst, const TextureData& src, const Pix
                 dstMip.Lines = mipHeight;
                 dstMip.Data.Allocate(dstMip.DepthPitch);
 
-                // Convert texture
-                for (int32 y = 0; y < mipHeight; y++)
+                for (int32 y = 0; y < mipHeight; y += STB_JOB_PIXEL_ROWS)
+                    ranges.Add({ &srcMip, &dstMip, mipWidth, y, Math::Min(y + STB_JOB_PIXEL_ROWS, mipHeight) });
+            }
+        }
+
+        // Convert texture (in parallel)
+        Function<void(int32)> job = [&ranges, sampler, dstSampler](int32 index)
+        {
+            const StbRowsRange& range = ranges[index];
+            const TextureMipData& srcMip = *range.Src;
+            TextureMipData& dstMip = *range.Dst;
+            for (int32 y = range.StartRow; y < range.EndRow; y++)
+            {
+                for (int32 x = 0; x < range.Width; x++)
                 {
-                    for (int32 x = 0; x < mipWidth; x++)
-                    {
-                        // Sample source texture
-                        Color color = TextureTool::SamplePoint(sampler, x, y, srcMip.Data.Get(), srcMip.RowPitch);
+                    // Sample source texture
+                    Color color = TextureTool::SamplePoint(sampler, x, y, srcMip.Data.Get(), srcMip.RowPitch);
 
-                        // Store destination texture
-                        TextureTool::Store(dstSampler, x, y, dstMip.Data.Get(), dstMip.RowPitch, color);
-                    }
+                    // Store destination texture
+                    TextureTool::Store(dstSampler, x, y, dstMip.Data.Get(), dstMip.RowPitch, color);
                 }
             }
-        }
+        };
+        ThreadPool::Execute(job, ranges.Count());
     }
 
     return false;
@@ -797,29 +865,32 @@ bool TextureTool::ResizeStb(TextureData& dst, const TextureData& src, int32 dstW
     auto formatSize = PixelFormatExtensions::SizeInBytes(src.Format);
     auto components = PixelFormatExtensions::ComputeComponentsCount(src.Format);
 
-    // Resize all array slices
+    // Allocate all array slices
+    int32 mipsCount = 0;
     for (int32 arrayIndex = 0; arrayIndex < arraySize; arrayIndex++)
     {
-        const auto& srcSlice = src.Items[arrayIndex];
-        auto& dstSlice = dst.Items[arrayIndex];
-        auto mipLevels = srcSlice.Mips.Count();
-        dstSlice.Mips.Resize(mipLevels, false);
-
-        // Resize all mip levels
-        for (int32 mipIndex = 0; mipIndex < mipLevels; mipIndex++)
-        {
-            const auto& srcMip = srcSlice.Mips[mipIndex];
-            auto& dstMip = dstSlice.Mips[mipIndex];
-            auto srcMipWidth = srcMip.RowPitch / formatSize;
-            auto srcMipHeight = srcMip.DepthPitch / srcMip.RowPitch;
-            auto dstMipWidth = Math::Max(dstWidth >> mipIndex, 1);
-            auto dstMipHeight = Math::Max(dstHeight >> mipIndex, 1);
-            if (ResizeStb(src.Format, dstMip, srcMip, dstMipWidth, dstMipHeight))
-                return true;
-        }
+        dst.Items[arrayIndex].Mips.Resize(src.Items[arrayIndex].Mips.Count(), false);
+        mipsCount += src.Items[arrayIndex].Mips.Count();
     }
 
-    return false;
+    // Resize all mip levels (each one is independent so do it in parallel)
+    int64 failed = 0;
+    Function<void(int32)> job = [&dst, &src, dstWidth, dstHeight, &failed](int32 index)
+    {
+        int32 arrayIndex = 0;
+        while (index >= src.Items[arrayIndex].Mips.Count())
+            index -= src.Items[arrayIndex++].Mips.Count();
+        const int32 mipIndex = index;
+        const auto& srcMip = src.Items[arrayIndex].Mips[mipIndex];
+        auto& dstMip = dst.Items[arrayIndex].Mips[mipIndex];
+        auto dstMipWidth = Math::Max(dstWidth >> mipIndex, 1);
+        auto dstMipHeight = Math::Max(dstHeight >> mipIndex, 1);
+        if (ResizeStb(src.Format, dstMip, srcMip, dstMipWidth, dstMipHeight))
+            Platform::AtomicStore(&failed, 1);
+    };
+    ThreadPool::Execute(job, mipsCount);
+
+    return failed != 0;
 }
 
 #endif
@@ -29,6 +29,8 @@ public class Button : ContainerControl
         /// </summary>
         protected LocalizedString _text = new LocalizedString();
 
+        private IBrush _backgroundBrush;
+
         /// <summary>
         /// Button text property.
         /// </summary>
@@ -36,7 +38,11 @@ public class Button : ContainerControl
         public LocalizedString Text
         {
             get => _text;
-            set => _text = value;
+            set
+            {
+                _text = value;
+                InvalidateDrawCache();
+            }
         }
 
         /// <summary>
@@ -46,7 +52,11 @@ public LocalizedString Text
         public FontReference Font
         {
             get => _font;
-            set => _font = value;
+            set
+            {
+                _font = value;
+                InvalidateDrawCache();
+            }
         }
 
         /// <summary>
@@ -75,7 +85,15 @@ public FontReference Font
         /// Gets or sets the brush used for background drawing.
         /// </summary>
         [EditorDisplay("Style"), EditorOrder(2000), Tooltip("The brush used for background drawing.")]
-        public IBrush BackgroundBrush { get; set; }
+        public IBrush BackgroundBrush
+        {
+            get => _backgroundBrush;
+            set
+            {
+                _backgroundBrush = value;
+                InvalidateDrawCache();
+            }
+        }
 
         /// <summary>
         /// Gets or sets the color of the border.
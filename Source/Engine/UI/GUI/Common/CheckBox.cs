@@ -68,6 +68,7 @@ public CheckBoxState State
                 if (_state != value)
                 {
                     _state = value;
+                    InvalidateDrawCache();
 
                     StateChanged?.Invoke(this);
                 }
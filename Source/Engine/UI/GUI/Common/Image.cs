@@ -10,11 +10,22 @@ namespace FlaxEngine.GUI
     /// <seealso cref="FlaxEngine.GUI.ContainerControl" />
     public class Image : ContainerControl
     {
+        private IBrush _brush;
+        private Color _color = Color.White;
+
         /// <summary>
         /// Gets or sets the image source.
         /// </summary>
         [EditorOrder(10), Tooltip("The image to draw.")]
-        public IBrush Brush { get; set; }
+        public IBrush Brush
+        {
+            get => _brush;
+            set
+            {
+                _brush = value;
+                InvalidateDrawCache();
+            }
+        }
 
         /// <summary>
         /// Gets or sets the margin for the image.
@@ -26,7 +37,18 @@ public class Image : ContainerControl
         /// Gets or sets the color used to multiply the image pixels.
         /// </summary>
         [EditorDisplay("Style"), EditorOrder(2000)]
-        public Color Color { get; set; } = Color.White;
+        public Color Color
+        {
+            get => _color;
+            set
+            {
+                if (_color != value)
+                {
+                    _color = value;
+                    InvalidateDrawCache();
+                }
+            }
+        }
 
         /// <summary>
         /// Gets or sets the color used to multiply the image pixels when mouse is over the image.
@@ -15,6 +15,8 @@ public class Label : ContainerControl
         /// </summary>
         protected LocalizedString _text = new LocalizedString();
 
+        private Color _textColor;
+        private MaterialBase _material;
         private bool _autoWidth;
         private bool _autoHeight;
         private bool _autoFitText;
@@ -40,6 +42,7 @@ public LocalizedString Text
                     _text = value;
                     _textSize = Vector2.Zero;
                     PerformLayout();
+                    InvalidateDrawCache();
                 }
             }
         }
@@ -48,7 +51,18 @@ public LocalizedString Text
         /// Gets or sets the color of the text.
         /// </summary>
         [EditorDisplay("Style"), EditorOrder(2000), Tooltip("The color of the text.")]
-        public Color TextColor { get; set; }
+        public Color TextColor
+        {
+            get => _textColor;
+            set
+            {
+                if (_textColor != value)
+                {
+                    _textColor = value;
+                    InvalidateDrawCache();
+                }
+            }
+        }
 
         /// <summary>
         /// Gets or sets the color of the text when it is highlighted (mouse is over).
@@ -86,6 +100,7 @@ public FontReference Font
                 if (_font != value)
                 {
                     _font = value;
+                    InvalidateDrawCache();
 
                     if (_autoWidth || _autoHeight || _autoFitText)
                     {
@@ -100,7 +115,18 @@ public FontReference Font
         /// Gets or sets the custom material used to render the text. It must has domain set to GUI and have a public texture parameter named Font used to sample font atlas texture with font characters data.
         /// </summary>
         [EditorDisplay("Style"), EditorOrder(2000)]
-        public MaterialBase Material { get; set; }
+        public MaterialBase Material
+        {
+            get => _material;
+            set
+            {
+                if (_material != value)
+                {
+                    _material = value;
+                    InvalidateDrawCache();
+                }
+            }
+        }
 
         /// <summary>
         /// Gets or sets the margin for the text within the control bounds.
@@ -315,6 +315,7 @@ public void SetText(string value)
                 ResetViewOffset();
 
                 _text = value;
+                InvalidateDrawCache();
 
                 OnTextChanged();
             }
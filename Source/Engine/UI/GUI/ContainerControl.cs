@@ -31,6 +31,11 @@ public class ContainerControl : Control
 
         private bool _clipChildren = true;
         private bool _cullChildren = true;
+        private bool _cacheDrawing;
+        private bool _isDrawCacheValid;
+        private Render2DCommandList _drawCache;
+        private Matrix3x3 _drawCacheTransform;
+        private Rectangle _drawCacheClip;
 
         /// <summary>
         /// Initializes a new instance of the <see cref="ContainerControl"/> class.
@@ -115,6 +120,37 @@ public bool CullChildren
             set => _cullChildren = value;
         }
 
+        /// <summary>
+        /// Gets or sets a value indicating whether cache the drawing of the control and its children. Draw commands are recorded once and replayed until invalidated (by layout, children, input or visual properties changes, or with <see cref="InvalidateDrawCache"/>). Use it for the mostly static content.
+        /// </summary>
+        /// <remarks>
+        /// Recorded commands reference the textures, materials and fonts used at the recording time. Don't use it for the animated or streamed content (eg. videos, render targets, materials with time-based effects, textures or fonts that are still loading) as the replayed drawing won't be updated.
+        /// </remarks>
+        [EditorOrder(550), Tooltip("If checked, control will record the drawing of itself and the children once and replay it until invalidated (eg. by layout or input events). Use it for the mostly static content.")]
+        public bool CacheDrawing
+        {
+            get => _cacheDrawing;
+            set
+            {
+                if (_cacheDrawing == value)
+                    return;
+                _cacheDrawing = value;
+                _isDrawCacheValid = false;
+                if (!value)
+                    Object.Destroy(ref _drawCache);
+            }
+        }
+
+        /// <summary>
+        /// Invalidates the cached drawing of this control and all the parent controls (see <see cref="CacheDrawing"/>). Call it when the visuals of the child controls change.
+        /// </summary>
+        [NoAnimate]
+        public override void InvalidateDrawCache()
+        {
+            _isDrawCacheValid = false;
+            base.InvalidateDrawCache();
+        }
+
         /// <summary>
         /// Locks all child controls layout and itself.
         /// </summary>
@@ -412,6 +448,7 @@ public void SortChildrenRecursive()
         /// <param name="control">The resized control.</param>
         public virtual void OnChildResized(Control control)
         {
+            InvalidateDrawCache();
         }
 
         /// <summary>
@@ -420,6 +457,8 @@ public virtual void OnChildResized(Control control)
         [NoAnimate]
         public virtual void OnChildrenChanged()
         {
+            InvalidateDrawCache();
+
             // Check if control isn't during disposing state
             if (!IsDisposing)
             {
@@ -717,6 +756,7 @@ public override void OnDestroy()
                 _children[i].OnDestroy();
             }
             _children.Clear();
+            Object.Destroy(ref _drawCache);
         }
 
         /// <inheritdoc />
@@ -754,6 +794,34 @@ public override void Update(float deltaTime)
         /// Draw the control and the children.
         /// </summary>
         public override void Draw()
+        {
+            if (_cacheDrawing)
+            {
+                // Replay the recorded drawing if the output transformation and clipping are the same
+                Render2D.PeekTransform(out var transform);
+                Render2D.PeekClip(out var clip);
+                if (_isDrawCacheValid && transform == _drawCacheTransform && clip == _drawCacheClip)
+                {
+                    var offset = Vector2.Zero;
+                    Render2D.Replay(_drawCache, ref offset);
+                    return;
+                }
+                if (_drawCache == null)
+                    _drawCache = new Render2DCommandList();
+                _drawCacheTransform = transform;
+                _drawCacheClip = clip;
+                _isDrawCacheValid = true;
+                Render2D.BeginRecording(_drawCache);
+                DrawContents();
+                Render2D.EndRecording();
+            }
+            else
+            {
+                DrawContents();
+            }
+        }
+
+        private void DrawContents()
         {
             DrawSelf();
 
@@ -824,6 +892,7 @@ public override void PerformLayout(bool force = false)
         {
             if (_isLayoutLocked && !force)
                 return;
+            InvalidateDrawCache();
 
             bool wasLocked = _isLayoutLocked;
             if (!wasLocked)
@@ -843,6 +912,7 @@ public override void PerformLayout(bool force = false)
         /// <inheritdoc />
         public override void OnMouseEnter(Vector2 location)
         {
+            InvalidateDrawCache();
             // Check all children collisions with mouse and fire events for them
             for (int i = _children.Count - 1; i >= 0 && _children.Count > 0; i--)
             {
@@ -863,6 +933,7 @@ public override void OnMouseEnter(Vector2 location)
         /// <inheritdoc />
         public override void OnMouseMove(Vector2 location)
         {
+            InvalidateDrawCache();
             // Check all children collisions with mouse and fire events for them
             for (int i = _children.Count - 1; i >= 0 && _children.Count > 0; i--)
             {
@@ -896,6 +967,7 @@ public override void OnMouseMove(Vector2 location)
         /// <inheritdoc />
         public override void OnMouseLeave()
         {
+            InvalidateDrawCache();
             // Check all children collisions with mouse and fire events for them
             for (int i = 0; i < _children.Count && _children.Count > 0; i++)
             {
@@ -913,6 +985,7 @@ public override void OnMouseLeave()
         /// <inheritdoc />
         public override bool OnMouseWheel(Vector2 location, float delta)
         {
+            InvalidateDrawCache();
             // Check all children collisions with mouse and fire events for them
             for (int i = _children.Count - 1; i >= 0 && _children.Count > 0; i--)
             {
@@ -934,6 +1007,7 @@ public override bool OnMouseWheel(Vector2 location, float delta)
         /// <inheritdoc />
         public override bool OnMouseDown(Vector2 location, MouseButton button)
         {
+            InvalidateDrawCache();
             // Check all children collisions with mouse and fire events for them
             for (int i = _children.Count - 1; i >= 0 && _children.Count > 0; i--)
             {
@@ -955,6 +1029,7 @@ public override bool OnMouseDown(Vector2 location, MouseButton button)
         /// <inheritdoc />
         public override bool OnMouseUp(Vector2 location, MouseButton button)
         {
+            InvalidateDrawCache();
             // Check all children collisions with mouse and fire events for them
             for (int i = _children.Count - 1; i >= 0 && _children.Count > 0; i--)
             {
@@ -976,6 +1051,7 @@ public override bool OnMouseUp(Vector2 location, MouseButton button)
         /// <inheritdoc />
         public override bool OnMouseDoubleClick(Vector2 location, MouseButton button)
         {
+            InvalidateDrawCache();
             // Check all children collisions with mouse and fire events for them
             for (int i = _children.Count - 1; i >= 0 && _children.Count > 0; i--)
             {
@@ -1012,6 +1088,7 @@ public override bool IsTouchPointerOver(int pointerId)
         /// <inheritdoc />
         public override void OnTouchEnter(Vector2 location, int pointerId)
         {
+            InvalidateDrawCache();
             for (int i = _children.Count - 1; i >= 0 && _children.Count > 0; i--)
             {
                 var child = _children[i];
@@ -1030,6 +1107,7 @@ public override void OnTouchEnter(Vector2 location, int pointerId)
         /// <inheritdoc />
         public override bool OnTouchDown(Vector2 location, int pointerId)
         {
+            InvalidateDrawCache();
             for (int i = _children.Count - 1; i >= 0 && _children.Count > 0; i--)
             {
                 var child = _children[i];
@@ -1055,6 +1133,7 @@ public override bool OnTouchDown(Vector2 location, int pointerId)
         /// <inheritdoc />
         public override void OnTouchMove(Vector2 location, int pointerId)
         {
+            InvalidateDrawCache();
             for (int i = _children.Count - 1; i >= 0 && _children.Count > 0; i--)
             {
                 var child = _children[i];
@@ -1084,6 +1163,7 @@ public override void OnTouchMove(Vector2 location, int pointerId)
         /// <inheritdoc />
         public override bool OnTouchUp(Vector2 location, int pointerId)
         {
+            InvalidateDrawCache();
             for (int i = _children.Count - 1; i >= 0 && _children.Count > 0; i--)
             {
                 var child = _children[i];
@@ -1105,6 +1185,7 @@ public override bool OnTouchUp(Vector2 location, int pointerId)
         /// <inheritdoc />
         public override void OnTouchLeave(int pointerId)
         {
+            InvalidateDrawCache();
             for (int i = 0; i < _children.Count && _children.Count > 0; i++)
             {
                 var child = _children[i];
@@ -1120,6 +1201,7 @@ public override void OnTouchLeave(int pointerId)
         /// <inheritdoc />
         public override bool OnCharInput(char c)
         {
+            InvalidateDrawCache();
             for (int i = 0; i < _children.Count && _children.Count > 0; i++)
             {
                 var child = _children[i];
@@ -1134,6 +1216,7 @@ public override bool OnCharInput(char c)
         /// <inheritdoc />
         public override bool OnKeyDown(KeyboardKeys key)
         {
+            InvalidateDrawCache();
             for (int i = 0; i < _children.Count && _children.Count > 0; i++)
             {
                 var child = _children[i];
@@ -1148,6 +1231,7 @@ public override bool OnKeyDown(KeyboardKeys key)
         /// <inheritdoc />
         public override void OnKeyUp(KeyboardKeys key)
         {
+            InvalidateDrawCache();
             for (int i = 0; i < _children.Count && _children.Count > 0; i++)
             {
                 var child = _children[i];
@@ -1162,6 +1246,7 @@ public override void OnKeyUp(KeyboardKeys key)
         /// <inheritdoc />
         public override DragDropEffect OnDragEnter(ref Vector2 location, DragData data)
         {
+            InvalidateDrawCache();
             // Base
             var result = base.OnDragEnter(ref location, data);
 
@@ -1187,6 +1272,7 @@ public override DragDropEffect OnDragEnter(ref Vector2 location, DragData data)
         /// <inheritdoc />
         public override DragDropEffect OnDragMove(ref Vector2 location, DragData data)
         {
+            InvalidateDrawCache();
             // Base
             var result = base.OnDragMove(ref location, data);
 
@@ -1227,6 +1313,7 @@ public override DragDropEffect OnDragMove(ref Vector2 location, DragData data)
         /// <inheritdoc />
         public override void OnDragLeave()
         {
+            InvalidateDrawCache();
             // Base
             base.OnDragLeave();
 
@@ -1245,6 +1332,7 @@ public override void OnDragLeave()
         /// <inheritdoc />
         public override DragDropEffect OnDragDrop(ref Vector2 location, DragData data)
         {
+            InvalidateDrawCache();
             // Base
             var result = base.OnDragDrop(ref location, data);
 
@@ -1270,6 +1358,8 @@ public override DragDropEffect OnDragDrop(ref Vector2 location, DragData data)
         /// <inheritdoc />
         protected override void OnSizeChanged()
         {
+            InvalidateDrawCache();
+
             // Lock updates to prevent additional layout calculations
             bool wasLayoutLocked = _isLayoutLocked;
             _isLayoutLocked = true;
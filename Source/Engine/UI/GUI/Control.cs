@@ -169,7 +169,14 @@ public int IndexInParent
         public Color BackgroundColor
         {
             get => _backgroundColor;
-            set => _backgroundColor = value;
+            set
+            {
+                if (_backgroundColor != value)
+                {
+                    _backgroundColor = value;
+                    InvalidateDrawCache();
+                }
+            }
         }
 
         /// <summary>
@@ -228,6 +235,8 @@ public bool Enabled
                         while (_touchOvers != null && _touchOvers.Count != 0)
                             OnTouchLeave(_touchOvers[0]);
                     }
+
+                    InvalidateDrawCache();
                 }
             }
         }
@@ -275,6 +284,7 @@ public bool Visible
                     }
 
                     OnVisibleChanged();
+                    InvalidateDrawCache();
                     _parent?.PerformLayout();
                 }
             }
@@ -444,6 +454,15 @@ public virtual void Draw()
             }
         }
 
+        /// <summary>
+        /// Invalidates the cached drawing of the parent controls (see <see cref="ContainerControl.CacheDrawing"/>). Call it when the control visuals change.
+        /// </summary>
+        [NoAnimate]
+        public virtual void InvalidateDrawCache()
+        {
+            _parent?.InvalidateDrawCache();
+        }
+
         /// <summary>
         /// Update control layout
         /// </summary>
@@ -0,0 +1,167 @@
+// Copyright (c) 2012-2022 Wojciech Figat. All rights reserved.
+
+#include "./Flax/Common.hlsl"
+
+// Size of the cluster container for instances (matches FOLIAGE_CLUSTER_CAPACITY)
+#define CLUSTER_CAPACITY 64
+
+// Maximum amount of the model LODs (matches MODEL_MAX_LODS)
+#define MAX_LODS 6
+
+// Maximum amount of the thread groups dispatched in a single dimension
+#define MAX_GROUPS_X 65535
+
+// Size of the indexed indirect draw arguments (in bytes)
+#define DRAW_ARGS_SIZE 20
+
+// Size of the instance data written to the instancing vertex buffer (in bytes)
+#define INSTANCE_DATA_SIZE 64
+
+// Primary constant buffer
+META_CB_BEGIN(0, Data)
+float4 FrustumPlanes[6];
+float3 ViewPosition;
+float LODDistanceFactor;
+float3 LODViewPosition;
+float MinScreenRadiusSquared;
+float4 LODScreenRadiusSquared[2];
+uint ClustersCount;
+uint LODsCount;
+uint MinLOD;
+int LODBias;
+uint MeshesCount;
+float3 Dummy0;
+META_CB_END
+
+struct FoliageCluster
+{
+	float3 BoundsCenter;
+	float BoundsRadius;
+	float MaxCullDistance;
+	uint InstancesStart;
+	uint InstancesCount;
+	float Dummy0;
+};
+
+struct FoliageInstance
+{
+	float3 InstanceOrigin;
+	float PerInstanceRandom;
+	float3 InstanceTransform1;
+	float CullDistance;
+	float3 InstanceTransform2;
+	float BoundsRadius;
+	float3 InstanceTransform3;
+	float Dummy0;
+	float3 BoundsCenter;
+	float Dummy1;
+};
+
+StructuredBuffer<FoliageCluster> Clusters : register(t0);
+StructuredBuffer<FoliageInstance> Instances : register(t1);
+
+// Per-LOD visible instances counters followed by the per-LOD instances write locations
+RWByteAddressBuffer Counters : register(u0);
+
+// Indirect draw arguments (for CS_Args) or instances data (for CS_Write)
+RWByteAddressBuffer Output : register(u1);
+
+bool IsInFrustum(float3 center, float radius)
+{
+	UNROLL
+	for (int i = 0; i < 6; i++)
+	{
+		if (dot(FrustumPlanes[i].xyz, center) + FrustumPlanes[i].w < -radius)
+			return false;
+	}
+	return true;
+}
+
+int SelectLOD(float3 center, float radius)
+{
+	// Matches RenderTools::ComputeModelLOD
+	float3 toView = center - LODViewPosition;
+	float screenRadiusSquared = LODDistanceFactor * radius * radius / max(1.0f, dot(toView, toView));
+	if (MinScreenRadiusSquared > screenRadiusSquared)
+		return -1;
+	int lod = 0;
+	for (int i = (int)LODsCount - 1; i >= 0; i--)
+	{
+		if (LODScreenRadiusSquared[i / 4][i % 4] >= screenRadiusSquared)
+		{
+			lod = i;
+			break;
+		}
+	}
+	return clamp(lod + LODBias, (int)MinLOD, (int)LODsCount - 1);
+}
+
+// Culls the foliage instance (each thread group processes a single leaf cluster). Returns the instance LOD or -1 if it's not visible.
+int CullInstance(uint3 groupId, uint groupIndex, out FoliageInstance instance)
+{
+	instance = (FoliageInstance)0;
+	uint clusterIndex = groupId.y * MAX_GROUPS_X + groupId.x;
+	if (clusterIndex >= ClustersCount)
+		return -1;
+	FoliageCluster cluster = Clusters[clusterIndex];
+	if (groupIndex >= cluster.InstancesCount)
+		return -1;
+	if (distance(ViewPosition, cluster.BoundsCenter) - cluster.BoundsRadius > cluster.MaxCullDistance || !IsInFrustum(cluster.BoundsCenter, cluster.BoundsRadius))
+		return -1;
+	instance = Instances[cluster.InstancesStart + groupIndex];
+	if (distance(ViewPosition, instance.BoundsCenter) - instance.BoundsRadius >= instance.CullDistance || !IsInFrustum(instance.BoundsCenter, instance.BoundsRadius))
+		return -1;
+	return SelectLOD(instance.BoundsCenter, instance.BoundsRadius);
+}
+
+// Visible instances counting shader
+META_CS(true, FEATURE_LEVEL_SM5)
+[numthreads(CLUSTER_CAPACITY, 1, 1)]
+void CS_Count(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+	FoliageInstance instance;
+	int lod = CullInstance(groupId, groupIndex, instance);
+	if (lod >= 0)
+		Counters.InterlockedAdd(lod * 4, 1);
+}
+
+// Indirect draw arguments generation shader
+META_CS(true, FEATURE_LEVEL_SM5)
+[numthreads(1, 1, 1)]
+void CS_Args()
+{
+	// Place instances of each LOD one after another in the output buffer
+	uint offset = 0;
+	for (uint lod = 0; lod < LODsCount; lod++)
+	{
+		uint count = Counters.Load(lod * 4);
+		Counters.Store((MAX_LODS + lod) * 4, offset);
+		for (uint mesh = 0; mesh < MeshesCount; mesh++)
+		{
+			uint args = (lod * MeshesCount + mesh) * DRAW_ARGS_SIZE;
+			Output.Store(args + 4, count);
+			Output.Store(args + 16, offset);
+		}
+		offset += count;
+	}
+}
+
+// Visible instances data writing shader
+META_CS(true, FEATURE_LEVEL_SM5)
+[numthreads(CLUSTER_CAPACITY, 1, 1)]
+void CS_Write(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+	FoliageInstance instance;
+	int lod = CullInstance(groupId, groupIndex, instance);
+	if (lod < 0)
+		return;
+	uint index;
+	Counters.InterlockedAdd((MAX_LODS + lod) * 4, 1, index);
+
+	// Write instance data (matches InstanceData layout, LOD dithering and lightmaps are not used)
+	uint address = index * INSTANCE_DATA_SIZE;
+	Output.Store4(address, asuint(float4(instance.InstanceOrigin, instance.PerInstanceRandom)));
+	Output.Store4(address + 16, asuint(float4(instance.InstanceTransform1, 0.0f)));
+	Output.Store4(address + 32, asuint(float4(instance.InstanceTransform2, instance.InstanceTransform3.x)));
+	Output.Store4(address + 48, uint4(asuint(instance.InstanceTransform3.yz), 0, 0));
+}